@@ -168,6 +168,9 @@ class fm_operator
 	static constexpr uint32_t EG_QUIET = 0x380;
 
 public:
+	// envelope captured by clock_block for a sample where the operator is quiet
+	static constexpr uint16_t BLOCK_ENV_QUIET = 0xffff;
+
 	// constructor
 	fm_operator(fm_engine_base<RegisterType> &owner, uint32_t opoffs);
 
@@ -193,9 +196,18 @@ public:
 	// return the current phase value
 	uint32_t phase() const { return m_phase >> 10; }
 
+	// clock over a block of samples, capturing each sample's phase and envelope
+	void clock_block(uint32_t samples, uint32_t const *env_counter, int32_t const *lfo_raw_pm, uint32_t const *am_offset, uint32_t *phase, uint16_t *envelope);
+
 	// compute operator volume
 	int32_t compute_volume(uint32_t phase, uint32_t am_offset) const;
 
+	// compute operator volume from a phase and an envelope captured by clock_block
+	int32_t compute_block_volume(uint32_t phase, uint32_t envelope) const
+	{
+		return (envelope == BLOCK_ENV_QUIET) ? 0 : attenuated_volume(phase, envelope);
+	}
+
 	// compute volume for the OPM noise channel
 	int32_t compute_noise_volume(uint32_t am_offset) const;
 
@@ -227,6 +239,9 @@ private:
 	// return effective attenuation of the envelope
 	uint32_t envelope_attenuation(uint32_t am_offset) const;
 
+	// combine the waveform at the given phase with a 4.8 envelope attenuation
+	int32_t attenuated_volume(uint32_t phase, uint32_t env_attenuation) const;
+
 	// internal state
 	uint32_t m_choffs;                     // channel offset in registers
 	uint32_t m_opoffs;                     // operator offset in registers
@@ -252,6 +267,9 @@ class fm_channel
 	using output_data = ymfm_output<RegisterType::OUTPUTS>;
 
 public:
+	// maximum number of samples clocked by one call to clock_block
+	static constexpr uint32_t BLOCK_SAMPLES = 64;
+
 	// constructor
 	fm_channel(fm_engine_base<RegisterType> &owner, uint32_t choffs);
 
@@ -282,6 +300,10 @@ public:
 	// master clocking function
 	void clock(uint32_t env_counter, int32_t lfo_raw_pm);
 
+	// clock over a block of samples, adding each sample's 2-operator or 4-operator
+	// output to the matching entry of the output array if non-null
+	void clock_block(uint32_t samples, uint32_t const *env_counter, int32_t const *lfo_raw_pm, uint32_t const *am_offset, output_data *output, uint32_t rshift, int32_t clipmax);
+
 	// specific 2-operator and 4-operator output handlers
 	void output_2op(output_data &output, uint32_t rshift, int32_t clipmax) const;
 	void output_4op(output_data &output, uint32_t rshift, int32_t clipmax) const;
@@ -306,6 +328,9 @@ public:
 	fm_operator<RegisterType> *debug_operator(uint32_t index) const { return m_op[index]; }
 
 private:
+	// return the operator connections for the given algorithm
+	static uint32_t algorithm_connections(uint32_t algorithm);
+
 	// helper to add values to the outputs based on channel enables
 	void add_to_output(uint32_t choffs, output_data &output, int32_t value) const
 	{
@@ -326,6 +351,28 @@ private:
 			output.data[out3_index] += value;
 	}
 
+	// helper to add a block of values to a block of outputs, checking the enables once
+	void add_to_output(uint32_t choffs, output_data *output, int32_t const *values, uint32_t samples) const
+	{
+		constexpr int out1_index = 1 % RegisterType::OUTPUTS;
+		constexpr int out2_index = 2 % RegisterType::OUTPUTS;
+		constexpr int out3_index = 3 % RegisterType::OUTPUTS;
+
+		auto add = [output, values, samples] (int index)
+		{
+			for (uint32_t samp = 0; samp < samples; samp++)
+				output[samp].data[index] += values[samp];
+		};
+		if (RegisterType::OUTPUTS == 1 || m_regs.ch_output_0(choffs))
+			add(0);
+		if (RegisterType::OUTPUTS >= 2 && m_regs.ch_output_1(choffs))
+			add(out1_index);
+		if (RegisterType::OUTPUTS >= 3 && m_regs.ch_output_2(choffs))
+			add(out2_index);
+		if (RegisterType::OUTPUTS >= 4 && m_regs.ch_output_3(choffs))
+			add(out3_index);
+	}
+
 	// internal state
 	uint32_t m_choffs;                     // channel offset in registers
 	int16_t m_feedback[2];                 // feedback memory for operator 1
@@ -360,6 +407,9 @@ public:
 	// expose the correct output class
 	using output_data = ymfm_output<OUTPUTS>;
 
+	// maximum number of samples produced by one call to generate_block
+	static constexpr uint32_t BLOCK_SAMPLES = fm_channel<RegisterType>::BLOCK_SAMPLES;
+
 	// constructor
 	fm_engine_base(ymfm_interface &intf);
 
@@ -375,6 +425,16 @@ public:
 	// compute sum of channel outputs
 	void output(output_data &output, uint32_t rshift, int32_t clipmax, uint32_t chanmask) const;
 
+	// clock and output up to BLOCK_SAMPLES samples, a channel at a time; each
+	// channel's output is added to chanout[chnum][sample] when chanout[chnum] is
+	// non-null, exactly as clock() followed by output() per sample would; returns
+	// the number of samples produced, which stops short before a periodic prepare
+	uint32_t generate_block(output_data *const *chanout, uint32_t numsamples, uint32_t rshift, int32_t clipmax, uint32_t chanmask);
+
+	// return the envelope counter that clock() would have returned for the given
+	// sample of the last generate_block
+	uint32_t block_env_counter(uint32_t index) const { return m_block_env_counter[index]; }
+
 	// write to the OPN registers
 	void write(uint16_t regnum, uint8_t data);
 
@@ -435,6 +495,9 @@ protected:
 	// assign the current set of operators to channels
 	void assign_operators();
 
+	// clock everything but the channels, returning the raw LFO PM value
+	int32_t clock_globals(uint32_t chanmask);
+
 	// update the state of the given timer
 	void update_timer(uint32_t which, uint32_t enable, int32_t delta_clocks);
 
@@ -453,6 +516,9 @@ protected:
 	RegisterType m_regs;             // register accessor
 	std::unique_ptr<fm_channel<RegisterType>> m_channel[CHANNELS]; // channel pointers
 	std::unique_ptr<fm_operator<RegisterType>> m_operator[OPERATORS]; // operator pointers
+	uint32_t m_block_env_counter[BLOCK_SAMPLES]; // envelope counter for each sample of a block
+	int32_t m_block_lfo_pm[BLOCK_SAMPLES]; // raw LFO PM value for each sample of a block
+	uint32_t m_block_am[CHANNELS][BLOCK_SAMPLES]; // per-channel LFO AM offset for each sample of a block
 #if (YMFM_DEBUG_LOG_WAVFILES)
 	mutable ymfm_wavfile<1> m_wavfile[CHANNELS]; // for debugging
 #endif
@@ -129,8 +129,10 @@ inline uint32_t attenuation_to_volume(uint32_t input)
 	};
 #undef X
 
-	// look up the fractional part, then shift by the whole
-	return s_power_table[input & 0xff] >> (input >> 8);
+	// look up the fractional part, then shift by the whole; inputs past 0x1fff
+	// (possible with OPL3 waveform 7 at low levels) are silent rather than
+	// depending on how the host masks oversized shift counts
+	return s_power_table[input & 0xff] >> std::min<uint32_t>(input >> 8, 31);
 }
 
 
@@ -460,6 +462,45 @@ void fm_operator<RegisterType>::clock(uint32_t env_counter, int32_t lfo_raw_pm)
 }
 
 
+//-------------------------------------------------
+//  clock_block - clock over a block of samples,
+//  capturing the phase and envelope attenuation
+//  that compute_volume would see after each one
+//-------------------------------------------------
+
+template<class RegisterType>
+void fm_operator<RegisterType>::clock_block(uint32_t samples, uint32_t const *env_counter, int32_t const *lfo_raw_pm, uint32_t const *am_offset, uint32_t *phase, uint16_t *envelope)
+{
+	// this is clock() unrolled over the block; the registers can't change within
+	// a block, so the SSG-EG enable is fixed, and a dynamic phase step only needs
+	// recomputing when the raw LFO PM value changes, which is rarely
+	bool ssg_eg_enable = m_regs.op_ssg_eg_enable(m_opoffs);
+	bool dynamic_step = (m_cache.phase_step == opdata_cache::PHASE_STEP_DYNAMIC);
+	uint32_t phase_step = m_cache.phase_step;
+	for (uint32_t samp = 0; samp < samples; samp++)
+	{
+		// clock the SSG-EG state (OPN/OPNA)
+		if (ssg_eg_enable)
+			clock_ssg_eg_state();
+		else
+			m_ssg_inverted = false;
+
+		// clock the envelope if on an envelope cycle; env_counter is a x.2 value
+		if (bitfield(env_counter[samp], 0, 2) == 0)
+			clock_envelope(env_counter[samp] >> 2);
+
+		// clock the phase
+		if (dynamic_step && (samp == 0 || lfo_raw_pm[samp] != lfo_raw_pm[samp - 1]))
+			phase_step = m_regs.compute_phase_step(m_choffs, m_opoffs, m_cache, lfo_raw_pm[samp]);
+		m_phase += phase_step;
+
+		// capture what the output sees
+		phase[samp] = m_phase >> 10;
+		envelope[samp] = (m_env_attenuation > EG_QUIET) ? BLOCK_ENV_QUIET : (envelope_attenuation(am_offset[samp]) << 2);
+	}
+}
+
+
 //-------------------------------------------------
 //  compute_volume - compute the 14-bit signed
 //  volume of this operator, given a phase
@@ -476,12 +517,23 @@ int32_t fm_operator<RegisterType>::compute_volume(uint32_t phase, uint32_t am_of
 	if (m_env_attenuation > EG_QUIET)
 		return 0;
 
+	// get the attenuation from the evelope generator as a 4.6 value, shifted up to 4.8
+	return attenuated_volume(phase, envelope_attenuation(am_offset) << 2);
+}
+
+
+//-------------------------------------------------
+//  attenuated_volume - compute the 14-bit signed
+//  volume of the waveform at the given phase,
+//  attenuated by a 4.8 envelope attenuation
+//-------------------------------------------------
+
+template<class RegisterType>
+int32_t fm_operator<RegisterType>::attenuated_volume(uint32_t phase, uint32_t env_attenuation) const
+{
 	// get the absolute value of the sin, as attenuation, as a 4.8 fixed point value
 	uint32_t sin_attenuation = m_cache.waveform[phase & (RegisterType::WAVEFORM_LENGTH - 1)];
 
-	// get the attenuation from the evelope generator as a 4.6 value, shifted up to 4.8
-	uint32_t env_attenuation = envelope_attenuation(am_offset) << 2;
-
 	// combine into a 5.8 value, then convert from attenuation to 13-bit linear volume
 	int32_t result = attenuation_to_volume((sin_attenuation & 0x7fff) + env_attenuation);
 
@@ -903,6 +955,185 @@ printf(" -- ");
 }
 
 
+//-------------------------------------------------
+//  algorithm_connections - return the operator
+//  inputs and outputs for the given algorithm
+//-------------------------------------------------
+
+template<class RegisterType>
+uint32_t fm_channel<RegisterType>::algorithm_connections(uint32_t algorithm)
+{
+	// OPM/OPN offer 8 different connection algorithms for 4 operators,
+	// and OPL3 offers 4 more, which we designate here as 8-11.
+	//
+	// The operators are computed in order, with the inputs pulled from
+	// an array of values (opout) that is populated as we go:
+	//    0 = 0
+	//    1 = O1
+	//    2 = O2
+	//    3 = O3
+	//    4 = (O4)
+	//    5 = O1+O2
+	//    6 = O1+O3
+	//    7 = O2+O3
+	//
+	// The s_algorithm_ops table describes the inputs and outputs of each
+	// algorithm as follows:
+	//
+	//      ---------x use opout[x] as operator 2 input
+	//      ------xxx- use opout[x] as operator 3 input
+	//      ---xxx---- use opout[x] as operator 4 input
+	//      --x------- include opout[1] in final sum
+	//      -x-------- include opout[2] in final sum
+	//      x--------- include opout[3] in final sum
+	#define ALGORITHM(op2in, op3in, op4in, op1out, op2out, op3out) \
+		((op2in) | ((op3in) << 1) | ((op4in) << 4) | ((op1out) << 7) | ((op2out) << 8) | ((op3out) << 9))
+	static uint16_t const s_algorithm_ops[8+4] =
+	{
+		ALGORITHM(1,2,3, 0,0,0),    //  0: O1 -> O2 -> O3 -> O4 -> out (O4)
+		ALGORITHM(0,5,3, 0,0,0),    //  1: (O1 + O2) -> O3 -> O4 -> out (O4)
+		ALGORITHM(0,2,6, 0,0,0),    //  2: (O1 + (O2 -> O3)) -> O4 -> out (O4)
+		ALGORITHM(1,0,7, 0,0,0),    //  3: ((O1 -> O2) + O3) -> O4 -> out (O4)
+		ALGORITHM(1,0,3, 0,1,0),    //  4: ((O1 -> O2) + (O3 -> O4)) -> out (O2+O4)
+		ALGORITHM(1,1,1, 0,1,1),    //  5: ((O1 -> O2) + (O1 -> O3) + (O1 -> O4)) -> out (O2+O3+O4)
+		ALGORITHM(1,0,0, 0,1,1),    //  6: ((O1 -> O2) + O3 + O4) -> out (O2+O3+O4)
+		ALGORITHM(0,0,0, 1,1,1),    //  7: (O1 + O2 + O3 + O4) -> out (O1+O2+O3+O4)
+		ALGORITHM(1,2,3, 0,0,0),    //  8: O1 -> O2 -> O3 -> O4 -> out (O4)         [same as 0]
+		ALGORITHM(0,2,3, 1,0,0),    //  9: (O1 + (O2 -> O3 -> O4)) -> out (O1+O4)   [unique]
+		ALGORITHM(1,0,3, 0,1,0),    // 10: ((O1 -> O2) + (O3 -> O4)) -> out (O2+O4) [same as 4]
+		ALGORITHM(0,2,0, 1,0,1)     // 11: (O1 + (O2 -> O3) + O4) -> out (O1+O3+O4) [unique]
+	};
+	#undef ALGORITHM
+	return s_algorithm_ops[algorithm];
+}
+
+
+//-------------------------------------------------
+//  clock_block - clock a block of samples and
+//  accumulate their output; the operators are
+//  clocked over the whole block first, and then
+//  each stage of the algorithm is computed for
+//  every sample before moving on to the next,
+//  which matches clock() + output_2op/4op()
+//  exactly, as nothing in between depends on
+//  the output except operator 1's feedback
+//-------------------------------------------------
+
+template<class RegisterType>
+void fm_channel<RegisterType>::clock_block(uint32_t samples, uint32_t const *env_counter, int32_t const *lfo_raw_pm, uint32_t const *am_offset, output_data *output, uint32_t rshift, int32_t clipmax)
+{
+	assert(samples <= BLOCK_SAMPLES);
+
+	// without output, the feedback never changes, so just clock
+	if (output == nullptr)
+	{
+		for (uint32_t samp = 0; samp < samples; samp++)
+			clock(env_counter[samp], lfo_raw_pm[samp]);
+		return;
+	}
+
+	// the first 2 operators should be populated
+	assert(m_op[0] != nullptr);
+	assert(m_op[1] != nullptr);
+
+	// clock each operator over the block, capturing what each sample sees
+	bool const fourop = is4op();
+	uint32_t phase[4][BLOCK_SAMPLES];
+	uint16_t envelope[4][BLOCK_SAMPLES];
+	for (uint32_t opnum = 0; opnum < (fourop ? 4 : 2); opnum++)
+		m_op[opnum]->clock_block(samples, env_counter, lfo_raw_pm, am_offset, phase[opnum], envelope[opnum]);
+
+	// operator 1 has optional self-feedback, so it goes a sample at a time; the
+	// history is laid out so that sample N reads feedback[N] and feedback[N+1] and
+	// writes feedback[N+2], which is also the value reported as operator 1
+	int16_t feedback[BLOCK_SAMPLES + 2];
+	feedback[0] = m_feedback[1];
+	feedback[1] = m_feedback_in;
+	uint32_t fbshift = m_regs.ch_feedback(m_choffs);
+	for (uint32_t samp = 0; samp < samples; samp++)
+	{
+		int32_t opmod = 0;
+		if (fbshift != 0)
+			opmod = (feedback[samp] + feedback[samp + 1]) >> (10 - fbshift);
+		feedback[samp + 2] = m_op[0]->compute_block_volume(phase[0][samp] + opmod, envelope[0][samp]);
+	}
+	m_feedback[0] = feedback[samples - 1];
+	m_feedback[1] = feedback[samples];
+	m_feedback_in = feedback[samples + 1];
+
+	// skip the rest if all volumes are clear
+	if (m_regs.ch_output_any(m_choffs) == 0)
+		return;
+
+	// some OPL chips use the previous sample for modulation instead of the
+	// current sample; that is the history entry before the current one
+	int16_t const *op1value = &feedback[2];
+	int16_t const *modulator = RegisterType::MODULATOR_DELAY ? &feedback[1] : op1value;
+	int32_t result[BLOCK_SAMPLES];
+	int32_t clipmin = -clipmax - 1;
+
+	if (!fourop)
+	{
+		// Algorithms for two-operator case:
+		//    0: O1 -> O2 -> out
+		//    1: (O1 + O2) -> out
+		if (bitfield(m_regs.ch_algorithm(m_choffs), 0) == 0)
+		{
+			for (uint32_t samp = 0; samp < samples; samp++)
+				result[samp] = m_op[1]->compute_block_volume(phase[1][samp] + (modulator[samp] >> 1), envelope[1][samp]) >> rshift;
+		}
+		else
+		{
+			for (uint32_t samp = 0; samp < samples; samp++)
+			{
+				int32_t value = (modulator[samp] >> rshift) + (m_op[1]->compute_block_volume(phase[1][samp], envelope[1][samp]) >> rshift);
+				result[samp] = clamp(value, clipmin, clipmax);
+			}
+		}
+	}
+	else
+	{
+		// populate the opout table a stage at a time, as in output_4op
+		uint32_t algorithm_ops = algorithm_connections(m_regs.ch_algorithm(m_choffs));
+		int16_t opzero[BLOCK_SAMPLES] = { 0 };
+		int16_t opvalue[5][BLOCK_SAMPLES];
+		int16_t const *opout[8] = { opzero, op1value, opvalue[0], opvalue[1], nullptr, opvalue[2], opvalue[3], opvalue[4] };
+
+		// compute the 14-bit volume/value of operator 2
+		int16_t const *opin = opout[bitfield(algorithm_ops, 0, 1)];
+		for (uint32_t samp = 0; samp < samples; samp++)
+		{
+			opvalue[0][samp] = m_op[1]->compute_block_volume(phase[1][samp] + (opin[samp] >> 1), envelope[1][samp]);
+			opvalue[2][samp] = op1value[samp] + opvalue[0][samp];
+		}
+
+		// compute the 14-bit volume/value of operator 3
+		opin = opout[bitfield(algorithm_ops, 1, 3)];
+		for (uint32_t samp = 0; samp < samples; samp++)
+		{
+			opvalue[1][samp] = m_op[2]->compute_block_volume(phase[2][samp] + (opin[samp] >> 1), envelope[2][samp]);
+			opvalue[3][samp] = op1value[samp] + opvalue[1][samp];
+			opvalue[4][samp] = opvalue[0][samp] + opvalue[1][samp];
+		}
+
+		// compute the 14-bit volume/value of operator 4; the OPM noise channel
+		// never comes through here
+		opin = opout[bitfield(algorithm_ops, 4, 3)];
+		for (uint32_t samp = 0; samp < samples; samp++)
+			result[samp] = m_op[3]->compute_block_volume(phase[3][samp] + (opin[samp] >> 1), envelope[3][samp]) >> rshift;
+
+		// optionally add OP1, OP2, OP3
+		for (uint32_t opnum = 1; opnum <= 3; opnum++)
+			if (bitfield(algorithm_ops, 6 + opnum) != 0)
+				for (uint32_t samp = 0; samp < samples; samp++)
+					result[samp] = clamp(result[samp] + (opout[opnum][samp] >> rshift), clipmin, clipmax);
+	}
+
+	// add to the output
+	add_to_output(m_choffs, output, result, samples);
+}
+
+
 //-------------------------------------------------
 //  output_2op - combine 4 operators according to
 //  the specified algorithm, returning a sum
@@ -991,47 +1222,8 @@ void fm_channel<RegisterType>::output_4op(output_data &output, uint32_t rshift,
 	if (m_regs.ch_output_any(m_choffs) == 0)
 		return;
 
-	// OPM/OPN offer 8 different connection algorithms for 4 operators,
-	// and OPL3 offers 4 more, which we designate here as 8-11.
-	//
-	// The operators are computed in order, with the inputs pulled from
-	// an array of values (opout) that is populated as we go:
-	//    0 = 0
-	//    1 = O1
-	//    2 = O2
-	//    3 = O3
-	//    4 = (O4)
-	//    5 = O1+O2
-	//    6 = O1+O3
-	//    7 = O2+O3
-	//
-	// The s_algorithm_ops table describes the inputs and outputs of each
-	// algorithm as follows:
-	//
-	//      ---------x use opout[x] as operator 2 input
-	//      ------xxx- use opout[x] as operator 3 input
-	//      ---xxx---- use opout[x] as operator 4 input
-	//      --x------- include opout[1] in final sum
-	//      -x-------- include opout[2] in final sum
-	//      x--------- include opout[3] in final sum
-	#define ALGORITHM(op2in, op3in, op4in, op1out, op2out, op3out) \
-		((op2in) | ((op3in) << 1) | ((op4in) << 4) | ((op1out) << 7) | ((op2out) << 8) | ((op3out) << 9))
-	static uint16_t const s_algorithm_ops[8+4] =
-	{
-		ALGORITHM(1,2,3, 0,0,0),    //  0: O1 -> O2 -> O3 -> O4 -> out (O4)
-		ALGORITHM(0,5,3, 0,0,0),    //  1: (O1 + O2) -> O3 -> O4 -> out (O4)
-		ALGORITHM(0,2,6, 0,0,0),    //  2: (O1 + (O2 -> O3)) -> O4 -> out (O4)
-		ALGORITHM(1,0,7, 0,0,0),    //  3: ((O1 -> O2) + O3) -> O4 -> out (O4)
-		ALGORITHM(1,0,3, 0,1,0),    //  4: ((O1 -> O2) + (O3 -> O4)) -> out (O2+O4)
-		ALGORITHM(1,1,1, 0,1,1),    //  5: ((O1 -> O2) + (O1 -> O3) + (O1 -> O4)) -> out (O2+O3+O4)
-		ALGORITHM(1,0,0, 0,1,1),    //  6: ((O1 -> O2) + O3 + O4) -> out (O2+O3+O4)
-		ALGORITHM(0,0,0, 1,1,1),    //  7: (O1 + O2 + O3 + O4) -> out (O1+O2+O3+O4)
-		ALGORITHM(1,2,3, 0,0,0),    //  8: O1 -> O2 -> O3 -> O4 -> out (O4)         [same as 0]
-		ALGORITHM(0,2,3, 1,0,0),    //  9: (O1 + (O2 -> O3 -> O4)) -> out (O1+O4)   [unique]
-		ALGORITHM(1,0,3, 0,1,0),    // 10: ((O1 -> O2) + (O3 -> O4)) -> out (O2+O4) [same as 4]
-		ALGORITHM(0,2,0, 1,0,1)     // 11: (O1 + (O2 -> O3) + O4) -> out (O1+O3+O4) [unique]
-	};
-	uint32_t algorithm_ops = s_algorithm_ops[m_regs.ch_algorithm(m_choffs)];
+	// look up the connections for the current algorithm
+	uint32_t algorithm_ops = algorithm_connections(m_regs.ch_algorithm(m_choffs));
 
 	// populate the opout table
 	int16_t opout[8];
@@ -1278,6 +1470,27 @@ void fm_engine_base<RegisterType>::save_restore(ymfm_saved_state &state)
 
 template<class RegisterType>
 uint32_t fm_engine_base<RegisterType>::clock(uint32_t chanmask)
+{
+	// clock the shared state
+	int32_t lfo_raw_pm = clock_globals(chanmask);
+
+	// now update the state of all the channels and operators
+	for (uint32_t chnum = 0; chnum < CHANNELS; chnum++)
+		if (bitfield(chanmask, chnum))
+			m_channel[chnum]->clock(m_env_counter, lfo_raw_pm);
+
+	// return the envelope counter as it is used to clock ADPCM-A
+	return m_env_counter;
+}
+
+
+//-------------------------------------------------
+//  clock_globals - clock everything that is
+//  shared between the channels forward one step
+//-------------------------------------------------
+
+template<class RegisterType>
+int32_t fm_engine_base<RegisterType>::clock_globals(uint32_t chanmask)
 {
 	// update the clock counter
 	m_total_clocks++;
@@ -1309,15 +1522,53 @@ uint32_t fm_engine_base<RegisterType>::clock(uint32_t chanmask)
 		m_env_counter += 4 - RegisterType::EG_CLOCK_DIVIDER;
 
 	// clock the noise generator
-	int32_t lfo_raw_pm = m_regs.clock_noise_and_lfo();
+	return m_regs.clock_noise_and_lfo();
+}
 
-	// now update the state of all the channels and operators
+
+//-------------------------------------------------
+//  generate_block - clock and output a block of
+//  samples a channel at a time
+//-------------------------------------------------
+
+template<class RegisterType>
+uint32_t fm_engine_base<RegisterType>::generate_block(output_data *const *chanout, uint32_t numsamples, uint32_t rshift, int32_t clipmax, uint32_t chanmask)
+{
+	numsamples = std::min(numsamples, BLOCK_SAMPLES);
+
+	// rhythm mode and the OPM noise channel read state across channels, so
+	// fall back to a sample at a time (as does the wavfile debugging)
+	if (YMFM_DEBUG_LOG_WAVFILES || m_regs.rhythm_enable() || m_regs.noise_enable())
+	{
+		for (uint32_t samp = 0; samp < numsamples; samp++)
+		{
+			m_block_env_counter[samp] = clock(chanmask);
+			for (uint32_t chnum = 0; chnum < CHANNELS; chnum++)
+				if (chanout[chnum] != nullptr)
+					output(chanout[chnum][samp], rshift, clipmax, chanmask & (1 << chnum));
+		}
+		return numsamples;
+	}
+
+	// clock the shared state over the block, capturing what each sample sees;
+	// register writes only happen between blocks, so a prepare can only be due
+	// mid-block from the periodic sweep, and the block stops short of it
+	uint32_t samples = 0;
+	for ( ; samples < numsamples && (samples == 0 || m_prepare_count < 4096); samples++)
+	{
+		m_block_lfo_pm[samples] = clock_globals(chanmask);
+		m_block_env_counter[samples] = m_env_counter;
+		for (uint32_t chnum = 0; chnum < CHANNELS; chnum++)
+			if (bitfield(chanmask, chnum))
+				m_block_am[chnum][samples] = m_regs.lfo_am_offset(m_channel[chnum]->choffs());
+	}
+
+	// the channels are independent, so run each over the whole block
+	uint32_t outmask = chanmask & debug::GLOBAL_FM_CHANNEL_MASK & m_active_channels;
 	for (uint32_t chnum = 0; chnum < CHANNELS; chnum++)
 		if (bitfield(chanmask, chnum))
-			m_channel[chnum]->clock(m_env_counter, lfo_raw_pm);
-
-	// return the envelope counter as it is used to clock ADPCM-A
-	return m_env_counter;
+			m_channel[chnum]->clock_block(samples, m_block_env_counter, m_block_lfo_pm, m_block_am[chnum], bitfield(outmask, chnum) ? chanout[chnum] : nullptr, rshift, clipmax);
+	return samples;
 }
 
 
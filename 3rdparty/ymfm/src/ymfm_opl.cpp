@@ -1401,16 +1401,21 @@ void ymf262::write(uint32_t offset, uint8_t data)
 
 void ymf262::generate(output_data *output, uint32_t numsamples)
 {
-	for (uint32_t samp = 0; samp < numsamples; samp++, output++)
+	output_data *chanout[fm_engine::CHANNELS];
+	while (numsamples != 0)
 	{
-		// clock the system
-		m_fm.clock(fm_engine::ALL_CHANNELS);
-
-		// update the FM content; mixing details for YMF262 need verification
-		m_fm.output(output->clear(), 0, 32767, fm_engine::ALL_CHANNELS);
+		// update the FM content a block at a time; mixing details for YMF262 need verification
+		uint32_t count = std::min(numsamples, fm_engine::BLOCK_SAMPLES);
+		for (uint32_t samp = 0; samp < count; samp++)
+			output[samp].clear();
+		for (uint32_t chnum = 0; chnum < fm_engine::CHANNELS; chnum++)
+			chanout[chnum] = output;
+		count = m_fm.generate_block(chanout, count, 0, 32767, fm_engine::ALL_CHANNELS);
 
 		// YMF262 output is 16-bit offset serial via YAC512 DAC
-		output->clamp16();
+		for (uint32_t samp = 0; samp < count; samp++, output++)
+			output->clamp16();
+		numsamples -= count;
 	}
 }
 
@@ -2208,6 +2213,8 @@ uint8_t const ds1001::s_default_instruments[] =
 //  EXPLICIT INSTANTIATION
 //*********************************************************
 
+template class opl_registers_base<3>;
+template class fm_engine_base<opl_registers_base<3>>;
 template class opl_registers_base<4>;
 template class fm_engine_base<opl_registers_base<4>>;
 
@@ -2112,11 +2112,27 @@ void ym2610::write(uint32_t offset, uint8_t data)
 
 void ym2610::generate(output_data *output, uint32_t numsamples)
 {
-	// FM output is just repeated the prescale number of times
+	// FM output is just repeated the prescale number of times; the FM and
+	// ADPCM samples are generated a block at a time as they are needed
+	fm_engine::output_data fmblock[fm_engine::BLOCK_SAMPLES];
+	uint32_t fmcount = 0, fmindex = 0;
+	uint32_t sampindex = m_ssg_resampler.sampindex();
 	for (uint32_t samp = 0; samp < numsamples; samp++, output++)
 	{
-		if ((m_ssg_resampler.sampindex() + samp) % m_fm_samples_per_output == 0)
-			clock_fm_and_adpcm();
+		if ((sampindex + samp) % m_fm_samples_per_output == 0)
+		{
+			if (fmindex == fmcount)
+			{
+				// generate exactly as many as this call still needs, up to a block
+				uint32_t needed = 0;
+				for (uint32_t next = samp; next < numsamples && needed < fm_engine::BLOCK_SAMPLES; next++)
+					if ((sampindex + next) % m_fm_samples_per_output == 0)
+						needed++;
+				fmcount = clock_fm_and_adpcm(fmblock, needed);
+				fmindex = 0;
+			}
+			m_last_fm = fmblock[fmindex++];
+		}
 		output->data[0] = m_last_fm.data[0];
 		output->data[1] = m_last_fm.data[1];
 	}
@@ -2160,33 +2176,41 @@ void ym2610::update_prescale()
 
 //-------------------------------------------------
 //  clock_fm_and_adpcm - clock FM and ADPCM state
+//  over up to a block of samples, returning how
+//  many were produced
 //-------------------------------------------------
 
-void ym2610::clock_fm_and_adpcm()
+uint32_t ym2610::clock_fm_and_adpcm(fm_engine::output_data *output, uint32_t numsamples)
 {
-	// clock the system
-	uint32_t env_counter = m_fm.clock(m_fm_mask);
+	// generate the FM content; OPNB is 13-bit with no intermediate clipping
+	fm_engine::output_data *chanout[fm_engine::CHANNELS];
+	for (uint32_t chnum = 0; chnum < fm_engine::CHANNELS; chnum++)
+		chanout[chnum] = output;
+	for (uint32_t samp = 0; samp < numsamples; samp++)
+		output[samp].clear();
+	numsamples = m_fm.generate_block(chanout, numsamples, 1, 32767, m_fm_mask);
 
-	// clock the ADPCM-A engine on every envelope cycle
-	if (bitfield(env_counter, 0, 2) == 0)
-		m_eos_status |= m_adpcm_a.clock(0x3f);
-
-	// clock the ADPCM-B engine every cycle
-	m_adpcm_b.clock();
+	for (uint32_t samp = 0; samp < numsamples; samp++)
+	{
+		// clock the ADPCM-A engine on every envelope cycle
+		if (bitfield(m_fm.block_env_counter(samp), 0, 2) == 0)
+			m_eos_status |= m_adpcm_a.clock(0x3f);
 
-	// we track the last ADPCM-B EOS value in bit 6 (which is hidden from callers);
-	// if it changed since the last sample, update the visible EOS state in bit 7
-	uint8_t live_eos = ((m_adpcm_b.status() & adpcm_b_channel::STATUS_EOS) != 0) ? 0x40 : 0x00;
-	if (((live_eos ^ m_eos_status) & 0x40) != 0)
-		m_eos_status = (m_eos_status & ~0xc0) | live_eos | (live_eos << 1);
+		// clock the ADPCM-B engine every cycle
+		m_adpcm_b.clock();
 
-	// update the FM content; OPNB is 13-bit with no intermediate clipping
-	m_fm.output(m_last_fm.clear(), 1, 32767, m_fm_mask);
+		// we track the last ADPCM-B EOS value in bit 6 (which is hidden from callers);
+		// if it changed since the last sample, update the visible EOS state in bit 7
+		uint8_t live_eos = ((m_adpcm_b.status() & adpcm_b_channel::STATUS_EOS) != 0) ? 0x40 : 0x00;
+		if (((live_eos ^ m_eos_status) & 0x40) != 0)
+			m_eos_status = (m_eos_status & ~0xc0) | live_eos | (live_eos << 1);
 
-	// mix in the ADPCM and clamp
-	m_adpcm_a.output(m_last_fm, 0x3f);
-	m_adpcm_b.output(m_last_fm, 1);
-	m_last_fm.clamp16();
+		// mix in the ADPCM and clamp
+		m_adpcm_a.output(output[samp], 0x3f);
+		m_adpcm_b.output(output[samp], 1);
+		output[samp].clamp16();
+	}
+	return numsamples;
 }
 
 
@@ -2382,39 +2406,50 @@ void ym2612::write(uint32_t offset, uint8_t data)
 
 void ym2612::generate(output_data *output, uint32_t numsamples)
 {
-	for (uint32_t samp = 0; samp < numsamples; samp++, output++)
-	{
-		// clock the system
-		m_fm.clock(fm_engine::ALL_CHANNELS);
-
-		// sum individual channels to apply DAC discontinuity on each
-		output->clear();
-		output_data temp;
+	// individual channel outputs for a block, to apply DAC discontinuity on each
+	output_data chanblock[fm_engine::CHANNELS][fm_engine::BLOCK_SAMPLES];
+	output_data *chanout[fm_engine::CHANNELS] = { nullptr };
 
+	while (numsamples != 0)
+	{
 		// first do FM-only channels; OPN2 is 9-bit with intermediate clipping
 		int const last_fm_channel = m_dac_enable ? 5 : 6;
+		uint32_t count = std::min(numsamples, fm_engine::BLOCK_SAMPLES);
 		for (int chan = 0; chan < last_fm_channel; chan++)
 		{
-			m_fm.output(temp.clear(), 5, 256, 1 << chan);
-			output->data[0] += dac_discontinuity(temp.data[0]);
-			output->data[1] += dac_discontinuity(temp.data[1]);
+			chanout[chan] = chanblock[chan];
+			for (uint32_t samp = 0; samp < count; samp++)
+				chanblock[chan][samp].clear();
 		}
+		count = m_fm.generate_block(chanout, count, 5, 256, fm_engine::ALL_CHANNELS);
 
-		// add in DAC
-		if (m_dac_enable)
+		for (uint32_t samp = 0; samp < count; samp++, output++)
 		{
-			// DAC enabled: start with DAC value then add the first 5 channels only
-			int32_t dacval = dac_discontinuity(int16_t(m_dac_data << 7) >> 7);
-			output->data[0] += m_fm.regs().ch_output_0(0x102) ? dacval : dac_discontinuity(0);
-			output->data[1] += m_fm.regs().ch_output_1(0x102) ? dacval : dac_discontinuity(0);
-		}
+			// sum individual channels
+			output->clear();
+			for (int chan = 0; chan < last_fm_channel; chan++)
+			{
+				output->data[0] += dac_discontinuity(chanblock[chan][samp].data[0]);
+				output->data[1] += dac_discontinuity(chanblock[chan][samp].data[1]);
+			}
+
+			// add in DAC
+			if (m_dac_enable)
+			{
+				// DAC enabled: start with DAC value then add the first 5 channels only
+				int32_t dacval = dac_discontinuity(int16_t(m_dac_data << 7) >> 7);
+				output->data[0] += m_fm.regs().ch_output_0(0x102) ? dacval : dac_discontinuity(0);
+				output->data[1] += m_fm.regs().ch_output_1(0x102) ? dacval : dac_discontinuity(0);
+			}
 
-		// output is technically multiplexed rather than mixed, but that requires
-		// a better sound mixer than we usually have, so just average over the six
-		// channels; also apply a 64/65 factor to account for the discontinuity
-		// adjustment above
-		output->data[0] = (output->data[0] * 128) * 64 / (6 * 65);
-		output->data[1] = (output->data[1] * 128) * 64 / (6 * 65);
+			// output is technically multiplexed rather than mixed, but that requires
+			// a better sound mixer than we usually have, so just average over the six
+			// channels; also apply a 64/65 factor to account for the discontinuity
+			// adjustment above
+			output->data[0] = (output->data[0] * 128) * 64 / (6 * 65);
+			output->data[1] = (output->data[1] * 128) * 64 / (6 * 65);
+		}
+		numsamples -= count;
 	}
 }
 
@@ -2485,4 +2520,13 @@ void ymf276::generate(output_data *output, uint32_t numsamples)
 	}
 }
 
+
+
+//*********************************************************
+//  EXPLICIT INSTANTIATION
+//*********************************************************
+
+template class opn_registers_base<true>;
+template class fm_engine_base<opn_registers_base<true>>;
+
 }
@@ -700,7 +700,7 @@ public:
 protected:
 	// internal helpers
 	void update_prescale();
-	void clock_fm_and_adpcm();
+	uint32_t clock_fm_and_adpcm(fm_engine::output_data *output, uint32_t numsamples);
 
 	// internal state
 	opn_fidelity m_fidelity;            // configured fidelity
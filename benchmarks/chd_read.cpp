@@ -0,0 +1,95 @@
+#include "benchmark/benchmark_api.h"
+#include "chd.h"
+#include "ioprocsvec.h"
+
+#include <memory>
+#include <random>
+#include <vector>
+
+// 16MB image in 16KB hunks with the codecs chdman uses for hard disks
+static constexpr uint32_t bm_chd_hunk_bytes = 16384;
+static constexpr uint32_t bm_chd_sector_bytes = 2048;
+static constexpr uint64_t bm_chd_logical_bytes = 16 * 1024 * 1024;
+
+// compresses a buffer of somewhat compressible data, like a typical disk image
+class bm_chd_compressor : public chd_file_compressor
+{
+public:
+	bm_chd_compressor(std::vector<uint8_t> const &data) : m_data(data) { }
+
+protected:
+	virtual uint32_t read_data(void *dest, uint64_t offset, uint32_t length) override
+	{
+		memcpy(dest, &m_data[offset], length);
+		return length;
+	}
+
+private:
+	std::vector<uint8_t> const &m_data;
+};
+
+static std::vector<uint8_t> const &bm_chd_image()
+{
+	static std::vector<uint8_t> image;
+	if (image.empty())
+	{
+		std::mt19937 rng(4321);
+		std::vector<uint8_t> data(bm_chd_logical_bytes);
+		for (auto &byte : data)
+			byte = "MAME compressed hunks of data "[rng() % 30] ^ ((rng() % 16) ? 0 : uint8_t(rng()));
+
+		bm_chd_compressor chd(data);
+		chd_codec_type const compression[4] = { CHD_CODEC_LZMA, CHD_CODEC_ZLIB, CHD_CODEC_HUFFMAN, CHD_CODEC_FLAC };
+		chd.create(std::make_unique<util::vector_read_write_adapter<uint8_t> >(image), bm_chd_logical_bytes, bm_chd_hunk_bytes, bm_chd_sector_bytes, compression);
+		chd.compress_begin();
+		double progress, ratio;
+		while (chd.compress_continue(progress, ratio) == chd_file::error::COMPRESSING) { }
+		chd.close();
+	}
+	return image;
+}
+
+static void bm_chd_open(chd_file &chd, std::vector<uint8_t> &storage, benchmark::State &state)
+{
+	storage = bm_chd_image();
+	chd.open(std::make_unique<util::vector_read_write_adapter<uint8_t> >(storage));
+	if (state.range(0))
+		chd.set_read_cache(64, state.range(0) - 1);
+}
+
+// streaming a disc sector by sector, like a CD-ROM drive reading a movie or level data;
+// argument is 0 for no caching, or 1 + the number of hunks to prefetch
+static void BM_chd_read_sequential(benchmark::State& state)
+{
+	std::vector<uint8_t> storage;
+	chd_file chd;
+	bm_chd_open(chd, storage, state);
+	uint8_t sector[bm_chd_sector_bytes];
+	uint64_t offset = 0;
+	while (state.KeepRunning())
+	{
+		chd.read_bytes(offset, sector, sizeof(sector));
+		offset = (offset + sizeof(sector)) % bm_chd_logical_bytes;
+	}
+	state.SetBytesProcessed(state.iterations() * sizeof(sector));
+}
+BENCHMARK(BM_chd_read_sequential)->Arg(0)->Arg(1)->Arg(3)->Arg(5)->Arg(9);
+
+// hopping between a few files on the disc, like a game streaming audio while loading
+static void BM_chd_read_interleaved(benchmark::State& state)
+{
+	std::vector<uint8_t> storage;
+	chd_file chd;
+	bm_chd_open(chd, storage, state);
+	uint8_t sector[bm_chd_sector_bytes];
+	uint64_t offset[4] = { 0, bm_chd_logical_bytes / 4, bm_chd_logical_bytes / 2, bm_chd_logical_bytes * 3 / 4 };
+	unsigned stream = 0;
+	while (state.KeepRunning())
+	{
+		chd.read_bytes(offset[stream], sector, sizeof(sector));
+		offset[stream] = (offset[stream] + sizeof(sector)) % bm_chd_logical_bytes;
+		stream = (stream + 1) % 4;
+	}
+	state.SetBytesProcessed(state.iterations() * sizeof(sector));
+}
+BENCHMARK(BM_chd_read_interleaved)->Arg(0)->Arg(1)->Arg(5);
@@ -0,0 +1,100 @@
+#include "benchmark/benchmark_api.h"
+#include "emu.h"
+#include "render.h"
+#include "rendersw.hxx"
+
+#include <random>
+#include <vector>
+
+typedef software_renderer<u32, 0,0,0, 16,8,0, false, true> bm_renderer;
+
+// a frame as the snapshot target produces it for a raster game with artwork: a bezel,
+// the screen scaled into it, a glass overlay, a few vectors and the UI's menu boxes
+class bm_render_frame
+{
+public:
+	bm_render_frame(u32 width, u32 height)
+	{
+		std::mt19937 rng(2468);
+		m_screen.resize(384 * 224);
+		for (auto &pixel : m_screen)
+			pixel = rng() & 0x00ffffff;
+		m_artwork.resize(512 * 512);
+		for (auto &pixel : m_artwork)
+			pixel = ((rng() % 4) ? 0xff000000 : 0x40000000) | (rng() & 0x00ffffff);
+
+		float const w = float(width), h = float(height);
+		add_quad(0.0F, 0.0F, w, h, m_artwork.data(), 512, 512, TEXFORMAT_ARGB32, BLENDMODE_NONE, 1.0F);
+		add_quad(w * 0.125F, h * 0.1F, w * 0.875F, h * 0.9F, m_screen.data(), 384, 224, TEXFORMAT_RGB32, BLENDMODE_NONE, 1.0F);
+		add_quad(w * 0.125F, h * 0.1F, w * 0.875F, h * 0.9F, m_artwork.data(), 512, 512, TEXFORMAT_ARGB32, BLENDMODE_ALPHA, 0.3F);
+		for (int i = 0; i < 64; i++)
+		{
+			render_primitive &prim = add(render_primitive::LINE, rng() % width, rng() % height, rng() % width, rng() % height);
+			prim.flags = PRIMFLAG_BLENDMODE(BLENDMODE_ADD) | PRIMFLAG_ANTIALIAS(1);
+			prim.width = 2.0F;
+		}
+		for (int i = 0; i < 8; i++)
+		{
+			render_primitive &prim = add(render_primitive::QUAD, w * 0.3F, h * (0.2F + i * 0.07F), w * 0.7F, h * (0.25F + i * 0.07F));
+			prim.flags = PRIMFLAG_BLENDMODE(BLENDMODE_ALPHA);
+			prim.color = render_color{ 0.8F, 0.1F, 0.1F, 0.3F };
+		}
+	}
+
+	render_primitive const *first() const { return m_list.first(); }
+
+private:
+	render_primitive &add(render_primitive::primitive_type type, float x0, float y0, float x1, float y1)
+	{
+		render_primitive &prim = m_list.append(*new render_primitive);
+		prim.type = type;
+		prim.bounds = render_bounds{ x0, y0, x1, y1 };
+		prim.color = render_color{ 1.0F, 1.0F, 1.0F, 1.0F };
+		prim.texture = render_texinfo();
+		return prim;
+	}
+
+	void add_quad(float x0, float y0, float x1, float y1, u32 *texture, u32 texwidth, u32 texheight, texture_format format, int blendmode, float alpha)
+	{
+		render_primitive &prim = add(render_primitive::QUAD, x0, y0, x1, y1);
+		prim.flags = PRIMFLAG_TEXFORMAT(format) | PRIMFLAG_BLENDMODE(blendmode);
+		prim.color.a = alpha;
+		prim.texture.base = texture;
+		prim.texture.rowpixels = texwidth;
+		prim.texture.width = texwidth;
+		prim.texture.height = texheight;
+		prim.texcoords = render_quad_texuv{ { 0.0F, 0.0F }, { 1.0F, 0.0F }, { 0.0F, 1.0F }, { 1.0F, 1.0F } };
+	}
+
+	simple_list<render_primitive> m_list;
+	std::vector<u32> m_screen;
+	std::vector<u32> m_artwork;
+};
+
+static u32 const bm_render_sizes[][2] = { { 640, 480 }, { 1920, 1080 }, { 3840, 2160 } };
+
+// rendering the frame on the calling thread
+static void BM_rendersw_serial(benchmark::State& state)
+{
+	u32 const width = bm_render_sizes[state.range(0)][0], height = bm_render_sizes[state.range(0)][1];
+	bm_render_frame frame(width, height);
+	std::vector<u32> bitmap(width * height);
+	while (state.KeepRunning())
+		bm_renderer::draw_primitives(frame.first(), bitmap.data(), width, height, width);
+	state.SetItemsProcessed(state.iterations() * width * height);
+}
+BENCHMARK(BM_rendersw_serial)->Arg(0)->Arg(1)->Arg(2);
+
+// rendering the frame in bands on a work queue; second argument is the number of bands
+static void BM_rendersw_banded(benchmark::State& state)
+{
+	u32 const width = bm_render_sizes[state.range(0)][0], height = bm_render_sizes[state.range(0)][1];
+	bm_render_frame frame(width, height);
+	std::vector<u32> bitmap(width * height);
+	osd_work_queue *const queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_MULTI);
+	while (state.KeepRunning())
+		bm_renderer::draw_primitives(frame.first(), bitmap.data(), width, height, width, queue, state.range(1));
+	osd_work_queue_free(queue);
+	state.SetItemsProcessed(state.iterations() * width * height);
+}
+BENCHMARK(BM_rendersw_banded)->Args({ 0, 8 })->Args({ 1, 8 })->Args({ 2, 8 })->Args({ 2, 32 });
@@ -0,0 +1,99 @@
+#include "benchmark/benchmark_api.h"
+#include "emu.h"
+#include "resampler.h"
+
+#include <cmath>
+#include <vector>
+
+// one 50Hz update's worth of output at 48kHz, from a source at the argument's rate
+static constexpr u32 OUTPUT_RATE = 48000;
+static constexpr u32 OUTPUT_SAMPLES = OUTPUT_RATE / 50;
+
+static std::vector<float> bm_resampler_input(u32 rate)
+{
+	std::vector<float> input(u64(OUTPUT_SAMPLES + 1) * rate / OUTPUT_RATE + 2048);
+	for (u32 index = 0; index < input.size(); index++)
+		input[index] = float(0.5 * std::sin(2.0 * M_PI * 1000.0 * index / rate));
+	return input;
+}
+
+// the inner loops of default_resampler_stream::resampler_sound_update
+static void BM_resampler_default(benchmark::State& state)
+{
+	u32 const rate = state.range(0);
+	std::vector<float> const input = bm_resampler_input(rate);
+	std::vector<float> output(OUTPUT_SAMPLES);
+	float const step = float(rate) / float(OUTPUT_RATE), stepinv = 1.0f / step;
+	while (state.KeepRunning())
+	{
+		float srcpos = 0;
+		u32 srcindex = 0;
+		float cursample = input[srcindex++];
+		if (step < 1.0f)
+		{
+			for (u32 dstindex = 0; dstindex < OUTPUT_SAMPLES; dstindex++)
+			{
+				srcpos += step;
+				if (srcpos <= 1.0f)
+					output[dstindex] = cursample;
+				else
+				{
+					srcpos -= 1.0f;
+					float const prevsample = cursample;
+					cursample = input[srcindex++];
+					output[dstindex] = stepinv * (prevsample * (step - srcpos) + srcpos * cursample);
+				}
+			}
+		}
+		else
+		{
+			for (u32 dstindex = 0; dstindex < OUTPUT_SAMPLES; dstindex++)
+			{
+				float const scale = 1.0f - srcpos;
+				float sample = cursample * scale;
+				float remaining = step - scale;
+				while (remaining >= 1.0f)
+				{
+					sample += input[srcindex++];
+					remaining -= 1.0f;
+				}
+				cursample = input[srcindex++];
+				sample += cursample * remaining;
+				output[dstindex] = sample * stepinv;
+				srcpos = remaining;
+			}
+		}
+		benchmark::DoNotOptimize(output.data());
+	}
+	state.SetItemsProcessed(state.iterations() * OUTPUT_SAMPLES);
+}
+BENCHMARK(BM_resampler_default)->Arg(44100)->Arg(55500)->Arg(1000000);
+
+template <int Quality>
+static void BM_resampler_polyphase(benchmark::State& state)
+{
+	u32 const rate = state.range(0);
+	std::vector<float> const input = bm_resampler_input(rate);
+	std::vector<float> output(OUTPUT_SAMPLES);
+	polyphase_resampler const filter(rate, OUTPUT_RATE, Quality);
+	while (state.KeepRunning())
+	{
+		filter.process(&output[0], OUTPUT_SAMPLES, &input[0], 0);
+		benchmark::DoNotOptimize(output.data());
+	}
+	state.SetItemsProcessed(state.iterations() * OUTPUT_SAMPLES);
+}
+BENCHMARK_TEMPLATE(BM_resampler_polyphase, polyphase_resampler::QUALITY_LOW)->Arg(44100)->Arg(55500)->Arg(1000000);
+BENCHMARK_TEMPLATE(BM_resampler_polyphase, polyphase_resampler::QUALITY_MEDIUM)->Arg(44100)->Arg(55500)->Arg(1000000);
+BENCHMARK_TEMPLATE(BM_resampler_polyphase, polyphase_resampler::QUALITY_HIGH)->Arg(44100)->Arg(55500)->Arg(1000000);
+
+// building the tables, which the sound manager does once per pair of rates
+static void BM_resampler_build(benchmark::State& state)
+{
+	while (state.KeepRunning())
+	{
+		polyphase_resampler const filter(state.range(0), OUTPUT_RATE, polyphase_resampler::QUALITY_MEDIUM);
+		benchmark::DoNotOptimize(filter.taps());
+	}
+}
+BENCHMARK(BM_resampler_build)->Arg(44100)->Arg(1000000);
@@ -0,0 +1,115 @@
+#include "benchmark/benchmark_api.h"
+#include "emu.h"
+#include "tilemap.h"
+
+#include <random>
+#include <vector>
+
+// a synthetic 256x256 tilemap of 8x8 tiles with a 320x224 window onto it; each frame marks
+// some random tiles dirty and then realizes them, the way a game rewriting its video RAM does
+class bm_tilemap
+{
+public:
+	static constexpr u32 COLS = 256, ROWS = 256, TILE = 8;
+	static constexpr u32 VIEW_COLS = 320 / TILE + 1, VIEW_ROWS = 224 / TILE + 1;
+
+	bm_tilemap() : m_flags(COLS * ROWS, 0), m_pixmap(COLS * TILE * ROWS * TILE), m_rng(1234)
+	{
+		m_dirty.resize(COLS * ROWS);
+		for (u32 i = 0; i < TILE * TILE; i++)
+			m_tile[i] = m_rng();
+	}
+
+	void mark(u32 count)
+	{
+		for (u32 i = 0; i < count; i++)
+		{
+			u32 const index = m_rng() % (COLS * ROWS);
+			m_flags[index] = 0xff;
+			m_dirty.set(index);
+		}
+	}
+
+	// decode a tile into the pixmap, as tilemap_t::tile_update does
+	void update(u32 index)
+	{
+		u16 *dest = &m_pixmap[(index / COLS) * TILE * COLS * TILE + (index % COLS) * TILE];
+		for (u32 y = 0; y < TILE; y++, dest += COLS * TILE)
+			for (u32 x = 0; x < TILE; x++)
+				dest[x] = m_tile[y * TILE + x];
+		m_flags[index] = 0;
+		m_dirty.clear(index);
+	}
+
+	// the whole map, scanning a byte per tile as pixmap_update used to
+	void realize_bytes()
+	{
+		for (u32 index = 0; index < COLS * ROWS; index++)
+			if (m_flags[index] == 0xff)
+				update(index);
+	}
+
+	// the whole map, through the dirty bitset
+	void realize_bits()
+	{
+		m_dirty.for_each(0, COLS * ROWS, [this] (u32 index) { update(index); });
+	}
+
+	// just the tiles under a scrolling window, leaving the rest dirty
+	void realize_window(u32 scrollx, u32 scrolly)
+	{
+		for (u32 y = 0; y < VIEW_ROWS; y++)
+		{
+			u32 const row = (scrolly + y) % ROWS, col = scrollx % COLS;
+			u32 const first = std::min(VIEW_COLS, COLS - col);
+			m_dirty.for_each(row * COLS + col, row * COLS + col + first, [this] (u32 index) { update(index); });
+			m_dirty.for_each(row * COLS, row * COLS + VIEW_COLS - first, [this] (u32 index) { update(index); });
+		}
+	}
+
+private:
+	std::vector<u8> m_flags;
+	tilemap_dirty_bits m_dirty;
+	std::vector<u16> m_pixmap;
+	u16 m_tile[TILE * TILE];
+	std::mt19937 m_rng;
+};
+
+// argument is the number of tiles marked dirty per frame
+static void BM_tilemap_realize_bytes(benchmark::State& state)
+{
+	bm_tilemap tilemap;
+	while (state.KeepRunning())
+	{
+		tilemap.mark(state.range(0));
+		tilemap.realize_bytes();
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_tilemap_realize_bytes)->Arg(0)->Arg(16)->Arg(256)->Arg(4096);
+
+static void BM_tilemap_realize_bits(benchmark::State& state)
+{
+	bm_tilemap tilemap;
+	while (state.KeepRunning())
+	{
+		tilemap.mark(state.range(0));
+		tilemap.realize_bits();
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_tilemap_realize_bits)->Arg(0)->Arg(16)->Arg(256)->Arg(4096);
+
+static void BM_tilemap_realize_window(benchmark::State& state)
+{
+	bm_tilemap tilemap;
+	u32 scroll = 0;
+	while (state.KeepRunning())
+	{
+		tilemap.mark(state.range(0));
+		tilemap.realize_window(scroll, scroll / 2);
+		scroll++;
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_tilemap_realize_window)->Arg(0)->Arg(16)->Arg(256)->Arg(4096);
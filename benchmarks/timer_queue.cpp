@@ -0,0 +1,134 @@
+#include "benchmark/benchmark_api.h"
+#include "emucore.h"
+#include "eminline.h"
+#include "attotime.h"
+#include "coretmpl.h"
+
+#include <random>
+#include <vector>
+
+// stand-in for emu_timer carrying just the fields each queue needs
+struct bm_timer
+{
+	bm_timer *next = nullptr;
+	bm_timer *prev = nullptr;
+	std::size_t heap_index = ~std::size_t(0);
+	u64 seq = 0;
+	attotime expire = attotime::never;
+};
+
+// sorted doubly-linked list, as in device_scheduler::timer_list_insert()
+class bm_timer_list
+{
+public:
+	void insert(bm_timer &timer)
+	{
+		bm_timer *prevtimer = nullptr;
+		for (bm_timer *curtimer = m_head; curtimer; prevtimer = curtimer, curtimer = curtimer->next)
+		{
+			if (curtimer->expire > timer.expire)
+			{
+				timer.prev = prevtimer;
+				timer.next = curtimer;
+				if (prevtimer)
+					prevtimer->next = &timer;
+				else
+					m_head = &timer;
+				curtimer->prev = &timer;
+				return;
+			}
+		}
+		if (prevtimer)
+			prevtimer->next = &timer;
+		else
+			m_head = &timer;
+		timer.prev = prevtimer;
+		timer.next = nullptr;
+	}
+
+	void remove(bm_timer &timer)
+	{
+		if (timer.prev)
+			timer.prev->next = timer.next;
+		else
+			m_head = timer.next;
+		if (timer.next)
+			timer.next->prev = timer.prev;
+	}
+
+	bm_timer *first() const { return m_head; }
+
+private:
+	bm_timer *m_head = nullptr;
+};
+
+// binary heap, as used by device_scheduler when built with MAME_TIMER_HEAP
+struct bm_timer_compare
+{
+	bool operator()(const bm_timer &a, const bm_timer &b) const
+	{
+		return (a.expire < b.expire) || ((a.expire == b.expire) && (a.seq < b.seq));
+	}
+};
+
+class bm_timer_heap
+{
+public:
+	void insert(bm_timer &timer) { timer.seq = m_seq++; m_heap.push(timer); }
+	void remove(bm_timer &timer) { m_heap.remove(timer); }
+	bm_timer *first() const { return m_heap.top(); }
+
+private:
+	util::intrusive_heap<bm_timer, bm_timer_compare, &bm_timer::heap_index> m_heap;
+	u64 m_seq = 0;
+};
+
+// periodic timers with a spread of rates firing in order, like sound chips and serial devices
+template <typename Queue>
+static void BM_timer_periodic(benchmark::State& state)
+{
+	std::mt19937 rng(1234);
+	std::vector<bm_timer> timers(state.range(0));
+	std::vector<attotime> periods(timers.size());
+	Queue queue;
+	for (std::size_t i = 0; i < timers.size(); i++)
+	{
+		periods[i] = attotime::from_hz(u32(1000 + (rng() % 2000000)));
+		timers[i].expire = periods[i];
+		queue.insert(timers[i]);
+	}
+	while (state.KeepRunning())
+	{
+		bm_timer &timer = *queue.first();
+		queue.remove(timer);
+		timer.expire += periods[&timer - &timers[0]];
+		queue.insert(timer);
+	}
+}
+BENCHMARK_TEMPLATE(BM_timer_periodic, bm_timer_list)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_TEMPLATE(BM_timer_periodic, bm_timer_heap)->Arg(16)->Arg(256)->Arg(4096);
+
+// arbitrary timers adjusted to random points in the future, like emu_timer::adjust()
+template <typename Queue>
+static void BM_timer_adjust(benchmark::State& state)
+{
+	std::mt19937 rng(5678);
+	std::vector<bm_timer> timers(state.range(0));
+	Queue queue;
+	for (auto &timer : timers)
+	{
+		timer.expire = attotime(0, ATTOSECONDS_IN_USEC(rng() % 1000000));
+		queue.insert(timer);
+	}
+	attotime now = attotime::zero;
+	while (state.KeepRunning())
+	{
+		bm_timer &timer = timers[rng() % timers.size()];
+		queue.remove(timer);
+		now = queue.first()->expire;
+		timer.expire = now + attotime(0, ATTOSECONDS_IN_USEC(rng() % 1000000));
+		queue.insert(timer);
+	}
+}
+BENCHMARK_TEMPLATE(BM_timer_adjust, bm_timer_list)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_TEMPLATE(BM_timer_adjust, bm_timer_heap)->Arg(16)->Arg(256)->Arg(4096);
@@ -0,0 +1,73 @@
+#include "benchmark/benchmark_api.h"
+#include "ymfm_opl.h"
+#include "ymfm_opn.h"
+
+#include <random>
+
+// one 50Hz update's worth of samples at roughly the native rates
+static constexpr uint32_t BM_YMFM_SAMPLES = 1000;
+
+// a chip with every channel playing a random patch
+template<class Chip>
+static void bm_ymfm_generate(benchmark::State& state, void (*setup)(Chip &, std::mt19937 &))
+{
+	ymfm::ymfm_interface intf;
+	Chip chip(intf);
+	chip.reset();
+	std::mt19937 rng(state.range(0));
+	setup(chip, rng);
+	typename Chip::output_data output[BM_YMFM_SAMPLES];
+	while (state.KeepRunning())
+	{
+		chip.generate(output, BM_YMFM_SAMPLES);
+		benchmark::DoNotOptimize(output);
+	}
+	state.SetItemsProcessed(state.iterations() * BM_YMFM_SAMPLES);
+}
+
+static void bm_ymfm_opn_setup(ymfm::ym2612 &chip, std::mt19937 &rng)
+{
+	auto write = [&chip] (uint32_t bank, uint8_t reg, uint8_t data) { chip.write(bank * 2, reg); chip.write(bank * 2 + 1, data); };
+	write(0, 0x22, 0x0b);
+	for (uint32_t bank = 0; bank < 2; bank++)
+	{
+		for (uint8_t reg = 0x30; reg < 0xa0; reg++)
+			write(bank, reg, ((reg & 0xf0) == 0x40) ? (rng() & 0x1f) : ((reg & 0xf0) == 0x90) ? 0 : rng());
+		for (uint8_t chnum = 0; chnum < 3; chnum++)
+		{
+			write(bank, 0xa4 + chnum, 0x20 + (rng() & 0x07));
+			write(bank, 0xa0 + chnum, rng());
+			write(bank, 0xb0 + chnum, rng() & 0x3f);
+			write(bank, 0xb4 + chnum, 0xc0 | (rng() & 0x37));
+		}
+	}
+	for (uint8_t chnum = 0; chnum < 6; chnum++)
+		write(0, 0x28, 0xf0 | (chnum + (chnum >= 3)));
+}
+
+static void bm_ymfm_opl3_setup(ymfm::ymf262 &chip, std::mt19937 &rng)
+{
+	auto write = [&chip] (uint32_t bank, uint8_t reg, uint8_t data) { chip.write(bank * 2, reg); chip.write(bank * 2 + 1, data); };
+	write(1, 0x05, 0x01);
+	write(1, 0x04, 0x09);
+	write(0, 0xbd, 0xc0);
+	for (uint32_t bank = 0; bank < 2; bank++)
+	{
+		for (uint8_t reg = 0x20; reg < 0xa0; reg++)
+			write(bank, reg, ((reg & 0xe0) == 0x40) ? (rng() & 0x1f) : rng());
+		for (uint8_t reg = 0xc0; reg < 0xc9; reg++)
+			write(bank, reg, 0x30 | (rng() & 0x0f));
+		for (uint8_t reg = 0xe0; reg < 0xf6; reg++)
+			write(bank, reg, rng() & 0x07);
+		for (uint8_t chnum = 0; chnum < 9; chnum++)
+		{
+			write(bank, 0xa0 + chnum, rng());
+			write(bank, 0xb0 + chnum, 0x30 | (rng() & 0x07));
+		}
+	}
+}
+
+static void BM_ymfm_ym2612(benchmark::State& state) { bm_ymfm_generate<ymfm::ym2612>(state, bm_ymfm_opn_setup); }
+static void BM_ymfm_ymf262(benchmark::State& state) { bm_ymfm_generate<ymfm::ymf262>(state, bm_ymfm_opl3_setup); }
+BENCHMARK(BM_ymfm_ym2612)->Arg(1)->Arg(2);
+BENCHMARK(BM_ymfm_ymf262)->Arg(1)->Arg(2);
@@ -172,6 +172,7 @@
 #include "debug/debugcpu.h"
 #include "emuopts.h"
 
+#include <algorithm>
 #include <cstddef>
 
 
@@ -264,6 +265,17 @@ static const Gp::Id int_register_map[REG_I_COUNT] =
 #endif
 };
 
+// host registers that can cache CPU state; these are otherwise only used to
+// pass arguments to C functions, and every call ends a run of cached code
+static const Gp::Id cache_register_map[] =
+{
+#ifdef X64_WINDOWS_ABI
+	Gp::kIdR8, Gp::kIdR9, Gp::kIdR10
+#else
+	Gp::kIdSi, Gp::kIdDi, Gp::kIdR8, Gp::kIdR9, Gp::kIdR10
+#endif
+};
+
 static uint32_t float_register_map[REG_F_COUNT] =
 {
 #ifdef X64_WINDOWS_ABI
@@ -425,7 +437,7 @@ public:
 
 drcbe_x64::be_parameter::be_parameter(drcbe_x64 &drcbe, const parameter &param, uint32_t allowed)
 {
-	int regnum;
+	uint32_t regnum;
 
 	switch (param.type())
 	{
@@ -435,10 +447,18 @@ drcbe_x64::be_parameter::be_parameter(drcbe_x64 &drcbe, const parameter &param,
 			*this = param.immediate();
 			break;
 
-		// memory passes through
+		// memory passes through, unless it's currently cached in a register
 		case parameter::PTYPE_MEMORY:
 			assert(allowed & PTYPE_M);
-			*this = make_memory(param.memory());
+			if (drcbe.regcache_lookup(param.memory(), regnum))
+			{
+				assert(allowed & PTYPE_R);
+				*this = make_ireg(regnum);
+			}
+			else
+			{
+				*this = make_memory(param.memory());
+			}
 			break;
 
 		// if a register maps to a register, keep it as a register; otherwise map it to memory
@@ -448,6 +468,8 @@ drcbe_x64::be_parameter::be_parameter(drcbe_x64 &drcbe, const parameter &param,
 			regnum = int_register_map[param.ireg() - REG_I0];
 			if (regnum != 0)
 				*this = make_ireg(regnum);
+			else if (drcbe.regcache_lookup(&drcbe.m_state.r[param.ireg() - REG_I0], regnum))
+				*this = make_ireg(regnum);
 			else
 				*this = make_memory(&drcbe.m_state.r[param.ireg() - REG_I0]);
 			break;
@@ -628,6 +650,8 @@ drcbe_x64::drcbe_x64(drcuml_state &drcuml, device_t &device, drc_cache &cache, u
 	, m_entry(nullptr)
 	, m_exit(nullptr)
 	, m_nocode(nullptr)
+	, m_regcache_enabled(device.machine().options().drc_regalloc())
+	, m_regcache_inum(0)
 	, m_near(*(near_state *)cache.alloc_near(sizeof(m_near)))
 {
 	// build up necessary arrays
@@ -963,11 +987,16 @@ void drcbe_x64::generate(drcuml_block &block, const instruction *instlist, uint3
 
 	// generate code
 	std::string blockname;
+	uint32_t runend = 0;
 	for (int inum = 0; inum < numinst; inum++)
 	{
 		const instruction &inst = instlist[inum];
 		assert(inst.opcode() < std::size(s_opcode_table));
 
+		// decide what to keep in host registers for the next run of straight-line code
+		if (inum == runend)
+			runend = regcache_plan(instlist, inum, numinst);
+
 		// must remain in scope until output
 		std::string dasm;
 
@@ -990,8 +1019,11 @@ void drcbe_x64::generate(drcuml_block &block, const instruction *instlist, uint3
 		}
 
 		// generate code
+		regcache_before(a, inst, inum);
 		(this->*s_opcode_table[inst.opcode()])(a, inst);
+		regcache_after(a, inst, inum);
 	}
+	m_regcache.clear();
 
 	// emit the generated code
 	size_t const bytes = emit(ch);
@@ -1034,6 +1066,258 @@ void drcbe_x64::get_info(drcbe_info &info)
 			break;
 }
 
+
+//-------------------------------------------------
+//  get_regcache_scope - classify how an opcode
+//  interacts with CPU state cached in registers
+//-------------------------------------------------
+
+enum class regcache_scope
+{
+	NORMAL,     // only touches its parameters
+	SYNC,       // may branch out or read arbitrary memory, so memory must be current
+	BOUNDARY    // entry point, call or exit; nothing stays cached across it
+};
+
+static regcache_scope get_regcache_scope(uml::opcode_t opcode)
+{
+	switch (opcode)
+	{
+	case OP_JMP:
+	case OP_LOAD:
+	case OP_LOADS:
+	case OP_FLOAD:
+		return regcache_scope::SYNC;
+
+	case OP_INVALID:
+	case OP_HANDLE:
+	case OP_HASH:
+	case OP_LABEL:
+	case OP_DEBUG:
+	case OP_EXIT:
+	case OP_HASHJMP:
+	case OP_EXH:
+	case OP_CALLH:
+	case OP_RET:
+	case OP_CALLC:
+	case OP_RECOVER:
+	case OP_SAVE:
+	case OP_RESTORE:
+	case OP_STORE:
+	case OP_READ:
+	case OP_READM:
+	case OP_WRITE:
+	case OP_WRITEM:
+	case OP_FSTORE:
+	case OP_FREAD:
+	case OP_FWRITE:
+		return regcache_scope::BOUNDARY;
+
+	default:
+		return regcache_scope::NORMAL;
+	}
+}
+
+
+//-------------------------------------------------
+//  regcache_address - return the memory backing
+//  a parameter, if any
+//-------------------------------------------------
+
+void *drcbe_x64::regcache_address(const parameter &param) const
+{
+	if (param.is_memory())
+		return param.memory();
+	else if (param.is_int_register() && (int_register_map[param.ireg() - REG_I0] == 0))
+		return &m_state.r[param.ireg() - REG_I0];
+	else
+		return nullptr;
+}
+
+
+//-------------------------------------------------
+//  regcache_lookup - find the host register
+//  currently holding a piece of memory
+//-------------------------------------------------
+
+bool drcbe_x64::regcache_lookup(void *base, uint32_t &regnum) const
+{
+	for (cached_memory const &entry : m_regcache)
+	{
+		if ((entry.base == base) && entry.loaded && (entry.first <= m_regcache_inum) && (m_regcache_inum <= entry.last))
+		{
+			regnum = entry.reg;
+			return true;
+		}
+	}
+	return false;
+}
+
+
+//-------------------------------------------------
+//  regcache_plan - choose what to keep in host
+//  registers up to the next boundary, returning
+//  the index of the instruction after the run
+//-------------------------------------------------
+
+uint32_t drcbe_x64::regcache_plan(const instruction *instlist, uint32_t start, uint32_t numinst)
+{
+	m_regcache.clear();
+
+	// boundaries stand alone with memory up to date
+	if (!m_regcache_enabled || (get_regcache_scope(instlist[start].opcode()) == regcache_scope::BOUNDARY))
+		return start + 1;
+
+	// gather every value accessed through memory up to the next boundary
+	std::vector<cached_memory> accessed;
+	uint32_t end = start;
+	for ( ; (end < numinst) && (get_regcache_scope(instlist[end].opcode()) != regcache_scope::BOUNDARY); end++)
+	{
+		const instruction &inst = instlist[end];
+		for (int pnum = 0; pnum < inst.numparams(); pnum++)
+		{
+			void *const base = regcache_address(inst.param(pnum));
+			if (!base)
+				continue;
+
+			// base pointers are addresses rather than values, so just keep them out of registers
+			bool const pointer = (pnum == 1) && ((inst.opcode() == OP_LOAD) || (inst.opcode() == OP_LOADS) || (inst.opcode() == OP_FLOAD));
+			uint8_t const size = pointer ? 1 : inst.param_size(pnum);
+			bool const eligible = !pointer && ((size == 4) || (size == 8)) && inst.param_allowed(pnum, parameter::make_ireg(REG_I0));
+
+			auto const found = std::find_if(accessed.begin(), accessed.end(), [base] (cached_memory const &entry) { return entry.base == base; });
+			if (found == accessed.end())
+			{
+				accessed.push_back(cached_memory{ base, end, end, 1, size, 0, eligible, false, false });
+			}
+			else
+			{
+				found->last = end;
+				found->uses++;
+				found->eligible = found->eligible && eligible && (found->size == size);
+				found->size = std::max(found->size, size);
+			}
+		}
+	}
+
+	// partially overlapping accesses have to go through memory
+	for (cached_memory &entry : accessed)
+	{
+		for (cached_memory const &other : accessed)
+		{
+			if ((&entry != &other) && (uintptr_t(entry.base) < (uintptr_t(other.base) + other.size)) && (uintptr_t(other.base) < (uintptr_t(entry.base) + entry.size)))
+				entry.eligible = false;
+		}
+	}
+
+	// give the most used values a register that's free for their whole lifetime
+	std::stable_sort(accessed.begin(), accessed.end(), [] (cached_memory const &a, cached_memory const &b) { return a.uses > b.uses; });
+	for (cached_memory &entry : accessed)
+	{
+		// a single access gains nothing over using memory directly
+		if (!entry.eligible || (entry.uses < 2))
+			continue;
+
+		for (Gp::Id const reg : cache_register_map)
+		{
+			bool const busy = std::any_of(
+					m_regcache.begin(),
+					m_regcache.end(),
+					[&entry, reg] (cached_memory const &other) { return (other.reg == reg) && (other.first <= entry.last) && (entry.first <= other.last); });
+			if (!busy)
+			{
+				entry.reg = reg;
+				m_regcache.push_back(entry);
+				break;
+			}
+		}
+	}
+	return end;
+}
+
+
+//-------------------------------------------------
+//  regcache_before - write back and load cached
+//  values ahead of an instruction
+//-------------------------------------------------
+
+void drcbe_x64::regcache_before(Assembler &a, const instruction &inst, uint32_t inum)
+{
+	m_regcache_inum = inum;
+
+	// anything that can see memory other than through parameters needs it up to date
+	if (get_regcache_scope(inst.opcode()) == regcache_scope::SYNC)
+	{
+		for (cached_memory &entry : m_regcache)
+		{
+			if (entry.dirty)
+				regcache_spill(a, entry);
+		}
+	}
+
+	// load values on first use, unless they're unconditionally overwritten
+	for (cached_memory &entry : m_regcache)
+	{
+		if (entry.first != inum)
+			continue;
+
+		bool needed = inst.condition() != COND_ALWAYS;
+		for (int pnum = 0; pnum < inst.numparams(); pnum++)
+		{
+			if (inst.param_input(pnum) && (regcache_address(inst.param(pnum)) == entry.base))
+				needed = true;
+		}
+		if (needed)
+		{
+			if (entry.size == 8)
+				a.mov(Gpq(entry.reg), MABS(entry.base));                                // mov   reg,[base]
+			else
+				a.mov(Gpd(entry.reg), MABS(entry.base));                                // mov   reg,[base]
+		}
+		entry.loaded = true;
+	}
+}
+
+
+//-------------------------------------------------
+//  regcache_after - note cached values written
+//  by an instruction, and write back any that
+//  aren't used again
+//-------------------------------------------------
+
+void drcbe_x64::regcache_after(Assembler &a, const instruction &inst, uint32_t inum)
+{
+	for (cached_memory &entry : m_regcache)
+	{
+		if ((entry.first > inum) || (entry.last < inum))
+			continue;
+
+		for (int pnum = 0; pnum < inst.numparams(); pnum++)
+		{
+			if (inst.param_output(pnum) && (regcache_address(inst.param(pnum)) == entry.base))
+				entry.dirty = true;
+		}
+		if ((entry.last == inum) && entry.dirty)
+			regcache_spill(a, entry);
+	}
+}
+
+
+//-------------------------------------------------
+//  regcache_spill - write a cached value back to
+//  memory
+//-------------------------------------------------
+
+void drcbe_x64::regcache_spill(Assembler &a, cached_memory &entry)
+{
+	if (entry.size == 8)
+		a.mov(MABS(entry.base), Gpq(entry.reg));                                        // mov   [base],reg
+	else
+		a.mov(MABS(entry.base), Gpd(entry.reg));                                        // mov   [base],reg
+	entry.dirty = false;
+}
+
+
 void drcbe_x64::alu_op_param(Assembler &a, Inst::Id const opcode, Operand const &dst, be_parameter const &param, std::function<bool(Assembler &a, Operand const &dst, be_parameter const &src)> optimize)
 {
 	bool const is64 = dst.x86RmSize() == 8;
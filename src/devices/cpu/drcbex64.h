@@ -225,6 +225,26 @@ private:
 	void movsd_r128_p64(asmjit::x86::Assembler &a, asmjit::x86::Xmm const &reg, be_parameter const &param);
 	void movsd_p64_r128(asmjit::x86::Assembler &a, be_parameter const &param, asmjit::x86::Xmm const &reg);
 
+	// host register caching of CPU state in straight-line code
+	struct cached_memory
+	{
+		void *              base;                   // address being cached
+		uint32_t            first;                  // first instruction accessing it
+		uint32_t            last;                   // last instruction accessing it
+		uint32_t            uses;                   // number of accesses
+		uint8_t             size;                   // access size in bytes, or 0 if mixed
+		uint8_t             reg;                    // host register holding the value
+		bool                eligible;               // only accessed in ways a register can stand in for
+		bool                loaded;                 // register holds the current value
+		bool                dirty;                  // register is newer than memory
+	};
+	void *regcache_address(const uml::parameter &param) const;
+	bool regcache_lookup(void *base, uint32_t &regnum) const;
+	uint32_t regcache_plan(const uml::instruction *instlist, uint32_t start, uint32_t numinst);
+	void regcache_before(asmjit::x86::Assembler &a, const uml::instruction &inst, uint32_t inum);
+	void regcache_after(asmjit::x86::Assembler &a, const uml::instruction &inst, uint32_t inum);
+	void regcache_spill(asmjit::x86::Assembler &a, cached_memory &entry);
+
 	size_t emit(asmjit::CodeHolder &ch);
 
 	// internal state
@@ -241,6 +261,10 @@ private:
 	x86code *               m_exit;                 // exit point
 	x86code *               m_nocode;               // nocode handler
 
+	bool const              m_regcache_enabled;     // cache CPU state in host registers?
+	uint32_t                m_regcache_inum;        // instruction currently being generated
+	std::vector<cached_memory> m_regcache;          // values cached in the current run of code
+
 	// state to live in the near cache
 	struct near_state
 	{
@@ -49,6 +49,9 @@ public:
 	drccodeptr near() const { return m_near; }
 	drccodeptr base() const { return m_base; }
 	drccodeptr top() const { return m_top; }
+	size_t near_used() const { return m_neartop - m_near; }
+	size_t available() const { return m_limit - m_top; }
+	size_t size() const { return m_size; }
 
 	// pointer checking
 	bool contains_pointer(const void *ptr) const { return ((const drccodeptr)ptr >= m_near && (const drccodeptr)ptr < m_near + m_size); }
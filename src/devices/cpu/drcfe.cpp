@@ -154,6 +154,36 @@ const opcode_desc *drc_frontend::describe_code(offs_t startpc)
 }
 
 
+//-------------------------------------------------
+//  hash_code - compute a 64-bit FNV-1a hash of
+//  the addresses, opcodes and flags of a
+//  described block, including delay slots
+//-------------------------------------------------
+
+u64 drc_frontend::hash_code(opcode_desc const *desclist, u64 seed)
+{
+	u64 hash = 0xcbf29ce484222325U ^ seed;
+	auto const add = [&hash] (u64 value, int bytes)
+	{
+		for (int i = 0; i < bytes; i++, value >>= 8)
+			hash = (hash ^ (value & 0xff)) * 0x100000001b3U;
+	};
+
+	for (opcode_desc const *desc = desclist; desc != nullptr; desc = desc->next())
+	{
+		add(desc->pc, 4);
+		add(desc->physpc, 4);
+		add(desc->length, 1);
+		add(desc->flags, 4);
+		for (int i = 0; i < desc->length && i < std::size(desc->opptr.b); i++)
+			add(desc->opptr.b[i], 1);
+		if (desc->delay.first() != nullptr)
+			hash = hash_code(desc->delay.first(), hash);
+	}
+	return hash;
+}
+
+
 //-------------------------------------------------
 //  describe_one - describe a single instruction,
 //  recursively describing opcodes in delay
@@ -135,6 +135,8 @@ public:
 	opcode_desc const *describe_code(offs_t startpc);
 	// get last opcode of block
 	opcode_desc const *get_last() { return m_desc_live_list.last(); }
+	// fingerprint a described block, for the persistent UML cache
+	static u64 hash_code(opcode_desc const *desclist, u64 seed = 0);
 
 protected:
 	// required overrides
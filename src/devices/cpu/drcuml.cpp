@@ -11,7 +11,7 @@
     Future improvements/changes:
 
     * UML optimizer:
-        - constant folding
+        - track values across labels and jumps
 
     * Write a back-end validator:
         - checks all combinations of memory/register/immediate on all params
@@ -35,13 +35,24 @@
 #include "drcuml.h"
 
 #include "emuopts.h"
+#include "debugger.h"
+#include "fileio.h"
+#include "main.h"
 #include "drcbec.h"
 #ifdef NATIVE_DRC
 #include "drcbex86.h"
 #include "drcbex64.h"
 #endif
 
+#include "debug/debugcon.h"
+
+#include "corestr.h"
+
+#include <algorithm>
 #include <fstream>
+#include <sstream>
+#include <string_view>
+#include <unordered_map>
 
 
 
@@ -83,47 +94,955 @@ struct bevalidate_test
 //**************************************************************************
 
 //-------------------------------------------------
-//  drcbe_interface - constructor
+//  drcbe_interface - constructor
+//-------------------------------------------------
+
+drcbe_interface::drcbe_interface(drcuml_state &drcuml, drc_cache &cache, device_t &device)
+	: m_drcuml(drcuml)
+	, m_cache(cache)
+	, m_device(device)
+	, m_space()
+	, m_state(*reinterpret_cast<drcuml_machine_state *>(cache.alloc_near(sizeof(m_state))))
+	, m_accessors(nullptr)
+{
+	// reset the machine state
+	memset(&m_state, 0, sizeof(m_state));
+
+	// find the spaces and fetch memory accessors
+	device_memory_interface *memory;
+	if (device.interface(memory))
+	{
+		int const count = memory->max_space_count();
+		m_accessors = reinterpret_cast<data_accessors *>(cache.alloc_near(sizeof(*m_accessors) * count));
+		memset(m_accessors, 0, sizeof(*m_accessors) * count);
+		m_space.resize(count, nullptr);
+
+		for (int spacenum = 0; spacenum < count; ++spacenum)
+		{
+			if (memory->has_space(spacenum))
+			{
+				m_space[spacenum] = &memory->space(spacenum);
+				m_space[spacenum]->accessors(m_accessors[spacenum]);
+			}
+		}
+	}
+}
+
+
+//-------------------------------------------------
+//  ~drcbe_interface - destructor
+//-------------------------------------------------
+
+drcbe_interface::~drcbe_interface()
+{
+}
+
+
+
+//**************************************************************************
+//  PERSISTENT BLOCK CACHE
+//**************************************************************************
+
+namespace {
+
+// little-endian serialization helpers
+void put_value(std::vector<u8> &out, u64 value, int bytes)
+{
+	for (int i = 0; i < bytes; i++, value >>= 8)
+		out.push_back(u8(value));
+}
+
+void put_string(std::vector<u8> &out, std::string_view str)
+{
+	put_value(out, str.length(), 4);
+	out.insert(out.end(), str.begin(), str.end());
+}
+
+struct byte_reader
+{
+	u8 const *ptr;
+	u8 const *end;
+	bool ok = true;
+
+	u64 get(int bytes)
+	{
+		if ((end - ptr) < bytes)
+		{
+			ok = false;
+			return 0;
+		}
+		u64 value = 0;
+		for (int i = 0; i < bytes; i++)
+			value |= u64(*ptr++) << (i * 8);
+		return value;
+	}
+
+	std::string get_string()
+	{
+		u32 const length = get(4);
+		if (!ok || (u32(end - ptr) < length))
+		{
+			ok = false;
+			return std::string();
+		}
+		std::string result(reinterpret_cast<char const *>(ptr), length);
+		ptr += length;
+		return result;
+	}
+};
+
+} // anonymous namespace
+
+
+class drcuml_state::persistent_cache
+{
+public:
+	persistent_cache(drcuml_state &drcuml);
+
+	bool replay(u32 mode, u32 pc, u64 hash);
+	void record(u32 mode, u32 pc, u64 hash, uml::instruction const *inst, u32 numinst);
+	void preload(std::function<u64 (u32 mode, u32 pc)> const &hasher);
+
+private:
+	// file header magic and version
+	static constexpr char MAGIC[8] = { 'M', 'A', 'M', 'E', 'D', 'R', 'C', 0 };
+	static constexpr u32 VERSION = 2;
+
+	// how pointer-sized values are stored
+	enum : u8
+	{
+		RELOC_LITERAL = 0,      // value as-is
+		RELOC_NEAR,             // offset into the near cache
+		RELOC_DEVICE,           // the owning device
+		RELOC_SYMBOL,           // symbol name + offset
+		RELOC_SHARE,            // memory share name + offset
+		RELOC_REGION,           // memory region name + offset
+		RELOC_CFUNC,            // name the front end gave the C function
+		RELOC_HANDLE            // index of the code handle
+	};
+
+	struct entry
+	{
+		u64                 hash;       // hash of the source code
+		u32                 numinst;    // number of instructions
+		std::vector<u8>     data;       // serialized instructions
+	};
+
+	static u64 key(u32 mode, u32 pc) { return (u64(mode) << 32) | pc; }
+	static std::string cache_filename(device_t &device);
+
+	void load();
+	void save();
+	void validate();
+	u64 fingerprint() const;
+	bool encode_pointer(std::vector<u8> &out, u64 value) const;
+	bool encode_param(std::vector<u8> &out, uml::parameter const &param);
+	bool decode_param(byte_reader &in, uml::parameter &param);
+	bool decode(entry const &ent);
+
+	drcuml_state &                      m_drcuml;       // owning UML state
+	std::string const                   m_filename;     // cache file name
+	std::unordered_map<u64, entry>      m_entries;      // cached blocks
+	std::vector<uml::instruction>       m_scratch;      // decoded instructions
+	std::vector<uml::code_handle *>     m_handles;      // handles by index
+	u64                                 m_fingerprint;  // layout fingerprint the entries were made with
+	bool                                m_validated;    // checked the fingerprint against this run?
+	bool                                m_preloaded;    // already preloaded blocks?
+	bool                                m_dirty;        // need to rewrite the file?
+};
+
+
+//-------------------------------------------------
+//  persistent_cache - constructor
+//-------------------------------------------------
+
+drcuml_state::persistent_cache::persistent_cache(drcuml_state &drcuml)
+	: m_drcuml(drcuml)
+	, m_filename(cache_filename(drcuml.device()))
+	, m_fingerprint(0)
+	, m_validated(false)
+	, m_preloaded(false)
+	, m_dirty(false)
+{
+	load();
+	drcuml.device().machine().add_notifier(MACHINE_NOTIFY_EXIT, machine_notify_delegate(&persistent_cache::save, this));
+}
+
+
+//-------------------------------------------------
+//  cache_filename - one file per CPU, grouped by
+//  system
+//-------------------------------------------------
+
+std::string drcuml_state::persistent_cache::cache_filename(device_t &device)
+{
+	std::string tag(device.tag() + 1);
+	strreplace(tag, ":", "_");
+	return util::string_format("%s" PATH_SEPARATOR "%s.drc", device.machine().system().name, tag);
+}
+
+
+//-------------------------------------------------
+//  replay - generate code for a cached block if
+//  its source hash matches
+//-------------------------------------------------
+
+bool drcuml_state::persistent_cache::replay(u32 mode, u32 pc, u64 hash)
+{
+	validate();
+
+	auto const found = m_entries.find(key(mode, pc));
+	if ((found == m_entries.end()) || (found->second.hash != hash))
+		return false;
+
+	// drop entries that no longer relocate
+	if (!decode(found->second))
+	{
+		m_entries.erase(found);
+		m_dirty = true;
+		return false;
+	}
+
+	drcuml_block &block(m_drcuml.begin_block(m_scratch.size()));
+	std::copy(m_scratch.begin(), m_scratch.end(), block.m_inst.begin());
+	block.m_nextinst = m_scratch.size();
+	block.m_replay = true;
+	block.end();
+	return true;
+}
+
+
+//-------------------------------------------------
+//  record - serialize a finalized block
+//-------------------------------------------------
+
+void drcuml_state::persistent_cache::record(u32 mode, u32 pc, u64 hash, uml::instruction const *inst, u32 numinst)
+{
+	validate();
+
+	entry ent{ hash, 0, std::vector<u8>() };
+	for (u32 instnum = 0; instnum < numinst; instnum++)
+	{
+		// comments only matter for logging
+		uml::instruction const &cur(inst[instnum]);
+		if (cur.opcode() == uml::OP_COMMENT)
+			continue;
+
+		put_value(ent.data, cur.opcode(), 1);
+		put_value(ent.data, cur.condition(), 1);
+		put_value(ent.data, cur.flags(), 1);
+		put_value(ent.data, cur.size(), 1);
+		put_value(ent.data, cur.numparams(), 1);
+		for (int pnum = 0; pnum < cur.numparams(); pnum++)
+		{
+			if (!encode_param(ent.data, cur.param(pnum)))
+			{
+				// something we can't find again next time; forget any older copy too
+				m_dirty = m_entries.erase(key(mode, pc)) || m_dirty;
+				return;
+			}
+		}
+		ent.numinst++;
+	}
+
+	m_entries[key(mode, pc)] = std::move(ent);
+	m_dirty = true;
+}
+
+
+//-------------------------------------------------
+//  preload - generate code for every cached
+//  block whose source still matches, leaving
+//  half the cache free
+//-------------------------------------------------
+
+void drcuml_state::persistent_cache::preload(std::function<u64 (u32 mode, u32 pc)> const &hasher)
+{
+	// only once; later flushes happen because the cache filled up
+	if (m_preloaded)
+		return;
+	m_preloaded = true;
+	validate();
+
+	std::vector<u64> keys;
+	keys.reserve(m_entries.size());
+	for (auto const &ent : m_entries)
+		keys.push_back(ent.first);
+	std::sort(keys.begin(), keys.end());
+
+	unsigned count = 0;
+	for (u64 const k : keys)
+	{
+		if (m_drcuml.cache().available() < (m_drcuml.cache().size() / 2))
+			break;
+
+		u32 const mode = u32(k >> 32);
+		u32 const pc = u32(k);
+		auto const found = m_entries.find(k);
+		if ((found != m_entries.end()) && !m_drcuml.hash_exists(mode, pc) && (hasher(mode, pc) == found->second.hash) && replay(mode, pc, found->second.hash))
+			count++;
+	}
+	osd_printf_verbose("%s: preloaded %u of %u cached DRC blocks\n", m_drcuml.device().tag(), count, unsigned(keys.size()));
+}
+
+
+//-------------------------------------------------
+//  load - read the cache file if present
+//-------------------------------------------------
+
+void drcuml_state::persistent_cache::load()
+{
+	emu_file file(m_drcuml.device().machine().options().drc_directory(), OPEN_FLAG_READ);
+	if (file.open(m_filename))
+		return;
+
+	std::vector<u8> buffer(file.size());
+	if (buffer.empty() || (file.read(&buffer[0], buffer.size()) != buffer.size()))
+		return;
+
+	byte_reader in{ &buffer[0], &buffer[0] + buffer.size() };
+	for (char const ch : MAGIC)
+	{
+		if (in.get(1) != u8(ch))
+			return;
+	}
+	if ((in.get(4) != VERSION) || (in.get(4) != sizeof(void *)))
+		return;
+	m_fingerprint = in.get(8);
+
+	u32 const count = in.get(4);
+	for (u32 i = 0; in.ok && (i < count); i++)
+	{
+		u32 const mode = in.get(4);
+		u32 const pc = in.get(4);
+		entry ent;
+		ent.hash = in.get(8);
+		ent.numinst = in.get(4);
+		u32 const length = in.get(4);
+		if (!in.ok || (u32(in.end - in.ptr) < length))
+			break;
+		ent.data.assign(in.ptr, in.ptr + length);
+		in.ptr += length;
+		m_entries.emplace(key(mode, pc), std::move(ent));
+	}
+	osd_printf_verbose("%s: loaded %u cached DRC blocks from %s\n", m_drcuml.device().tag(), unsigned(m_entries.size()), file.fullpath());
+}
+
+
+//-------------------------------------------------
+//  save - write the cache file on exit if it
+//  changed
+//-------------------------------------------------
+
+void drcuml_state::persistent_cache::save()
+{
+	if (!m_dirty)
+		return;
+	validate();
+
+	std::vector<u8> buffer(std::begin(MAGIC), std::end(MAGIC));
+	put_value(buffer, VERSION, 4);
+	put_value(buffer, sizeof(void *), 4);
+	put_value(buffer, m_fingerprint, 8);
+	put_value(buffer, m_entries.size(), 4);
+	for (auto const &ent : m_entries)
+	{
+		put_value(buffer, ent.first >> 32, 4);
+		put_value(buffer, ent.first, 4);
+		put_value(buffer, ent.second.hash, 8);
+		put_value(buffer, ent.second.numinst, 4);
+		put_value(buffer, ent.second.data.size(), 4);
+		buffer.insert(buffer.end(), ent.second.data.begin(), ent.second.data.end());
+	}
+
+	emu_file file(m_drcuml.device().machine().options().drc_directory(), OPEN_FLAG_WRITE | OPEN_FLAG_CREATE | OPEN_FLAG_CREATE_PATHS);
+	if (file.open(m_filename) || (file.write(&buffer[0], buffer.size()) != buffer.size()))
+		osd_printf_error("Error writing DRC cache file %s\n", m_filename);
+	m_dirty = false;
+}
+
+
+//-------------------------------------------------
+//  validate - throw away the loaded entries if
+//  they were made with a different build, cache
+//  layout or debugger setting
+//-------------------------------------------------
+
+void drcuml_state::persistent_cache::validate()
+{
+	if (m_validated)
+		return;
+	m_validated = true;
+
+	u64 const current = fingerprint();
+	if (current != m_fingerprint)
+	{
+		if (!m_entries.empty())
+		{
+			osd_printf_verbose("%s: discarding cached DRC blocks from a different build or debugger setting\n", m_drcuml.device().tag());
+			m_entries.clear();
+			m_dirty = true;
+		}
+		m_fingerprint = current;
+	}
+}
+
+
+//-------------------------------------------------
+//  fingerprint - hash everything that near cache
+//  and symbol relocations depend on, plus whether
+//  the debugger hooks are being generated and
+//  where the named C functions ended up relative
+//  to each other, which catches most rebuilds
+//  that keep the same version string
+//-------------------------------------------------
+
+u64 drcuml_state::persistent_cache::fingerprint() const
+{
+	std::vector<u8> data;
+	put_string(data, emulator_info::get_build_version());
+	put_string(data, m_drcuml.device().shortname());
+	put_value(data, m_drcuml.cache().near_used(), 4);
+	put_value(data, (m_drcuml.device().machine().debug_flags & DEBUG_FLAG_ENABLED) ? 1 : 0, 1);
+	for (symbol const &sym : m_drcuml.m_symlist)
+	{
+		// only near cache symbols have a stable address
+		put_string(data, sym.name());
+		if (m_drcuml.cache().contains_near_pointer(sym.base()))
+			put_value(data, sym.base() - m_drcuml.cache().near(), 4);
+	}
+	for (auto const &cfunc : m_drcuml.m_cfunclist)
+	{
+		put_string(data, cfunc.second);
+		put_value(data, reinterpret_cast<uintptr_t>(cfunc.first) - reinterpret_cast<uintptr_t>(m_drcuml.m_cfunclist.front().first), 8);
+	}
+
+	u64 hash = 0xcbf29ce484222325U;
+	for (u8 const b : data)
+		hash = (hash ^ b) * 0x100000001b3U;
+	return hash;
+}
+
+
+//-------------------------------------------------
+//  encode_pointer - store a pointer relative to
+//  something that can be found again next run
+//-------------------------------------------------
+
+bool drcuml_state::persistent_cache::encode_pointer(std::vector<u8> &out, u64 value) const
+{
+	void *const ptr = reinterpret_cast<void *>(uintptr_t(value));
+	drc_cache const &cache(m_drcuml.cache());
+	if (cache.contains_near_pointer(ptr))
+	{
+		put_value(out, RELOC_NEAR, 1);
+		put_value(out, reinterpret_cast<drccodeptr>(ptr) - cache.near(), 4);
+		return true;
+	}
+
+	if (ptr == &m_drcuml.device())
+	{
+		put_value(out, RELOC_DEVICE, 1);
+		return true;
+	}
+
+	u32 offset;
+	char const *const name = m_drcuml.symbol_find(ptr, &offset);
+	if (name)
+	{
+		put_value(out, RELOC_SYMBOL, 1);
+		put_string(out, name);
+		put_value(out, offset, 4);
+		return true;
+	}
+
+	memory_manager &memory(m_drcuml.device().machine().memory());
+	for (auto const &share : memory.shares())
+	{
+		u8 *const base = reinterpret_cast<u8 *>(share.second->ptr());
+		if ((reinterpret_cast<u8 *>(ptr) >= base) && (reinterpret_cast<u8 *>(ptr) < (base + share.second->bytes())))
+		{
+			put_value(out, RELOC_SHARE, 1);
+			put_string(out, share.first);
+			put_value(out, reinterpret_cast<u8 *>(ptr) - base, 8);
+			return true;
+		}
+	}
+	for (auto const &region : memory.regions())
+	{
+		u8 *const base = region.second->base();
+		if ((reinterpret_cast<u8 *>(ptr) >= base) && (reinterpret_cast<u8 *>(ptr) < region.second->end()))
+		{
+			put_value(out, RELOC_REGION, 1);
+			put_string(out, region.first);
+			put_value(out, reinterpret_cast<u8 *>(ptr) - base, 8);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+//-------------------------------------------------
+//  encode_param - serialize one instruction
+//  parameter
+//-------------------------------------------------
+
+bool drcuml_state::persistent_cache::encode_param(std::vector<u8> &out, uml::parameter const &param)
+{
+	put_value(out, param.type(), 1);
+	switch (param.type())
+	{
+	case uml::parameter::PTYPE_IMMEDIATE:
+	{
+		// immediates are sometimes pointers
+		u64 const value = param.immediate();
+		if (encode_pointer(out, value))
+			return true;
+
+		// anything else must be a plain constant, or it would be baked into the next run's
+		// code as a stale pointer: either the front end said so, or on a 64-bit host it's
+		// too narrow to be an address
+		bool const narrow = (sizeof(void *) > 4) && ((value <= 0xffffffffU) || ((s64(value) < 0) && (s64(value) >= -0x80000000LL)));
+		if (!narrow && !param.is_constant())
+			return false;
+
+		put_value(out, RELOC_LITERAL, 1);
+		put_value(out, value, 8);
+		return true;
+	}
+
+	case uml::parameter::PTYPE_MEMORY:
+		return encode_pointer(out, reinterpret_cast<uintptr_t>(param.memory()));
+
+	case uml::parameter::PTYPE_C_FUNCTION:
+	{
+		// only functions the front end named can be found again
+		char const *const name = m_drcuml.cfunc_find(param.cfunc());
+		if (!name)
+			return false;
+		put_value(out, RELOC_CFUNC, 1);
+		put_string(out, name);
+		return true;
+	}
+
+	case uml::parameter::PTYPE_CODE_HANDLE:
+	{
+		u32 index = 0;
+		for (uml::code_handle &handle : m_drcuml.m_handlelist)
+		{
+			if (&handle == &param.handle())
+			{
+				put_value(out, RELOC_HANDLE, 1);
+				put_value(out, index, 4);
+				return true;
+			}
+			index++;
+		}
+		return false;
+	}
+
+	case uml::parameter::PTYPE_STRING:
+		return false;
+
+	default:
+		put_value(out, param.m_value, 8);
+		return true;
+	}
+}
+
+
+//-------------------------------------------------
+//  decode_param - restore one instruction
+//  parameter, relocating pointers
+//-------------------------------------------------
+
+bool drcuml_state::persistent_cache::decode_param(byte_reader &in, uml::parameter &param)
+{
+	auto const type = uml::parameter::parameter_type(in.get(1));
+	switch (type)
+	{
+	case uml::parameter::PTYPE_IMMEDIATE:
+	case uml::parameter::PTYPE_MEMORY:
+	case uml::parameter::PTYPE_C_FUNCTION:
+	case uml::parameter::PTYPE_CODE_HANDLE:
+		break;
+
+	default:
+		if (type >= uml::parameter::PTYPE_MAX)
+			return false;
+		param = uml::parameter(type, in.get(8));
+		return in.ok;
+	}
+
+	u64 value = 0;
+	switch (in.get(1))
+	{
+	case RELOC_LITERAL:
+		value = in.get(8);
+		break;
+
+	case RELOC_NEAR:
+	{
+		u32 const offset = in.get(4);
+		if (offset >= m_drcuml.cache().near_used())
+			return false;
+		value = reinterpret_cast<uintptr_t>(m_drcuml.cache().near() + offset);
+		break;
+	}
+
+	case RELOC_DEVICE:
+		value = reinterpret_cast<uintptr_t>(&m_drcuml.device());
+		break;
+
+	case RELOC_SYMBOL:
+	{
+		std::string const name = in.get_string();
+		u32 const offset = in.get(4);
+		auto const sym = std::find_if(m_drcuml.m_symlist.begin(), m_drcuml.m_symlist.end(), [&name] (symbol const &s) { return s.name() == name; });
+		if (sym == m_drcuml.m_symlist.end() || !sym->includes(sym->base() + offset))
+			return false;
+		value = reinterpret_cast<uintptr_t>(sym->base() + offset);
+		break;
+	}
+
+	case RELOC_SHARE:
+	{
+		std::string const name = in.get_string();
+		u64 const offset = in.get(8);
+		auto const &shares = m_drcuml.device().machine().memory().shares();
+		auto const share = shares.find(name);
+		if ((share == shares.end()) || (offset >= share->second->bytes()))
+			return false;
+		value = reinterpret_cast<uintptr_t>(share->second->ptr()) + offset;
+		break;
+	}
+
+	case RELOC_REGION:
+	{
+		std::string const name = in.get_string();
+		u64 const offset = in.get(8);
+		auto const &regions = m_drcuml.device().machine().memory().regions();
+		auto const region = regions.find(name);
+		if ((region == regions.end()) || (offset >= region->second->bytes()))
+			return false;
+		value = reinterpret_cast<uintptr_t>(region->second->base()) + offset;
+		break;
+	}
+
+	case RELOC_CFUNC:
+	{
+		// never trust an address from the file, only a name this run knows
+		std::string const name = in.get_string();
+		uml::c_function const func = m_drcuml.cfunc_find(std::string_view(name));
+		if (!in.ok || !func)
+			return false;
+		value = reinterpret_cast<uintptr_t>(func);
+		break;
+	}
+
+	case RELOC_HANDLE:
+	{
+		if (m_handles.size() != m_drcuml.m_handlelist.size())
+		{
+			m_handles.clear();
+			for (uml::code_handle &handle : m_drcuml.m_handlelist)
+				m_handles.push_back(&handle);
+		}
+		u32 const index = in.get(4);
+		if (index >= m_handles.size())
+			return false;
+		value = reinterpret_cast<uintptr_t>(m_handles[index]);
+		break;
+	}
+
+	default:
+		return false;
+	}
+
+	param = uml::parameter(type, value);
+	return in.ok;
+}
+
+
+//-------------------------------------------------
+//  decode - restore a cached block into the
+//  scratch instruction list
+//-------------------------------------------------
+
+bool drcuml_state::persistent_cache::decode(entry const &ent)
+{
+	m_scratch.resize(ent.numinst);
+	byte_reader in{ ent.data.data(), ent.data.data() + ent.data.size() };
+	for (uml::instruction &inst : m_scratch)
+	{
+		inst.m_opcode = uml::opcode_t(in.get(1));
+		inst.m_condition = uml::condition_t(in.get(1));
+		inst.m_flags = in.get(1);
+		inst.m_size = in.get(1);
+		inst.m_numparams = in.get(1);
+		if (!in.ok || (inst.m_opcode >= uml::OP_MAX) || (inst.m_numparams > std::size(inst.m_param)))
+			return false;
+		for (int pnum = 0; pnum < inst.m_numparams; pnum++)
+		{
+			if (!decode_param(in, inst.m_param[pnum]))
+				return false;
+		}
+	}
+	return in.ok && (in.ptr == in.end);
+}
+
+
+
+//**************************************************************************
+//  BLOCK PROFILER
+//**************************************************************************
+
+class drcuml_state::block_profiler
+{
+public:
+	block_profiler(drcuml_state &drcuml);
+	~block_profiler();
+
+	u64 *counter(u32 mode, u32 pc);
+	void record(std::vector<std::pair<u32, u32> > const &entries, std::string &&disasm, u32 numinst, u32 codesize);
+
+private:
+	// counters allocated from the cache at a time
+	static constexpr u32 COUNTER_CHUNK = 64;
+
+	// number of blocks listed by default
+	static constexpr int DEFAULT_REPORT = 20;
+
+	struct block_info
+	{
+		u32                 mode;       // mode of the first entry point
+		u32                 pc;         // PC of the first entry point
+		u32                 numinst;    // number of UML instructions
+		u32                 codesize;   // bytes of host code
+		std::string         disasm;     // UML disassembly
+	};
+
+	struct entry
+	{
+		u32                                 mode;       // mode of the entry point
+		u32                                 pc;         // PC of the entry point
+		u64 *                               counter;    // execution counter in the cache
+		std::shared_ptr<block_info const>   block;      // most recent translation
+	};
+
+	static u64 key(u32 mode, u32 pc) { return (u64(mode) << 32) | pc; }
+
+	std::vector<entry const *> hottest(int count, u64 &total) const;
+	void report(std::ostream &stream, int count) const;
+	void exit();
+	void execute_command(std::vector<std::string_view> const &params);
+
+	drcuml_state &                      m_drcuml;       // owning UML state
+	std::unordered_map<u64, entry>      m_entries;      // entry points by mode and PC
+	u64 *                               m_nextcounter;  // next free counter
+	u32                                 m_freecounters; // counters left in the current chunk
+
+	static std::vector<block_profiler *> s_profilers;   // for the debugger command
+};
+
+std::vector<drcuml_state::block_profiler *> drcuml_state::block_profiler::s_profilers;
+
+
+//-------------------------------------------------
+//  block_profiler - constructor
+//-------------------------------------------------
+
+drcuml_state::block_profiler::block_profiler(drcuml_state &drcuml)
+	: m_drcuml(drcuml)
+	, m_nextcounter(nullptr)
+	, m_freecounters(0)
+{
+	running_machine &machine(drcuml.device().machine());
+	machine.add_notifier(MACHINE_NOTIFY_EXIT, machine_notify_delegate(&block_profiler::exit, this));
+
+	// one debugger command covers every profiled CPU
+	if (s_profilers.empty() && (machine.debug_flags & DEBUG_FLAG_ENABLED))
+	{
+		using namespace std::placeholders;
+		machine.debugger().console().register_command("drcprofile", CMDFLAG_NONE, 0, 2, std::bind(&block_profiler::execute_command, this, _1));
+	}
+	s_profilers.push_back(this);
+}
+
+
+//-------------------------------------------------
+//  ~block_profiler - destructor
+//-------------------------------------------------
+
+drcuml_state::block_profiler::~block_profiler()
+{
+	s_profilers.erase(std::find(s_profilers.begin(), s_profilers.end(), this));
+}
+
+
+//-------------------------------------------------
+//  counter - get the execution counter for an
+//  entry point, allocating one on first use;
+//  counters live in permanent cache memory so
+//  they survive flushes and recompilation
+//-------------------------------------------------
+
+u64 *drcuml_state::block_profiler::counter(u32 mode, u32 pc)
+{
+	auto const found(m_entries.find(key(mode, pc)));
+	if (found != m_entries.end())
+		return found->second.counter;
+
+	if (!m_freecounters)
+	{
+		m_nextcounter = reinterpret_cast<u64 *>(m_drcuml.cache().alloc(COUNTER_CHUNK * sizeof(u64)));
+		if (!m_nextcounter)
+			return nullptr;
+		std::fill_n(m_nextcounter, COUNTER_CHUNK, 0);
+		m_freecounters = COUNTER_CHUNK;
+	}
+
+	u64 *const result(m_nextcounter++);
+	m_freecounters--;
+	m_entries.emplace(key(mode, pc), entry{ mode, pc, result, nullptr });
+	return result;
+}
+
+
+//-------------------------------------------------
+//  record - attach a freshly generated block to
+//  each of its entry points
+//-------------------------------------------------
+
+void drcuml_state::block_profiler::record(std::vector<std::pair<u32, u32> > const &entries, std::string &&disasm, u32 numinst, u32 codesize)
+{
+	if (entries.empty())
+		return;
+
+	auto const block(std::make_shared<block_info const>(block_info{ entries[0].first, entries[0].second, numinst, codesize, std::move(disasm) }));
+	for (auto const &ent : entries)
+	{
+		auto const found(m_entries.find(key(ent.first, ent.second)));
+		if (found != m_entries.end())
+			found->second.block = block;
+	}
+}
+
+
+//-------------------------------------------------
+//  hottest - find the most executed entry points
+//  that have been generated
+//-------------------------------------------------
+
+std::vector<drcuml_state::block_profiler::entry const *> drcuml_state::block_profiler::hottest(int count, u64 &total) const
+{
+	std::vector<entry const *> result;
+	total = 0;
+	result.reserve(m_entries.size());
+	for (auto const &ent : m_entries)
+	{
+		if (ent.second.block)
+		{
+			result.push_back(&ent.second);
+			total += *ent.second.counter;
+		}
+	}
+
+	auto const last(result.begin() + std::min<size_t>(count, result.size()));
+	std::partial_sort(result.begin(), last, result.end(), [] (entry const *a, entry const *b) { return *a->counter > *b->counter; });
+	result.erase(last, result.end());
+	return result;
+}
+
+
+//-------------------------------------------------
+//  report - list the most executed entry points
+//  with the block that contains them
+//-------------------------------------------------
+
+void drcuml_state::block_profiler::report(std::ostream &stream, int count) const
+{
+	u64 total;
+	std::vector<entry const *> const sorted(hottest(count, total));
+
+	util::stream_format(stream, "%s: %u block entries executed, %u entry points\n\n", m_drcuml.device().tag(), total, m_entries.size());
+	for (size_t index = 0; index < sorted.size(); index++)
+	{
+		entry const &ent(*sorted[index]);
+		util::stream_format(stream, "#%-3d (%X,%X): %u executions (%.2f%%), block (%X,%X), %u UML instructions, %u bytes of host code\n",
+				index + 1,
+				ent.mode,
+				ent.pc,
+				*ent.counter,
+				total ? (100.0 * double(*ent.counter) / double(total)) : 0.0,
+				ent.block->mode,
+				ent.block->pc,
+				ent.block->numinst,
+				ent.block->codesize);
+		stream << ent.block->disasm;
+	}
+}
+
+
+//-------------------------------------------------
+//  exit - write the full report to a file and
+//  summarize it in the log
 //-------------------------------------------------
 
-drcbe_interface::drcbe_interface(drcuml_state &drcuml, drc_cache &cache, device_t &device)
-	: m_drcuml(drcuml)
-	, m_cache(cache)
-	, m_device(device)
-	, m_space()
-	, m_state(*reinterpret_cast<drcuml_machine_state *>(cache.alloc_near(sizeof(m_state))))
-	, m_accessors(nullptr)
+void drcuml_state::block_profiler::exit()
 {
-	// reset the machine state
-	memset(&m_state, 0, sizeof(m_state));
+	device_t &device(m_drcuml.device());
+	std::string const filename(util::string_format("drcprof_%s.txt", device.shortname()));
+	std::ofstream file(filename);
+	if (file)
+		report(file, DEFAULT_REPORT);
+	else
+		osd_printf_error("Error writing DRC profile %s\n", filename);
 
-	// find the spaces and fetch memory accessors
-	device_memory_interface *memory;
-	if (device.interface(memory))
+	u64 total;
+	osd_printf_info("%s: hottest DRC blocks (see %s for disassembly)\n", device.tag(), filename);
+	for (entry const *ent : hottest(10, total))
 	{
-		int const count = memory->max_space_count();
-		m_accessors = reinterpret_cast<data_accessors *>(cache.alloc_near(sizeof(*m_accessors) * count));
-		memset(m_accessors, 0, sizeof(*m_accessors) * count);
-		m_space.resize(count, nullptr);
-
-		for (int spacenum = 0; spacenum < count; ++spacenum)
-		{
-			if (memory->has_space(spacenum))
-			{
-				m_space[spacenum] = &memory->space(spacenum);
-				m_space[spacenum]->accessors(m_accessors[spacenum]);
-			}
-		}
+		osd_printf_info("  (%X,%X): %u executions (%.2f%%), %u bytes of host code\n",
+				ent->mode,
+				ent->pc,
+				*ent->counter,
+				total ? (100.0 * double(*ent->counter) / double(total)) : 0.0,
+				ent->block->codesize);
 	}
 }
 
 
 //-------------------------------------------------
-//  ~drcbe_interface - destructor
+//  execute_command - debugger command to print
+//  the report: drcprofile [<cpu>[,<count>]]
 //-------------------------------------------------
 
-drcbe_interface::~drcbe_interface()
+void drcuml_state::block_profiler::execute_command(std::vector<std::string_view> const &params)
 {
+	debugger_console &console(m_drcuml.device().machine().debugger().console());
+
+	device_t *cpu;
+	if (!console.validate_cpu_parameter(params.empty() ? std::string_view() : params[0], cpu))
+		return;
+
+	u64 count(DEFAULT_REPORT);
+	if ((params.size() > 1) && !console.validate_number_parameter(params[1], count))
+		return;
+
+	for (block_profiler const *profiler : s_profilers)
+	{
+		if (&profiler->m_drcuml.device() == cpu)
+		{
+			std::ostringstream text;
+			profiler->report(text, int(std::min<u64>(count, 1000)));
+			console.printf("%s", std::move(text).str());
+			return;
+		}
+	}
+	console.printf("No DRC profile for %s (use -drc_profile)\n", cpu->tag());
 }
 
 
@@ -148,7 +1067,17 @@ drcuml_state::drcuml_state(device_t &device, drc_cache &cache, u32 flags, int mo
 	, m_blocklist()
 	, m_handlelist()
 	, m_symlist()
+	, m_cfunclist()
+	, m_optblocks(0)
+	, m_optbefore(0)
+	, m_optafter(0)
 {
+	if (device.machine().options().drc_cache())
+		m_persist = std::make_unique<persistent_cache>(*this);
+	if (device.machine().options().drc_profile())
+		m_profiler = std::make_unique<block_profiler>(*this);
+	if (device.machine().options().drc_log_opt())
+		device.machine().add_notifier(MACHINE_NOTIFY_EXIT, machine_notify_delegate(&drcuml_state::report_optimizer, this));
 }
 
 
@@ -225,6 +1154,31 @@ drcuml_block &drcuml_state::begin_block(uint32_t maxinst)
 }
 
 
+//-------------------------------------------------
+//  replay_block - generate a block from the
+//  persistent cache if we have a copy made from
+//  the same source code
+//-------------------------------------------------
+
+bool drcuml_state::replay_block(u32 mode, u32 pc, u64 hash)
+{
+	return m_persist && m_persist->replay(mode, pc, hash);
+}
+
+
+//-------------------------------------------------
+//  preload_blocks - generate blocks from the
+//  persistent cache up front; the hasher
+//  describes the current code at a mode/PC
+//-------------------------------------------------
+
+void drcuml_state::preload_blocks(std::function<u64 (u32 mode, u32 pc)> const &hasher)
+{
+	if (m_persist)
+		m_persist->preload(hasher);
+}
+
+
 //-------------------------------------------------
 //  handle_alloc - allocate a new handle
 //-------------------------------------------------
@@ -247,6 +1201,50 @@ void drcuml_state::symbol_add(void *base, u32 length, char const *name)
 }
 
 
+//-------------------------------------------------
+//  cfunc_add - name a C function that generated
+//  code calls
+//-------------------------------------------------
+
+void drcuml_state::cfunc_add(uml::c_function func, char const *name)
+{
+	assert(!cfunc_find(std::string_view(name)));
+	m_cfunclist.emplace_back(func, name);
+}
+
+
+//-------------------------------------------------
+//  cfunc_find - look up the name of a C function
+//  or return nullptr if it wasn't added
+//-------------------------------------------------
+
+char const *drcuml_state::cfunc_find(uml::c_function func) const
+{
+	for (auto const &cur : m_cfunclist)
+	{
+		if (cur.first == func)
+			return cur.second.c_str();
+	}
+	return nullptr;
+}
+
+
+//-------------------------------------------------
+//  cfunc_find - look up a C function by name or
+//  return nullptr if there isn't one
+//-------------------------------------------------
+
+uml::c_function drcuml_state::cfunc_find(std::string_view name) const
+{
+	for (auto const &cur : m_cfunclist)
+	{
+		if (cur.second == name)
+			return cur.first;
+	}
+	return nullptr;
+}
+
+
 //-------------------------------------------------
 //  symbol_find - look up a symbol from the
 //  internal symbol table or return nullptr if not
@@ -291,6 +1289,22 @@ void drcuml_state::log_vprintf(util::format_argument_pack<char> const &args)
 }
 
 
+//-------------------------------------------------
+//  report_optimizer - print how much the UML
+//  optimizer removed
+//-------------------------------------------------
+
+void drcuml_state::report_optimizer()
+{
+	osd_printf_info("%s: optimized %u UML blocks, %u instructions reduced to %u (%.1f%%)\n",
+			m_device.tag(),
+			m_optblocks,
+			m_optbefore,
+			m_optafter,
+			m_optbefore ? (100.0 * double(m_optafter) / double(m_optbefore)) : 100.0);
+}
+
+
 
 //**************************************************************************
 //  DRCUML BLOCK
@@ -306,6 +1320,11 @@ drcuml_block::drcuml_block(drcuml_state &drcuml, u32 maxinst)
 	, m_maxinst(maxinst * 3/2)
 	, m_inst(m_maxinst)
 	, m_inuse(false)
+	, m_replay(false)
+	, m_cachekey(false)
+	, m_cachemode(0)
+	, m_cachepc(0)
+	, m_cachehash(0)
 {
 }
 
@@ -328,6 +1347,8 @@ void drcuml_block::begin()
 	// set up the block information and return it
 	m_inuse = true;
 	m_nextinst = 0;
+	m_replay = false;
+	m_cachekey = false;
 }
 
 
@@ -340,16 +1361,51 @@ void drcuml_block::end()
 {
 	assert(m_inuse);
 
-	// optimize the resulting code first
-	optimize();
+	// optimize the resulting code first, unless it came from the persistent cache already optimized
+	if (!m_replay)
+	{
+		u32 const before(count_instructions());
+		optimize();
+		u32 const after(count_instructions());
+
+		m_drcuml.m_optblocks++;
+		m_drcuml.m_optbefore += before;
+		m_drcuml.m_optafter += after;
+		if (m_drcuml.logging())
+			m_drcuml.log_printf("; optimized %u -> %u instructions\n", before, after);
+	}
 
 	// if we have a logfile, generate a disassembly of the block
 	if (m_drcuml.logging())
-		disassemble();
+	{
+		disassemble(*m_drcuml.m_umllog);
+		m_drcuml.log_flush();
+	}
+
+	// remember it for next time
+	if (m_cachekey && m_drcuml.m_persist)
+		m_drcuml.m_persist->record(m_cachemode, m_cachepc, m_cachehash, &m_inst[0], m_nextinst);
+
+	// count executions of each entry point if profiling; this happens after recording
+	// so the persistent cache never sees the counter addresses
+	std::vector<std::pair<u32, u32> > entries;
+	std::string disasm;
+	u32 numinst(0);
+	if (m_drcuml.m_profiler)
+	{
+		std::ostringstream text;
+		disassemble(text);
+		disasm = std::move(text).str();
+		numinst = count_instructions();
+		add_profile_counters(entries);
+	}
 
 	// generate the code via the back-end
 	m_drcuml.cache().codegen_init();
+	drccodeptr const codestart(m_drcuml.cache().top());
 	m_drcuml.generate(*this, &m_inst[0], m_nextinst);
+	if (m_drcuml.m_profiler)
+		m_drcuml.m_profiler->record(entries, std::move(disasm), numinst, m_drcuml.cache().top() - codestart);
 
 	// block is no longer in use
 	m_inuse = false;
@@ -387,6 +1443,62 @@ uml::instruction &drcuml_block::append()
 }
 
 
+//-------------------------------------------------
+//  get_opcode_scope - classify how far the
+//  effects of an opcode reach for the optimizer
+//-------------------------------------------------
+
+namespace {
+
+enum class opcode_scope
+{
+	LOCAL,      // only touches its parameters and the flags
+	MEMORY,     // may also write memory not named by its parameters
+	BARRIER,    // leaves straight-line code or has opaque side effects
+	ENTRY       // code may branch here
+};
+
+opcode_scope get_opcode_scope(uml::opcode_t opcode)
+{
+	switch (opcode)
+	{
+	case uml::OP_HANDLE:
+	case uml::OP_HASH:
+	case uml::OP_LABEL:
+		return opcode_scope::ENTRY;
+
+	case uml::OP_INVALID:
+	case uml::OP_DEBUG:
+	case uml::OP_EXIT:
+	case uml::OP_HASHJMP:
+	case uml::OP_JMP:
+	case uml::OP_EXH:
+	case uml::OP_CALLH:
+	case uml::OP_RET:
+	case uml::OP_CALLC:
+	case uml::OP_RECOVER:
+	case uml::OP_SAVE:
+	case uml::OP_RESTORE:
+		return opcode_scope::BARRIER;
+
+	case uml::OP_STORE:
+	case uml::OP_READ:
+	case uml::OP_READM:
+	case uml::OP_WRITE:
+	case uml::OP_WRITEM:
+	case uml::OP_FSTORE:
+	case uml::OP_FREAD:
+	case uml::OP_FWRITE:
+		return opcode_scope::MEMORY;
+
+	default:
+		return opcode_scope::LOCAL;
+	}
+}
+
+} // anonymous namespace
+
+
 //-------------------------------------------------
 //  optimize - apply various optimizations to a
 //  block of code
@@ -395,6 +1507,7 @@ uml::instruction &drcuml_block::append()
 void drcuml_block::optimize()
 {
 	u32 mapvar[uml::MAPVAR_COUNT] = { 0 };
+	u32 mapvarknown(0);
 
 	// iterate over instructions
 	for (int instnum = 0; instnum < m_nextinst; instnum++)
@@ -418,9 +1531,21 @@ void drcuml_block::optimize()
 		}
 		inst.set_flags(accumflags);
 
-		// track mapvars
+		// track mapvars, dropping any that don't change the value
 		if (inst.opcode() == uml::OP_MAPVAR)
-			mapvar[inst.param(0).mapvar() - uml::MAPVAR_M0] = inst.param(1).immediate();
+		{
+			int const index(inst.param(0).mapvar() - uml::MAPVAR_M0);
+			u32 const value(inst.param(1).immediate());
+			if (BIT(mapvarknown, index) && (mapvar[index] == value))
+			{
+				inst.nop();
+			}
+			else
+			{
+				mapvar[index] = value;
+				mapvarknown |= 1 << index;
+			}
+		}
 
 		// convert all mapvar parameters to immediates
 		else if (inst.opcode() != uml::OP_RECOVER)
@@ -431,15 +1556,390 @@ void drcuml_block::optimize()
 		// now that flags are correct, simplify the instruction
 		inst.simplify();
 	}
+
+	// then clean up each straight-line run of instructions
+	propagate_values();
+	coalesce_copies();
+	eliminate_dead_stores();
+}
+
+
+//-------------------------------------------------
+//  propagate_values - substitute known constants,
+//  copies and memory contents for register and
+//  memory reads, folding as we go
+//-------------------------------------------------
+
+void drcuml_block::propagate_values()
+{
+	// an immediate or integer register known to hold the low bytes of a register
+	struct known_register
+	{
+		uml::parameter  value;
+		u8              size;
+	};
+
+	// an immediate or integer register known to match a piece of memory
+	struct known_memory
+	{
+		uintptr_t       base;
+		u8              size;
+		uml::parameter  value;
+	};
+
+	known_register regs[uml::REG_I_COUNT];
+	std::vector<known_memory> mems;
+
+	auto const forget_register =
+			[&regs, &mems] (uml::parameter const &reg)
+			{
+				regs[reg.ireg() - uml::REG_I0].value = uml::parameter();
+				for (known_register &known : regs)
+				{
+					if (known.value == reg)
+						known.value = uml::parameter();
+				}
+				mems.erase(
+						std::remove_if(mems.begin(), mems.end(), [&reg] (known_memory const &mem) { return mem.value == reg; }),
+						mems.end());
+			};
+	auto const forget_memory =
+			[&mems] (void const *base, u8 size)
+			{
+				uintptr_t const start(reinterpret_cast<uintptr_t>(base));
+				mems.erase(
+						std::remove_if(
+							mems.begin(),
+							mems.end(),
+							[start, size] (known_memory const &mem) { return (mem.base < (start + size)) && (start < (mem.base + mem.size)); }),
+						mems.end());
+			};
+	auto const forget_all =
+			[&regs, &mems] ()
+			{
+				for (known_register &known : regs)
+					known = known_register{ uml::parameter(), 0 };
+				mems.clear();
+			};
+	auto const lookup =
+			[&regs, &mems] (uml::parameter const &param, u8 size) -> uml::parameter
+			{
+				uml::parameter result;
+				if (param.is_int_register())
+				{
+					known_register const &known(regs[param.ireg() - uml::REG_I0]);
+					if (known.size >= size)
+						result = known.value;
+				}
+				else if (param.is_memory())
+				{
+					uintptr_t const base(reinterpret_cast<uintptr_t>(param.memory()));
+					for (known_memory const &mem : mems)
+					{
+						if ((mem.base == base) && (mem.size == size))
+						{
+							result = mem.value;
+							break;
+						}
+					}
+				}
+				if (result.is_immediate())
+					result = result.immediate() & make_bitmask<u64>(size * 8);
+				return result;
+			};
+
+	forget_all();
+	for (u32 instnum = 0; instnum < m_nextinst; instnum++)
+	{
+		uml::instruction &inst(m_inst[instnum]);
+		opcode_scope const scope(get_opcode_scope(inst.opcode()));
+
+		// code can branch to an entry point with anything in registers and memory
+		if (scope == opcode_scope::ENTRY)
+		{
+			forget_all();
+			continue;
+		}
+
+		// substitute known values for anything read
+		if (inst.opcode() != uml::OP_RECOVER)
+		{
+			for (int pnum = 0; pnum < inst.numparams(); pnum++)
+			{
+				uml::parameter const &param(inst.param(pnum));
+				if (inst.param_input(pnum) && !inst.param_output(pnum) && (param.is_int_register() || param.is_memory()))
+				{
+					uml::parameter const known(lookup(param, inst.param_size(pnum)));
+					if ((known.type() != uml::parameter::PTYPE_NONE) && (known != param) && inst.param_allowed(pnum, known))
+						inst.set_param(pnum, known);
+				}
+			}
+			inst.simplify();
+		}
+
+		// drop moves that store what's already there
+		if ((inst.opcode() == uml::OP_MOV) && (inst.condition() == uml::COND_ALWAYS))
+		{
+			uml::parameter const &dst(inst.param(0));
+			uml::parameter src(inst.param(1));
+			if (src.is_immediate())
+				src = src.immediate() & make_bitmask<u64>(inst.size() * 8);
+
+			bool redundant(false);
+			if (dst.is_int_register())
+			{
+				known_register const &known(regs[dst.ireg() - uml::REG_I0]);
+				redundant = ((dst == src) && (inst.size() == 8)) || ((known.size == inst.size()) && (known.value == src));
+			}
+			else if (dst.is_memory())
+			{
+				redundant = lookup(dst, inst.size()) == src;
+			}
+			if (redundant)
+			{
+				inst.nop();
+				continue;
+			}
+		}
+
+		// anything written is no longer known
+		for (int pnum = 0; pnum < inst.numparams(); pnum++)
+		{
+			uml::parameter const &param(inst.param(pnum));
+			if (inst.param_output(pnum))
+			{
+				if (param.is_int_register())
+					forget_register(param);
+				else if (param.is_memory())
+					forget_memory(param.memory(), inst.param_size(pnum));
+			}
+		}
+
+		if (scope == opcode_scope::BARRIER)
+		{
+			forget_all();
+		}
+		else if (scope == opcode_scope::MEMORY)
+		{
+			mems.clear();
+		}
+		else if ((inst.opcode() == uml::OP_MOV) && (inst.condition() == uml::COND_ALWAYS))
+		{
+			// remember what an unconditional move leaves behind
+			uml::parameter const &dst(inst.param(0));
+			uml::parameter src(inst.param(1));
+			u8 const size(inst.size());
+			if (src.is_immediate())
+				src = src.immediate() & make_bitmask<u64>(size * 8);
+
+			if (dst.is_int_register())
+			{
+				if (src.is_immediate() || (src.is_int_register() && (src != dst)))
+					regs[dst.ireg() - uml::REG_I0] = known_register{ src, size };
+				else if (src.is_memory())
+					mems.push_back(known_memory{ reinterpret_cast<uintptr_t>(src.memory()), size, dst });
+			}
+			else if (dst.is_memory() && (src.is_immediate() || src.is_int_register()))
+			{
+				mems.push_back(known_memory{ reinterpret_cast<uintptr_t>(dst.memory()), size, src });
+			}
+		}
+	}
+}
+
+
+//-------------------------------------------------
+//  coalesce_copies - have an instruction write
+//  directly to the destination of a following
+//  move from a temporary register
+//-------------------------------------------------
+
+void drcuml_block::coalesce_copies()
+{
+	for (u32 instnum = 1; instnum < m_nextinst; instnum++)
+	{
+		uml::instruction &inst(m_inst[instnum]);
+		if ((inst.opcode() != uml::OP_MOV) || (inst.condition() != uml::COND_ALWAYS) || !inst.param(1).is_int_register() || (inst.param(0) == inst.param(1)))
+			continue;
+
+		// find the instruction that produced the source
+		int prevnum(instnum - 1);
+		while ((prevnum >= 0) && ((m_inst[prevnum].opcode() == uml::OP_COMMENT) || (m_inst[prevnum].opcode() == uml::OP_NOP)))
+			prevnum--;
+		if (prevnum < 0)
+			continue;
+		uml::instruction &prev(m_inst[prevnum]);
+
+		// it needs to be a plain write of the whole source and nothing else
+		if ((get_opcode_scope(prev.opcode()) != opcode_scope::LOCAL) || (prev.condition() != uml::COND_ALWAYS) || (prev.numparams() == 0))
+			continue;
+		if (!prev.param_output(0) || prev.param_input(0) || (prev.param(0) != inst.param(1)) || (prev.param_size(0) != inst.size()))
+			continue;
+		bool otheroutputs(false);
+		for (int pnum = 1; pnum < prev.numparams(); pnum++)
+			otheroutputs = otheroutputs || prev.param_output(pnum);
+		if (otheroutputs || !prev.param_allowed(0, inst.param(0)))
+			continue;
+
+		// and the source can't be needed afterwards
+		if (!register_dead(instnum + 1, inst.param(1).ireg(), inst.size()))
+			continue;
+
+		prev.set_param(0, inst.param(0));
+		inst.nop();
+	}
+}
+
+
+//-------------------------------------------------
+//  eliminate_dead_stores - remove instructions
+//  whose results are overwritten before use
+//-------------------------------------------------
+
+void drcuml_block::eliminate_dead_stores()
+{
+	// work backwards so chains of dead values go in one pass
+	for (int instnum = m_nextinst - 1; instnum >= 0; instnum--)
+	{
+		uml::instruction &inst(m_inst[instnum]);
+		if ((get_opcode_scope(inst.opcode()) != opcode_scope::LOCAL) || (inst.condition() != uml::COND_ALWAYS) || (inst.flags() != 0))
+			continue;
+
+		// only register results can be proven dead; instructions without results only exist for their flags
+		bool dead(inst.output_flags() != 0);
+		for (int pnum = 0; pnum < inst.numparams(); pnum++)
+		{
+			if (inst.param_output(pnum))
+			{
+				uml::parameter const &param(inst.param(pnum));
+				dead = param.is_int_register() && register_dead(instnum + 1, param.ireg(), inst.param_size(pnum));
+				if (!dead)
+					break;
+			}
+		}
+		if (dead)
+			inst.nop();
+	}
+}
+
+
+//-------------------------------------------------
+//  register_dead - return true if a register is
+//  overwritten before it is read, starting at the
+//  given instruction
+//-------------------------------------------------
+
+bool drcuml_block::register_dead(u32 instnum, int regnum, u8 size) const
+{
+	uml::parameter const reg(uml::parameter::make_ireg(regnum));
+	for ( ; instnum < m_nextinst; instnum++)
+	{
+		// assume anything that leaves straight-line code reads everything
+		uml::instruction const &inst(m_inst[instnum]);
+		if ((get_opcode_scope(inst.opcode()) == opcode_scope::BARRIER) || (get_opcode_scope(inst.opcode()) == opcode_scope::ENTRY))
+			return false;
+
+		bool overwritten(false);
+		for (int pnum = 0; pnum < inst.numparams(); pnum++)
+		{
+			if (inst.param(pnum) == reg)
+			{
+				if (inst.param_input(pnum))
+					return false;
+				if (inst.param_output(pnum) && (inst.condition() == uml::COND_ALWAYS) && (inst.param_size(pnum) >= size))
+					overwritten = true;
+			}
+		}
+		if (overwritten)
+			return true;
+	}
+	return false;
+}
+
+
+//-------------------------------------------------
+//  count_instructions - count the instructions
+//  that generate code
+//-------------------------------------------------
+
+u32 drcuml_block::count_instructions() const
+{
+	u32 count(0);
+	for (u32 instnum = 0; instnum < m_nextinst; instnum++)
+	{
+		switch (m_inst[instnum].opcode())
+		{
+		case uml::OP_HANDLE:
+		case uml::OP_HASH:
+		case uml::OP_LABEL:
+		case uml::OP_COMMENT:
+		case uml::OP_MAPVAR:
+		case uml::OP_NOP:
+			break;
+
+		default:
+			count++;
+			break;
+		}
+	}
+	return count;
+}
+
+
+//-------------------------------------------------
+//  add_profile_counters - increment a counter at
+//  each hash entry point; flags are undefined on
+//  entry so the add may clobber them
+//-------------------------------------------------
+
+void drcuml_block::add_profile_counters(std::vector<std::pair<u32, u32> > &entries)
+{
+	// find the entry points and their counters
+	std::vector<u64 *> counters;
+	for (u32 instnum = 0; instnum < m_nextinst; instnum++)
+	{
+		uml::instruction const &inst(m_inst[instnum]);
+		if (inst.opcode() == uml::OP_HASH)
+		{
+			u32 const mode(inst.param(0).immediate());
+			u32 const pc(inst.param(1).immediate());
+			entries.emplace_back(mode, pc);
+			counters.push_back(m_drcuml.m_profiler->counter(mode, pc));
+		}
+	}
+	if (entries.empty())
+		return;
+
+	// make room and spread the instructions out from the end, adding a counter after each hash
+	if (m_nextinst + entries.size() > m_maxinst)
+	{
+		m_maxinst = m_nextinst + entries.size();
+		m_inst.resize(m_maxinst);
+	}
+	u32 dstnum(m_nextinst + entries.size());
+	auto counter(counters.rbegin());
+	for (u32 instnum = m_nextinst; instnum-- > 0; )
+	{
+		if (m_inst[instnum].opcode() == uml::OP_HASH)
+		{
+			u64 *const count(*counter++);
+			if (count)
+				m_inst[--dstnum].dadd(uml::mem(count), uml::mem(count), 1);
+			else
+				m_inst[--dstnum].nop();
+		}
+		m_inst[--dstnum] = m_inst[instnum];
+	}
+	m_nextinst += entries.size();
 }
 
 
 //-------------------------------------------------
 //  disassemble - disassemble a block of
-//  instructions to the log
+//  instructions to a stream
 //-------------------------------------------------
 
-void drcuml_block::disassemble()
+void drcuml_block::disassemble(std::ostream &stream)
 {
 	std::string comment;
 
@@ -459,11 +1959,11 @@ void drcuml_block::disassemble()
 
 		// print labels, handles, and hashes left justified
 		else if (inst.opcode() == uml::OP_LABEL)
-			m_drcuml.log_printf("$%X:\n", u32(inst.param(0).label()));
+			util::stream_format(stream, "$%X:\n", u32(inst.param(0).label()));
 		else if (inst.opcode() == uml::OP_HANDLE)
-			m_drcuml.log_printf("%s:\n", inst.param(0).handle().string());
+			util::stream_format(stream, "%s:\n", inst.param(0).handle().string());
 		else if (inst.opcode() == uml::OP_HASH)
-			m_drcuml.log_printf("(%X,%X):\n", u32(inst.param(0).immediate()), u32(inst.param(1).immediate()));
+			util::stream_format(stream, "(%X,%X):\n", u32(inst.param(0).immediate()), u32(inst.param(1).immediate()));
 
 		// indent everything else with a tab
 		else
@@ -473,13 +1973,13 @@ void drcuml_block::disassemble()
 			// include the first accumulated comment with this line
 			if (firstcomment != -1)
 			{
-				m_drcuml.log_printf("\t%-50.50s; %s\n", dasm, get_comment_text(m_inst[firstcomment], comment));
+				util::stream_format(stream, "\t%-50.50s; %s\n", dasm, get_comment_text(m_inst[firstcomment], comment));
 				firstcomment++;
 				flushcomments = true;
 			}
 			else
 			{
-				m_drcuml.log_printf("\t%s\n", dasm);
+				util::stream_format(stream, "\t%s\n", dasm);
 			}
 		}
 
@@ -490,13 +1990,12 @@ void drcuml_block::disassemble()
 			{
 				char const *const text(get_comment_text(m_inst[firstcomment++], comment));
 				if (text)
-					m_drcuml.log_printf("\t%50s; %s\n", "", text);
+					util::stream_format(stream, "\t%50s; %s\n", "", text);
 			}
 			firstcomment = -1;
 		}
 	}
-	m_drcuml.log_printf("\n\n");
-	m_drcuml.log_flush();
+	util::stream_format(stream, "\n\n");
 }
 
 
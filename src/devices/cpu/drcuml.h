@@ -15,9 +15,13 @@
 #include "drccache.h"
 #include "uml.h"
 
+#include <functional>
 #include <iostream>
 #include <list>
 #include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 
@@ -83,6 +87,8 @@ struct drcbe_info
 // a drcuml_block describes a basic block of instructions
 class drcuml_block
 {
+	friend class drcuml_state;
+
 public:
 	// construction/destruction
 	drcuml_block(drcuml_state &drcuml, u32 maxinst);
@@ -99,6 +105,9 @@ public:
 	void end();
 	void abort();
 
+	// persistent cache key for the code being generated
+	void set_cache_key(u32 mode, u32 pc, u64 hash) { m_cachekey = true; m_cachemode = mode; m_cachepc = pc; m_cachehash = hash; }
+
 	// instruction appending
 	uml::instruction &append();
 	template <typename Format, typename... Params> void append_comment(Format &&fmt, Params &&... args);
@@ -113,7 +122,13 @@ public:
 private:
 	// internal helpers
 	void optimize();
-	void disassemble();
+	void propagate_values();
+	void coalesce_copies();
+	void eliminate_dead_stores();
+	bool register_dead(u32 instnum, int regnum, u8 size) const;
+	u32 count_instructions() const;
+	void add_profile_counters(std::vector<std::pair<u32, u32> > &entries);
+	void disassemble(std::ostream &stream);
 	char const *get_comment_text(uml::instruction const &inst, std::string &comment);
 
 	// internal state
@@ -122,6 +137,11 @@ private:
 	u32                             m_maxinst;  // maximum number of instructions
 	std::vector<uml::instruction>   m_inst;     // pointer to the instruction list
 	bool                            m_inuse;    // this block is in use
+	bool                            m_replay;   // instructions came from the persistent cache
+	bool                            m_cachekey; // save the block in the persistent cache?
+	u32                             m_cachemode; // mode for the persistent cache
+	u32                             m_cachepc;  // PC for the persistent cache
+	u64                             m_cachehash; // source code hash for the persistent cache
 };
 
 
@@ -157,6 +177,8 @@ protected:
 // structure describing UML generation state
 class drcuml_state
 {
+	friend class drcuml_block;
+
 public:
 	// construction/destruction
 	drcuml_state(device_t &device, drc_cache &cache, u32 flags, int modes, int addrbits, int ignorebits);
@@ -173,6 +195,10 @@ public:
 	// code generation
 	drcuml_block &begin_block(u32 maxinst);
 
+	// persistent cache of finalized blocks, keyed by mode, PC and source hash
+	bool replay_block(u32 mode, u32 pc, u64 hash);
+	void preload_blocks(std::function<u64 (u32 mode, u32 pc)> const &hasher);
+
 	// back-end interface
 	void get_backend_info(drcbe_info &info) { m_beintf->get_info(info); }
 	bool hash_exists(u32 mode, u32 pc) { return m_beintf->hash_exists(mode, pc); }
@@ -185,6 +211,11 @@ public:
 	void symbol_add(void *base, u32 length, char const *name);
 	char const *symbol_find(void *base, u32 *offset = nullptr);
 
+	// C functions generated code calls, named so cached blocks can find them again
+	void cfunc_add(uml::c_function func, char const *name);
+	char const *cfunc_find(uml::c_function func) const;
+	uml::c_function cfunc_find(std::string_view name) const;
+
 	// logging
 	bool logging() const { return bool(m_umllog); }
 	template <typename Format, typename... Params>
@@ -197,6 +228,12 @@ public:
 	bool logging_native() const { return m_beintf->logging(); }
 
 private:
+	class persistent_cache;
+	class block_profiler;
+
+	// optimizer statistics
+	void report_optimizer();
+
 	// symbol class
 	class symbol
 	{
@@ -228,6 +265,12 @@ private:
 	std::list<drcuml_block>                 m_blocklist;        // list of active blocks
 	std::list<uml::code_handle>             m_handlelist;       // list of active handles
 	std::list<symbol>                       m_symlist;          // list of symbols
+	std::vector<std::pair<uml::c_function, std::string> > m_cfunclist; // named C functions
+	std::unique_ptr<persistent_cache>       m_persist;          // persistent block cache
+	std::unique_ptr<block_profiler>         m_profiler;         // per-block execution counters
+	u64                                     m_optblocks;        // number of blocks optimized
+	u64                                     m_optbefore;        // UML instructions before optimization
+	u64                                     m_optafter;         // UML instructions after optimization
 };
 
 
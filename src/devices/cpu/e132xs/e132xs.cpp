@@ -1171,6 +1171,7 @@ void hyperstone_device::init(int scale_mask)
 
 	m_drcuml->symbol_add(&m_core->arg0, sizeof(uint32_t), "arg0");
 	m_drcuml->symbol_add(&m_core->arg1, sizeof(uint32_t), "arg1");
+	code_register_cfuncs();
 
 	/* initialize the front-end helper */
 	m_drcfe = std::make_unique<e132xs_frontend>(this, COMPILE_BACKWARDS_BYTES, COMPILE_FORWARDS_BYTES, SINGLE_INSTRUCTION_MODE ? 1 : COMPILE_MAX_SEQUENCE);
@@ -479,8 +479,10 @@ private:
 
 	void execute_run_drc();
 	void flush_drc_cache();
+	void code_register_cfuncs();
 	void code_flush_cache();
 	void code_compile_block(offs_t pc);
+	uint64_t code_cache_seed() const { return m_drcoptions | (uint64_t((machine().debug_flags & DEBUG_FLAG_ENABLED) != 0) << 63); }
 	//void load_fast_iregs(drcuml_block &block);
 	//void save_fast_iregs(drcuml_block &block);
 	void static_generate_entry_point();
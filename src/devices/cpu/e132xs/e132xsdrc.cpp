@@ -17,6 +17,7 @@ void hyperstone_device::execute_run_drc()
 	if (m_cache_dirty)
 	{
 		code_flush_cache();
+		m_drcuml->preload_blocks([this] (uint32_t mode, uint32_t pc) { return drc_frontend::hash_code(m_drcfe->describe_code(pc), code_cache_seed()); });
 		m_cache_dirty = false;
 	}
 
@@ -122,6 +123,25 @@ static void cfunc_total_cycles(void *param)
 	((hyperstone_device *)param)->ccfunc_total_cycles();
 }
 
+/*-------------------------------------------------
+    code_register_cfuncs - name the C functions
+    generated code calls, so cached blocks can
+    find them again
+-------------------------------------------------*/
+
+void hyperstone_device::code_register_cfuncs()
+{
+	m_drcuml->cfunc_add(cfunc_unimplemented, "unimplemented");
+	m_drcuml->cfunc_add(cfunc_adjust_timer_interrupt, "adjust_timer_interrupt");
+	m_drcuml->cfunc_add(cfunc_compute_tr, "compute_tr");
+	m_drcuml->cfunc_add(cfunc_update_timer_prescale, "update_timer_prescale");
+	m_drcuml->cfunc_add(cfunc_standard_irq_callback, "standard_irq_callback");
+	m_drcuml->cfunc_add(cfunc_total_cycles, "total_cycles");
+#if E132XS_LOG_DRC_REGS
+	m_drcuml->cfunc_add(cfunc_dump_registers, "dump_registers");
+#endif
+}
+
 /***************************************************************************
     CACHE MANAGEMENT
 ***************************************************************************/
@@ -219,14 +239,23 @@ void hyperstone_device::code_compile_block(offs_t pc)
 
 	/* get a description of this sequence */
 	const opcode_desc *desclist = m_drcfe->describe_code(pc);
+	const uint64_t codehash = drc_frontend::hash_code(desclist, code_cache_seed());
 
 	bool succeeded = false;
 	while (!succeeded)
 	{
 		try
 		{
+			/* reuse the translation from an earlier run if the code hasn't changed */
+			if (m_drcuml->replay_block(0, pc, codehash))
+			{
+				succeeded = true;
+				break;
+			}
+
 			/* start the block */
 			drcuml_block &block(m_drcuml->begin_block(8192));
+			block.set_cache_key(0, pc, codehash);
 
 			/* loop until we get through all instruction sequences */
 			for (seqhead = desclist; seqhead != nullptr; seqhead = seqlast->next())
@@ -659,7 +659,7 @@ void hyperstone_device::generate_divsu(drcuml_block &block, compiler_state &comp
 	UML_JMPc(block, uml::COND_Z, no_result);
 	if (SIGNED)
 	{
-		UML_DTEST(block, I1, 0x8000000000000000LL);
+		UML_DTEST(block, I1, uml::constant(0x8000000000000000LL));
 		UML_JMPc(block, uml::COND_NZ, no_result);
 	}
 
@@ -880,7 +880,7 @@ void hyperstone_device::generate_sum(drcuml_block &block, compiler_state &compil
 	UML_DADD(block, I5, I1, I2);
 
 	UML_AND(block, DRC_SR, DRC_SR, ~(C_MASK | V_MASK | Z_MASK | N_MASK));
-	UML_DTEST(block, I5, 0x100000000ULL);
+	UML_DTEST(block, I5, uml::constant(0x100000000ULL));
 	UML_SETc(block, uml::COND_NZ, I6);
 	UML_ROLINS(block, DRC_SR, I6, C_SHIFT, C_MASK);
 
@@ -1370,7 +1370,7 @@ void hyperstone_device::generate_sub(drcuml_block &block, compiler_state &compil
 
 	UML_AND(block, DRC_SR, DRC_SR, ~(C_MASK | V_MASK | Z_MASK | N_MASK));
 
-	UML_DTEST(block, I2, 0x100000000ULL);
+	UML_DTEST(block, I2, uml::constant(0x100000000ULL));
 	UML_SETc(block, uml::COND_NZ, I4);
 	UML_ROLINS(block, DRC_SR, I4, 0, C_MASK);
 
@@ -2950,7 +2950,7 @@ void hyperstone_device::generate_shldi(drcuml_block &block, compiler_state &comp
 
 	UML_MOV(block, I4, HI_N ? (0x10 | (op & 0xf)) : (op & 0xf));
 
-	UML_DSHR(block, I1, 0xffffffff00000000ULL, I4); // I1: mask
+	UML_DSHR(block, I1, uml::constant(0xffffffff00000000ULL), I4); // I1: mask
 
 	UML_AND(block, DRC_SR, DRC_SR, ~C_MASK);
 
@@ -2966,7 +2966,7 @@ void hyperstone_device::generate_shldi(drcuml_block &block, compiler_state &comp
 	UML_DSHL(block, I0, I0, I4); // I0: val << n
 
 	UML_MOV(block, I4, 0);
-	UML_DTEST(block, I0, 0x8000000000000000ULL);
+	UML_DTEST(block, I0, uml::constant(0x8000000000000000ULL));
 	UML_JMPc(block, uml::COND_Z, no_hi_bit);
 	UML_XOR(block, I5, I5, I1); // I5: (high_order & mask) ^ mask
 	UML_LABEL(block, no_hi_bit);
@@ -3027,7 +3027,7 @@ void hyperstone_device::generate_shld(drcuml_block &block, compiler_state &compi
 	UML_LOAD(block, I4, (void *)m_core->local_regs, I4, SIZE_DWORD, SCALE_x4);
 	UML_AND(block, I4, I4, 0x1f); // I4: n
 
-	UML_DSHR(block, I1, 0xffffffff00000000ULL, I4); // I1: mask
+	UML_DSHR(block, I1, uml::constant(0xffffffff00000000ULL), I4); // I1: mask
 
 	UML_AND(block, DRC_SR, DRC_SR, ~C_MASK);
 
@@ -3043,7 +3043,7 @@ void hyperstone_device::generate_shld(drcuml_block &block, compiler_state &compi
 	UML_DSHL(block, I0, I0, I4); // I0: val << n
 
 	UML_MOV(block, I4, 0);
-	UML_DTEST(block, I0, 0x8000000000000000ULL);
+	UML_DTEST(block, I0, uml::constant(0x8000000000000000ULL));
 	UML_JMPc(block, uml::COND_Z, no_hi_bit);
 	UML_XOR(block, I5, I5, I1); // I5: (high_order & mask) ^ mask
 	UML_LABEL(block, no_hi_bit);
@@ -3100,7 +3100,7 @@ void hyperstone_device::generate_shl(drcuml_block &block, compiler_state &compil
 	UML_OR(block, I6, I6, C_MASK);
 
 	UML_LABEL(block, no_carry);
-	UML_DSHR(block, I5, 0xffffffff00000000ULL, I1);
+	UML_DSHR(block, I5, uml::constant(0xffffffff00000000ULL), I1);
 	UML_AND(block, I3, I0, I5);
 
 	UML_SHL(block, I0, I0, I1);
@@ -3261,7 +3261,7 @@ void hyperstone_device::generate_rol(drcuml_block &block, compiler_state &compil
 	UML_ROL(block, I2, I0, I1);
 	UML_LABEL(block, no_shift);
 
-	UML_DSHR(block, I5, 0xffffffff00000000ULL, I1);
+	UML_DSHR(block, I5, uml::constant(0xffffffff00000000ULL), I1);
 	UML_AND(block, I3, I0, I5);
 
 	UML_MOV(block, I6, 0);
@@ -482,6 +482,7 @@ void mips3_device::device_start()
 	m_drcuml->symbol_add(&m_core->arg1, sizeof(m_core->arg1), "arg1");
 	m_drcuml->symbol_add(&m_core->numcycles, sizeof(m_core->numcycles), "numcycles");
 	m_drcuml->symbol_add(&m_fpmode, sizeof(m_fpmode), "fpmode");
+	code_register_cfuncs();
 
 	/* initialize the front-end helper */
 	m_drcfe = std::make_unique<mips3_frontend>(this, COMPILE_BACKWARDS_BYTES, COMPILE_FORWARDS_BYTES, SINGLE_INSTRUCTION_MODE ? 1 : COMPILE_MAX_SEQUENCE);
@@ -5315,9 +5316,12 @@ void mips3_device::execute_run()
 	{
 		int execute_result;
 
-		/* reset the cache if dirty */
+		/* reset the cache if dirty, and bring back blocks from earlier runs the first time */
 		if (m_drc_cache_dirty)
+		{
 			code_flush_cache();
+			m_drcuml->preload_blocks([this] (uint32_t mode, uint32_t pc) { return drc_frontend::hash_code(m_drcfe->describe_code(pc), code_cache_seed()); });
+		}
 		m_drc_cache_dirty = false;
 
 		/* execute */
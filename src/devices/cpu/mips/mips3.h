@@ -601,8 +601,10 @@ private:
 	void sdr_le(uint32_t op);
 	void load_fast_iregs(drcuml_block &block);
 	void save_fast_iregs(drcuml_block &block);
+	void code_register_cfuncs();
 	void code_flush_cache();
 	void code_compile_block(uint8_t mode, offs_t pc);
+	uint64_t code_cache_seed() const { return m_drcoptions | (uint64_t(m_hotspot_select) << 32) | (uint64_t((machine().debug_flags & DEBUG_FLAG_ENABLED) != 0) << 63); }
 public:
 	void func_get_cycles();
 	void func_printf_exception();
@@ -308,6 +308,7 @@ void mips3_device::code_compile_block(uint8_t mode, offs_t pc)
 	codelast = m_drcfe->get_last();
 	if (m_drcuml->logging() || m_drcuml->logging_native())
 		log_opcode_desc(desclist, 0);
+	const uint64_t codehash = drc_frontend::hash_code(desclist, code_cache_seed());
 
 	/* if we get an error back, flush the cache and try again */
 	bool succeeded = false;
@@ -315,8 +316,16 @@ void mips3_device::code_compile_block(uint8_t mode, offs_t pc)
 	{
 		try
 		{
+			/* reuse the translation from an earlier run if the code hasn't changed */
+			if (m_drcuml->replay_block(mode, pc, codehash))
+			{
+				succeeded = true;
+				break;
+			}
+
 			/* start the block */
 			drcuml_block &block(m_drcuml->begin_block(4096));
+			block.set_cache_key(mode, pc, codehash);
 
 			/* loop until we get through all instruction sequences */
 			for (seqhead = desclist; seqhead != nullptr; seqhead = seqlast->next())
@@ -575,6 +584,28 @@ static void cfunc_unimplemented(void *param)
 	((mips3_device *)param)->func_unimplemented();
 }
 
+/*-------------------------------------------------
+    code_register_cfuncs - name the C functions
+    generated code calls, so cached blocks can
+    find them again
+-------------------------------------------------*/
+
+void mips3_device::code_register_cfuncs()
+{
+	m_drcuml->cfunc_add(cfunc_mips3com_update_cycle_counting, "mips3com_update_cycle_counting");
+	m_drcuml->cfunc_add(cfunc_mips3com_asid_changed, "mips3com_asid_changed");
+	m_drcuml->cfunc_add(cfunc_mips3com_tlbr, "mips3com_tlbr");
+	m_drcuml->cfunc_add(cfunc_mips3com_tlbwi, "mips3com_tlbwi");
+	m_drcuml->cfunc_add(cfunc_mips3com_tlbwr, "mips3com_tlbwr");
+	m_drcuml->cfunc_add(cfunc_mips3com_tlbp, "mips3com_tlbp");
+	m_drcuml->cfunc_add(cfunc_get_cycles, "get_cycles");
+	m_drcuml->cfunc_add(cfunc_printf_exception, "printf_exception");
+	m_drcuml->cfunc_add(cfunc_printf_debug, "printf_debug");
+	m_drcuml->cfunc_add(cfunc_printf_probe, "printf_probe");
+	m_drcuml->cfunc_add(cfunc_debug_break, "debug_break");
+	m_drcuml->cfunc_add(cfunc_unimplemented, "unimplemented");
+}
+
 
 /***************************************************************************
     STATIC CODEGEN
@@ -3066,7 +3097,7 @@ bool mips3_device::generate_cop1(drcuml_block &block, compiler_state &compiler,
 					{
 						UML_FDNEG(block, FPR64(FDREG), FPR64(FSREG));                         // fdneg   <fdreg>,<fsreg>
 						UML_DCMP(block, FPR64(FSREG), 0);                                     // cmp     <fsreg>,0.0
-						UML_DMOVc(block, COND_E, FPR64(FDREG), 0x8000000000000000U);          // dmov    <fdreg>,-0.0,e
+						UML_DMOVc(block, COND_E, FPR64(FDREG), uml::constant(0x8000000000000000U));          // dmov    <fdreg>,-0.0,e
 					}
 					return true;
 
@@ -654,8 +654,10 @@ protected:
 	uint32_t compute_rlw_mask(uint8_t mb, uint8_t me);
 	uint32_t compute_crf_mask(uint8_t crm);
 	uint32_t compute_spr(uint32_t spr);
+	void code_register_cfuncs();
 	void code_flush_cache();
 	void code_compile_block(uint8_t mode, offs_t pc);
+	uint64_t code_cache_seed() const { return m_drcoptions | (uint64_t(m_hotspot_select) << 32) | (uint64_t((machine().debug_flags & DEBUG_FLAG_ENABLED) != 0) << 63); }
 	void static_generate_entry_point();
 	void static_generate_nocode_handler();
 	void static_generate_out_of_cycles();
@@ -226,9 +226,12 @@ void ppc_device::execute_run()
 {
 	int execute_result;
 
-	/* reset the cache if dirty */
+	/* reset the cache if dirty, and bring back blocks from earlier runs the first time */
 	if (m_cache_dirty)
+	{
 		code_flush_cache();
+		m_drcuml->preload_blocks([this] (uint32_t mode, uint32_t pc) { return drc_frontend::hash_code(m_drcfe->describe_code(pc), code_cache_seed()); });
+	}
 	m_cache_dirty = false;
 
 	/* execute */
@@ -387,14 +390,23 @@ void ppc_device::code_compile_block(uint8_t mode, offs_t pc)
 	desclist = m_drcfe->describe_code(pc);
 	if (m_drcuml->logging() || m_drcuml->logging_native())
 		log_opcode_desc(desclist, 0);
+	const uint64_t codehash = drc_frontend::hash_code(desclist, code_cache_seed());
 
 	bool succeeded = false;
 	while (!succeeded)
 	{
 		try
 		{
+			/* reuse the translation from an earlier run if the code hasn't changed */
+			if (m_drcuml->replay_block(mode, pc, codehash))
+			{
+				succeeded = true;
+				break;
+			}
+
 			/* start the block */
 			drcuml_block &block(m_drcuml->begin_block(4096));
+			block.set_cache_key(mode, pc, codehash);
 
 			/* loop until we get through all instruction sequences */
 			for (seqhead = desclist; seqhead != nullptr; seqhead = seqlast->next())
@@ -656,6 +668,34 @@ static void cfunc_ppccom_get_dsisr(void *param)
 	ppc->ppccom_get_dsisr();
 }
 
+/*-------------------------------------------------
+    code_register_cfuncs - name the C functions
+    generated code calls, so cached blocks can
+    find them again
+-------------------------------------------------*/
+
+void ppc_device::code_register_cfuncs()
+{
+	m_drcuml->cfunc_add(cfunc_printf_exception, "printf_exception");
+	m_drcuml->cfunc_add(cfunc_printf_debug, "printf_debug");
+	m_drcuml->cfunc_add(cfunc_printf_probe, "printf_probe");
+	m_drcuml->cfunc_add(cfunc_unimplemented, "unimplemented");
+	m_drcuml->cfunc_add(cfunc_ppccom_mismatch, "ppccom_mismatch");
+	m_drcuml->cfunc_add(cfunc_ppccom_tlb_fill, "ppccom_tlb_fill");
+	m_drcuml->cfunc_add(cfunc_ppccom_update_fprf, "ppccom_update_fprf");
+	m_drcuml->cfunc_add(cfunc_ppccom_dcstore_callback, "ppccom_dcstore_callback");
+	m_drcuml->cfunc_add(cfunc_ppccom_execute_tlbie, "ppccom_execute_tlbie");
+	m_drcuml->cfunc_add(cfunc_ppccom_execute_tlbia, "ppccom_execute_tlbia");
+	m_drcuml->cfunc_add(cfunc_ppccom_execute_tlbl, "ppccom_execute_tlbl");
+	m_drcuml->cfunc_add(cfunc_ppccom_execute_mfspr, "ppccom_execute_mfspr");
+	m_drcuml->cfunc_add(cfunc_ppccom_execute_mftb, "ppccom_execute_mftb");
+	m_drcuml->cfunc_add(cfunc_ppccom_execute_mtspr, "ppccom_execute_mtspr");
+	m_drcuml->cfunc_add(cfunc_ppccom_tlb_flush, "ppccom_tlb_flush");
+	m_drcuml->cfunc_add(cfunc_ppccom_execute_mfdcr, "ppccom_execute_mfdcr");
+	m_drcuml->cfunc_add(cfunc_ppccom_execute_mtdcr, "ppccom_execute_mtdcr");
+	m_drcuml->cfunc_add(cfunc_ppccom_get_dsisr, "ppccom_get_dsisr");
+}
+
 /***************************************************************************
     STATIC CODEGEN
 ***************************************************************************/
@@ -1336,7 +1376,7 @@ void ppc_device::static_generate_memory_accessor(int mode, int size, int iswrite
 				UML_CALLH(block, *masked);                                  // callh   masked
 				UML_ADD(block, I0, mem(&m_core->tempaddr), 4);              // add     i0,[tempaddr],4
 				UML_DSHL(block, I1, mem(&m_core->tempdata.d), 32);          // dshl    i1,[tempdata],32
-				UML_DMOV(block, I2, 0xffffffff00000000U);                   // dmov    i2,0xffffffff00000000
+				UML_DMOV(block, I2, uml::constant(0xffffffff00000000U));                   // dmov    i2,0xffffffff00000000
 				UML_CALLH(block, *masked);                                  // callh   masked
 			}
 			else
@@ -1347,7 +1387,7 @@ void ppc_device::static_generate_memory_accessor(int mode, int size, int iswrite
 				UML_CALLH(block, *masked);                                  // callh   masked
 				UML_DSHL(block, mem(&m_core->tempdata.d), I0, 32);          // dshl    [tempdata],i0,32
 				UML_ADD(block, I0, mem(&m_core->tempaddr), 4);              // add     i0,[tempaddr],4
-				UML_DMOV(block, I2, 0xffffffff00000000U);                   // dmov    i2,0xffffffff00000000
+				UML_DMOV(block, I2, uml::constant(0xffffffff00000000U));                   // dmov    i2,0xffffffff00000000
 				UML_CALLH(block, *masked);                                  // callh   masked
 				UML_DSHR(block, I0, I0, 32);                                // dshr    i0,i0,32
 				UML_DOR(block, I0, I0, mem(&m_core->tempdata.d));           // dor     i0,i0,[tempdata]
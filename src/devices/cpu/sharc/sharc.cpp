@@ -554,6 +554,7 @@ void adsp21062_device::device_start()
 	m_drcuml->symbol_add(&m_core->dreg_temp, sizeof(m_core->dreg_temp), "dreg_temp");
 	m_drcuml->symbol_add(&m_core->lstkp, sizeof(m_core->lstkp), "lstkp");
 	m_drcuml->symbol_add(&m_core->px, sizeof(m_core->px), "px");
+	register_cfuncs();
 
 	m_drcfe = std::make_unique<sharc_frontend>(this, COMPILE_BACKWARDS_BYTES, COMPILE_FORWARDS_BYTES, COMPILE_MAX_SEQUENCE);
 
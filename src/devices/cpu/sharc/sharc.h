@@ -610,8 +610,10 @@ private:
 	};
 
 	void execute_run_drc();
+	void register_cfuncs();
 	void flush_cache();
 	void compile_block(offs_t pc);
+	uint64_t code_cache_seed() const { return (uint64_t((machine().debug_flags & DEBUG_FLAG_ENABLED) != 0) << 63); }
 	void alloc_handle(uml::code_handle *&handleptr, const char *name);
 	void static_generate_entry_point();
 	void static_generate_nocode_handler();
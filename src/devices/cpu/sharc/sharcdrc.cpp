@@ -165,6 +165,25 @@ static void cfunc_unimplemented_shiftimm(void *param)
 	sharc->sharc_cfunc_unimplemented_shiftimm();
 }
 
+/*-------------------------------------------------
+    register_cfuncs - name the C functions
+    generated code calls, so cached blocks can
+    find them again
+-------------------------------------------------*/
+
+void adsp21062_device::register_cfuncs()
+{
+	m_drcuml->cfunc_add(cfunc_unimplemented, "unimplemented");
+	m_drcuml->cfunc_add(cfunc_pcstack_overflow, "pcstack_overflow");
+	m_drcuml->cfunc_add(cfunc_pcstack_underflow, "pcstack_underflow");
+	m_drcuml->cfunc_add(cfunc_loopstack_overflow, "loopstack_overflow");
+	m_drcuml->cfunc_add(cfunc_loopstack_underflow, "loopstack_underflow");
+	m_drcuml->cfunc_add(cfunc_statusstack_overflow, "statusstack_overflow");
+	m_drcuml->cfunc_add(cfunc_statusstack_underflow, "statusstack_underflow");
+	m_drcuml->cfunc_add(cfunc_unimplemented_compute, "unimplemented_compute");
+	m_drcuml->cfunc_add(cfunc_unimplemented_shiftimm, "unimplemented_shiftimm");
+}
+
 void adsp21062_device::sharc_cfunc_unimplemented()
 {
 	uint64_t op = m_core->arg64;
@@ -784,9 +803,12 @@ void adsp21062_device::execute_run_drc()
 //  if (m_cache_dirty)
 //      printf("SHARC cache reset\n");
 
-	/* reset the cache if dirty */
+	/* reset the cache if dirty, and bring back blocks from earlier runs the first time */
 	if (m_core->cache_dirty)
+	{
 		flush_cache();
+		m_drcuml->preload_blocks([this] (uint32_t mode, uint32_t pc) { return drc_frontend::hash_code(m_drcfe->describe_code(pc), code_cache_seed()); });
+	}
 
 	m_core->cache_dirty = 0;
 	m_core->force_recompile = 0;
@@ -822,13 +844,22 @@ void adsp21062_device::compile_block(offs_t pc)
 	bool override = false;
 
 	desclist = m_drcfe->describe_code(pc);
+	const uint64_t codehash = drc_frontend::hash_code(desclist, code_cache_seed());
 
 	bool succeeded = false;
 	while (!succeeded)
 	{
 		try
 		{
+			// reuse the translation from an earlier run if the code hasn't changed
+			if (m_drcuml->replay_block(0, pc, codehash))
+			{
+				succeeded = true;
+				break;
+			}
+
 			drcuml_block &block(m_drcuml->begin_block(4096));
+			block.set_cache_key(0, pc, codehash);
 
 			for (seqhead = desclist; seqhead != nullptr; seqhead = seqlast->next())
 			{
@@ -3401,7 +3432,7 @@ void adsp21062_device::generate_compute(drcuml_block &block, compiler_state &com
 				switch (ai)
 				{
 					case 0x00:  // MR0F
-						UML_DAND(block, MRF, MRF, 0xffffffff00000000U);
+						UML_DAND(block, MRF, MRF, uml::constant(0xffffffff00000000U));
 						UML_AND(block, I0, REG(rn), 0xffffffff);
 						UML_DOR(block, MRF, MRF, I0);
 						break;
@@ -3411,7 +3442,7 @@ void adsp21062_device::generate_compute(drcuml_block &block, compiler_state &com
 						UML_DOR(block, MRF, MRF, I0);
 						break;
 					case 0x04:  // MR0B
-						UML_DAND(block, MRB, MRB, 0xffffffff00000000U);
+						UML_DAND(block, MRB, MRB, uml::constant(0xffffffff00000000U));
 						UML_AND(block, I0, REG(rn), 0xffffffff);
 						UML_DOR(block, MRB, MRB, I0);
 						break;
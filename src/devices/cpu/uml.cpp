@@ -804,6 +804,66 @@ u8 uml::instruction::modified_flags() const
 }
 
 
+//-------------------------------------------------
+//  param_input - return true if the given
+//  parameter is read by the instruction
+//-------------------------------------------------
+
+bool uml::instruction::param_input(int paramnum) const
+{
+	assert(paramnum < m_numparams);
+	return (s_opcode_info_table[m_opcode].param[paramnum].output & PIO_IN) != 0;
+}
+
+
+//-------------------------------------------------
+//  param_output - return true if the given
+//  parameter is written by the instruction
+//-------------------------------------------------
+
+bool uml::instruction::param_output(int paramnum) const
+{
+	assert(paramnum < m_numparams);
+	return (s_opcode_info_table[m_opcode].param[paramnum].output & PIO_OUT) != 0;
+}
+
+
+//-------------------------------------------------
+//  param_size - return the size in bytes of the
+//  value read or written through a parameter
+//-------------------------------------------------
+
+u8 uml::instruction::param_size(int paramnum) const
+{
+	assert(paramnum < m_numparams);
+	u8 const size = s_opcode_info_table[m_opcode].param[paramnum].size;
+	if (size == PSIZE_OP)
+		return m_size;
+	else if (size >= PSIZE_P1 && size <= PSIZE_P4)
+		return ((size - PSIZE_P1) < m_numparams) ? (1 << m_param[size - PSIZE_P1].size()) : m_size;
+	else
+		return 1 << size;
+}
+
+
+//-------------------------------------------------
+//  param_allowed - return true if the given
+//  parameter may be substituted for an existing
+//  value parameter
+//-------------------------------------------------
+
+bool uml::instruction::param_allowed(int paramnum, parameter const &param) const
+{
+	assert(paramnum < m_numparams);
+	u16 const typemask = s_opcode_info_table[m_opcode].param[paramnum].typemask;
+
+	// pointers and state blocks are addresses rather than values
+	if ((typemask & (PTYPES_PTR | PTYPES_STATE)) & ~PTYPES_MEM)
+		return false;
+	return ((typemask >> param.type()) & 1) != 0;
+}
+
+
 //-------------------------------------------------
 //  disasm - disassemble an instruction to the
 //  given buffer
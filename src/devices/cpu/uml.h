@@ -299,7 +299,7 @@ namespace uml
 
 		// construction
 		constexpr parameter() : m_type(PTYPE_NONE), m_value(0) { }
-		constexpr parameter(parameter const &param) : m_type(param.m_type), m_value(param.m_value) { }
+		constexpr parameter(parameter const &param) : m_type(param.m_type), m_constant(param.m_constant), m_value(param.m_value) { }
 		constexpr parameter(u64 val) : m_type(PTYPE_IMMEDIATE), m_value(val) { }
 		parameter(operand_size size, memory_scale scale) : m_type(PTYPE_SIZE_SCALE), m_value((scale << 4) | size) { assert(size >= SIZE_BYTE && size <= SIZE_DQWORD); assert(scale >= SCALE_x1 && scale <= SCALE_x8); }
 		parameter(operand_size size, memory_space space) : m_type(PTYPE_SIZE_SPACE), m_value((space << 4) | size) { assert(size >= SIZE_BYTE && size <= SIZE_DQWORD); assert(space >= SPACE_PROGRAM && space <= SPACE_IO); }
@@ -317,6 +317,7 @@ namespace uml
 		static parameter make_string(char const *string) { return parameter(PTYPE_STRING, reinterpret_cast<parameter_value>(const_cast<char *>(string))); }
 		static parameter make_cfunc(c_function func) { return parameter(PTYPE_C_FUNCTION, reinterpret_cast<parameter_value>(func)); }
 		static parameter make_rounding(float_rounding_mode mode) { assert(mode >= ROUND_TRUNC && mode <= ROUND_DEFAULT); return parameter(PTYPE_ROUNDING, mode); }
+		static constexpr parameter make_constant(u64 val) { parameter result(val); result.m_constant = true; return result; }
 
 		// operators
 		constexpr bool operator==(parameter const &rhs) const { return (m_type == rhs.m_type) && (m_value == rhs.m_value); }
@@ -354,16 +355,20 @@ namespace uml
 		constexpr bool is_c_function() const { return m_type == PTYPE_C_FUNCTION; }
 		constexpr bool is_rounding() const { return m_type == PTYPE_ROUNDING; }
 		constexpr bool is_string() const { return m_type == PTYPE_STRING; }
+		constexpr bool is_constant() const { return (m_type == PTYPE_IMMEDIATE) && m_constant; }
 
 		// other queries
 		constexpr bool is_immediate_value(u64 value) const { return (m_type == PTYPE_IMMEDIATE) && (m_value == value); }
 
 	private:
+		friend class ::drcuml_state; // for restoring cached blocks
+
 		// private constructor
 		constexpr parameter(parameter_type type, parameter_value value) : m_type(type), m_value(value) { }
 
 		// internals
 		parameter_type      m_type;             // parameter type
+		bool                m_constant = false; // immediate known not to be a host address
 		parameter_value     m_value;            // parameter value
 	};
 
@@ -405,12 +410,17 @@ namespace uml
 		// setters
 		void set_flags(u8 flags) { m_flags = flags; }
 		void set_mapvar(int paramnum, u32 value) { assert(paramnum < m_numparams); assert(m_param[paramnum].is_mapvar()); m_param[paramnum] = value; }
+		void set_param(int paramnum, parameter const &param) { assert(paramnum < m_numparams); m_param[paramnum] = param; validate(); }
 
 		// misc
 		std::string disasm(drcuml_state *drcuml = nullptr) const;
 		u8 input_flags() const;
 		u8 output_flags() const;
 		u8 modified_flags() const;
+		bool param_input(int paramnum) const;
+		bool param_output(int paramnum) const;
+		u8 param_size(int paramnum) const;
+		bool param_allowed(int paramnum, parameter const &param) const;
 		void simplify();
 
 		// compile-time opcodes
@@ -575,6 +585,8 @@ namespace uml
 		static constexpr int MAX_PARAMS = 4;
 
 	private:
+		friend class ::drcuml_state; // for restoring cached blocks
+
 		// internal configuration
 		void configure(opcode_t op, u8 size, condition_t cond = COND_ALWAYS);
 		void configure(opcode_t op, u8 size, parameter p0, condition_t cond = COND_ALWAYS);
@@ -615,6 +627,9 @@ namespace uml
 	// global inline functions to define memory parameters
 	inline parameter mem(const void *ptr) { return parameter::make_memory(ptr); }
 
+	// global inline function to mark a wide immediate as a plain constant rather than an address
+	constexpr parameter constant(u64 value) { return parameter::make_constant(value); }
+
 	// global register objects for direct access
 	const parameter I0(parameter::make_ireg(REG_I0 + 0));
 	const parameter I1(parameter::make_ireg(REG_I0 + 1));
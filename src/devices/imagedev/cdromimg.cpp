@@ -9,8 +9,11 @@
 #include "emu.h"
 #include "cdromimg.h"
 
+#include "emuopts.h"
 #include "romload.h"
 
+#include <algorithm>
+
 // device type definition
 DEFINE_DEVICE_TYPE(CDROM, cdrom_image_device, "cdrom_image", "CD-ROM Image")
 DEFINE_DEVICE_TYPE(GDROM, gdrom_image_device, "gdrom_image", "CD/GD-ROM Image")
@@ -119,6 +122,7 @@ std::pair<std::error_condition, std::string> cdrom_image_device::call_load()
 				err = m_self_chd.open(std::move(proxy)); // CDs are never writeable
 			if (err)
 				goto error;
+			m_self_chd.set_read_cache(std::max(machine().options().chd_cache(), 0), std::max(machine().options().chd_prefetch(), 0));
 			chd = &m_self_chd;
 		}
 	}
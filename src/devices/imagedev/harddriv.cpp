@@ -274,6 +274,7 @@ std::error_condition harddisk_image_device::internal_load_hd()
 
 				if (!err)
 				{
+					m_origchd.set_read_cache(std::max(machine().options().chd_cache(), 0), std::max(machine().options().chd_prefetch(), 0));
 					err = open_disk_diff(device().machine().options(), basename_noext(), m_origchd, m_diffchd);
 					if (!err)
 					{
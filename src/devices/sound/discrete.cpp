@@ -40,9 +40,13 @@
 
 #include "wavwrite.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cstdarg>
+#include <deque>
 #include <iostream>
+#include <mutex>
+#include <thread>
 
 
 // device type definition
@@ -95,14 +99,9 @@ struct output_buffer
 	{
 	}
 
-	// required for use in vector (std::atomic<T> has deleted copy constructor)
-	output_buffer(output_buffer &&that) : node_buf(std::move(that.node_buf)), source(that.source), ptr(that.ptr.load(std::memory_order_relaxed)), node_num(that.node_num)
-	{
-	}
-
 	std::unique_ptr<double []>  node_buf;
 	const double *              source;
-	std::atomic<double *>       ptr;
+	double *                    ptr;
 	int                         node_num;
 };
 
@@ -113,39 +112,43 @@ struct input_buffer
 	double                      buffer;             // input[] will point here
 };
 
+/*
+ * Each update is cut into slices of MAX_SAMPLES_PER_TASK_SLICE samples, and
+ * every slice of every task is a node in a dependency graph: slice n of a task
+ * waits for slice n of each task it reads buffers from, and for its own slice
+ * n - 1. A task is handed to a worker as soon as its next slice has nothing
+ * left to wait for, so nobody polls tasks that cannot make progress.
+ */
 class discrete_task
 {
 public:
-	discrete_task(discrete_device &pdev) : m_device(pdev), m_threadid(-1), m_samples(0)
+	discrete_task(discrete_device &pdev) : m_device(pdev), m_source_tasks(0), m_pending_size(0), m_samples(0), m_slice(0), m_slices(0)
 	{
 		// FIXME: the code expects to be able to take pointers to members of elements of this vector before it's filled
 		source_list.reserve(16);
 	}
 
 	void check(discrete_task &dest_task);
-	void prepare_for_queue(int samples);
+	int prepare_for_queue(int samples);
 
-	static void *task_callback(void *param, int threadid);
+	bool ready() const { return m_pending[0].load(std::memory_order_relaxed) == 0; }
+	void run_slice(discrete_worker &worker, bool stolen);
+	void mark_ready();
 
 	//const linked_list_entry *list;
 	discrete_device::node_step_list_t        step_list;
 
 	int task_group = 0;
 
+	/* statistics, gathered when profiling */
+	osd_ticks_t                 run_time = 0;       /* ticks spent stepping our slices */
+	osd_ticks_t                 wait_time = 0;      /* ticks between becoming ready and starting */
+	uint64_t                    slices_run = 0;
+	uint64_t                    slices_stolen = 0;  /* slices run by a worker other than the one we were queued on */
+
 private:
 	void step_nodes();
-	bool process();
-
-	bool lock_threadid(int32_t threadid)
-	{
-		int expected = -1;
-		return m_threadid.compare_exchange_strong(expected, threadid, std::memory_order_acquire, std::memory_order_relaxed);
-	}
-
-	void unlock()
-	{
-		m_threadid.store(-1, std::memory_order_release);
-	}
+	bool release_slice(int slice);
 
 	/* list of source nodes */
 	std::vector<input_buffer> source_list;      /* discrete_source_node */
@@ -153,8 +156,47 @@ private:
 	std::vector<output_buffer>  m_buffers;
 	discrete_device &           m_device;
 
-	std::atomic<int32_t>        m_threadid;
+	/* dependency graph */
+	std::vector<discrete_task *> m_dependents;  /* tasks reading our buffers */
+	int                         m_source_tasks; /* tasks whose buffers we read */
+	std::unique_ptr<std::atomic<int> []> m_pending; /* per slice: sources and earlier slice still to finish */
+	int                         m_pending_size;
+
 	int                         m_samples;
+	int                         m_slice;        /* next slice to run */
+	int                         m_slices;
+	osd_ticks_t                 m_ready_time = 0;
+};
+
+/*
+ * One per work item. Each worker runs tasks from the back of its own deque,
+ * where the ones it just made ready are still warm in its cache, and when
+ * that runs dry takes the oldest entry from the front of another worker's.
+ */
+class discrete_worker
+{
+public:
+	discrete_worker(discrete_device &pdev, int index) : m_device(pdev), m_index(index)
+	{
+	}
+
+	static void *work_callback(void *param, int threadid);
+
+	void push(discrete_task &task);
+	void run();
+
+	/* statistics, gathered when profiling */
+	uint64_t                    steals = 0;
+	osd_ticks_t                 idle_time = 0;
+
+private:
+	discrete_task *pop();
+	discrete_task *steal();
+
+	discrete_device &           m_device;
+	int                         m_index;
+	std::mutex                  m_lock;
+	std::deque<discrete_task *> m_ready;
 };
 
 
@@ -209,78 +251,91 @@ inline void discrete_task::step_nodes()
 		}
 	}
 
-	// buffer the outputs
-	for (output_buffer &outbuf : m_buffers)
-		*outbuf.ptr.load(std::memory_order_relaxed) = *outbuf.source;
-	std::atomic_thread_fence(std::memory_order_release);
+	// buffer the outputs; readers only look at them once the whole slice is released
 	for (output_buffer &outbuf : m_buffers)
-		outbuf.ptr.store(outbuf.ptr.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		*outbuf.ptr++ = *outbuf.source;
 }
 
-void *discrete_task::task_callback(void *param, int threadid)
-{
-	const auto &list = *reinterpret_cast<const discrete_sound_device::task_list_t *>(param);
-	while (true)
-	{
-		for (const auto &task : list)
-		{
-			// try to lock
-			if (task->lock_threadid(threadid))
-			{
-				if (!task->process())
-					return nullptr;
-				task->unlock();
-			}
-		}
-	}
+//-------------------------------------------------
+//  release_slice - count off one of the things
+//  the given slice is waiting for; returns true
+//  if that was the last
+//-------------------------------------------------
 
-	return nullptr;
+inline bool discrete_task::release_slice(int slice)
+{
+	// acq_rel so whoever takes the count to zero sees every buffer written before each release
+	return m_pending[slice].fetch_sub(1, std::memory_order_acq_rel) == 1;
 }
 
-inline bool discrete_task::process()
+void discrete_task::mark_ready()
 {
-	int samples = std::min(m_samples, MAX_SAMPLES_PER_TASK_SLICE);
+	if (m_device.profiling())
+		m_ready_time = get_profile_ticks();
+}
 
-	// check dependencies
-	for (input_buffer &sn : source_list)
-	{
-		const int avail = sn.linked_outbuf->ptr.load(std::memory_order_relaxed) - sn.ptr;
-		if (avail < 0)
-			throw emu_fatalerror("discrete_task::process: available samples are negative");
-		if (avail < samples)
-			samples = avail;
-	}
-	std::atomic_thread_fence(std::memory_order_acquire);
+//-------------------------------------------------
+//  run_slice - step the nodes through our next
+//  slice, then queue whichever tasks that
+//  completes the inputs for on the same worker
+//-------------------------------------------------
+
+void discrete_task::run_slice(discrete_worker &worker, bool stolen)
+{
+	const int slice = m_slice++;
+	int samples = std::min(m_samples - slice * MAX_SAMPLES_PER_TASK_SLICE, MAX_SAMPLES_PER_TASK_SLICE);
 
-	m_samples -= samples;
-	if (m_samples < 0)
-		throw emu_fatalerror("discrete_task::process: m_samples got negative");
-	while (samples > 0)
+	if (EXPECTED(!m_device.profiling()))
 	{
-		// step
-		step_nodes();
-		samples--;
+		while (samples-- > 0)
+			step_nodes();
 	}
-	if (m_samples == 0)
+	else
 	{
-		// return and keep the task locked so it is not picked up by other worker threads
-		return false;
+		const osd_ticks_t start = get_profile_ticks();
+		wait_time += start - m_ready_time;
+		while (samples-- > 0)
+			step_nodes();
+		run_time += get_profile_ticks() - start;
+		slices_run++;
+		if (stolen)
+			slices_stolen++;
 	}
-	return true;
+
+	// the same slice of our dependents, and our own next slice
+	for (discrete_task *dest : m_dependents)
+		if (dest->release_slice(slice))
+			worker.push(*dest);
+	if (m_slice < m_slices && release_slice(m_slice))
+		worker.push(*this);
+
+	m_device.m_slices_pending.fetch_sub(1, std::memory_order_release);
 }
 
-void discrete_task::prepare_for_queue(int samples)
+int discrete_task::prepare_for_queue(int samples)
 {
-	m_threadid.store(-1, std::memory_order_relaxed); // unlock the thread
 	m_samples = samples;
+	m_slice = 0;
+	m_slices = (samples + MAX_SAMPLES_PER_TASK_SLICE - 1) / MAX_SAMPLES_PER_TASK_SLICE;
+	if (m_slices > m_pending_size)
+	{
+		m_pending = std::make_unique<std::atomic<int> []>(m_slices);
+		m_pending_size = m_slices;
+	}
+
+	// the first slice only waits for our sources, later ones for the previous slice too
+	for (int slice = 0; slice < m_slices; slice++)
+		m_pending[slice].store(m_source_tasks + (slice ? 1 : 0), std::memory_order_relaxed);
 
 	// set up task buffers
 	for (output_buffer &ob : m_buffers)
-		ob.ptr.store(ob.node_buf.get(), std::memory_order_relaxed);
+		ob.ptr = ob.node_buf.get();
 
 	// initialize sources
 	for (input_buffer &sn : source_list)
 		sn.ptr = sn.linked_outbuf->node_buf.get();
+
+	return m_slices;
 }
 
 void discrete_task::check(discrete_task &dest_task)
@@ -288,6 +343,7 @@ void discrete_task::check(discrete_task &dest_task)
 	// FIXME: this function takes addresses of elements of a vector that has items added later
 	// 16 is enough for the systems in MAME, but the code should be fixed properly
 	m_buffers.reserve(16);
+	bool linked = false;
 
 	/* Determine, which nodes in the task are referenced by nodes in dest_task
 	 * and add them to the list of nodes to be buffered for further processing
@@ -326,7 +382,7 @@ void discrete_task::check(discrete_task &dest_task)
 							output_buffer buf;
 
 							buf.node_buf = std::make_unique<double []>((task_node->sample_rate() + sound_manager::STREAMS_UPDATE_FREQUENCY) / sound_manager::STREAMS_UPDATE_FREQUENCY);
-							buf.ptr.store(buf.node_buf.get(), std::memory_order_relaxed);
+							buf.ptr = buf.node_buf.get();
 							buf.source = dest_node->m_input[inputnum];
 							buf.node_num = inputnode_num;
 							//buf.node = device->discrete_find_node(inputnode);
@@ -339,11 +395,106 @@ void discrete_task::check(discrete_task &dest_task)
 						dest_task.source_list.push_back(input_buffer{ nullptr, pbuf, 0.0 });
 						// FIXME: taking address of element of vector before it's filled
 						dest_node->m_input[inputnum] = &dest_task.source_list.back().buffer;
+						linked = true;
 					}
 				}
 			}
 		}
 	}
+
+	/* dest_task's slices now wait for ours */
+	if (linked)
+	{
+		m_dependents.push_back(&dest_task);
+		dest_task.m_source_tasks++;
+	}
+}
+
+
+/*************************************
+ *
+ *  Worker implementation
+ *
+ *************************************/
+
+void discrete_worker::push(discrete_task &task)
+{
+	task.mark_ready();
+	std::lock_guard<std::mutex> lock(m_lock);
+	m_ready.push_back(&task);
+}
+
+inline discrete_task *discrete_worker::pop()
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+	if (m_ready.empty())
+		return nullptr;
+	discrete_task *const task = m_ready.back();
+	m_ready.pop_back();
+	return task;
+}
+
+inline discrete_task *discrete_worker::steal()
+{
+	std::unique_lock<std::mutex> lock(m_lock, std::try_to_lock);
+	if (!lock.owns_lock() || m_ready.empty())
+		return nullptr;
+	discrete_task *const task = m_ready.front();
+	m_ready.pop_front();
+	return task;
+}
+
+void *discrete_worker::work_callback(void *param, int threadid)
+{
+	(*reinterpret_cast<std::unique_ptr<discrete_worker> *>(param))->run();
+	return nullptr;
+}
+
+//-------------------------------------------------
+//  run - run slices until every task has
+//  finished the update
+//-------------------------------------------------
+
+void discrete_worker::run()
+{
+	const auto &workers = m_device.m_workers;
+	const int count = workers.size();
+	osd_ticks_t idle_start = 0;
+
+	while (m_device.m_slices_pending.load(std::memory_order_acquire) > 0)
+	{
+		bool stolen = false;
+		discrete_task *task = pop();
+
+		// nothing of our own, so try everyone else starting with our neighbour
+		for (int i = 1; task == nullptr && i < count; i++)
+		{
+			task = workers[(m_index + i) % count]->steal();
+			stolen = (task != nullptr);
+		}
+
+		if (task == nullptr)
+		{
+			// whatever is left is still waiting on slices running elsewhere
+			if (m_device.profiling() && idle_start == 0)
+				idle_start = get_profile_ticks();
+			std::this_thread::yield();
+			continue;
+		}
+
+		if (m_device.profiling())
+		{
+			if (idle_start != 0)
+				idle_time += get_profile_ticks() - idle_start;
+			idle_start = 0;
+			if (stolen)
+				steals++;
+		}
+		task->run_slice(*this, stolen);
+	}
+
+	if (idle_start != 0)
+		idle_time += get_profile_ticks() - idle_start;
 }
 
 /*************************************
@@ -663,6 +814,18 @@ void discrete_device::display_profiling()
 		osd_printf_info("Task(%d): %8.2f %15.2f\n", task->task_group, tt / double(total) * 100.0, tt / double(m_total_samples));
 	}
 
+	/* Scheduling information: per task, slices run, ticks per slice stepping and waiting once ready, and the share stolen */
+	for (const auto &task : task_list)
+	{
+		if (task->slices_run == 0)
+			continue;
+		osd_printf_info("Task(%d) slices: %10d %12.2f %12.2f %7.2f%%\n", task->task_group, task->slices_run,
+				double(task->run_time) / double(task->slices_run), double(task->wait_time) / double(task->slices_run),
+				double(task->slices_stolen) / double(task->slices_run) * 100.0);
+	}
+	for (int i = 0; i < int(m_workers.size()); i++)
+		osd_printf_info("Worker(%d): %10d steals %15d idle ticks\n", i, m_workers[i]->steals, m_workers[i]->idle_time);
+
 	osd_printf_info("Average samples/double->update: %8.2f\n", double(m_total_samples) / double(m_total_stream_updates));
 }
 
@@ -827,6 +990,7 @@ discrete_device::discrete_device(const machine_config &mconfig, device_type type
 		m_indexed_node(nullptr),
 		m_disclogfile(nullptr),
 		m_queue(nullptr),
+		m_slices_pending(0),
 		m_profiling(0),
 		m_total_samples(0),
 		m_total_stream_updates(0)
@@ -897,9 +1061,6 @@ void discrete_device::device_start()
 		node->resolve_input_nodes();
 	}
 
-	/* allocate a queue */
-	m_queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_MULTI | WORK_QUEUE_FLAG_HIGH_FREQ);
-
 	/* Process nodes which have a start func */
 	for (const auto &node : m_node_list)
 	{
@@ -915,6 +1076,13 @@ void discrete_device::device_start()
 				dest_task->check(*task);
 		}
 	}
+
+	/* one worker per task, up to the number of processors; a single worker runs on the caller */
+	const int workers = std::min<int>(task_list.size(), std::max(1, osd_get_num_processors(false)));
+	for (int i = 0; i < workers; i++)
+		m_workers.push_back(std::make_unique<discrete_worker>(*this, i));
+	if (workers > 1)
+		m_queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_MULTI | WORK_QUEUE_FLAG_HIGH_FREQ);
 }
 
 void discrete_device::device_stop()
@@ -1025,18 +1193,23 @@ void discrete_device::process(int samples)
 	if (samples == 0)
 		return;
 
-	// Set up tasks
+	// Set up tasks, and spread those with nothing to wait for over the workers
+	int slices = 0;
 	for (const auto &task : task_list)
-		task->prepare_for_queue(samples);
-	std::atomic_thread_fence(std::memory_order_release);
+		slices += task->prepare_for_queue(samples);
+	m_slices_pending.store(slices, std::memory_order_relaxed);
 
+	int next = 0;
 	for (const auto &task : task_list)
-	{
-		// Fire a work item for each task
-		(void)task;
-		osd_work_item_queue(m_queue, discrete_task::task_callback, (void *)&task_list, WORK_ITEM_FLAG_AUTO_RELEASE);
-	}
-	osd_work_queue_wait(m_queue, osd_ticks_per_second() * 10);
+		if (task->ready())
+			m_workers[next++ % m_workers.size()]->push(*task);
+
+	// the first worker runs here while the queue runs the rest
+	if (m_workers.size() > 1)
+		osd_work_item_queue_multiple(m_queue, discrete_worker::work_callback, m_workers.size() - 1, &m_workers[1], sizeof(m_workers[1]), WORK_ITEM_FLAG_AUTO_RELEASE);
+	m_workers[0]->run();
+	if (m_workers.size() > 1)
+		while (!osd_work_queue_wait(m_queue, osd_ticks_per_second())) { }
 
 	if (m_profiling)
 	{
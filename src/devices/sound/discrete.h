@@ -7,6 +7,7 @@
 
 #include "machine/rescap.h"
 
+#include <atomic>
 #include <memory>
 #include <vector>
 
@@ -4103,6 +4104,7 @@ enum discrete_node_type
 
 struct discrete_block;
 class discrete_task;
+class discrete_worker;
 class discrete_base_node;
 class discrete_dss_input_stream_node;
 class discrete_device;
@@ -4184,6 +4186,7 @@ protected:
 
 public:
 	typedef std::vector<std::unique_ptr<discrete_task> > task_list_t;
+	typedef std::vector<std::unique_ptr<discrete_worker> > worker_list_t;
 	typedef std::vector<std::unique_ptr<discrete_base_node> > node_list_t;
 	typedef std::vector<discrete_step_interface *> node_step_list_t;
 
@@ -4265,12 +4268,17 @@ private:
 	FILE *                  m_disclogfile;
 
 	/* parallel tasks */
+	worker_list_t           m_workers;
 	osd_work_queue *        m_queue;
+	std::atomic<int>        m_slices_pending;   /* task slices left to run this update */
 
 	/* profiling */
 	int                     m_profiling;
 	uint64_t                  m_total_samples;
 	uint64_t                  m_total_stream_updates;
+
+	friend class discrete_task;
+	friend class discrete_worker;
 };
 
 // ======================> discrete_sound_device
@@ -18,6 +18,8 @@ mixer_device::mixer_device(const machine_config &mconfig, const char *tag, devic
 	device_t(mconfig, MIXER, tag, owner, clock),
 	device_mixer_interface(mconfig, *this)
 {
+	// we only ever mix, so our stream can be updated alongside unrelated ones
+	m_mixer_flags = STREAM_THREAD_SAFE;
 }
 
 
@@ -192,8 +192,10 @@ protected:
 		// let our parent do its startup
 		ym_generic_device::device_start();
 
-		// allocate our stream
-		m_stream = device_sound_interface::stream_alloc(0, OUTPUTS, m_chip.sample_rate(device_t::clock()));
+		// allocate our stream; unless the chip reads sample data through an address
+		// space, generating samples only touches its own state
+		device_memory_interface *memory;
+		m_stream = device_sound_interface::stream_alloc(0, OUTPUTS, m_chip.sample_rate(device_t::clock()), device_t::interface(memory) ? STREAM_DEFAULT_FLAGS : STREAM_THREAD_SAFE);
 
 		// compute the size of the save buffer by doing an initial save
 		ymfm::ymfm_saved_state state(m_save_blob, true);
@@ -116,6 +116,13 @@ public:
 	// inline configuration helpers
 	void set_disable() { m_disabled = true; }
 
+	// devices sharing a non-zero group run in order against the same target
+	// after the ungrouped devices; separate groups may run on separate host
+	// threads, so they must only interact at quantum boundaries and must not
+	// touch timers, triggers or other devices' state while executing
+	void set_execute_group(int group) { m_execute_group = group; }
+	int execute_group() const { return m_execute_group; }
+
 	template <typename... T> void set_vblank_int(const char *tag, T &&... args)
 	{
 		m_vblank_interrupt.set(std::forward<T>(args)...);
@@ -186,6 +193,19 @@ public:
 	attotime local_time() const noexcept;
 	u64 total_cycles() const noexcept;
 
+	// scheduler statistics, only collected while enabled in the scheduler
+	struct scheduler_stats
+	{
+		u64 m_executions = 0;       // number of times the device was resumed
+		u64 m_cycles_requested = 0; // cycles requested by the scheduler
+		u64 m_cycles_run = 0;       // cycles actually run
+		u64 m_cycles_aborted = 0;   // cycles given back by abort_timeslice()
+		u64 m_cycles_eaten = 0;     // cycles swallowed by eat_all_cycles()
+		u64 m_aborts = 0;           // timeslices cut short by abort_timeslice()
+		u64 m_quantum_changes = 0;  // add_quantum()/perfect_quantum() calls made while executing
+	};
+	const scheduler_stats &stats() const noexcept { return m_stats; }
+
 	// required operation overrides
 	void run() { execute_run(); }
 
@@ -288,6 +308,7 @@ private:
 
 	// configuration
 	bool                    m_disabled;                 // disabled from executing?
+	int                     m_execute_group;            // execute group (0 = none)
 	device_interrupt_delegate m_vblank_interrupt;       // for interrupts tied to VBLANK
 	const char *            m_vblank_interrupt_screen;  // the screen that causes the VBLANK interrupt
 	device_interrupt_delegate m_timed_interrupt;        // for interrupts not tied to VBLANK
@@ -324,6 +345,7 @@ private:
 	u8                      m_divshift;                 // right shift amount to fit the divisor into 32 bits
 	u32                     m_cycles_per_second;        // cycles per second, adjusted for multipliers
 	attoseconds_t           m_attoseconds_per_cycle;    // attoseconds per adjusted clock cycle
+	scheduler_stats         m_stats;                    // scheduler statistics
 
 	emu_timer *             m_spin_end_timer;           // timer for triggering the end of spin_until_time
 	emu_timer *             m_pulse_end_timers[MAX_INPUT_LINES]; // timer for ending input-line pulses
@@ -9,6 +9,7 @@
 ***************************************************************************/
 
 #include "emu.h"
+#include "emuopts.h"
 #include "validity.h"
 
 
@@ -264,6 +265,10 @@ void device_gfx_interface::decode_gfx(const gfx_decode_entry *gfxdecodeinfo)
 
 		// allocate the graphics
 		m_gfx[curgfx] = std::make_unique<gfx_element>(m_palette, glcopy, (region_base != nullptr) ? region_base + gfx.start : nullptr, xormask, gfx.total_color_codes, gfx.color_codes_start);
+
+		// optionally trade memory for skipping transparent rows of sprites
+		if (device().machine().options().gfx_row_cache())
+			m_gfx[curgfx]->set_row_cache(true);
 	}
 
 	m_decoded = true;
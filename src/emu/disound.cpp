@@ -405,7 +405,8 @@ void device_sound_interface::sound_stream_update(sound_stream &stream, std::vect
 device_mixer_interface::device_mixer_interface(const machine_config &mconfig, device_t &device, int outputs)
 	: device_sound_interface(mconfig, device),
 		m_outputs(outputs),
-		m_mixer_stream(nullptr)
+		m_mixer_stream(nullptr),
+		m_mixer_flags(STREAM_DEFAULT_FLAGS)
 {
 }
 
@@ -459,7 +460,7 @@ void device_mixer_interface::interface_pre_start()
 	m_output_clear.resize(m_outputs);
 
 	// allocate the mixer stream
-	m_mixer_stream = stream_alloc(m_auto_allocated_inputs, m_outputs, device().machine().sample_rate(), STREAM_DEFAULT_FLAGS);
+	m_mixer_stream = stream_alloc(m_auto_allocated_inputs, m_outputs, device().machine().sample_rate(), m_mixer_flags);
 }
 
 
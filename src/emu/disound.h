@@ -139,6 +139,7 @@ protected:
 	std::vector<u8> m_outputmap;            // map of inputs to outputs
 	std::vector<bool> m_output_clear;       // flag for tracking cleared buffers
 	sound_stream *m_mixer_stream;           // mixing stream
+	sound_stream_flags m_mixer_flags;       // flags for the mixing stream
 };
 
 // iterator
@@ -94,6 +94,7 @@ gfx_element::gfx_element(device_palette_interface *palette, u8 *base, u16 width,
 		m_srcdata(base),
 		m_dirtyseq(1),
 		m_gfxdata(base),
+		m_row_cache(false),
 		m_layout_is_raw(true),
 		m_layout_planes(0),
 		m_layout_xormask(0),
@@ -119,6 +120,7 @@ gfx_element::gfx_element(device_palette_interface *palette, const gfx_layout &gl
 		m_srcdata(nullptr),
 		m_dirtyseq(1),
 		m_gfxdata(nullptr),
+		m_row_cache(false),
 		m_layout_is_raw(false),
 		m_layout_planes(0),
 		m_layout_xormask(xormask),
@@ -194,12 +196,7 @@ void gfx_element::set_layout(const gfx_layout &gl, const u8 *srcdata)
 	// mark everything dirty
 	m_dirty.resize(m_total_elements);
 	memset(&m_dirty[0], 1, m_total_elements);
-
-	// allocate a pen usage array for entries with 32 pens or less
-	if (m_color_depth <= 32)
-		m_pen_usage.resize(m_total_elements);
-	else
-		m_pen_usage.clear();
+	alloc_pen_summaries();
 }
 
 
@@ -246,10 +243,7 @@ void gfx_element::set_source_and_total(const u8 *source, u32 total)
 	// mark everything dirty
 	m_dirty.resize(m_total_elements);
 	memset(&m_dirty[0], 1, m_total_elements);
-
-	// allocate a pen usage array for entries with 32 pens or less
-	if (m_color_depth <= 32)
-		m_pen_usage.resize(m_total_elements);
+	alloc_pen_summaries();
 
 	if (m_layout_is_raw)
 	{
@@ -282,6 +276,52 @@ void gfx_element::set_source_clip(u32 xoffs, u32 width, u32 yoffs, u32 height)
 }
 
 
+//-------------------------------------------------
+//  set_row_cache - keep the range of pens on
+//  every row, so draws with a transparent pen can
+//  skip transparent rows and copy opaque ones
+//-------------------------------------------------
+
+void gfx_element::set_row_cache(bool enable)
+{
+	// only elements that are decoded on demand can fill the cache
+	if (m_dirty.empty())
+		enable = false;
+
+	m_row_cache = enable;
+	alloc_pen_summaries();
+	if (enable)
+		mark_all_dirty();
+}
+
+
+//-------------------------------------------------
+//  alloc_pen_summaries - size the per-element pen
+//  summaries to the number of elements
+//-------------------------------------------------
+
+void gfx_element::alloc_pen_summaries()
+{
+	// a pen usage bitmask for entries with 32 pens or less, the range of pens used otherwise
+	if (m_color_depth <= 32)
+	{
+		m_pen_usage.resize(m_total_elements);
+		m_pen_range.clear();
+	}
+	else
+	{
+		m_pen_usage.clear();
+		m_pen_range.resize(m_total_elements);
+	}
+
+	// and the range on each row if asked for
+	if (m_row_cache)
+		m_row_pens.resize(m_total_elements * m_origheight);
+	else
+		m_row_pens.clear();
+}
+
+
 //-------------------------------------------------
 //  decode - decode a single character
 //-------------------------------------------------
@@ -317,6 +357,29 @@ void gfx_element::decode(u32 code)
 		}
 	}
 
+	// (re)compute the range of pens used on each row and overall
+	if (m_row_cache || code < m_pen_range.size())
+	{
+		const u8 *dp = m_gfxdata + code * m_char_modulo;
+		u8 lowest = 0xff, highest = 0;
+		for (int y = 0; y < m_origheight; y++)
+		{
+			u8 rowlowest = 0xff, rowhighest = 0;
+			for (int x = 0; x < m_origwidth; x++)
+			{
+				rowlowest = std::min(rowlowest, dp[x]);
+				rowhighest = std::max(rowhighest, dp[x]);
+			}
+			if (m_row_cache)
+				m_row_pens[code * m_origheight + y] = rowlowest | (rowhighest << 8);
+			lowest = std::min(lowest, rowlowest);
+			highest = std::max(highest, rowhighest);
+			dp += m_line_modulo;
+		}
+		if (code < m_pen_range.size())
+			m_pen_range[code] = lowest | (highest << 8);
+	}
+
 	// (re)compute pen usage
 	if (code < m_pen_usage.size())
 	{
@@ -339,6 +402,51 @@ void gfx_element::decode(u32 code)
 }
 
 
+//-------------------------------------------------
+//  draw_row_runs - split a draw with a single
+//  transparent pen into runs of rows that are
+//  all transparent (skipped), all opaque (drawn
+//  with opaque_op) or mixed (drawn with
+//  mixed_op); each op gets the run's cliprect
+//-------------------------------------------------
+
+template <typename OpaqueOp, typename MixedOp>
+void gfx_element::draw_row_runs(const rectangle &cliprect, u32 code, int flipy, s32 desty, u32 trans_pen, OpaqueOp &&opaque_op, MixedOp &&mixed_op)
+{
+	s32 const top = std::max(desty, cliprect.top());
+	s32 const bottom = std::min(desty + height() - 1, cliprect.bottom());
+	if (top > bottom)
+		return;
+
+	// the cache covers whole rows of the unclipped element, which is conservative for a source clip
+	const u16 *const rowpens = &m_row_pens[code * m_origheight + m_starty];
+	rectangle run(cliprect);
+	auto const flush = [&] (s32 start, s32 end, opacity runopacity)
+	{
+		run.sety(start, end);
+		if (runopacity == opacity::OPAQUE)
+			opaque_op(run);
+		else if (runopacity == opacity::MIXED)
+			mixed_op(run);
+	};
+
+	s32 runstart = top;
+	opacity runopacity = opacity::MIXED;
+	for (s32 y = top; y <= bottom; y++)
+	{
+		s32 const row = flipy ? (desty + height() - 1 - y) : (y - desty);
+		opacity const rowopacity = range_opacity(rowpens[row], trans_pen);
+		if (y != top && rowopacity != runopacity)
+		{
+			flush(runstart, y - 1, runopacity);
+			runstart = y;
+		}
+		runopacity = rowopacity;
+	}
+	flush(runstart, bottom, runopacity);
+}
+
+
 
 /***************************************************************************
     DRAWGFX IMPLEMENTATIONS
@@ -354,7 +462,7 @@ void gfx_element::opaque(bitmap_ind16 &dest, const rectangle &cliprect,
 {
 	color = colorbase() + granularity() * (color % colors());
 	code %= elements();
-	drawgfx_core(dest, cliprect, code, flipx, flipy, destx, desty, [color](u16 &destp, const u8 &srcp) { PIXEL_OP_REBASE_OPAQUE(destp, srcp); });
+	drawgfx_core(dest, cliprect, code, flipx, flipy, destx, desty, span_op_rebase(color, gfx_span::all_pens()));
 }
 
 void gfx_element::opaque(bitmap_rgb32 &dest, const rectangle &cliprect,
@@ -362,7 +470,7 @@ void gfx_element::opaque(bitmap_rgb32 &dest, const rectangle &cliprect,
 {
 	const pen_t *paldata = m_palette->pens() + colorbase() + granularity() * (color % colors());
 	code %= elements();
-	drawgfx_core(dest, cliprect, code, flipx, flipy, destx, desty, [paldata](u32 &destp, const u8 &srcp) { PIXEL_OP_REMAP_OPAQUE(destp, srcp); });
+	drawgfx_core(dest, cliprect, code, flipx, flipy, destx, desty, span_op_remap(paldata, gfx_span::all_pens()));
 }
 
 
@@ -379,23 +487,26 @@ void gfx_element::transpen(bitmap_ind16 &dest, const rectangle &cliprect,
 	if (trans_pen > 0xff)
 		return opaque(dest, cliprect, code, color, flipx, flipy, destx, desty);
 
-	// use pen usage to optimize
+	// use the element's opacity to optimize
 	code %= elements();
-	if (has_pen_usage())
-	{
-		// fully transparent; do nothing
-		u32 usage = pen_usage(code);
-		if ((usage & ~(1 << trans_pen)) == 0)
-			return;
+	opacity const tileopacity = pen_opacity(code, trans_pen);
 
-		// fully opaque; draw as such
-		if ((usage & (1 << trans_pen)) == 0)
-			return opaque(dest, cliprect, code, color, flipx, flipy, destx, desty);
-	}
+	// fully transparent; do nothing
+	if (tileopacity == opacity::TRANSPARENT)
+		return;
 
-	// render
+	// fully opaque; draw as such
+	if (tileopacity == opacity::OPAQUE)
+		return opaque(dest, cliprect, code, color, flipx, flipy, destx, desty);
+
+	// render, a run of rows at a time if they are cached
+	u32 const origcolor = color;
 	color = colorbase() + granularity() * (color % colors());
-	drawgfx_core(dest, cliprect, code, flipx, flipy, destx, desty, [trans_pen, color](u16 &destp, const u8 &srcp) { PIXEL_OP_REBASE_TRANSPEN(destp, srcp); });
+	auto const mixed = [&] (const rectangle &clip) { drawgfx_core(dest, clip, code, flipx, flipy, destx, desty, span_op_rebase(color, gfx_span::trans_pen(trans_pen))); };
+	if (m_row_cache)
+		draw_row_runs(cliprect, code, flipy, desty, trans_pen, [&] (const rectangle &clip) { opaque(dest, clip, code, origcolor, flipx, flipy, destx, desty); }, mixed);
+	else
+		mixed(cliprect);
 }
 
 void gfx_element::transpen(bitmap_rgb32 &dest, const rectangle &cliprect,
@@ -406,23 +517,25 @@ void gfx_element::transpen(bitmap_rgb32 &dest, const rectangle &cliprect,
 	if (trans_pen > 0xff)
 		return opaque(dest, cliprect, code, color, flipx, flipy, destx, desty);
 
-	// use pen usage to optimize
+	// use the element's opacity to optimize
 	code %= elements();
-	if (has_pen_usage())
-	{
-		// fully transparent; do nothing
-		u32 usage = pen_usage(code);
-		if ((usage & ~(1 << trans_pen)) == 0)
-			return;
+	opacity const tileopacity = pen_opacity(code, trans_pen);
 
-		// fully opaque; draw as such
-		if ((usage & (1 << trans_pen)) == 0)
-			return opaque(dest, cliprect, code, color, flipx, flipy, destx, desty);
-	}
+	// fully transparent; do nothing
+	if (tileopacity == opacity::TRANSPARENT)
+		return;
 
-	// render
+	// fully opaque; draw as such
+	if (tileopacity == opacity::OPAQUE)
+		return opaque(dest, cliprect, code, color, flipx, flipy, destx, desty);
+
+	// render, a run of rows at a time if they are cached
 	const pen_t *paldata = m_palette->pens() + colorbase() + granularity() * (color % colors());
-	drawgfx_core(dest, cliprect, code, flipx, flipy, destx, desty, [trans_pen, paldata](u32 &destp, const u8 &srcp) { PIXEL_OP_REMAP_TRANSPEN(destp, srcp); });
+	auto const mixed = [&] (const rectangle &clip) { drawgfx_core(dest, clip, code, flipx, flipy, destx, desty, span_op_remap(paldata, gfx_span::trans_pen(trans_pen))); };
+	if (m_row_cache)
+		draw_row_runs(cliprect, code, flipy, desty, trans_pen, [&] (const rectangle &clip) { opaque(dest, clip, code, color, flipx, flipy, destx, desty); }, mixed);
+	else
+		mixed(cliprect);
 }
 
 
@@ -438,11 +551,11 @@ void gfx_element::transpen_raw(bitmap_ind16 &dest, const rectangle &cliprect,
 {
 	// early out if completely transparent
 	code %= elements();
-	if (has_pen_usage() && (pen_usage(code) & ~(1 << trans_pen)) == 0)
+	if (pen_opacity(code, trans_pen) == opacity::TRANSPARENT)
 		return;
 
 	// render
-	drawgfx_core(dest, cliprect, code, flipx, flipy, destx, desty, [trans_pen, color](u16 &destp, const u8 &srcp) { PIXEL_OP_REBASE_TRANSPEN(destp, srcp); });
+	drawgfx_core(dest, cliprect, code, flipx, flipy, destx, desty, span_op_rebase(color, gfx_span::trans_pen(trans_pen)));
 }
 
 void gfx_element::transpen_raw(bitmap_rgb32 &dest, const rectangle &cliprect,
@@ -451,7 +564,7 @@ void gfx_element::transpen_raw(bitmap_rgb32 &dest, const rectangle &cliprect,
 {
 	// early out if completely transparent
 	code %= elements();
-	if (has_pen_usage() && (pen_usage(code) & ~(1 << trans_pen)) == 0)
+	if (pen_opacity(code, trans_pen) == opacity::TRANSPARENT)
 		return;
 
 	// render
@@ -489,7 +602,7 @@ void gfx_element::transmask(bitmap_ind16 &dest, const rectangle &cliprect,
 
 	// render
 	color = colorbase() + granularity() * (color % colors());
-	drawgfx_core(dest, cliprect, code, flipx, flipy, destx, desty, [trans_mask, color](u16 &destp, const u8 &srcp) { PIXEL_OP_REBASE_TRANSMASK(destp, srcp); });
+	drawgfx_core(dest, cliprect, code, flipx, flipy, destx, desty, span_op_rebase(color, gfx_span::trans_mask(trans_mask)));
 }
 
 void gfx_element::transmask(bitmap_rgb32 &dest, const rectangle &cliprect,
@@ -516,7 +629,7 @@ void gfx_element::transmask(bitmap_rgb32 &dest, const rectangle &cliprect,
 
 	// render
 	const pen_t *paldata = m_palette->pens() + colorbase() + granularity() * (color % colors());
-	drawgfx_core(dest, cliprect, code, flipx, flipy, destx, desty, [trans_mask, paldata](u32 &destp, const u8 &srcp) { PIXEL_OP_REMAP_TRANSMASK(destp, srcp); });
+	drawgfx_core(dest, cliprect, code, flipx, flipy, destx, desty, span_op_remap(paldata, gfx_span::trans_mask(trans_mask)));
 }
 
 
@@ -569,12 +682,12 @@ void gfx_element::alpha(bitmap_rgb32 &dest, const rectangle &cliprect,
 
 	// early out if completely transparent
 	code %= elements();
-	if (has_pen_usage() && (pen_usage(code) & ~(1 << trans_pen)) == 0)
+	if (pen_opacity(code, trans_pen) == opacity::TRANSPARENT)
 		return;
 
 	// get final code and color, and grab lookup tables
 	const pen_t *paldata = m_palette->pens() + colorbase() + granularity() * (color % colors());
-	drawgfx_core(dest, cliprect, code, flipx, flipy, destx, desty, [trans_pen, alpha_val, paldata](u32 &destp, const u8 &srcp) { PIXEL_OP_REMAP_TRANSPEN_ALPHA32(destp, srcp); });
+	drawgfx_core(dest, cliprect, code, flipx, flipy, destx, desty, span_op_alpha(paldata, gfx_span::trans_pen(trans_pen), alpha_val));
 }
 
 
@@ -599,7 +712,7 @@ void gfx_element::zoom_opaque(bitmap_ind16 &dest, const rectangle &cliprect,
 	// render
 	color = colorbase() + granularity() * (color % colors());
 	code %= elements();
-	drawgfxzoom_core(dest, cliprect, code, flipx, flipy, destx, desty, scalex, scaley, [color](u16 &destp, const u8 &srcp) { PIXEL_OP_REBASE_OPAQUE(destp, srcp); });
+	drawgfxzoom_core(dest, cliprect, code, flipx, flipy, destx, desty, scalex, scaley, span_op_rebase(color, gfx_span::all_pens()));
 }
 
 void gfx_element::zoom_opaque(bitmap_rgb32 &dest, const rectangle &cliprect,
@@ -613,7 +726,7 @@ void gfx_element::zoom_opaque(bitmap_rgb32 &dest, const rectangle &cliprect,
 	// render
 	const pen_t *paldata = m_palette->pens() + colorbase() + granularity() * (color % colors());
 	code %= elements();
-	drawgfxzoom_core(dest, cliprect, code, flipx, flipy, destx, desty, scalex, scaley, [paldata](u32 &destp, const u8 &srcp) { PIXEL_OP_REMAP_OPAQUE(destp, srcp); });
+	drawgfxzoom_core(dest, cliprect, code, flipx, flipy, destx, desty, scalex, scaley, span_op_remap(paldata, gfx_span::all_pens()));
 }
 
 
@@ -634,23 +747,21 @@ void gfx_element::zoom_transpen(bitmap_ind16 &dest, const rectangle &cliprect,
 	if (trans_pen > 0xff)
 		return zoom_opaque(dest, cliprect, code, color, flipx, flipy, destx, desty, scalex, scaley);
 
-	// use pen usage to optimize
+	// use the element's opacity to optimize
 	code %= elements();
-	if (has_pen_usage())
-	{
-		// fully transparent; do nothing
-		u32 usage = pen_usage(code);
-		if ((usage & ~(1 << trans_pen)) == 0)
-			return;
+	opacity const tileopacity = pen_opacity(code, trans_pen);
 
-		// fully opaque; draw as such
-		if ((usage & (1 << trans_pen)) == 0)
-			return zoom_opaque(dest, cliprect, code, color, flipx, flipy, destx, desty, scalex, scaley);
-	}
+	// fully transparent; do nothing
+	if (tileopacity == opacity::TRANSPARENT)
+		return;
+
+	// fully opaque; draw as such
+	if (tileopacity == opacity::OPAQUE)
+		return zoom_opaque(dest, cliprect, code, color, flipx, flipy, destx, desty, scalex, scaley);
 
 	// render
 	color = colorbase() + granularity() * (color % colors());
-	drawgfxzoom_core(dest, cliprect, code, flipx, flipy, destx, desty, scalex, scaley, [trans_pen, color](u16 &destp, const u8 &srcp) { PIXEL_OP_REBASE_TRANSPEN(destp, srcp); });
+	drawgfxzoom_core(dest, cliprect, code, flipx, flipy, destx, desty, scalex, scaley, span_op_rebase(color, gfx_span::trans_pen(trans_pen)));
 }
 
 void gfx_element::zoom_transpen(bitmap_rgb32 &dest, const rectangle &cliprect,
@@ -665,23 +776,21 @@ void gfx_element::zoom_transpen(bitmap_rgb32 &dest, const rectangle &cliprect,
 	if (trans_pen > 0xff)
 		return zoom_opaque(dest, cliprect, code, color, flipx, flipy, destx, desty, scalex, scaley);
 
-	// use pen usage to optimize
+	// use the element's opacity to optimize
 	code %= elements();
-	if (has_pen_usage())
-	{
-		// fully transparent; do nothing
-		u32 usage = pen_usage(code);
-		if ((usage & ~(1 << trans_pen)) == 0)
-			return;
+	opacity const tileopacity = pen_opacity(code, trans_pen);
 
-		// fully opaque; draw as such
-		if ((usage & (1 << trans_pen)) == 0)
-			return zoom_opaque(dest, cliprect, code, color, flipx, flipy, destx, desty, scalex, scaley);
-	}
+	// fully transparent; do nothing
+	if (tileopacity == opacity::TRANSPARENT)
+		return;
+
+	// fully opaque; draw as such
+	if (tileopacity == opacity::OPAQUE)
+		return zoom_opaque(dest, cliprect, code, color, flipx, flipy, destx, desty, scalex, scaley);
 
 	// render
 	const pen_t *paldata = m_palette->pens() + colorbase() + granularity() * (color % colors());
-	drawgfxzoom_core(dest, cliprect, code, flipx, flipy, destx, desty, scalex, scaley, [trans_pen, paldata](u32 &destp, const u8 &srcp) { PIXEL_OP_REMAP_TRANSPEN(destp, srcp); });
+	drawgfxzoom_core(dest, cliprect, code, flipx, flipy, destx, desty, scalex, scaley, span_op_remap(paldata, gfx_span::trans_pen(trans_pen)));
 }
 
 
@@ -701,11 +810,11 @@ void gfx_element::zoom_transpen_raw(bitmap_ind16 &dest, const rectangle &cliprec
 
 	// early out if completely transparent
 	code %= elements();
-	if (has_pen_usage() && (pen_usage(code) & ~(1 << trans_pen)) == 0)
+	if (pen_opacity(code, trans_pen) == opacity::TRANSPARENT)
 		return;
 
 	// render
-	drawgfxzoom_core(dest, cliprect, code, flipx, flipy, destx, desty, scalex, scaley, [trans_pen, color](u16 &destp, const u8 &srcp) { PIXEL_OP_REBASE_TRANSPEN(destp, srcp); });
+	drawgfxzoom_core(dest, cliprect, code, flipx, flipy, destx, desty, scalex, scaley, span_op_rebase(color, gfx_span::trans_pen(trans_pen)));
 }
 
 void gfx_element::zoom_transpen_raw(bitmap_rgb32 &dest, const rectangle &cliprect,
@@ -718,7 +827,7 @@ void gfx_element::zoom_transpen_raw(bitmap_rgb32 &dest, const rectangle &cliprec
 
 	// early out if completely transparent
 	code %= elements();
-	if (has_pen_usage() && (pen_usage(code) & ~(1 << trans_pen)) == 0)
+	if (pen_opacity(code, trans_pen) == opacity::TRANSPARENT)
 		return;
 
 	// render
@@ -760,7 +869,7 @@ void gfx_element::zoom_transmask(bitmap_ind16 &dest, const rectangle &cliprect,
 
 	// render
 	color = colorbase() + granularity() * (color % colors());
-	drawgfxzoom_core(dest, cliprect, code, flipx, flipy, destx, desty, scalex, scaley, [trans_mask, color](u16 &destp, const u8 &srcp) { PIXEL_OP_REBASE_TRANSMASK(destp, srcp); });
+	drawgfxzoom_core(dest, cliprect, code, flipx, flipy, destx, desty, scalex, scaley, span_op_rebase(color, gfx_span::trans_mask(trans_mask)));
 }
 
 void gfx_element::zoom_transmask(bitmap_rgb32 &dest, const rectangle &cliprect,
@@ -791,7 +900,7 @@ void gfx_element::zoom_transmask(bitmap_rgb32 &dest, const rectangle &cliprect,
 
 	// render
 	const pen_t *paldata = m_palette->pens() + colorbase() + granularity() * (color % colors());
-	drawgfxzoom_core(dest, cliprect, code, flipx, flipy, destx, desty, scalex, scaley, [trans_mask, paldata](u32 &destp, const u8 &srcp) { PIXEL_OP_REMAP_TRANSMASK(destp, srcp); });
+	drawgfxzoom_core(dest, cliprect, code, flipx, flipy, destx, desty, scalex, scaley, span_op_remap(paldata, gfx_span::trans_mask(trans_mask)));
 }
 
 
@@ -856,12 +965,12 @@ void gfx_element::zoom_alpha(bitmap_rgb32 &dest, const rectangle &cliprect,
 
 	// early out if completely transparent
 	code %= elements();
-	if (has_pen_usage() && (pen_usage(code) & ~(1 << trans_pen)) == 0)
+	if (pen_opacity(code, trans_pen) == opacity::TRANSPARENT)
 		return;
 
 	// render
 	const pen_t *paldata = m_palette->pens() + colorbase() + granularity() * (color % colors());
-	drawgfxzoom_core(dest, cliprect, code, flipx, flipy, destx, desty, scalex, scaley, [trans_pen, alpha_val, paldata](u32 &destp, const u8 &srcp) { PIXEL_OP_REMAP_TRANSPEN_ALPHA32(destp, srcp); });
+	drawgfxzoom_core(dest, cliprect, code, flipx, flipy, destx, desty, scalex, scaley, span_op_alpha(paldata, gfx_span::trans_pen(trans_pen), alpha_val));
 }
 
 
@@ -886,7 +995,7 @@ void gfx_element::prio_opaque(bitmap_ind16 &dest, const rectangle &cliprect,
 	// render
 	color = colorbase() + granularity() * (color % colors());
 	code %= elements();
-	drawgfx_core(dest, cliprect, code, flipx, flipy, destx, desty, priority, [pmask, color](u16 &destp, u8 &pri, const u8 &srcp) { PIXEL_OP_REBASE_OPAQUE_PRIORITY(destp, pri, srcp); });
+	drawgfx_core(dest, cliprect, code, flipx, flipy, destx, desty, priority, span_op_rebase_priority(color, gfx_span::all_pens(), pmask));
 }
 
 void gfx_element::prio_opaque(bitmap_rgb32 &dest, const rectangle &cliprect,
@@ -899,7 +1008,7 @@ void gfx_element::prio_opaque(bitmap_rgb32 &dest, const rectangle &cliprect,
 	// render
 	const pen_t *paldata = m_palette->pens() + colorbase() + granularity() * (color % colors());
 	code %= elements();
-	drawgfx_core(dest, cliprect, code, flipx, flipy, destx, desty, priority, [pmask, paldata](u32 &destp, u8 &pri, const u8 &srcp) { PIXEL_OP_REMAP_OPAQUE_PRIORITY(destp, pri, srcp); });
+	drawgfx_core(dest, cliprect, code, flipx, flipy, destx, desty, priority, span_op_remap_priority(paldata, gfx_span::all_pens(), pmask));
 }
 
 
@@ -917,26 +1026,29 @@ void gfx_element::prio_transpen(bitmap_ind16 &dest, const rectangle &cliprect,
 	if (trans_pen > 0xff)
 		return prio_opaque(dest, cliprect, code, color, flipx, flipy, destx, desty, priority, pmask);
 
-	// use pen usage to optimize
+	// use the element's opacity to optimize
 	code %= elements();
-	if (has_pen_usage())
-	{
-		// fully transparent; do nothing
-		u32 usage = pen_usage(code);
-		if ((usage & ~(1 << trans_pen)) == 0)
-			return;
+	opacity const tileopacity = pen_opacity(code, trans_pen);
 
-		// fully opaque; draw as such
-		if ((usage & (1 << trans_pen)) == 0)
-			return prio_opaque(dest, cliprect, code, color, flipx, flipy, destx, desty, priority, pmask);
-	}
+	// fully transparent; do nothing
+	if (tileopacity == opacity::TRANSPARENT)
+		return;
+
+	// fully opaque; draw as such
+	if (tileopacity == opacity::OPAQUE)
+		return prio_opaque(dest, cliprect, code, color, flipx, flipy, destx, desty, priority, pmask);
 
 	// high bit of the mask is implicitly on
+	u32 const origcolor = color;
 	pmask |= 1 << 31;
 
-	// render
+	// render, a run of rows at a time if they are cached
 	color = colorbase() + granularity() * (color % colors());
-	drawgfx_core(dest, cliprect, code, flipx, flipy, destx, desty, priority, [pmask, trans_pen, color](u16 &destp, u8 &pri, const u8 &srcp) { PIXEL_OP_REBASE_TRANSPEN_PRIORITY(destp, pri, srcp); });
+	auto const mixed = [&] (const rectangle &clip) { drawgfx_core(dest, clip, code, flipx, flipy, destx, desty, priority, span_op_rebase_priority(color, gfx_span::trans_pen(trans_pen), pmask)); };
+	if (m_row_cache)
+		draw_row_runs(cliprect, code, flipy, desty, trans_pen, [&] (const rectangle &clip) { prio_opaque(dest, clip, code, origcolor, flipx, flipy, destx, desty, priority, pmask); }, mixed);
+	else
+		mixed(cliprect);
 }
 
 void gfx_element::prio_transpen(bitmap_rgb32 &dest, const rectangle &cliprect,
@@ -947,26 +1059,28 @@ void gfx_element::prio_transpen(bitmap_rgb32 &dest, const rectangle &cliprect,
 	if (trans_pen > 0xff)
 		return prio_opaque(dest, cliprect, code, color, flipx, flipy, destx, desty, priority, pmask);
 
-	// use pen usage to optimize
+	// use the element's opacity to optimize
 	code %= elements();
-	if (has_pen_usage())
-	{
-		// fully transparent; do nothing
-		u32 usage = pen_usage(code);
-		if ((usage & ~(1 << trans_pen)) == 0)
-			return;
+	opacity const tileopacity = pen_opacity(code, trans_pen);
 
-		// fully opaque; draw as such
-		if ((usage & (1 << trans_pen)) == 0)
-			return prio_opaque(dest, cliprect, code, color, flipx, flipy, destx, desty, priority, pmask);
-	}
+	// fully transparent; do nothing
+	if (tileopacity == opacity::TRANSPARENT)
+		return;
+
+	// fully opaque; draw as such
+	if (tileopacity == opacity::OPAQUE)
+		return prio_opaque(dest, cliprect, code, color, flipx, flipy, destx, desty, priority, pmask);
 
 	// high bit of the mask is implicitly on
 	pmask |= 1 << 31;
 
-	// render
+	// render, a run of rows at a time if they are cached
 	const pen_t *paldata = m_palette->pens() + colorbase() + granularity() * (color % colors());
-	drawgfx_core(dest, cliprect, code, flipx, flipy, destx, desty, priority, [pmask, trans_pen, paldata](u32 &destp, u8 &pri, const u8 &srcp) { PIXEL_OP_REMAP_TRANSPEN_PRIORITY(destp, pri, srcp); });
+	auto const mixed = [&] (const rectangle &clip) { drawgfx_core(dest, clip, code, flipx, flipy, destx, desty, priority, span_op_remap_priority(paldata, gfx_span::trans_pen(trans_pen), pmask)); };
+	if (m_row_cache)
+		draw_row_runs(cliprect, code, flipy, desty, trans_pen, [&] (const rectangle &clip) { prio_opaque(dest, clip, code, color, flipx, flipy, destx, desty, priority, pmask); }, mixed);
+	else
+		mixed(cliprect);
 }
 
 
@@ -982,14 +1096,14 @@ void gfx_element::prio_transpen_raw(bitmap_ind16 &dest, const rectangle &cliprec
 {
 	// early out if completely transparent
 	code %= elements();
-	if (has_pen_usage() && (pen_usage(code) & ~(1 << trans_pen)) == 0)
+	if (pen_opacity(code, trans_pen) == opacity::TRANSPARENT)
 		return;
 
 	// high bit of the mask is implicitly on
 	pmask |= 1 << 31;
 
 	// render
-	drawgfx_core(dest, cliprect, code, flipx, flipy, destx, desty, priority, [pmask, trans_pen, color](u16 &destp, u8 &pri, const u8 &srcp) { PIXEL_OP_REBASE_TRANSPEN_PRIORITY(destp, pri, srcp); });
+	drawgfx_core(dest, cliprect, code, flipx, flipy, destx, desty, priority, span_op_rebase_priority(color, gfx_span::trans_pen(trans_pen), pmask));
 }
 
 void gfx_element::prio_transpen_raw(bitmap_rgb32 &dest, const rectangle &cliprect,
@@ -998,7 +1112,7 @@ void gfx_element::prio_transpen_raw(bitmap_rgb32 &dest, const rectangle &cliprec
 {
 	// early out if completely transparent
 	code %= elements();
-	if (has_pen_usage() && (pen_usage(code) & ~(1 << trans_pen)) == 0)
+	if (pen_opacity(code, trans_pen) == opacity::TRANSPARENT)
 		return;
 
 	// high bit of the mask is implicitly on
@@ -1042,7 +1156,7 @@ void gfx_element::prio_transmask(bitmap_ind16 &dest, const rectangle &cliprect,
 
 	// render
 	color = colorbase() + granularity() * (color % colors());
-	drawgfx_core(dest, cliprect, code, flipx, flipy, destx, desty, priority, [pmask, trans_mask, color](u16 &destp, u8 &pri, const u8 &srcp) { PIXEL_OP_REBASE_TRANSMASK_PRIORITY(destp, pri, srcp); });
+	drawgfx_core(dest, cliprect, code, flipx, flipy, destx, desty, priority, span_op_rebase_priority(color, gfx_span::trans_mask(trans_mask), pmask));
 }
 
 void gfx_element::prio_transmask(bitmap_rgb32 &dest, const rectangle &cliprect,
@@ -1072,7 +1186,7 @@ void gfx_element::prio_transmask(bitmap_rgb32 &dest, const rectangle &cliprect,
 
 	// render
 	const pen_t *paldata = m_palette->pens() + colorbase() + granularity() * (color % colors());
-	drawgfx_core(dest, cliprect, code, flipx, flipy, destx, desty, priority, [pmask, trans_mask, paldata](u32 &destp, u8 &pri, const u8 &srcp) { PIXEL_OP_REMAP_TRANSMASK_PRIORITY(destp, pri, srcp); });
+	drawgfx_core(dest, cliprect, code, flipx, flipy, destx, desty, priority, span_op_remap_priority(paldata, gfx_span::trans_mask(trans_mask), pmask));
 }
 
 
@@ -1133,7 +1247,7 @@ void gfx_element::prio_alpha(bitmap_rgb32 &dest, const rectangle &cliprect,
 
 	// early out if completely transparent
 	code %= elements();
-	if (has_pen_usage() && (pen_usage(code) & ~(1 << trans_pen)) == 0)
+	if (pen_opacity(code, trans_pen) == opacity::TRANSPARENT)
 		return;
 
 	// high bit of the mask is implicitly on
@@ -1141,7 +1255,7 @@ void gfx_element::prio_alpha(bitmap_rgb32 &dest, const rectangle &cliprect,
 
 	// render
 	const pen_t *paldata = m_palette->pens() + colorbase() + granularity() * (color % colors());
-	drawgfx_core(dest, cliprect, code, flipx, flipy, destx, desty, priority, [pmask, trans_pen, alpha_val, paldata](u32 &destp, u8 &pri, const u8 &srcp) { PIXEL_OP_REMAP_TRANSPEN_ALPHA32_PRIORITY(destp, pri, srcp); });
+	drawgfx_core(dest, cliprect, code, flipx, flipy, destx, desty, priority, span_op_alpha_priority(paldata, gfx_span::trans_pen(trans_pen), pmask, alpha_val));
 }
 
 
@@ -1170,7 +1284,7 @@ void gfx_element::prio_zoom_opaque(bitmap_ind16 &dest, const rectangle &cliprect
 	// render
 	color = colorbase() + granularity() * (color % colors());
 	code %= elements();
-	drawgfxzoom_core(dest, cliprect, code, flipx, flipy, destx, desty, scalex, scaley, priority, [pmask, color](u16 &destp, u8 &pri, const u8 &srcp) { PIXEL_OP_REBASE_OPAQUE_PRIORITY(destp, pri, srcp); });
+	drawgfxzoom_core(dest, cliprect, code, flipx, flipy, destx, desty, scalex, scaley, priority, span_op_rebase_priority(color, gfx_span::all_pens(), pmask));
 }
 
 void gfx_element::prio_zoom_opaque(bitmap_rgb32 &dest, const rectangle &cliprect,
@@ -1187,7 +1301,7 @@ void gfx_element::prio_zoom_opaque(bitmap_rgb32 &dest, const rectangle &cliprect
 	// render
 	const pen_t *paldata = m_palette->pens() + colorbase() + granularity() * (color % colors());
 	code %= elements();
-	drawgfxzoom_core(dest, cliprect, code, flipx, flipy, destx, desty, scalex, scaley, priority, [pmask, paldata](u32 &destp, u8 &pri, const u8 &srcp) { PIXEL_OP_REMAP_OPAQUE_PRIORITY(destp, pri, srcp); });
+	drawgfxzoom_core(dest, cliprect, code, flipx, flipy, destx, desty, scalex, scaley, priority, span_op_remap_priority(paldata, gfx_span::all_pens(), pmask));
 }
 
 
@@ -1210,26 +1324,24 @@ void gfx_element::prio_zoom_transpen(bitmap_ind16 &dest, const rectangle &clipre
 	if (trans_pen > 0xff)
 		return prio_zoom_opaque(dest, cliprect, code, color, flipx, flipy, destx, desty, scalex, scaley, priority, pmask);
 
-	// use pen usage to optimize
+	// use the element's opacity to optimize
 	code %= elements();
-	if (has_pen_usage())
-	{
-		// fully transparent; do nothing
-		u32 usage = pen_usage(code);
-		if ((usage & ~(1 << trans_pen)) == 0)
-			return;
+	opacity const tileopacity = pen_opacity(code, trans_pen);
 
-		// fully opaque; draw as such
-		if ((usage & (1 << trans_pen)) == 0)
-			return prio_zoom_opaque(dest, cliprect, code, color, flipx, flipy, destx, desty, scalex, scaley, priority, pmask);
-	}
+	// fully transparent; do nothing
+	if (tileopacity == opacity::TRANSPARENT)
+		return;
+
+	// fully opaque; draw as such
+	if (tileopacity == opacity::OPAQUE)
+		return prio_zoom_opaque(dest, cliprect, code, color, flipx, flipy, destx, desty, scalex, scaley, priority, pmask);
 
 	// high bit of the mask is implicitly on
 	pmask |= 1 << 31;
 
 	// render
 	color = colorbase() + granularity() * (color % colors());
-	drawgfxzoom_core(dest, cliprect, code, flipx, flipy, destx, desty, scalex, scaley, priority, [pmask, trans_pen, color](u16 &destp, u8 &pri, const u8 &srcp) { PIXEL_OP_REBASE_TRANSPEN_PRIORITY(destp, pri, srcp); });
+	drawgfxzoom_core(dest, cliprect, code, flipx, flipy, destx, desty, scalex, scaley, priority, span_op_rebase_priority(color, gfx_span::trans_pen(trans_pen), pmask));
 }
 
 void gfx_element::prio_zoom_transpen(bitmap_rgb32 &dest, const rectangle &cliprect,
@@ -1245,26 +1357,24 @@ void gfx_element::prio_zoom_transpen(bitmap_rgb32 &dest, const rectangle &clipre
 	if (trans_pen > 0xff)
 		return prio_zoom_opaque(dest, cliprect, code, color, flipx, flipy, destx, desty, scalex, scaley, priority, pmask);
 
-	// use pen usage to optimize
+	// use the element's opacity to optimize
 	code %= elements();
-	if (has_pen_usage())
-	{
-		// fully transparent; do nothing
-		u32 usage = pen_usage(code);
-		if ((usage & ~(1 << trans_pen)) == 0)
-			return;
+	opacity const tileopacity = pen_opacity(code, trans_pen);
 
-		// fully opaque; draw as such
-		if ((usage & (1 << trans_pen)) == 0)
-			return prio_zoom_opaque(dest, cliprect, code, color, flipx, flipy, destx, desty, scalex, scaley, priority, pmask);
-	}
+	// fully transparent; do nothing
+	if (tileopacity == opacity::TRANSPARENT)
+		return;
+
+	// fully opaque; draw as such
+	if (tileopacity == opacity::OPAQUE)
+		return prio_zoom_opaque(dest, cliprect, code, color, flipx, flipy, destx, desty, scalex, scaley, priority, pmask);
 
 	// high bit of the mask is implicitly on
 	pmask |= 1 << 31;
 
 	// render
 	const pen_t *paldata = m_palette->pens() + colorbase() + granularity() * (color % colors());
-	drawgfxzoom_core(dest, cliprect, code, flipx, flipy, destx, desty, scalex, scaley, priority, [pmask, trans_pen, paldata](u32 &destp, u8 &pri, const u8 &srcp) { PIXEL_OP_REMAP_TRANSPEN_PRIORITY(destp, pri, srcp); });
+	drawgfxzoom_core(dest, cliprect, code, flipx, flipy, destx, desty, scalex, scaley, priority, span_op_remap_priority(paldata, gfx_span::trans_pen(trans_pen), pmask));
 }
 
 
@@ -1286,14 +1396,14 @@ void gfx_element::prio_zoom_transpen_raw(bitmap_ind16 &dest, const rectangle &cl
 
 	// early out if completely transparent
 	code %= elements();
-	if (has_pen_usage() && (pen_usage(code) & ~(1 << trans_pen)) == 0)
+	if (pen_opacity(code, trans_pen) == opacity::TRANSPARENT)
 		return;
 
 	// high bit of the mask is implicitly on
 	pmask |= 1 << 31;
 
 	// render
-	drawgfxzoom_core(dest, cliprect, code, flipx, flipy, destx, desty, scalex, scaley, priority, [pmask, trans_pen, color](u16 &destp, u8 &pri, const u8 &srcp) { PIXEL_OP_REBASE_TRANSPEN_PRIORITY(destp, pri, srcp); });
+	drawgfxzoom_core(dest, cliprect, code, flipx, flipy, destx, desty, scalex, scaley, priority, span_op_rebase_priority(color, gfx_span::trans_pen(trans_pen), pmask));
 }
 
 void gfx_element::prio_zoom_transpen_raw(bitmap_rgb32 &dest, const rectangle &cliprect,
@@ -1307,7 +1417,7 @@ void gfx_element::prio_zoom_transpen_raw(bitmap_rgb32 &dest, const rectangle &cl
 
 	// early out if completely transparent
 	code %= elements();
-	if (has_pen_usage() && (pen_usage(code) & ~(1 << trans_pen)) == 0)
+	if (pen_opacity(code, trans_pen) == opacity::TRANSPARENT)
 		return;
 
 	// high bit of the mask is implicitly on
@@ -1357,7 +1467,7 @@ void gfx_element::prio_zoom_transmask(bitmap_ind16 &dest, const rectangle &clipr
 
 	// render
 	color = colorbase() + granularity() * (color % colors());
-	drawgfxzoom_core(dest, cliprect, code, flipx, flipy, destx, desty, scalex, scaley, priority, [pmask, trans_mask, color](u16 &destp, u8 &pri, const u8 &srcp) { PIXEL_OP_REBASE_TRANSMASK_PRIORITY(destp, pri, srcp); });
+	drawgfxzoom_core(dest, cliprect, code, flipx, flipy, destx, desty, scalex, scaley, priority, span_op_rebase_priority(color, gfx_span::trans_mask(trans_mask), pmask));
 }
 
 void gfx_element::prio_zoom_transmask(bitmap_rgb32 &dest, const rectangle &cliprect,
@@ -1392,7 +1502,7 @@ void gfx_element::prio_zoom_transmask(bitmap_rgb32 &dest, const rectangle &clipr
 
 	// render
 	const pen_t *paldata = m_palette->pens() + colorbase() + granularity() * (color % colors());
-	drawgfxzoom_core(dest, cliprect, code, flipx, flipy, destx, desty, scalex, scaley, priority, [pmask, trans_mask, paldata](u32 &destp, u8 &pri, const u8 &srcp) { PIXEL_OP_REMAP_TRANSMASK_PRIORITY(destp, pri, srcp); });
+	drawgfxzoom_core(dest, cliprect, code, flipx, flipy, destx, desty, scalex, scaley, priority, span_op_remap_priority(paldata, gfx_span::trans_mask(trans_mask), pmask));
 }
 
 
@@ -1469,7 +1579,7 @@ void gfx_element::prio_zoom_alpha(bitmap_rgb32 &dest, const rectangle &cliprect,
 
 	// early out if completely transparent
 	code %= elements();
-	if (has_pen_usage() && (pen_usage(code) & ~(1 << trans_pen)) == 0)
+	if (pen_opacity(code, trans_pen) == opacity::TRANSPARENT)
 		return;
 
 	// high bit of the mask is implicitly on
@@ -1477,7 +1587,7 @@ void gfx_element::prio_zoom_alpha(bitmap_rgb32 &dest, const rectangle &cliprect,
 
 	// render
 	const pen_t *paldata = m_palette->pens() + colorbase() + granularity() * (color % colors());
-	drawgfxzoom_core(dest, cliprect, code, flipx, flipy, destx, desty, scalex, scaley, priority, [pmask, trans_pen, alpha_val, paldata](u32 &destp, u8 &pri, const u8 &srcp) { PIXEL_OP_REMAP_TRANSPEN_ALPHA32_PRIORITY(destp, pri, srcp); });
+	drawgfxzoom_core(dest, cliprect, code, flipx, flipy, destx, desty, scalex, scaley, priority, span_op_alpha_priority(paldata, gfx_span::trans_pen(trans_pen), pmask, alpha_val));
 }
 
 
@@ -1508,15 +1618,9 @@ void gfx_element::prio_transpen_additive(bitmap_rgb32 &dest, const rectangle &cl
 	color %= colors();
 	paldata = m_palette->pens() + colorbase() + granularity() * color;
 
-	/* use pen usage to optimize */
-	if (has_pen_usage())
-	{
-		u32 usage = pen_usage(code);
-
-		/* fully transparent; do nothing */
-		if ((usage & ~(1 << trans_pen)) == 0)
-			return;
-	}
+	/* fully transparent; do nothing */
+	if (pen_opacity(code, trans_pen) == opacity::TRANSPARENT)
+		return;
 
 	/* high bit of the mask is implicitly on */
 	pmask |= 1 << 31;
@@ -1549,15 +1653,9 @@ void gfx_element::prio_zoom_transpen_additive(bitmap_rgb32 &dest, const rectangl
 	color %= colors();
 	paldata = m_palette->pens() + colorbase() + granularity() * color;
 
-	/* use pen usage to optimize */
-	if (has_pen_usage())
-	{
-		u32 usage = pen_usage(code);
-
-		/* fully transparent; do nothing */
-		if ((usage & ~(1 << trans_pen)) == 0)
-			return;
-	}
+	/* fully transparent; do nothing */
+	if (pen_opacity(code, trans_pen) == opacity::TRANSPARENT)
+		return;
 
 	/* high bit of the mask is implicitly on */
 	pmask |= 1 << 31;
@@ -148,6 +148,14 @@ enum
 class gfx_element
 {
 public:
+	// how much of an element (or a row of one) a single transparent pen leaves visible
+	enum class opacity : u8
+	{
+		MIXED,
+		OPAQUE,
+		TRANSPARENT
+	};
+
 	// construction/destruction
 #ifdef UNUSED_FUNCTION
 	gfx_element();
@@ -166,6 +174,7 @@ public:
 	u32 colors() const { return m_total_colors; }
 	u32 rowbytes() const { return m_line_modulo; }
 	bool has_pen_usage() const { return !m_pen_usage.empty(); }
+	bool has_row_cache() const { return m_row_cache; }
 	bool has_palette() const { return m_palette; }
 
 	// used by tilemaps
@@ -182,6 +191,7 @@ public:
 	void set_colorbase(u16 colorbase) { m_color_base = colorbase; }
 	void set_granularity(u16 granularity) { m_color_granularity = granularity; }
 	void set_source_clip(u32 xoffs, u32 width, u32 yoffs, u32 height);
+	void set_row_cache(bool enable);
 
 	// operations
 	void mark_dirty(u32 code) { if (code < elements()) { m_dirty[code] = 1; m_dirtyseq++; } }
@@ -201,6 +211,25 @@ public:
 		return m_pen_usage[code];
 	}
 
+	opacity pen_opacity(u32 code, u32 trans_pen)
+	{
+		// exact for elements with 32 pens or less
+		if (has_pen_usage())
+		{
+			u32 const usage = pen_usage(code);
+			u32 const transbit = (trans_pen < 32) ? (1U << trans_pen) : 0;
+			if ((usage & ~transbit) == 0)
+				return opacity::TRANSPARENT;
+			return (usage & transbit) ? opacity::MIXED : opacity::OPAQUE;
+		}
+
+		// otherwise judged from the range of pens used
+		if (m_pen_range.empty())
+			return opacity::MIXED;
+		if (m_dirty[code]) decode(code);
+		return range_opacity(m_pen_range[code], trans_pen);
+	}
+
 	// ----- core graphics drawing -----
 
 	// core drawgfx implementation
@@ -282,6 +311,17 @@ public:
 private:
 	// internal helpers
 	void decode(u32 code);
+	void alloc_pen_summaries();
+	template <typename OpaqueOp, typename MixedOp> void draw_row_runs(const rectangle &cliprect, u32 code, int flipy, s32 desty, u32 trans_pen, OpaqueOp &&opaque_op, MixedOp &&mixed_op);
+
+	// the lowest pen in the low byte and the highest in the high byte decide what a transparent pen leaves
+	static opacity range_opacity(u16 range, u32 trans_pen)
+	{
+		u32 const lowest = range & 0xff, highest = range >> 8;
+		if (lowest == trans_pen && highest == trans_pen)
+			return opacity::TRANSPARENT;
+		return (trans_pen < lowest || trans_pen > highest) ? opacity::OPAQUE : opacity::MIXED;
+	}
 
 	// internal state
 	device_palette_interface *m_palette;    // palette used for drawing (optional when used as a pure decoder)
@@ -309,6 +349,9 @@ private:
 	std::vector<u8> m_gfxdata_allocated;    // allocated decoded pixel data, 8bpp
 	std::vector<u8> m_dirty;                // dirty array for detecting chars that need decoding
 	std::vector<u32>  m_pen_usage;      // bitmask of pens that are used (pens 0-31 only)
+	std::vector<u16>  m_pen_range;      // lowest and highest pens used (elements with more than 32 pens)
+	std::vector<u16>  m_row_pens;       // lowest and highest pens used on each row, when caching rows
+	bool            m_row_cache;            // split transparent draws into runs of rows by opacity?
 
 	bool            m_layout_is_raw;        // raw layout?
 	u8              m_layout_planes;        // bit planes in the layout
@@ -15,6 +15,12 @@
 
 #pragma once
 
+#include "screen.h"
+#include "video/gfxspan.h"
+
+#include <algorithm>
+#include <type_traits>
+
 
 /***************************************************************************
     PIXEL OPERATIONS
@@ -399,6 +405,128 @@ do
 while (0)
 
 
+
+/***************************************************************************
+    SPAN OPERATIONS
+***************************************************************************/
+
+/*
+    The common pixel operations above, packaged so the drawgfx cores
+    can hand them a whole row at a time for the gfx_span kernels. Any
+    other pixel op (a plain lambda) is still applied pixel by pixel.
+    Each also works as an ordinary pixel op, for the cores that
+    don't look for spans.
+*/
+
+template <typename T, typename = void> struct drawgfx_has_span : std::false_type { };
+template <typename T> struct drawgfx_has_span<T, std::void_t<decltype(&T::span)>> : std::true_type { };
+
+/*-------------------------------------------------
+    span_op_rebase - PIXEL_OP_REBASE_OPAQUE,
+    _TRANSPEN or _TRANSMASK depending on 'Pens'
+-------------------------------------------------*/
+
+template <typename Pens>
+struct span_op_rebase
+{
+	span_op_rebase(u32 color, Pens pens) : color(color), pens(pens) { }
+	void operator()(u16 &destp, const u8 &srcp) const { span(&destp, &srcp, 1); }
+	void span(u16 *destp, const u8 *srcp, s32 count) const { gfx_span::rebase_ind16(destp, srcp, count, color, pens); }
+
+	u32 color;
+	Pens pens;
+};
+
+template <typename Pens>
+struct span_op_rebase_priority
+{
+	span_op_rebase_priority(u32 color, Pens pens, u32 pmask) : color(color), pens(pens), pmask(pmask) { }
+	void operator()(u16 &destp, u8 &pri, const u8 &srcp) const { span(&destp, &pri, &srcp, 1); }
+	void span(u16 *destp, u8 *pri, const u8 *srcp, s32 count) const { gfx_span::rebase_ind16(destp, pri, srcp, count, color, pens, pmask); }
+
+	u32 color;
+	Pens pens;
+	gfx_span::pri_mask pmask;
+};
+
+/*-------------------------------------------------
+    span_op_remap - PIXEL_OP_REMAP_OPAQUE,
+    _TRANSPEN or _TRANSMASK depending on 'Pens'
+-------------------------------------------------*/
+
+template <typename Pens>
+struct span_op_remap
+{
+	span_op_remap(const pen_t *paldata, Pens pens) : paldata(paldata), pens(pens) { }
+	void operator()(u32 &destp, const u8 &srcp) const { span(&destp, &srcp, 1); }
+	void span(u32 *destp, const u8 *srcp, s32 count) const { gfx_span::remap_rgb32(destp, srcp, count, paldata, pens); }
+
+	const pen_t *paldata;
+	Pens pens;
+};
+
+template <typename Pens>
+struct span_op_remap_priority
+{
+	span_op_remap_priority(const pen_t *paldata, Pens pens, u32 pmask) : paldata(paldata), pens(pens), pmask(pmask) { }
+	void operator()(u32 &destp, u8 &pri, const u8 &srcp) const { span(&destp, &pri, &srcp, 1); }
+	void span(u32 *destp, u8 *pri, const u8 *srcp, s32 count) const { gfx_span::remap_rgb32(destp, pri, srcp, count, paldata, pens, pmask); }
+
+	const pen_t *paldata;
+	Pens pens;
+	gfx_span::pri_mask pmask;
+};
+
+/*-------------------------------------------------
+    span_op_alpha - PIXEL_OP_REMAP_TRANSPEN_ALPHA32
+-------------------------------------------------*/
+
+template <typename Pens>
+struct span_op_alpha
+{
+	span_op_alpha(const pen_t *paldata, Pens pens, u8 alpha_val) : paldata(paldata), pens(pens), alpha_val(alpha_val) { }
+	void operator()(u32 &destp, const u8 &srcp) const { span(&destp, &srcp, 1); }
+	void span(u32 *destp, const u8 *srcp, s32 count) const { gfx_span::alpha_rgb32(destp, srcp, count, paldata, pens, alpha_val); }
+
+	const pen_t *paldata;
+	Pens pens;
+	u8 alpha_val;
+};
+
+template <typename Pens>
+struct span_op_alpha_priority
+{
+	span_op_alpha_priority(const pen_t *paldata, Pens pens, u32 pmask, u8 alpha_val) : paldata(paldata), pens(pens), pmask(pmask), alpha_val(alpha_val) { }
+	void operator()(u32 &destp, u8 &pri, const u8 &srcp) const { span(&destp, &pri, &srcp, 1); }
+	void span(u32 *destp, u8 *pri, const u8 *srcp, s32 count) const { gfx_span::alpha_rgb32(destp, pri, srcp, count, paldata, pens, pmask, alpha_val); }
+
+	const pen_t *paldata;
+	Pens pens;
+	gfx_span::pri_mask pmask;
+	u8 alpha_val;
+};
+
+/*-------------------------------------------------
+    drawgfx_span_staged - gather 'count' source
+    pixels through 'fetch' into a small buffer and
+    hand them to 'apply' a chunk at a time, for
+    flipped and zoomed rows
+-------------------------------------------------*/
+
+template <typename FetchClass, typename ApplyClass>
+inline void drawgfx_span_staged(s32 count, FetchClass &&fetch, ApplyClass &&apply)
+{
+	u8 staged[64];
+	for (s32 x = 0; x < count; x += std::size(staged))
+	{
+		s32 const chunk = std::min<s32>(count - x, std::size(staged));
+		for (s32 i = 0; i < chunk; i++)
+			staged[i] = fetch();
+		apply(x, staged, chunk);
+	}
+}
+
+
 /***************************************************************************
     BASIC DRAWGFX CORE
 ***************************************************************************/
@@ -465,6 +593,9 @@ inline void gfx_element::drawgfx_core(BitmapType &dest, const rectangle &cliprec
 		if (destendy > cliprect.bottom())
 			destendy = cliprect.bottom();
 
+		// let a dirty-tracked screen know what we cover
+		screen_device::mark_bitmap_dirty(dest, rectangle(destx, destendx, desty, destendy));
+
 		// apply X flipping
 		if (flipx)
 			srcx = width() - 1 - srcx;
@@ -487,6 +618,22 @@ inline void gfx_element::drawgfx_core(BitmapType &dest, const rectangle &cliprec
 		// adjust srcdata to point to the first source pixel of the row
 		srcdata += srcy * rowbytes() + srcx;
 
+		// span ops take whole rows, staging flipped ones
+		if constexpr (drawgfx_has_span<FunctionClass>::value)
+		{
+			s32 const count = destendx + 1 - destx;
+			for (s32 cury = desty; cury <= destendy; cury++, srcdata += dy)
+			{
+				auto *destptr = &dest.pix(cury, destx);
+				if (!flipx)
+					pixel_op.span(destptr, srcdata, count);
+				else
+					drawgfx_span_staged(count, [srcptr = srcdata] () mutable { return *srcptr--; },
+							[&] (s32 x, const u8 *staged, s32 chunk) { pixel_op.span(destptr + x, staged, chunk); });
+			}
+			break;
+		}
+
 		// non-flipped 8bpp case
 		if (!flipx)
 		{
@@ -602,6 +749,9 @@ inline void gfx_element::drawgfx_core(BitmapType &dest, const rectangle &cliprec
 		if (destendy > cliprect.bottom())
 			destendy = cliprect.bottom();
 
+		// let a dirty-tracked screen know what we cover
+		screen_device::mark_bitmap_dirty(dest, rectangle(destx, destendx, desty, destendy));
+
 		// apply X flipping
 		if (flipx)
 			srcx = width() - 1 - srcx;
@@ -624,6 +774,23 @@ inline void gfx_element::drawgfx_core(BitmapType &dest, const rectangle &cliprec
 		// adjust srcdata to point to the first source pixel of the row
 		srcdata += srcy * rowbytes() + srcx;
 
+		// span ops take whole rows, staging flipped ones
+		if constexpr (drawgfx_has_span<FunctionClass>::value)
+		{
+			s32 const count = destendx + 1 - destx;
+			for (s32 cury = desty; cury <= destendy; cury++, srcdata += dy)
+			{
+				auto *priptr = &priority.pix(cury, destx);
+				auto *destptr = &dest.pix(cury, destx);
+				if (!flipx)
+					pixel_op.span(destptr, priptr, srcdata, count);
+				else
+					drawgfx_span_staged(count, [srcptr = srcdata] () mutable { return *srcptr--; },
+							[&] (s32 x, const u8 *staged, s32 chunk) { pixel_op.span(destptr + x, priptr + x, staged, chunk); });
+			}
+			break;
+		}
+
 		// non-flipped 8bpp case
 		if (!flipx)
 		{
@@ -775,6 +942,9 @@ inline void gfx_element::drawgfxzoom_core(BitmapType &dest, const rectangle &cli
 		if (destendy > cliprect.bottom())
 			destendy = cliprect.bottom();
 
+		// let a dirty-tracked screen know what we cover
+		screen_device::mark_bitmap_dirty(dest, rectangle(destx, destendx, desty, destendy));
+
 		// apply X flipping
 		if (flipx)
 		{
@@ -792,6 +962,19 @@ inline void gfx_element::drawgfxzoom_core(BitmapType &dest, const rectangle &cli
 		// fetch the source data
 		const u8 *srcdata = get_data(code);
 
+		// span ops take whole rows, staged through the source steps
+		if constexpr (drawgfx_has_span<FunctionClass>::value)
+		{
+			s32 const count = destendx + 1 - destx;
+			for (s32 cury = desty; cury <= destendy; cury++, srcy += dy)
+			{
+				auto *destptr = &dest.pix(cury, destx);
+				drawgfx_span_staged(count, [srcptr = srcdata + (srcy >> 16) * rowbytes(), cursrcx = srcx, dx] () mutable { u8 const pen = srcptr[cursrcx >> 16]; cursrcx += dx; return pen; },
+						[&] (s32 x, const u8 *staged, s32 chunk) { pixel_op.span(destptr + x, staged, chunk); });
+			}
+			break;
+		}
+
 		// compute how many blocks of 4 pixels we have
 		u32 numblocks = (destendx + 1 - destx) / 4;
 		u32 leftovers = (destendx + 1 - destx) - 4 * numblocks;
@@ -888,6 +1071,9 @@ inline void gfx_element::drawgfxzoom_core(BitmapType &dest, const rectangle &cli
 		if (destendy > cliprect.bottom())
 			destendy = cliprect.bottom();
 
+		// let a dirty-tracked screen know what we cover
+		screen_device::mark_bitmap_dirty(dest, rectangle(destx, destendx, desty, destendy));
+
 		// apply X flipping
 		if (flipx)
 		{
@@ -905,6 +1091,20 @@ inline void gfx_element::drawgfxzoom_core(BitmapType &dest, const rectangle &cli
 		// fetch the source data
 		const u8 *srcdata = get_data(code);
 
+		// span ops take whole rows, staged through the source steps
+		if constexpr (drawgfx_has_span<FunctionClass>::value)
+		{
+			s32 const count = destendx + 1 - destx;
+			for (s32 cury = desty; cury <= destendy; cury++, srcy += dy)
+			{
+				auto *priptr = &priority.pix(cury, destx);
+				auto *destptr = &dest.pix(cury, destx);
+				drawgfx_span_staged(count, [srcptr = srcdata + (srcy >> 16) * rowbytes(), cursrcx = srcx, dx] () mutable { u8 const pen = srcptr[cursrcx >> 16]; cursrcx += dx; return pen; },
+						[&] (s32 x, const u8 *staged, s32 chunk) { pixel_op.span(destptr + x, priptr + x, staged, chunk); });
+			}
+			break;
+		}
+
 		// compute how many blocks of 4 pixels we have
 		u32 numblocks = (destendx + 1 - destx) / 4;
 		u32 leftovers = (destendx + 1 - destx) - 4 * numblocks;
@@ -1016,6 +1216,9 @@ inline void copybitmap_core(BitmapType &dest, const BitmapType &src, int flipx,
 		if (destendy > cliprect.bottom())
 			destendy = cliprect.bottom();
 
+		// let a dirty-tracked screen know what we cover
+		screen_device::mark_bitmap_dirty(dest, rectangle(destx, destendx, desty, destendy));
+
 		// apply X flipping
 		if (flipx)
 		{
@@ -1156,6 +1359,9 @@ inline void copybitmap_core(BitmapType &dest, const BitmapType &src, int flipx,
 		if (destendy > cliprect.bottom())
 			destendy = cliprect.bottom();
 
+		// let a dirty-tracked screen know what we cover
+		screen_device::mark_bitmap_dirty(dest, rectangle(destx, destendx, desty, destendy));
+
 		// apply X flipping
 		if (flipx)
 		{
@@ -1285,6 +1491,7 @@ inline void copyrozbitmap_core(BitmapType &dest, const rectangle &cliprect, cons
 	// ignore empty/invalid cliprects
 	if (cliprect.empty())
 		return;
+	screen_device::mark_bitmap_dirty(dest, cliprect);
 
 	// compute fixed-point 16.16 size of the source bitmap
 	u32 srcfixwidth = src.width() << 16;
@@ -1543,6 +1750,7 @@ inline void copyrozbitmap_core(BitmapType &dest, const rectangle &cliprect, cons
 	// ignore empty/invalid cliprects
 	if (cliprect.empty())
 		return;
+	screen_device::mark_bitmap_dirty(dest, cliprect);
 
 	// compute fixed-point 16.16 size of the source bitmap
 	u32 srcfixwidth = src.width() << 16;
@@ -1824,6 +2032,7 @@ inline void drawscanline_core(BitmapType &bitmap, s32 destx, s32 desty, s32 leng
 	assert(desty < bitmap.height());
 	assert(srcptr != nullptr);
 
+	screen_device::mark_bitmap_dirty(bitmap, rectangle(destx, destx + length - 1, desty, desty));
 	auto *destptr = &bitmap.pix(desty, destx);
 
 	// iterate over unrolled blocks of 4
@@ -1860,6 +2069,7 @@ inline void drawscanline_core(BitmapType &bitmap, s32 destx, s32 desty, s32 leng
 	assert(srcptr != nullptr);
 	assert(priority.valid());
 
+	screen_device::mark_bitmap_dirty(bitmap, rectangle(destx, destx + length - 1, desty, desty));
 	auto *priptr = &priority.pix(desty, destx);
 	auto *destptr = &bitmap.pix(desty, destx);
 
@@ -64,13 +64,17 @@ const options_entry emu_options::s_option_entries[] =
 	{ OPTION_DIFF_DIRECTORY,                             "diff",      core_options::option_type::PATH,       "directory to save hard drive image difference files" },
 	{ OPTION_COMMENT_DIRECTORY,                          "comments",  core_options::option_type::PATH,       "directory to save debugger comments" },
 	{ OPTION_SHARE_DIRECTORY,                            "share",     core_options::option_type::PATH,       "directory to share with emulated machines" },
+	{ OPTION_DRC_DIRECTORY,                              "drc",       core_options::option_type::PATH,       "directory to save DRC translation caches" },
 
 	// state/playback options
 	{ nullptr,                                           nullptr,     core_options::option_type::HEADER,     "CORE STATE/PLAYBACK OPTIONS" },
 	{ OPTION_STATE,                                      nullptr,     core_options::option_type::STRING,     "saved state to load" },
 	{ OPTION_AUTOSAVE,                                   "0",         core_options::option_type::BOOLEAN,    "automatically restore state on start and save on exit for supported systems" },
+	{ OPTION_ASYNC_SAVE,                                 "0",         core_options::option_type::BOOLEAN,    "compress and write save states on a background thread" },
 	{ OPTION_REWIND,                                     "0",         core_options::option_type::BOOLEAN,    "enable rewind savestates" },
 	{ OPTION_REWIND_CAPACITY "(1-2048)",                 "100",       core_options::option_type::INTEGER,    "rewind buffer size in megabytes" },
+	{ OPTION_REWIND_DELTA,                               "0",         core_options::option_type::BOOLEAN,    "store rewind states as changes relative to periodic full keyframes" },
+	{ OPTION_REWIND_KEYFRAME "(1-1000)",                 "30",        core_options::option_type::INTEGER,    "maximum number of delta rewind states between full keyframes" },
 	{ OPTION_PLAYBACK ";pb",                             nullptr,     core_options::option_type::STRING,     "playback an input file" },
 	{ OPTION_RECORD ";rec",                              nullptr,     core_options::option_type::STRING,     "record an input file" },
 	{ OPTION_EXIT_AFTER_PLAYBACK,                        "0",         core_options::option_type::BOOLEAN,    "close the program at the end of playback" },
@@ -82,6 +86,7 @@ const options_entry emu_options::s_option_entries[] =
 	{ OPTION_SNAPSIZE,                                   "auto",      core_options::option_type::STRING,     "specify snapshot/movie resolution (<width>x<height>) or 'auto' to use minimal size " },
 	{ OPTION_SNAPVIEW,                                   "auto",      core_options::option_type::STRING,     "snapshot/movie view - 'auto' for default, or 'native' for per-screen pixel-aspect views" },
 	{ OPTION_SNAPBILINEAR,                               "1",         core_options::option_type::BOOLEAN,    "specify if the snapshot/movie should have bilinear filtering applied" },
+	{ OPTION_SNAPBANDS,                                  "0",         core_options::option_type::INTEGER,    "number of horizontal bands to render each snapshot/movie frame in on multiple threads (0 = single thread)" },
 	{ OPTION_STATENAME,                                  "%g",        core_options::option_type::STRING,     "override of the default state subfolder naming; %g == gamename" },
 	{ OPTION_BURNIN,                                     "0",         core_options::option_type::BOOLEAN,    "create burn-in snapshots for each screen" },
 
@@ -95,6 +100,13 @@ const options_entry emu_options::s_option_entries[] =
 	{ OPTION_SPEED "(0.01-100)",                         "1.0",       core_options::option_type::FLOAT,      "controls the speed of gameplay, relative to realtime; smaller numbers are slower" },
 	{ OPTION_REFRESHSPEED ";rs",                         "0",         core_options::option_type::BOOLEAN,    "automatically adjust emulation speed to keep the emulated refresh rate slower than the host screen" },
 	{ OPTION_LOWLATENCY ";lolat",                        "0",         core_options::option_type::BOOLEAN,    "draws new frame before throttling to reduce input latency" },
+	{ OPTION_PARALLEL_EXEC,                              "0",         core_options::option_type::BOOLEAN,    "run independent execute groups on multiple host threads" },
+	{ OPTION_CHD_CACHE,                                  "0",         core_options::option_type::INTEGER,    "number of decompressed hunks to keep for each compressed CHD (0 = disabled)" },
+	{ OPTION_CHD_PREFETCH,                               "0",         core_options::option_type::INTEGER,    "number of hunks to decompress ahead on other threads when CHD reads are sequential" },
+	{ OPTION_TILEMAP_BANDS,                              "0",         core_options::option_type::INTEGER,    "number of horizontal bands to draw large tilemap layers in on multiple threads (0 = single thread)" },
+	{ OPTION_GFX_ROW_CACHE,                              "0",         core_options::option_type::BOOLEAN,    "keep per-row pen ranges for decoded graphics so transparent sprite rows can be skipped" },
+	{ OPTION_SOUND_BATCH,                                "0",         core_options::option_type::INTEGER,    "update the sound graph in dependency order in batches of this many output samples (0 = pull from the speakers)" },
+	{ OPTION_SOUND_PARALLEL,                             "0",         core_options::option_type::BOOLEAN,    "update independent sound subgraphs on multiple threads when their streams are thread-safe" },
 
 	// render options
 	{ nullptr,                                           nullptr,     core_options::option_type::HEADER,     "CORE RENDER OPTIONS" },
@@ -106,6 +118,7 @@ const options_entry emu_options::s_option_entries[] =
 	{ OPTION_INTOVERSCAN ";ios",                         "0",         core_options::option_type::BOOLEAN,    "allow overscan on integer scaled targets"},
 	{ OPTION_INTSCALEX ";sx",                            "0",         core_options::option_type::INTEGER,    "set horizontal integer scale factor"},
 	{ OPTION_INTSCALEY ";sy",                            "0",         core_options::option_type::INTEGER,    "set vertical integer scale factor"},
+	{ OPTION_SCALED_TEXTURE_CACHE,                       "64",        core_options::option_type::INTEGER,    "megabytes of scaled artwork, font and UI textures to keep across all render targets" },
 
 	// rotation options
 	{ nullptr,                                           nullptr,     core_options::option_type::HEADER,     "CORE ROTATION OPTIONS" },
@@ -146,6 +159,7 @@ const options_entry emu_options::s_option_entries[] =
 	{ OPTION_VOLUME ";vol",                              "0",         core_options::option_type::INTEGER,    "sound volume in decibels (-32 min, 0 max)" },
 	{ OPTION_COMPRESSOR,                                 "1",         core_options::option_type::BOOLEAN,    "enable compressor for sound" },
 	{ OPTION_SPEAKER_REPORT "(0-4)",                     "0",         core_options::option_type::INTEGER,    "print report of speaker ouput maxima (0=none, or 1-4 for more detail)" },
+	{ OPTION_RESAMPLER_QUALITY "(0-3)",                  "0",         core_options::option_type::INTEGER,    "sound resampler quality (0=original, or 1-3 for windowed-sinc filters of increasing length)" },
 
 	// input options
 	{ nullptr,                                           nullptr,     core_options::option_type::HEADER,     "CORE INPUT OPTIONS" },
@@ -202,6 +216,10 @@ const options_entry emu_options::s_option_entries[] =
 	{ OPTION_DRC_USE_C,                                  "0",         core_options::option_type::BOOLEAN,    "force DRC to use C backend" },
 	{ OPTION_DRC_LOG_UML,                                "0",         core_options::option_type::BOOLEAN,    "write DRC UML disassembly log" },
 	{ OPTION_DRC_LOG_NATIVE,                             "0",         core_options::option_type::BOOLEAN,    "write DRC native disassembly log" },
+	{ OPTION_DRC_CACHE,                                  "0",         core_options::option_type::BOOLEAN,    "keep translated DRC blocks on disk between runs" },
+	{ OPTION_DRC_LOG_OPT,                                "0",         core_options::option_type::BOOLEAN,    "report UML instruction counts before and after optimization" },
+	{ OPTION_DRC_REGALLOC,                               "0",         core_options::option_type::BOOLEAN,    "keep frequently used CPU state in host registers within DRC blocks (x64 back-end)" },
+	{ OPTION_DRC_PROFILE,                                "0",         core_options::option_type::BOOLEAN,    "count executions of each DRC block and report the hottest ones at exit" },
 	{ OPTION_BIOS,                                       nullptr,     core_options::option_type::STRING,     "select the system BIOS to use" },
 	{ OPTION_CHEAT ";c",                                 "0",         core_options::option_type::BOOLEAN,    "enable cheat subsystem" },
 	{ OPTION_SKIP_GAMEINFO,                              "0",         core_options::option_type::BOOLEAN,    "skip displaying the system information screen at startup" },
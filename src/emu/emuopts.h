@@ -48,12 +48,16 @@
 #define OPTION_DIFF_DIRECTORY       "diff_directory"
 #define OPTION_COMMENT_DIRECTORY    "comment_directory"
 #define OPTION_SHARE_DIRECTORY      "share_directory"
+#define OPTION_DRC_DIRECTORY        "drc_directory"
 
 // core state/playback options
 #define OPTION_STATE                "state"
 #define OPTION_AUTOSAVE             "autosave"
+#define OPTION_ASYNC_SAVE           "async_save"
 #define OPTION_REWIND               "rewind"
 #define OPTION_REWIND_CAPACITY      "rewind_capacity"
+#define OPTION_REWIND_DELTA         "rewind_delta"
+#define OPTION_REWIND_KEYFRAME      "rewind_keyframe"
 #define OPTION_PLAYBACK             "playback"
 #define OPTION_RECORD               "record"
 #define OPTION_EXIT_AFTER_PLAYBACK  "exit_after_playback"
@@ -64,6 +68,7 @@
 #define OPTION_SNAPSIZE             "snapsize"
 #define OPTION_SNAPVIEW             "snapview"
 #define OPTION_SNAPBILINEAR         "snapbilinear"
+#define OPTION_SNAPBANDS            "snapbands"
 #define OPTION_STATENAME            "statename"
 #define OPTION_BURNIN               "burnin"
 
@@ -76,6 +81,13 @@
 #define OPTION_SPEED                "speed"
 #define OPTION_REFRESHSPEED         "refreshspeed"
 #define OPTION_LOWLATENCY           "lowlatency"
+#define OPTION_PARALLEL_EXEC        "parallel_exec"
+#define OPTION_CHD_CACHE            "chd_cache"
+#define OPTION_CHD_PREFETCH         "chd_prefetch"
+#define OPTION_TILEMAP_BANDS        "tilemap_bands"
+#define OPTION_GFX_ROW_CACHE        "gfx_row_cache"
+#define OPTION_SOUND_BATCH          "sound_batch"
+#define OPTION_SOUND_PARALLEL       "sound_parallel"
 
 // core render options
 #define OPTION_KEEPASPECT           "keepaspect"
@@ -86,6 +98,7 @@
 #define OPTION_INTOVERSCAN          "intoverscan"
 #define OPTION_INTSCALEX            "intscalex"
 #define OPTION_INTSCALEY            "intscaley"
+#define OPTION_SCALED_TEXTURE_CACHE "scaled_texture_cache"
 
 // core rotation options
 #define OPTION_ROTATE               "rotate"
@@ -121,6 +134,7 @@
 #define OPTION_VOLUME               "volume"
 #define OPTION_COMPRESSOR           "compressor"
 #define OPTION_SPEAKER_REPORT       "speaker_report"
+#define OPTION_RESAMPLER_QUALITY    "resampler_quality"
 
 // core input options
 #define OPTION_COIN_LOCKOUT         "coin_lockout"
@@ -165,6 +179,10 @@
 #define OPTION_DRC_USE_C            "drc_use_c"
 #define OPTION_DRC_LOG_UML          "drc_log_uml"
 #define OPTION_DRC_LOG_NATIVE       "drc_log_native"
+#define OPTION_DRC_CACHE            "drc_cache"
+#define OPTION_DRC_LOG_OPT          "drc_log_opt"
+#define OPTION_DRC_REGALLOC         "drc_regalloc"
+#define OPTION_DRC_PROFILE          "drc_profile"
 #define OPTION_BIOS                 "bios"
 #define OPTION_CHEAT                "cheat"
 #define OPTION_SKIP_GAMEINFO        "skip_gameinfo"
@@ -334,12 +352,16 @@ public:
 	const char *diff_directory() const { return value(OPTION_DIFF_DIRECTORY); }
 	const char *comment_directory() const { return value(OPTION_COMMENT_DIRECTORY); }
 	const char *share_directory() const { return value(OPTION_SHARE_DIRECTORY); }
+	const char *drc_directory() const { return value(OPTION_DRC_DIRECTORY); }
 
 	// core state/playback options
 	const char *state() const { return value(OPTION_STATE); }
 	bool autosave() const { return bool_value(OPTION_AUTOSAVE); }
+	bool async_save() const { return bool_value(OPTION_ASYNC_SAVE); }
 	int rewind() const { return bool_value(OPTION_REWIND); }
 	int rewind_capacity() const { return int_value(OPTION_REWIND_CAPACITY); }
+	bool rewind_delta() const { return bool_value(OPTION_REWIND_DELTA); }
+	int rewind_keyframe() const { return int_value(OPTION_REWIND_KEYFRAME); }
 	const char *playback() const { return value(OPTION_PLAYBACK); }
 	const char *record() const { return value(OPTION_RECORD); }
 	bool exit_after_playback() const { return bool_value(OPTION_EXIT_AFTER_PLAYBACK); }
@@ -350,6 +372,7 @@ public:
 	const char *snap_size() const { return value(OPTION_SNAPSIZE); }
 	const char *snap_view() const { return value(OPTION_SNAPVIEW); }
 	bool snap_bilinear() const { return bool_value(OPTION_SNAPBILINEAR); }
+	int snap_bands() const { return int_value(OPTION_SNAPBANDS); }
 	const char *state_name() const { return value(OPTION_STATENAME); }
 	bool burnin() const { return bool_value(OPTION_BURNIN); }
 
@@ -362,6 +385,13 @@ public:
 	float speed() const { return float_value(OPTION_SPEED); }
 	bool refresh_speed() const { return m_refresh_speed; }
 	bool low_latency() const { return bool_value(OPTION_LOWLATENCY); }
+	bool parallel_exec() const { return bool_value(OPTION_PARALLEL_EXEC); }
+	int chd_cache() const { return int_value(OPTION_CHD_CACHE); }
+	int chd_prefetch() const { return int_value(OPTION_CHD_PREFETCH); }
+	int tilemap_bands() const { return int_value(OPTION_TILEMAP_BANDS); }
+	bool gfx_row_cache() const { return bool_value(OPTION_GFX_ROW_CACHE); }
+	int sound_batch() const { return int_value(OPTION_SOUND_BATCH); }
+	bool sound_parallel() const { return bool_value(OPTION_SOUND_PARALLEL); }
 
 	// core render options
 	bool keep_aspect() const { return bool_value(OPTION_KEEPASPECT); }
@@ -372,6 +402,7 @@ public:
 	bool int_overscan() const { return bool_value(OPTION_INTOVERSCAN); }
 	int int_scale_x() const { return int_value(OPTION_INTSCALEX); }
 	int int_scale_y() const { return int_value(OPTION_INTSCALEY); }
+	int scaled_texture_cache() const { return int_value(OPTION_SCALED_TEXTURE_CACHE); }
 
 	// core rotation options
 	bool rotate() const { return bool_value(OPTION_ROTATE); }
@@ -407,6 +438,7 @@ public:
 	int volume() const { return int_value(OPTION_VOLUME); }
 	bool compressor() const { return bool_value(OPTION_COMPRESSOR); }
 	int speaker_report() const { return int_value(OPTION_SPEAKER_REPORT); }
+	int resampler_quality() const { return int_value(OPTION_RESAMPLER_QUALITY); }
 
 	// core input options
 	bool coin_lockout() const { return bool_value(OPTION_COIN_LOCKOUT); }
@@ -449,6 +481,10 @@ public:
 	bool drc_use_c() const { return bool_value(OPTION_DRC_USE_C); }
 	bool drc_log_uml() const { return bool_value(OPTION_DRC_LOG_UML); }
 	bool drc_log_native() const { return bool_value(OPTION_DRC_LOG_NATIVE); }
+	bool drc_cache() const { return bool_value(OPTION_DRC_CACHE); }
+	bool drc_log_opt() const { return bool_value(OPTION_DRC_LOG_OPT); }
+	bool drc_regalloc() const { return bool_value(OPTION_DRC_REGALLOC); }
+	bool drc_profile() const { return bool_value(OPTION_DRC_PROFILE); }
 	const char *bios() const { return value(OPTION_BIOS); }
 	bool cheat() const { return bool_value(OPTION_CHEAT); }
 	bool skip_gameinfo() const { return bool_value(OPTION_SKIP_GAMEINFO); }
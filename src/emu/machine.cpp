@@ -214,6 +214,7 @@ void running_machine::start()
 	save().register_presave(save_prepost_delegate(FUNC(running_machine::presave_all_devices), this));
 	start_all_devices();
 	save().register_postload(save_prepost_delegate(FUNC(running_machine::postload_all_devices), this));
+	save().register_save_complete(save_complete_delegate(&running_machine::save_complete, this));
 
 	// save outputs created before start time
 	output().register_save();
@@ -338,9 +339,20 @@ int running_machine::run(bool quiet)
 			// handle save/load
 			if (m_saveload_schedule != saveload_schedule::NONE)
 				handle_saveload();
+			m_save.update_async();
 		}
 		m_manager.http()->clear();
 
+		// finish writing any save state still in flight
+		m_save.wait_async();
+
+		// report how the scheduler and sound streams spent their time
+		if (options().verbose())
+		{
+			m_scheduler.dump_stats();
+			m_sound->dump_stats();
+		}
+
 		// and out via the exit phase
 		m_current_phase = machine_phase::EXIT;
 
@@ -606,6 +618,9 @@ void running_machine::immediate_save(std::string_view filename)
 
 	// jump right into the save, anonymous timers can't hurt us!
 	handle_saveload();
+
+	// callers expect the file to be complete on return
+	m_save.wait_async();
 }
 
 
@@ -877,49 +892,34 @@ void running_machine::handle_saveload()
 		}
 		else
 		{
-			u32 const openflags = (m_saveload_schedule == saveload_schedule::LOAD) ? OPEN_FLAG_READ : (OPEN_FLAG_WRITE | OPEN_FLAG_CREATE | OPEN_FLAG_CREATE_PATHS);
+			const bool load = m_saveload_schedule == saveload_schedule::LOAD;
+			u32 const openflags = load ? OPEN_FLAG_READ : (OPEN_FLAG_WRITE | OPEN_FLAG_CREATE | OPEN_FLAG_CREATE_PATHS);
+
+			// don't race a background write to the same file
+			m_save.wait_async();
 
 			// open the file
-			emu_file file(m_saveload_searchpath ? m_saveload_searchpath : "", openflags);
-			auto const filerr = file.open(m_saveload_pending_file);
-			if (!filerr)
+			auto file = std::make_unique<emu_file>(m_saveload_searchpath ? m_saveload_searchpath : "", openflags);
+			auto const filerr = file->open(m_saveload_pending_file);
+			if (!filerr && !load && options().async_save())
 			{
-				// read/write the save state
-				save_error saverr = (m_saveload_schedule == saveload_schedule::LOAD) ? m_save.read_file(file) : m_save.write_file(file);
-
-				// handle the result
-				switch (saverr)
+				// snapshot the state now; the result is reported when the write completes
+				save_error saverr = m_save.write_file_async(std::move(file));
+				if (saverr != STATERR_NONE)
 				{
-				case STATERR_INVALID_HEADER:
-					popmessage("Error: Unable to %s state %s %s due to an invalid header. Make sure the save state is correct for this system.", opname, preposname, m_saveload_pending_file);
-					break;
-
-				case STATERR_READ_ERROR:
-					popmessage("Error: Unable to %s state %s %s due to a read error (file is likely corrupt).", opname, preposname, m_saveload_pending_file);
-					break;
-
-				case STATERR_WRITE_ERROR:
-					popmessage("Error: Unable to %s state %s %s due to a write error. Verify there is enough disk space.", opname, preposname, m_saveload_pending_file);
-					break;
-
-				case STATERR_NONE:
-				{
-					const char *const opnamed = (m_saveload_schedule == saveload_schedule::LOAD) ? "Loaded" : "Saved";
-					if (!(m_system.flags & MACHINE_SUPPORTS_SAVE))
-						popmessage("%s state %s %s.\nWarning: Save states are not officially supported for this system.", opnamed, preposname, m_saveload_pending_file);
-					else
-						popmessage("%s state %s %s.", opnamed, preposname, m_saveload_pending_file);
-					break;
-				}
-
-				default:
-					popmessage("Error: Unknown error during %s state %s %s.", opname, preposname, m_saveload_pending_file);
-					break;
+					report_saveload(load, m_saveload_pending_file, saverr);
+					file->remove_on_close();
 				}
+			}
+			else if (!filerr)
+			{
+				// read/write the save state
+				save_error saverr = load ? m_save.read_file(*file) : m_save.write_file(*file);
+				report_saveload(load, m_saveload_pending_file, saverr);
 
 				// close and perhaps delete the file
-				if (saverr != STATERR_NONE && m_saveload_schedule == saveload_schedule::SAVE)
-					file.remove_on_close();
+				if (saverr != STATERR_NONE && !load)
+					file->remove_on_close();
 			}
 			else if ((openflags == OPEN_FLAG_READ) && (std::errc::no_such_file_or_directory == filerr))
 			{
@@ -940,6 +940,58 @@ void running_machine::handle_saveload()
 }
 
 
+//-------------------------------------------------
+//  report_saveload - tell the user how a save or
+//  load went
+//-------------------------------------------------
+
+void running_machine::report_saveload(bool load, std::string const &filename, save_error saverr)
+{
+	const char *const opname = load ? "load" : "save";
+	const char *const preposname = load ? "from" : "to";
+
+	switch (saverr)
+	{
+	case STATERR_INVALID_HEADER:
+		popmessage("Error: Unable to %s state %s %s due to an invalid header. Make sure the save state is correct for this system.", opname, preposname, filename);
+		break;
+
+	case STATERR_READ_ERROR:
+		popmessage("Error: Unable to %s state %s %s due to a read error (file is likely corrupt).", opname, preposname, filename);
+		break;
+
+	case STATERR_WRITE_ERROR:
+		popmessage("Error: Unable to %s state %s %s due to a write error. Verify there is enough disk space.", opname, preposname, filename);
+		break;
+
+	case STATERR_NONE:
+	{
+		const char *const opnamed = load ? "Loaded" : "Saved";
+		if (!(m_system.flags & MACHINE_SUPPORTS_SAVE))
+			popmessage("%s state %s %s.\nWarning: Save states are not officially supported for this system.", opnamed, preposname, filename);
+		else
+			popmessage("%s state %s %s.", opnamed, preposname, filename);
+		break;
+	}
+
+	default:
+		popmessage("Error: Unknown error during %s state %s %s.", opname, preposname, filename);
+		break;
+	}
+}
+
+
+//-------------------------------------------------
+//  save_complete - an asynchronous save has been
+//  written out
+//-------------------------------------------------
+
+void running_machine::save_complete(std::string const &filename, save_error saverr)
+{
+	report_saveload(false, filename, saverr);
+}
+
+
 //-------------------------------------------------
 //  soft_reset - actually perform a soft-reset
 //  of the system
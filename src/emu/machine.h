@@ -246,6 +246,8 @@ private:
 	void start();
 	void set_saveload_filename(std::string &&filename);
 	void handle_saveload();
+	void report_saveload(bool load, std::string const &filename, save_error saverr);
+	void save_complete(std::string const &filename, save_error saverr);
 	void soft_reset(s32 param = 0);
 	std::string nvram_filename(device_t &device) const;
 	void nvram_load();
@@ -333,11 +333,16 @@ render_texture::render_texture()
 		m_old_id(~0ULL),
 		m_scaler(nullptr),
 		m_param(nullptr),
-		m_curseq(0)
+		m_curseq(0),
+		m_scaled_count(0),
+		m_tracked(false),
+		m_modified(false),
+		m_dirty_seq(0),
+		m_palette_seq(0)
 {
 	m_sbounds.set(0, -1, 0, -1);
-	for (auto &elem : m_scaled)
-		elem.seqid = 0;
+	m_pending.set(0, -1, 0, -1);
+	m_dirty.set(0, -1, 0, -1);
 }
 
 
@@ -376,21 +381,26 @@ void render_texture::reset(render_manager &manager, texture_scaler_func scaler,
 
 void render_texture::release()
 {
-	// free all scaled versions
-	for (auto &elem : m_scaled)
+	// a texture never handed out by a manager has nothing cached to drop
+	if (m_manager != nullptr)
 	{
-		m_manager->invalidate_all(elem.bitmap.get());
-		elem.bitmap.reset();
-		elem.seqid = 0;
-	}
+		// free all scaled versions
+		m_manager->scaled_purge(*this);
 
-	// invalidate references to the original bitmap as well
-	m_manager->invalidate_all(m_bitmap);
+		// invalidate references to the original bitmap as well
+		m_manager->invalidate_all(m_bitmap);
+	}
 	m_bitmap = nullptr;
 	m_sbounds.set(0, -1, 0, -1);
 	m_format = TEXFORMAT_ARGB32;
 	m_scaler = nullptr;
 	m_curseq = 0;
+	m_tracked = false;
+	m_modified = false;
+	m_pending.set(0, -1, 0, -1);
+	m_dirty.set(0, -1, 0, -1);
+	m_dirty_seq = 0;
+	m_palette_seq = 0;
 }
 
 
@@ -407,7 +417,7 @@ void render_texture::set_bitmap(bitmap_t &bitmap, const rectangle &sbounds, text
 		assert(bitmap.palette() != nullptr);
 
 	// invalidate references to the old bitmap
-	if (&bitmap != m_bitmap && m_bitmap != nullptr)
+	if (&bitmap != m_bitmap && m_bitmap != nullptr && m_manager != nullptr)
 		m_manager->invalidate_all(m_bitmap);
 
 	// set the new bitmap/palette
@@ -416,13 +426,55 @@ void render_texture::set_bitmap(bitmap_t &bitmap, const rectangle &sbounds, text
 	m_format = format;
 
 	// invalidate all scaled versions
-	for (auto & elem : m_scaled)
+	if (m_manager != nullptr)
+		m_manager->scaled_purge(*this);
+
+	// without a dirty area, assume everything changed
+	m_tracked = false;
+	mark_all_dirty();
+}
+
+
+//-------------------------------------------------
+//  set_bitmap - set a source bitmap along with
+//  the area of it that changed since the last
+//  call; anything but a repeat of the same
+//  bitmap, bounds and format is treated as a
+//  change to the whole texture
+//-------------------------------------------------
+
+void render_texture::set_bitmap(bitmap_t &bitmap, const rectangle &sbounds, texture_format format, const rectangle &dirty)
+{
+	if (!m_tracked || &bitmap != m_bitmap || sbounds != m_sbounds || format != m_format)
 	{
-		if (elem.bitmap)
-			m_manager->invalidate_all(elem.bitmap.get());
-		elem.bitmap.reset();
-		elem.seqid = 0;
+		set_bitmap(bitmap, sbounds, format);
+		m_tracked = true;
+		return;
 	}
+
+	// accumulate the changed area relative to the source bounds
+	rectangle changed = dirty;
+	changed &= sbounds;
+	if (changed.empty())
+		return;
+	changed.offset(-sbounds.left(), -sbounds.top());
+	if (!m_modified || m_pending.empty())
+		m_pending = changed;
+	else
+		m_pending |= changed;
+	m_modified = true;
+}
+
+
+//-------------------------------------------------
+//  mark_all_dirty - treat the whole texture as
+//  changed since the last get_scaled
+//-------------------------------------------------
+
+void render_texture::mark_all_dirty()
+{
+	m_pending.set(0, m_sbounds.width() - 1, 0, m_sbounds.height() - 1);
+	m_modified = true;
 }
 
 
@@ -471,7 +523,22 @@ void render_texture::get_scaled(u32 dwidth, u32 dheight, render_texinfo &texinfo
 		texinfo.width_margin = m_sbounds.left();
 		texinfo.height = sheight;
 		// palette will be set later
-		texinfo.seqid = ++m_curseq;
+
+		// untracked textures change on every call; tracked ones only when their owner says so
+		if (!m_tracked || m_modified)
+		{
+			m_dirty_seq = m_curseq;
+			if (m_tracked)
+				m_dirty = m_pending;
+			else
+				m_dirty.set(0, swidth - 1, 0, sheight - 1);
+			m_pending.set(0, -1, 0, -1);
+			m_modified = false;
+			++m_curseq;
+		}
+		texinfo.seqid = m_curseq;
+		texinfo.dirty_seqid = m_dirty_seq;
+		texinfo.dirty = m_dirty;
 	}
 	else
 	{
@@ -479,54 +546,26 @@ void render_texture::get_scaled(u32 dwidth, u32 dheight, render_texinfo &texinfo
 		bitmap_argb32 dummy;
 		bitmap_argb32 &srcbitmap = (m_bitmap != nullptr) ? downcast<bitmap_argb32 &>(*m_bitmap) : dummy;
 
-		// is it a size we already have?
-		scaled_texture *scaled = nullptr;
-		int scalenum;
-		for (scalenum = 0; scalenum < std::size(m_scaled); scalenum++)
+		// is it a size we already have? if not, let the scaler do the work
+		u32 seqid;
+		bitmap_argb32 *scaled = m_manager->scaled_find(*this, dwidth, dheight, seqid);
+		if (scaled == nullptr)
 		{
-			scaled = &m_scaled[scalenum];
-
-			// we need a non-NULL bitmap with matching dest size
-			if (scaled->bitmap != nullptr && dwidth == scaled->bitmap->width() && dheight == scaled->bitmap->height())
-				break;
-		}
-
-		// did we get one?
-		if (scalenum == std::size(m_scaled))
-		{
-			int lowest = -1;
-
-			// didn't find one -- take the entry with the lowest seqnum
-			for (scalenum = 0; scalenum < std::size(m_scaled); scalenum++)
-				if ((lowest == -1 || m_scaled[scalenum].seqid < m_scaled[lowest].seqid) && !primlist.has_reference(m_scaled[scalenum].bitmap.get()))
-					lowest = scalenum;
-			if (-1 == lowest)
-				throw emu_fatalerror("render_texture::get_scaled: Too many live texture instances!");
-
-			// throw out any existing entries
-			scaled = &m_scaled[lowest];
-			if (scaled->bitmap)
-			{
-				m_manager->invalidate_all(scaled->bitmap.get());
-				scaled->bitmap.reset();
-			}
-
-			// allocate a new bitmap
-			scaled->bitmap = std::make_unique<bitmap_argb32>(dwidth, dheight);
-			scaled->seqid = ++m_curseq;
-
-			// let the scaler do the work
-			(*m_scaler)(*scaled->bitmap, srcbitmap, m_sbounds, m_param);
+			seqid = ++m_curseq;
+			scaled = &m_manager->scaled_alloc(*this, dwidth, dheight, seqid, primlist);
+			(*m_scaler)(*scaled, srcbitmap, m_sbounds, m_param);
 		}
 
 		// finally fill out the new info
-		primlist.add_reference(scaled->bitmap.get());
-		texinfo.base = &scaled->bitmap->pix(0);
-		texinfo.rowpixels = scaled->bitmap->rowpixels();
+		primlist.add_reference(scaled);
+		texinfo.base = &scaled->pix(0);
+		texinfo.rowpixels = scaled->rowpixels();
 		texinfo.width = dwidth;
 		texinfo.height = dheight;
 		// palette will be set later
-		texinfo.seqid = scaled->seqid;
+		texinfo.seqid = seqid;
+		texinfo.dirty_seqid = seqid - 1;
+		texinfo.dirty.set(0, dwidth - 1, 0, dheight - 1);
 	}
 }
 
@@ -565,6 +604,32 @@ const rgb_t *render_texture::get_adjusted_palette(render_container &container, u
 }
 
 
+//-------------------------------------------------
+//  set_adjusted_palette - fill in the adjusted
+//  palette for a texture, treating the whole
+//  texture as changed whenever the container's
+//  lookup tables have changed under it
+//-------------------------------------------------
+
+void render_texture::set_adjusted_palette(render_container &container, render_texinfo &texinfo)
+{
+	texinfo.palette = get_adjusted_palette(container, texinfo.palette_length);
+
+	if (m_tracked && m_palette_seq != container.lookup_seq())
+	{
+		m_palette_seq = container.lookup_seq();
+		if (texinfo.seqid == m_curseq)
+		{
+			m_dirty_seq = m_curseq;
+			m_dirty.set(0, texinfo.width - 1, 0, texinfo.height - 1);
+			texinfo.seqid = ++m_curseq;
+			texinfo.dirty_seqid = m_dirty_seq;
+			texinfo.dirty = m_dirty;
+		}
+	}
+}
+
+
 
 //**************************************************************************
 //  RENDER CONTAINER
@@ -579,6 +644,7 @@ render_container::render_container(render_manager &manager, screen_device *scree
 	, m_screen(screen)
 	, m_overlaybitmap(nullptr)
 	, m_overlaytexture(nullptr)
+	, m_lookup_seq(0)
 {
 	// make sure it is empty
 	empty();
@@ -811,6 +877,8 @@ render_container::item &render_container::add_generic(u8 type, float x0, float y
 
 void render_container::recompute_lookups()
 {
+	m_lookup_seq++;
+
 	// recompute the 256 entry lookup table
 	for (int i = 0; i < 0x100; i++)
 	{
@@ -863,6 +931,7 @@ void render_container::update_palette()
 	// iterate over dirty items and update them
 	if (dirty != nullptr)
 	{
+		m_lookup_seq++;
 		palette_t &palette = m_palclient->palette();
 		const rgb_t *adjusted_palette = palette.entry_list_adjusted();
 
@@ -2581,7 +2650,7 @@ void render_target::add_container_primitives(render_primitive_list &list, const
 					curitem.texture()->get_scaled(width, height, prim->texture, list, curitem.flags());
 
 					// set the palette
-					prim->texture.palette = curitem.texture()->get_adjusted_palette(container, prim->texture.palette_length);
+					curitem.texture()->set_adjusted_palette(container, prim->texture);
 
 					// determine UV coordinates
 					prim->texcoords = oriented_texcoords[finalorient];
@@ -3320,6 +3389,14 @@ done:
 
 render_manager::render_manager(running_machine &machine)
 	: m_machine(machine)
+	, m_scaled_bytes(0)
+	, m_scaled_budget(size_t(std::max(machine.options().scaled_texture_cache(), 0)) << 20)
+	, m_scaled_peak(0)
+	, m_scaled_hits(0)
+	, m_scaled_misses(0)
+	, m_scaled_evictions(0)
+	, m_uploaded_pixels(0)
+	, m_upload_total_pixels(0)
 	, m_ui_target(nullptr)
 	, m_live_textures(0)
 	, m_texture_id(0)
@@ -3348,6 +3425,14 @@ render_manager::~render_manager()
 
 	// better not be any outstanding textures when we die
 	assert(m_live_textures == 0);
+
+	if (m_scaled_hits + m_scaled_misses != 0)
+	{
+		osd_printf_verbose("Scaled textures: %u hits, %u misses, %u evictions, peak %u KB\n",
+				u32(m_scaled_hits), u32(m_scaled_misses), u32(m_scaled_evictions), u32(m_scaled_peak >> 10));
+	}
+	if (m_upload_total_pixels != 0)
+		osd_printf_verbose("Texture uploads: %.1f%% of refreshed texture pixels\n", double(m_uploaded_pixels) * 100.0 / double(m_upload_total_pixels));
 }
 
 
@@ -3535,6 +3620,95 @@ void render_manager::texture_free(render_texture *texture)
 }
 
 
+//-------------------------------------------------
+//  scaled_find - look up a scaled variant of a
+//  texture, making it the most recently used
+//-------------------------------------------------
+
+bitmap_argb32 *render_manager::scaled_find(render_texture &texture, u32 width, u32 height, u32 &seqid)
+{
+	auto const found = m_scaled_map.find(std::make_tuple(&texture, width, height));
+	if (found == m_scaled_map.end())
+	{
+		m_scaled_misses++;
+		return nullptr;
+	}
+
+	m_scaled_hits++;
+	m_scaled_list.splice(m_scaled_list.begin(), m_scaled_list, found->second);
+	seqid = found->second->seqid;
+	return found->second->bitmap.get();
+}
+
+
+//-------------------------------------------------
+//  scaled_alloc - add a new scaled variant of a
+//  texture, evicting the least recently used
+//  ones the primitive list being built doesn't
+//  need until it fits the budget
+//-------------------------------------------------
+
+bitmap_argb32 &render_manager::scaled_alloc(render_texture &texture, u32 width, u32 height, u32 seqid, render_primitive_list &primlist)
+{
+	size_t const bytes = size_t(width) * height * sizeof(u32);
+	auto victim = m_scaled_list.end();
+	while (m_scaled_bytes + bytes > m_scaled_budget && victim != m_scaled_list.begin())
+	{
+		--victim;
+		if (!primlist.has_reference(victim->bitmap.get()))
+		{
+			m_scaled_evictions++;
+			scaled_free(victim++);
+		}
+	}
+
+	scaled_texture &entry = m_scaled_list.emplace_front();
+	entry.texture = &texture;
+	entry.width = width;
+	entry.height = height;
+	entry.seqid = seqid;
+	entry.bitmap = std::make_unique<bitmap_argb32>(width, height);
+	m_scaled_map.emplace(std::make_tuple(&texture, width, height), m_scaled_list.begin());
+	texture.m_scaled_count++;
+
+	m_scaled_bytes += bytes;
+	m_scaled_peak = std::max(m_scaled_peak, m_scaled_bytes);
+	return *entry.bitmap;
+}
+
+
+//-------------------------------------------------
+//  scaled_purge - drop every scaled variant of a
+//  texture
+//-------------------------------------------------
+
+void render_manager::scaled_purge(render_texture &texture)
+{
+	for (auto entry = m_scaled_list.begin(); texture.m_scaled_count != 0 && entry != m_scaled_list.end(); )
+	{
+		if (entry->texture == &texture)
+			scaled_free(entry++);
+		else
+			++entry;
+	}
+}
+
+
+//-------------------------------------------------
+//  scaled_free - drop a cached scaled variant and
+//  any references to it
+//-------------------------------------------------
+
+void render_manager::scaled_free(scaled_list::iterator entry)
+{
+	invalidate_all(entry->bitmap.get());
+	m_scaled_bytes -= size_t(entry->width) * entry->height * sizeof(u32);
+	entry->texture->m_scaled_count--;
+	m_scaled_map.erase(std::make_tuple(entry->texture, entry->width, entry->height));
+	m_scaled_list.erase(entry);
+}
+
+
 //-------------------------------------------------
 //  font_alloc - allocate a new font instance
 //-------------------------------------------------
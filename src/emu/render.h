@@ -54,6 +54,8 @@
 #include <list>
 #include <memory>
 #include <mutex>
+#include <tuple>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -162,6 +164,8 @@ struct render_texinfo
 	u32                 width_margin;       // left margin of the scaled bounds, if applicable
 	u32                 height;             // height of the image
 	u32                 seqid;              // sequence ID
+	u32                 dirty_seqid;        // sequence ID the dirty area is relative to
+	rectangle           dirty;              // area changed since dirty_seqid, in texture coordinates
 	u64                 unique_id;          // unique identifier to pass to osd
 	u64                 old_id;             // previously allocated id, if applicable
 	const rgb_t *       palette;            // palette for PALETTE16 textures, bcg lookup table for RGB32/YUY16
@@ -255,11 +259,11 @@ class render_primitive_list
 {
 	friend class render_target;
 
+public:
 	// construction/destruction
 	render_primitive_list();
 	~render_primitive_list();
 
-public:
 	// getters
 	render_primitive *first() const { return m_primlist.first(); }
 
@@ -330,26 +334,22 @@ public:
 
 	// configure the texture bitmap
 	void set_bitmap(bitmap_t &bitmap, const rectangle &sbounds, texture_format format);
+	void set_bitmap(bitmap_t &bitmap, const rectangle &sbounds, texture_format format, const rectangle &dirty);
 
 	// set a unique identifier
 	void set_id(u64 id) { m_old_id = m_id; m_id = id; }
 
+	// get the bitmap and texture info to draw at the given size, holding a reference in the list
+	void get_scaled(u32 dwidth, u32 dheight, render_texinfo &texinfo, render_primitive_list &primlist, u32 flags = 0);
+
 	// generic high-quality bitmap scaler
 	static void hq_scale(bitmap_argb32 &dest, bitmap_argb32 &source, const rectangle &sbounds, void *param);
 
 private:
 	// internal helpers
-	void get_scaled(u32 dwidth, u32 dheight, render_texinfo &texinfo, render_primitive_list &primlist, u32 flags = 0);
 	const rgb_t *get_adjusted_palette(render_container &container, u32 &out_length);
-
-	static constexpr int MAX_TEXTURE_SCALES = 100;
-
-	// a scaled_texture contains a single scaled entry for a texture
-	struct scaled_texture
-	{
-		std::unique_ptr<bitmap_argb32>  bitmap;     // final bitmap
-		u32                             seqid;      // sequence number
-	};
+	void set_adjusted_palette(render_container &container, render_texinfo &texinfo);
+	void mark_all_dirty();
 
 	// internal state
 	render_manager *    m_manager;                  // reference to our manager
@@ -364,7 +364,15 @@ private:
 	texture_scaler_func m_scaler;                   // scaling callback
 	void *              m_param;                    // scaling callback parameter
 	u32                 m_curseq;                   // current sequence number
-	scaled_texture      m_scaled[MAX_TEXTURE_SCALES];// array of scaled variants of this texture
+	u32                 m_scaled_count;             // scaled variants in the manager's cache
+
+	// dirty tracking state (unscaled only)
+	bool                m_tracked;                  // whether the owner reports changed areas
+	bool                m_modified;                 // whether anything changed since the last get_scaled
+	rectangle           m_pending;                  // area changed since the last get_scaled
+	rectangle           m_dirty;                    // area changed between m_dirty_seq and m_curseq
+	u32                 m_dirty_seq;                // sequence number m_dirty is relative to
+	u32                 m_palette_seq;              // container lookup sequence number last seen
 };
 
 
@@ -402,6 +410,7 @@ public:
 	screen_device *screen() const { return m_screen; }
 	render_manager &manager() const { return m_manager; }
 	render_texture *overlay() const { return m_overlaytexture; }
+	u32 lookup_seq() const { return m_lookup_seq; }
 	int orientation() const { return m_user.m_orientation; }
 	float xscale() const { return m_user.m_xscale; }
 	float yscale() const { return m_user.m_yscale; }
@@ -482,6 +491,7 @@ private:
 	std::unique_ptr<palette_client> m_palclient;    // client to the screen palette
 	std::vector<rgb_t>      m_bcglookup;            // copy of screen palette with bcg adjustment
 	rgb_t                   m_bcglookup256[0x400];  // lookup table for brightness/contrast/gamma
+	u32                     m_lookup_seq;           // bumped whenever the lookup tables change
 };
 
 
@@ -655,6 +665,7 @@ private:
 class render_manager
 {
 	friend class render_target;
+	friend class render_texture;
 
 public:
 	// construction/destruction
@@ -688,6 +699,12 @@ public:
 	render_texture *texture_alloc(texture_scaler_func scaler = nullptr, void *param = nullptr);
 	void texture_free(render_texture *texture);
 
+	// texture uploads, as reported by OSD renderers: pixels converted and sent to the
+	// GPU, against the full size of the textures they refreshed
+	void add_texture_upload(u64 uploaded, u64 total) { m_uploaded_pixels += uploaded; m_upload_total_pixels += total; }
+	u64 uploaded_pixels() const { return m_uploaded_pixels; }
+	u64 upload_total_pixels() const { return m_upload_total_pixels; }
+
 	// fonts
 	std::unique_ptr<render_font> font_alloc(const char *filename = nullptr);
 
@@ -698,13 +715,51 @@ public:
 	void resolve_tags();
 
 private:
+	// a scaled_texture is one scaled variant of a texture, shared by every target that wants that size
+	struct scaled_texture
+	{
+		render_texture *                texture;    // texture it was scaled from
+		u32                             width;      // scaled width
+		u32                             height;     // scaled height
+		u32                             seqid;      // sequence number handed to the OSD
+		std::unique_ptr<bitmap_argb32>  bitmap;     // scaled bitmap
+	};
+	using scaled_list = std::list<scaled_texture>;
+	struct scaled_key_hash
+	{
+		size_t operator()(std::tuple<render_texture const *, u32, u32> const &key) const
+		{
+			return std::hash<render_texture const *>()(std::get<0>(key)) ^ (size_t(std::get<1>(key)) * 0x9e3779b1U) ^ (size_t(std::get<2>(key)) << 16);
+		}
+	};
+
 	// config callbacks
 	void config_load(config_type cfg_type, config_level cfg_lvl, util::xml::data_node const *parentnode);
 	void config_save(config_type cfg_type, util::xml::data_node *parentnode);
 
+	// scaled texture cache
+	bitmap_argb32 *scaled_find(render_texture &texture, u32 width, u32 height, u32 &seqid);
+	bitmap_argb32 &scaled_alloc(render_texture &texture, u32 width, u32 height, u32 seqid, render_primitive_list &primlist);
+	void scaled_purge(render_texture &texture);
+	void scaled_free(scaled_list::iterator entry);
+
 	// internal state
 	running_machine &               m_machine;                  // reference back to the machine
 
+	// scaled textures, most recently used first; declared first so it outlives the targets and textures
+	scaled_list                     m_scaled_list;              // cached scaled variants
+	std::unordered_map<std::tuple<render_texture const *, u32, u32>, scaled_list::iterator, scaled_key_hash> m_scaled_map; // lookup by texture and size
+	size_t                          m_scaled_bytes;             // memory held by the cache
+	size_t                          m_scaled_budget;            // memory the cache may hold before evicting
+	size_t                          m_scaled_peak;              // most memory the cache has held
+	u64                             m_scaled_hits;              // lookups satisfied from the cache
+	u64                             m_scaled_misses;            // lookups that had to scale
+	u64                             m_scaled_evictions;         // variants dropped to stay within budget
+
+	// texture upload statistics
+	u64                             m_uploaded_pixels;          // pixels the OSD uploaded
+	u64                             m_upload_total_pixels;      // pixels in the textures it refreshed
+
 	// array of live targets
 	simple_list<render_target>      m_targetlist;               // list of targets
 	render_target *                 m_ui_target;                // current UI target
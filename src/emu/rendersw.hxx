@@ -11,11 +11,18 @@
 
 #include "emucore.h"
 #include "eminline.h"
+#include "video/rgbspan.h"
 #include "video/rgbutil.h"
 #include "render.h"
 
+#include "osdcore.h"
 
-template <typename PixelType, int SrcShiftR, int SrcShiftG, int SrcShiftB, int DstShiftR, int DstShiftG, int DstShiftB, bool NoDestRead = false, bool BilinearFilter = false>
+#include <algorithm>
+#include <array>
+#include <type_traits>
+
+
+template <typename PixelType, int SrcShiftR, int SrcShiftG, int SrcShiftB, int DstShiftR, int DstShiftG, int DstShiftB, bool NoDestRead = false, bool BilinearFilter = false, bool SimdSpans = true>
 class software_renderer
 {
 private:
@@ -57,6 +64,11 @@ private:
 			return dest_assemble_rgb(source32_r(pixel), source32_g(pixel), source32_b(pixel));
 	}
 
+	// rows are combined with the SIMD span kernels when the destination is in the standard format
+	static constexpr bool UseSpans = SimdSpans && rgb_span::enabled && std::is_same_v<PixelType, u32> &&
+			SrcShiftR == 0 && SrcShiftG == 0 && SrcShiftB == 0 && DstShiftR == 16 && DstShiftG == 8 && DstShiftB == 0;
+	static constexpr s32 SPAN_CHUNK = 64;
+
 
 	//-------------------------------------------------
 	//  ycc_to_rgb - convert YCC to RGB; the YCC pixel
@@ -424,10 +436,16 @@ private:
 	//  draw_line - draw a line or point
 	//-------------------------------------------------
 
-	static void draw_line(render_primitive const &prim, PixelType *dstdata, s32 width, s32 height, u32 pitch)
+	static void draw_line(render_primitive const &prim, PixelType *dstdata, s32 width, s32 top, s32 bottom, u32 pitch)
 	{
-		// internal tables
-		static u32 s_cosine_table[2049];
+		// internal tables, built once even when several bands draw lines at the same time
+		static std::array<u32, 2049> const s_cosine_table = []
+		{
+			std::array<u32, 2049> table;
+			for (int entry = 0; entry <= 2048; entry++)
+				table[entry] = int(double(1.0 / cos(atan(double(entry) / 2048.0))) * 0x10000000 + 0.5);
+			return table;
+		}();
 
 		// compute the start/end coordinates
 		int x1 = int(prim.bounds.x0 * 65536.0f);
@@ -440,11 +458,6 @@ private:
 
 		if (PRIMFLAG_GET_ANTIALIAS(prim.flags))
 		{
-			// build up the cosine table if we haven't yet
-			if (s_cosine_table[0] == 0)
-				for (int entry = 0; entry <= 2048; entry++)
-					s_cosine_table[entry] = int(double(1.0 / cos(atan(double(entry) / 2048.0))) * 0x10000000 + 0.5);
-
 			int beam = prim.width * 65536.0f;
 			if (beam < 0x00010000)
 				beam = 0x00010000;
@@ -469,7 +482,7 @@ private:
 					{
 						dx = bwidth;    // init diameter of beam
 						dy = y1 >> 16;
-						if (dy >= 0 && dy < height)
+						if (dy >= top && dy < bottom)
 							draw_aa_pixel(dstdata, pitch, x1, dy, apply_intensity(0xff & (~y1 >> 8), col));
 						dy++;
 						dx -= 0x10000 - (0xffff & y1); // take off amount plotted
@@ -477,11 +490,11 @@ private:
 						dx >>= 16;                   // adjust to pixel (solid) count
 						while (dx--)                 // plot rest of pixels
 						{
-							if (dy >= 0 && dy < height)
+							if (dy >= top && dy < bottom)
 								draw_aa_pixel(dstdata, pitch, x1, dy, col);
 							dy++;
 						}
-						if (dy >= 0 && dy < height)
+						if (dy >= top && dy < bottom)
 							draw_aa_pixel(dstdata, pitch, x1, dy, apply_intensity(a1,col));
 					}
 					if (x1 == xx) break;
@@ -501,7 +514,7 @@ private:
 				x1 -= bwidth >> 1; // start back half the width
 				for (;;)
 				{
-					if (y1 >= 0 && y1 < height)
+					if (y1 >= top && y1 < bottom)
 					{
 						dy = bwidth;    // calc diameter of beam
 						dx = x1 >> 16;
@@ -544,7 +557,7 @@ private:
 			{
 				for (;;)
 				{
-					if (x1 >= 0 && x1 < width && y1 >= 0 && y1 < height)
+					if (x1 >= 0 && x1 < width && y1 >= top && y1 < bottom)
 						draw_aa_pixel(dstdata, pitch, x1, y1, col);
 					if (x1 == x2) break;
 					x1 += sx;
@@ -560,7 +573,7 @@ private:
 			{
 				for (;;)
 				{
-					if (x1 >= 0 && x1 < width && y1 >= 0 && y1 < height)
+					if (x1 >= 0 && x1 < width && y1 >= top && y1 < bottom)
 						draw_aa_pixel(dstdata, pitch, x1, y1, col);
 					if (y1 == y2) break;
 					y1 += sy;
@@ -585,7 +598,7 @@ private:
 	//  draw_rect - draw a solid rectangle
 	//-------------------------------------------------
 
-	static void draw_rect(render_primitive const &prim, PixelType *dstdata, s32 width, s32 height, u32 pitch)
+	static void draw_rect(render_primitive const &prim, PixelType *dstdata, s32 width, s32 top, s32 bottom, u32 pitch)
 	{
 		render_bounds const fpos = prim.bounds;
 		assert(fpos.x0 <= fpos.x1);
@@ -593,9 +606,9 @@ private:
 
 		// clamp to integers and ensure we fit
 		s32 const startx = std::clamp<s32>(round_nearest(fpos.x0), 0, width);
-		s32 const starty = std::clamp<s32>(round_nearest(fpos.y0), 0, height);
+		s32 const starty = std::clamp<s32>(round_nearest(fpos.y0), top, bottom);
 		s32 const endx = std::clamp<s32>(round_nearest(fpos.x1), 0, width);
-		s32 const endy = std::clamp<s32>(round_nearest(fpos.y1), 0, height);
+		s32 const endy = std::clamp<s32>(round_nearest(fpos.y1), top, bottom);
 
 		// bail if nothing left
 		if ((startx > endx) || (starty > endy))
@@ -662,6 +675,73 @@ private:
 	}
 
 
+	//**************************************************************************
+	//  SPAN HELPERS
+	//**************************************************************************
+
+	//-------------------------------------------------
+	//  draw_span_row - fetch one row of a quad into
+	//  a texel buffer a chunk at a time, and hand
+	//  each chunk to a span kernel
+	//-------------------------------------------------
+
+	template <bool Clamped32, typename Fetch, typename Kernel>
+	static inline void draw_span_row(PixelType *dest, render_texinfo const &texture, s32 curu, s32 curv, quad_setup_data const &setup, Fetch &&fetch, Kernel &&kernel)
+	{
+		u32 texels[SPAN_CHUNK];
+		for (s32 remaining = setup.endx - setup.startx; remaining > 0; )
+		{
+			s32 const count = std::min(remaining, SPAN_CHUNK);
+			if constexpr (Clamped32)
+			{
+				// point sampled 32bpp texels can be gathered directly
+				rgb_span::fetch_clamped(texels, reinterpret_cast<u32 const *>(texture.base), texture.rowpixels, texture.width, texture.height, curu, curv, setup.dudx, setup.dvdx, count);
+				curu += setup.dudx * count;
+				curv += setup.dvdx * count;
+			}
+			else
+			{
+				for (s32 x = 0; x < count; x++)
+				{
+					texels[x] = fetch(texture, curu, curv);
+					curu += setup.dudx;
+					curv += setup.dvdx;
+				}
+			}
+			kernel(reinterpret_cast<u32 *>(dest), texels, count);
+			dest += count;
+			remaining -= count;
+		}
+	}
+
+
+	//-------------------------------------------------
+	//  spans_can_blend - determine whether the span
+	//  kernels reproduce a constant alpha blend; the
+	//  scalar blend carries into the neighbouring
+	//  channel when the factors sum to more than 256
+	//-------------------------------------------------
+
+	static constexpr bool spans_can_blend(u32 sr, u32 sg, u32 sb, u32 invsa)
+	{
+		return UseSpans && (NoDestRead || (std::max({ sr, sg, sb }) + invsa <= 0x100));
+	}
+
+
+	//-------------------------------------------------
+	//  blend_span - blend a chunk of texels into the
+	//  destination with constant factors
+	//-------------------------------------------------
+
+	static inline void blend_span(u32 *dest, u32 const *src, s32 count, u32 sr, u32 sg, u32 sb, u32 invsa)
+	{
+		if constexpr (NoDestRead)
+			rgb_span::modulate(dest, src, count, sr, sg, sb);
+		else
+			rgb_span::blend_const(dest, src, count, sr, sg, sb, invsa);
+	}
+
+
 	//**************************************************************************
 	//  16-BIT PALETTE RASTERIZERS
 	//**************************************************************************
@@ -713,6 +793,14 @@ private:
 				s32 curu = setup.startu + (y - setup.starty) * setup.dudy;
 				s32 curv = setup.startv + (y - setup.starty) * setup.dvdy;
 
+				if constexpr (UseSpans)
+				{
+					draw_span_row<false>(dest, prim.texture, curu, curv, setup,
+							[] (render_texinfo const &texture, s32 u, s32 v) { return get_texel_palette16(texture, u, v); },
+							[sr, sg, sb] (u32 *d, u32 const *s, s32 n) { rgb_span::modulate(d, s, n, sr, sg, sb); });
+					continue;
+				}
+
 				// loop over cols
 				for (s32 x = setup.startx; x < setup.endx; x++)
 				{
@@ -736,6 +824,7 @@ private:
 			u32 const sg = u32(std::clamp(256.0f * prim.color.g * prim.color.a, 0.0f, 256.0f));
 			u32 const sb = u32(std::clamp(256.0f * prim.color.b * prim.color.a, 0.0f, 256.0f));
 			u32 const invsa = u32(std::clamp(256.0f * (1.0f - prim.color.a), 0.0f, 256.0f));
+			bool const spans = spans_can_blend(sr, sg, sb, invsa);
 
 			// loop over rows
 			for (s32 y = setup.starty; y < setup.endy; y++)
@@ -744,6 +833,14 @@ private:
 				s32 curu = setup.startu + (y - setup.starty) * setup.dudy;
 				s32 curv = setup.startv + (y - setup.starty) * setup.dvdy;
 
+				if (spans)
+				{
+					draw_span_row<false>(dest, prim.texture, curu, curv, setup,
+							[] (render_texinfo const &texture, s32 u, s32 v) { return get_texel_palette16(texture, u, v); },
+							[sr, sg, sb, invsa] (u32 *d, u32 const *s, s32 n) { blend_span(d, s, n, sr, sg, sb, invsa); });
+					continue;
+				}
+
 				// loop over cols
 				for (s32 x = setup.startx; x < setup.endx; x++)
 				{
@@ -1042,7 +1139,12 @@ private:
 				s32 curu = setup.startu + (y - setup.starty) * setup.dudy;
 				s32 curv = setup.startv + (y - setup.starty) * setup.dvdy;
 
-				if (!palbase)
+				if (UseSpans && !BilinearFilter && !Wrap && !palbase)
+				{
+					// point sampled no lookup case: gather straight into the destination
+					rgb_span::fetch_clamped(reinterpret_cast<u32 *>(dest), reinterpret_cast<u32 const *>(prim.texture.base), prim.texture.rowpixels, prim.texture.width, prim.texture.height, curu, curv, setup.dudx, setup.dvdx, setup.endx - setup.startx);
+				}
+				else if (!palbase)
 				{
 					// no lookup case
 
@@ -1090,7 +1192,14 @@ private:
 				s32 curu = setup.startu + (y - setup.starty) * setup.dudy;
 				s32 curv = setup.startv + (y - setup.starty) * setup.dvdy;
 
-				if (!palbase)
+				if (UseSpans && !palbase)
+				{
+					// no lookup case, a chunk at a time
+					draw_span_row<!BilinearFilter && !Wrap>(dest, prim.texture, curu, curv, setup,
+							[] (render_texinfo const &texture, s32 u, s32 v) { return get_texel_rgb32<Wrap>(texture, u, v); },
+							[sr, sg, sb] (u32 *d, u32 const *s, s32 n) { rgb_span::modulate(d, s, n, sr, sg, sb); });
+				}
+				else if (!palbase)
 				{
 					// no lookup case
 
@@ -1135,6 +1244,7 @@ private:
 			u32 const sg = u32(std::clamp(256.0f * prim.color.g * prim.color.a, 0.0f, 256.0f));
 			u32 const sb = u32(std::clamp(256.0f * prim.color.b * prim.color.a, 0.0f, 256.0f));
 			u32 const invsa = u32(std::clamp(256.0f * (1.0f - prim.color.a), 0.0f, 256.0f));
+			bool const spans = spans_can_blend(sr, sg, sb, invsa);
 
 			// loop over rows
 			for (s32 y = setup.starty; y < setup.endy; y++)
@@ -1143,7 +1253,14 @@ private:
 				s32 curu = setup.startu + (y - setup.starty) * setup.dudy;
 				s32 curv = setup.startv + (y - setup.starty) * setup.dvdy;
 
-				if (!palbase)
+				if (spans && !palbase)
+				{
+					// no lookup case, a chunk at a time
+					draw_span_row<!BilinearFilter && !Wrap>(dest, prim.texture, curu, curv, setup,
+							[] (render_texinfo const &texture, s32 u, s32 v) { return get_texel_rgb32<Wrap>(texture, u, v); },
+							[sr, sg, sb, invsa] (u32 *d, u32 const *s, s32 n) { blend_span(d, s, n, sr, sg, sb, invsa); });
+				}
+				else if (!palbase)
 				{
 					// no lookup case
 
@@ -1209,7 +1326,14 @@ private:
 				s32 curu = setup.startu + (y - setup.starty) * setup.dudy;
 				s32 curv = setup.startv + (y - setup.starty) * setup.dvdy;
 
-				if (!palbase)
+				if (UseSpans && !palbase)
+				{
+					// no lookup case, a chunk at a time
+					draw_span_row<!BilinearFilter && !Wrap>(dest, prim.texture, curu, curv, setup,
+							[] (render_texinfo const &texture, s32 u, s32 v) { return get_texel_argb32<Wrap>(texture, u, v); },
+							[] (u32 *d, u32 const *s, s32 n) { rgb_span::add_saturate(d, s, n); });
+				}
+				else if (!palbase)
 				{
 					// no lookup case
 
@@ -1268,7 +1392,14 @@ private:
 				s32 curu = setup.startu + (y - setup.starty) * setup.dudy;
 				s32 curv = setup.startv + (y - setup.starty) * setup.dvdy;
 
-				if (!palbase)
+				if (UseSpans && !palbase)
+				{
+					// no lookup case, a chunk at a time
+					draw_span_row<!BilinearFilter && !Wrap>(dest, prim.texture, curu, curv, setup,
+							[] (render_texinfo const &texture, s32 u, s32 v) { return get_texel_argb32<Wrap>(texture, u, v); },
+							[sr, sg, sb, sa] (u32 *d, u32 const *s, s32 n) { rgb_span::add_scaled(d, s, n, sr, sg, sb, sa); });
+				}
+				else if (!palbase)
 				{
 					// no lookup case
 
@@ -1458,7 +1589,14 @@ private:
 				s32 curu = setup.startu + (y - setup.starty) * setup.dudy;
 				s32 curv = setup.startv + (y - setup.starty) * setup.dvdy;
 
-				if (!palbase)
+				if (UseSpans && !NoDestRead && !palbase)
+				{
+					// no lookup case, a chunk at a time
+					draw_span_row<!BilinearFilter && !Wrap>(dest, prim.texture, curu, curv, setup,
+							[] (render_texinfo const &texture, s32 u, s32 v) { return get_texel_argb32<Wrap>(texture, u, v); },
+							[] (u32 *d, u32 const *s, s32 n) { rgb_span::blend_alpha(d, s, n); });
+				}
+				else if (!palbase)
 				{
 					// no lookup case
 
@@ -1602,7 +1740,14 @@ private:
 				s32 curu = setup.startu + (y - setup.starty) * setup.dudy;
 				s32 curv = setup.startv + (y - setup.starty) * setup.dvdy;
 
-				if (!palbase)
+				if (UseSpans && !palbase)
+				{
+					// no lookup case, a chunk at a time
+					draw_span_row<!BilinearFilter && !Wrap>(dest, prim.texture, curu, curv, setup,
+							[] (render_texinfo const &texture, s32 u, s32 v) { return get_texel_argb32<Wrap>(texture, u, v); },
+							[] (u32 *d, u32 const *s, s32 n) { rgb_span::add_alpha(d, s, n); });
+				}
+				else if (!palbase)
 				{
 					// no lookup case
 
@@ -1736,7 +1881,7 @@ private:
 	//  drawing routine
 	//-------------------------------------------------
 
-	static void setup_and_draw_textured_quad(render_primitive const &prim, PixelType *dstdata, s32 width, s32 height, u32 pitch)
+	static void setup_and_draw_textured_quad(render_primitive const &prim, PixelType *dstdata, s32 width, s32 top, s32 bottom, u32 pitch)
 	{
 		assert(prim.bounds.x0 <= prim.bounds.x1);
 		assert(prim.bounds.y0 <= prim.bounds.y1);
@@ -1760,9 +1905,9 @@ private:
 		if (setup.endx < 0) setup.endx = 0;
 		if (setup.endx >= width) setup.endx = width;
 		if (setup.starty < 0) setup.starty = 0;
-		if (setup.starty >= height) setup.starty = height;
+		if (setup.starty >= bottom) setup.starty = bottom;
 		if (setup.endy < 0) setup.endy = 0;
-		if (setup.endy >= height) setup.endy = height;
+		if (setup.endy >= bottom) setup.endy = bottom;
 
 		// compute start and delta U,V coordinates now
 		setup.dudx = round_nearest(65536.0f * float(prim.texture.width) * fdudx);
@@ -1783,6 +1928,15 @@ private:
 			setup.startv -= 0x8000;
 		}
 
+		// when drawing a band, start part way down the quad exactly where the full quad would be
+		if (setup.starty < top)
+		{
+			setup.startu += (top - setup.starty) * setup.dudy;
+			setup.startv += (top - setup.starty) * setup.dvdy;
+			setup.starty = top;
+			if (setup.endy < top) setup.endy = top;
+		}
+
 		// render based on the texture coordinates
 		switch (prim.flags & (PRIMFLAG_TEXFORMAT_MASK | PRIMFLAG_BLENDMODE_MASK))
 		{
@@ -1850,34 +2004,111 @@ private:
 
 
 	//**************************************************************************
-	//  PRIMARY ENTRY POINT
+	//  BAND RENDERING
 	//**************************************************************************
 
 	//-------------------------------------------------
-	//  draw_primitives - draw a series of primitives
-	//  using a software rasterizer
+	//  draw_band - draw the rows from top to bottom
+	//  of a series of primitives
 	//-------------------------------------------------
 
-public:
-	static void draw_primitives(render_primitive_list const &primlist, void *dstdata, u32 width, u32 height, u32 pitch)
+	static void draw_band(render_primitive const *first, PixelType *dstdata, s32 width, s32 top, s32 bottom, u32 pitch)
 	{
 		// loop over the list and render each element
-		for (render_primitive const *prim = primlist.first(); prim != nullptr; prim = prim->next())
+		for (render_primitive const *prim = first; prim != nullptr; prim = prim->next())
 			switch (prim->type)
 			{
 				case render_primitive::LINE:
-					draw_line(*prim, reinterpret_cast<PixelType *>(dstdata), width, height, pitch);
+					draw_line(*prim, dstdata, width, top, bottom, pitch);
 					break;
 
 				case render_primitive::QUAD:
+					// skip quads entirely outside the band before doing any setup
+					if (round_nearest(prim->bounds.y1) <= top || round_nearest(prim->bounds.y0) >= bottom)
+						break;
 					if (!prim->texture.base)
-						draw_rect(*prim, reinterpret_cast<PixelType *>(dstdata), width, height, pitch);
+						draw_rect(*prim, dstdata, width, top, bottom, pitch);
 					else
-						setup_and_draw_textured_quad(*prim, reinterpret_cast<PixelType *>(dstdata), width, height, pitch);
+						setup_and_draw_textured_quad(*prim, dstdata, width, top, bottom, pitch);
 					break;
 
 				default:
 					throw emu_fatalerror("Unexpected render_primitive type");
 			}
 	}
+
+
+	//-------------------------------------------------
+	//  draw_band_work - work queue callback for
+	//  rendering a single band
+	//-------------------------------------------------
+
+	struct band_params
+	{
+		render_primitive const *first;
+		PixelType *dstdata;
+		s32 width, top, bottom;
+		u32 pitch;
+	};
+
+	static void *draw_band_work(void *param, int)
+	{
+		band_params const &band = *reinterpret_cast<band_params const *>(param);
+		draw_band(band.first, band.dstdata, band.width, band.top, band.bottom, band.pitch);
+		return nullptr;
+	}
+
+
+	//**************************************************************************
+	//  PRIMARY ENTRY POINT
+	//**************************************************************************
+
+public:
+	// most bands a frame can be split into
+	static constexpr u32 MAX_BANDS = 64;
+
+	//-------------------------------------------------
+	//  draw_primitives - draw a series of primitives
+	//  using a software rasterizer
+	//-------------------------------------------------
+
+	static void draw_primitives(render_primitive const *first, void *dstdata, u32 width, u32 height, u32 pitch)
+	{
+		draw_band(first, reinterpret_cast<PixelType *>(dstdata), width, 0, height, pitch);
+	}
+
+	static void draw_primitives(render_primitive_list const &primlist, void *dstdata, u32 width, u32 height, u32 pitch)
+	{
+		draw_primitives(primlist.first(), dstdata, width, height, pitch);
+	}
+
+
+	//-------------------------------------------------
+	//  draw_primitives - draw a series of primitives
+	//  in horizontal bands on a work queue; the
+	//  output is identical to drawing them serially
+	//-------------------------------------------------
+
+	static void draw_primitives(render_primitive const *first, void *dstdata, u32 width, u32 height, u32 pitch, osd_work_queue *queue, u32 bands)
+	{
+		// never split into more bands than there are rows
+		bands = std::min({ bands, MAX_BANDS, height });
+		if (!queue || bands < 2)
+		{
+			draw_primitives(first, dstdata, width, height, pitch);
+			return;
+		}
+
+		band_params params[MAX_BANDS];
+		for (u32 band = 0; band < bands; band++)
+			params[band] = band_params{ first, reinterpret_cast<PixelType *>(dstdata), s32(width), s32(height * band / bands), s32(height * (band + 1) / bands), pitch };
+
+		osd_work_item_queue_multiple(queue, draw_band_work, bands, params, sizeof(params[0]), WORK_ITEM_FLAG_AUTO_RELEASE);
+		while (!osd_work_queue_wait(queue, osd_ticks_per_second())) { }
+	}
+
+	static void draw_primitives(render_primitive_list const &primlist, void *dstdata, u32 width, u32 height, u32 pitch, osd_work_queue *queue, u32 bands)
+	{
+		draw_primitives(primlist.first(), dstdata, width, height, pitch, queue, bands);
+	}
 };
@@ -0,0 +1,131 @@
+// license:BSD-3-Clause
+// copyright-holders:agent
+/***************************************************************************
+
+    resampler.cpp
+
+    Windowed-sinc polyphase resampling for sound streams.
+
+***************************************************************************/
+
+#include "emu.h"
+#include "resampler.h"
+
+#include <cmath>
+
+
+namespace {
+
+//**************************************************************************
+//  QUALITY LEVELS
+//**************************************************************************
+
+struct resampler_quality_params
+{
+	u32 taps;                             // taps per phase when not downsampling
+	u32 phases;                           // phases in the table
+	double beta;                          // Kaiser window shape
+	double rolloff;                       // passband edge, as a fraction of the lower Nyquist frequency
+};
+
+const resampler_quality_params s_quality_params[] =
+{
+	{ 16,  64,  6.0, 0.85 },              // QUALITY_LOW
+	{ 32, 128,  8.0, 0.90 },              // QUALITY_MEDIUM
+	{ 64, 256, 10.0, 0.94 }               // QUALITY_HIGH
+};
+
+// downsampling widens the window in proportion, up to this many taps
+constexpr u32 MAX_TAPS = 1024;
+
+
+//-------------------------------------------------
+//  bessel_i0 - zeroth-order modified Bessel
+//  function of the first kind, for the Kaiser
+//  window
+//-------------------------------------------------
+
+double bessel_i0(double x)
+{
+	double sum = 1.0, term = 1.0;
+	double const half = x * 0.5;
+	for (int k = 1; k < 64 && term > sum * 1e-12; k++)
+	{
+		term *= (half / k) * (half / k);
+		sum += term;
+	}
+	return sum;
+}
+
+} // anonymous namespace
+
+
+
+//**************************************************************************
+//  POLYPHASE RESAMPLER
+//**************************************************************************
+
+//-------------------------------------------------
+//  polyphase_resampler - build the coefficient
+//  tables for one pair of rates
+//-------------------------------------------------
+
+polyphase_resampler::polyphase_resampler(u32 input_rate, u32 output_rate, int quality) :
+	m_input_rate(input_rate),
+	m_output_rate(output_rate),
+	m_quality(std::clamp(quality, QUALITY_LOW, QUALITY_HIGH)),
+	m_taps(0),
+	m_phases(0),
+	m_step(0),
+	m_coef(nullptr),
+	m_delta(nullptr)
+{
+	resampler_quality_params const &params = s_quality_params[m_quality - QUALITY_LOW];
+	double const ratio = double(input_rate) / double(output_rate);
+
+	// when downsampling, the cutoff drops to the output's Nyquist frequency and the
+	// window widens to keep the same number of zero crossings
+	double const scale = std::min(1.0, 1.0 / ratio);
+	double const cutoff = 0.5 * params.rolloff * scale;
+	m_taps = std::min<u32>(MAX_TAPS, (u32(std::ceil(params.taps * std::max(1.0, ratio))) + 7) & ~7);
+	m_phases = params.phases;
+	m_step = u64(std::llround(ratio * 4294967296.0));
+
+	// one row per phase plus one for the far end, then the deltas between rows
+	m_storage.resize((2 * m_phases + 1) * m_taps / 8);
+	m_coef = m_storage[0].value;
+	m_delta = m_coef + (m_phases + 1) * m_taps;
+
+	double const half = double(m_taps) * 0.5;
+	double const norm = 1.0 / bessel_i0(params.beta);
+	std::vector<double> row(m_taps);
+	for (u32 phase = 0; phase <= m_phases; phase++)
+	{
+		// tap k sits this far from the point being reconstructed
+		double const frac = double(phase) / double(m_phases);
+		double sum = 0.0;
+		for (u32 k = 0; k < m_taps; k++)
+		{
+			double const distance = double(k) - half + 1.0 - frac;
+			double const edge = distance / half;
+			double value = 0.0;
+			if (edge > -1.0 && edge < 1.0)
+			{
+				double const x = 2.0 * cutoff * distance;
+				double const sinc = (x == 0.0) ? 1.0 : std::sin(M_PI * x) / (M_PI * x);
+				value = 2.0 * cutoff * sinc * bessel_i0(params.beta * std::sqrt(1.0 - edge * edge)) * norm;
+			}
+			row[k] = value;
+			sum += value;
+		}
+
+		// normalize each phase to unity gain at DC
+		float *const dest = m_coef + phase * m_taps;
+		for (u32 k = 0; k < m_taps; k++)
+			dest[k] = float(row[k] / sum);
+	}
+
+	for (u32 phase = 0; phase < m_phases; phase++)
+		for (u32 k = 0; k < m_taps; k++)
+			m_delta[phase * m_taps + k] = m_coef[(phase + 1) * m_taps + k] - m_coef[phase * m_taps + k];
+}
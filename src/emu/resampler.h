@@ -0,0 +1,154 @@
+// license:BSD-3-Clause
+// copyright-holders:agent
+/***************************************************************************
+
+    resampler.h
+
+    Windowed-sinc polyphase resampling for sound streams.
+
+    A polyphase_resampler holds the coefficient tables for one pair
+    of sample rates at one quality level; the sound manager builds
+    each one once and shares it between every resampler stream that
+    converts between those rates. Each output sample is the dot
+    product of a window of input samples with a row of coefficients
+    interpolated between the two nearest of the table's phases.
+
+    The dot products are vectorized, with the instruction set picked
+    at compile time the same way rgbspan.h picks one.
+
+***************************************************************************/
+
+#ifndef MAME_EMU_RESAMPLER_H
+#define MAME_EMU_RESAMPLER_H
+
+#pragma once
+
+#include <vector>
+
+#if (!defined(MAME_DEBUG) || defined(__OPTIMIZE__)) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)))
+#define MAME_RESAMPLER_SSE
+#include <emmintrin.h>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define MAME_RESAMPLER_NEON
+#include <arm_neon.h>
+#endif
+
+
+// ======================> polyphase_resampler
+
+class polyphase_resampler
+{
+public:
+	// quality levels, as selected by the resampler_quality option
+	static constexpr int QUALITY_LOW = 1;
+	static constexpr int QUALITY_MEDIUM = 2;
+	static constexpr int QUALITY_HIGH = 3;
+
+	// construction/destruction
+	polyphase_resampler(u32 input_rate, u32 output_rate, int quality);
+	polyphase_resampler(polyphase_resampler const &) = delete;
+	polyphase_resampler &operator=(polyphase_resampler const &) = delete;
+
+	// getters
+	u32 input_rate() const { return m_input_rate; }
+	u32 output_rate() const { return m_output_rate; }
+	int quality() const { return m_quality; }
+	u32 taps() const { return m_taps; }
+	u32 phases() const { return m_phases; }
+
+	// input samples of delay needed so that every output's window has arrived; the
+	// reconstructed signal lags the input by half of this
+	u32 latency() const { return m_taps; }
+
+	// 32.32 fixed-point input step per output sample
+	u64 step() const { return m_step; }
+
+	// produce 'count' output samples; output N reads input[(position >> 32) + k] for each
+	// tap k, where position = 'start' + N * step(), and reconstructs the input at
+	// (position >> 32) + taps() / 2 - 1 plus the fraction of position
+	void process(float *output, s32 count, float const *input, u64 start) const
+	{
+		u64 position = start;
+		for (s32 index = 0; index < count; index++, position += m_step)
+		{
+			u64 const scaled = (position & 0xffffffff) * m_phases;
+			u32 const phase = u32(scaled >> 32);
+			float const weight = float(u32(scaled)) * (1.0F / 4294967296.0F);
+			output[index] = dot(input + (position >> 32), &m_coef[phase * m_taps], &m_delta[phase * m_taps], m_taps, weight);
+		}
+	}
+
+private:
+	// sum of input[k] * (coef[k] + weight * delta[k]); 'taps' is a multiple of 8
+	static float dot(float const *input, float const *coef, float const *delta, u32 taps, float weight)
+	{
+#if defined(MAME_RESAMPLER_SSE) && defined(__AVX2__)
+		__m256 sum = _mm256_setzero_ps(), sumdelta = _mm256_setzero_ps();
+		for (u32 k = 0; k < taps; k += 8)
+		{
+			__m256 const x = _mm256_loadu_ps(input + k);
+			sum = _mm256_add_ps(sum, _mm256_mul_ps(x, _mm256_load_ps(coef + k)));
+			sumdelta = _mm256_add_ps(sumdelta, _mm256_mul_ps(x, _mm256_load_ps(delta + k)));
+		}
+		__m256 const total = _mm256_add_ps(sum, _mm256_mul_ps(sumdelta, _mm256_set1_ps(weight)));
+		__m128 const half = _mm_add_ps(_mm256_castps256_ps128(total), _mm256_extractf128_ps(total, 1));
+		__m128 const pair = _mm_add_ps(half, _mm_movehl_ps(half, half));
+		return _mm_cvtss_f32(_mm_add_ss(pair, _mm_shuffle_ps(pair, pair, 1)));
+#elif defined(MAME_RESAMPLER_SSE)
+		__m128 sum0 = _mm_setzero_ps(), sum1 = _mm_setzero_ps();
+		__m128 delta0 = _mm_setzero_ps(), delta1 = _mm_setzero_ps();
+		for (u32 k = 0; k < taps; k += 8)
+		{
+			__m128 const x0 = _mm_loadu_ps(input + k), x1 = _mm_loadu_ps(input + k + 4);
+			sum0 = _mm_add_ps(sum0, _mm_mul_ps(x0, _mm_load_ps(coef + k)));
+			sum1 = _mm_add_ps(sum1, _mm_mul_ps(x1, _mm_load_ps(coef + k + 4)));
+			delta0 = _mm_add_ps(delta0, _mm_mul_ps(x0, _mm_load_ps(delta + k)));
+			delta1 = _mm_add_ps(delta1, _mm_mul_ps(x1, _mm_load_ps(delta + k + 4)));
+		}
+		__m128 const total = _mm_add_ps(_mm_add_ps(sum0, sum1), _mm_mul_ps(_mm_add_ps(delta0, delta1), _mm_set1_ps(weight)));
+		__m128 const pair = _mm_add_ps(total, _mm_movehl_ps(total, total));
+		return _mm_cvtss_f32(_mm_add_ss(pair, _mm_shuffle_ps(pair, pair, 1)));
+#elif defined(MAME_RESAMPLER_NEON)
+		float32x4_t sum0 = vdupq_n_f32(0), sum1 = vdupq_n_f32(0);
+		float32x4_t delta0 = vdupq_n_f32(0), delta1 = vdupq_n_f32(0);
+		for (u32 k = 0; k < taps; k += 8)
+		{
+			float32x4_t const x0 = vld1q_f32(input + k), x1 = vld1q_f32(input + k + 4);
+			sum0 = vmlaq_f32(sum0, x0, vld1q_f32(coef + k));
+			sum1 = vmlaq_f32(sum1, x1, vld1q_f32(coef + k + 4));
+			delta0 = vmlaq_f32(delta0, x0, vld1q_f32(delta + k));
+			delta1 = vmlaq_f32(delta1, x1, vld1q_f32(delta + k + 4));
+		}
+		float32x4_t const total = vmlaq_n_f32(vaddq_f32(sum0, sum1), vaddq_f32(delta0, delta1), weight);
+		float32x2_t const pair = vadd_f32(vget_low_f32(total), vget_high_f32(total));
+		return vget_lane_f32(vpadd_f32(pair, pair), 0);
+#else
+		float sum = 0, sumdelta = 0;
+		for (u32 k = 0; k < taps; k++)
+		{
+			sum += input[k] * coef[k];
+			sumdelta += input[k] * delta[k];
+		}
+		return sum + weight * sumdelta;
+#endif
+	}
+
+	// simple aligned storage for the tables
+	struct alignas(32) block { float value[8]; };
+
+	// internal state
+	u32 m_input_rate;                     // input sample rate
+	u32 m_output_rate;                    // output sample rate
+	int m_quality;                        // quality level
+	u32 m_taps;                           // taps per phase, a multiple of 8
+	u32 m_phases;                         // number of phases
+	u64 m_step;                           // 32.32 input step per output sample
+	std::vector<block> m_storage;         // coefficient rows, then rows of deltas to the next phase
+	float *m_coef;                        // pointer to the first row
+	float *m_delta;                       // pointer to the first row of deltas
+};
+
+#endif // MAME_EMU_RESAMPLER_H
@@ -1216,6 +1216,9 @@ void rom_load_manager::process_disk_entries(
 				m_knownbad++;
 			}
 
+			// cache and prefetch decompressed hunks as configured
+			chd->orig_chd().set_read_cache(std::max(machine().options().chd_cache(), 0), std::max(machine().options().chd_prefetch(), 0));
+
 			// if not read-only, open or create the diff file
 			if (!DISK_ISREADONLY(romp))
 			{
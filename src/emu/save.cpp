@@ -25,6 +25,7 @@
 #include "emu.h"
 #include "emuopts.h"
 
+#include "fileio.h"
 #include "main.h"
 
 #include "util/ioprocs.h"
@@ -48,6 +49,10 @@
 const int SAVE_VERSION      = 2;
 const int HEADER_SIZE       = 32;
 
+// rewind delta encoding
+const u32 DELTA_PAGE_SIZE   = 4096;     // granularity of change detection
+const u32 DELTA_MIN_RUN     = 4;        // shortest unchanged run worth ending a literal
+
 // Available flags
 enum
 {
@@ -56,6 +61,25 @@ enum
 
 #define STATE_MAGIC_NUM         "MAMESAVE"
 
+
+
+//**************************************************************************
+//  ASYNCHRONOUS WRITES
+//**************************************************************************
+
+class save_manager::async_write
+{
+public:
+	async_write() : m_result(STATERR_NONE), m_item(nullptr) { }
+
+	std::unique_ptr<emu_file>   m_file;             // file being written
+	std::vector<u8>             m_data;             // staged header and state data
+	save_error                  m_result;           // result from the worker
+	osd_work_item *             m_item;             // work item, nullptr when idle
+};
+
+
+
 //**************************************************************************
 //  INITIALIZATION
 //**************************************************************************
@@ -67,11 +91,28 @@ enum
 save_manager::save_manager(running_machine &machine)
 	: m_machine(machine)
 	, m_reg_allowed(true)
+	, m_async(std::make_unique<async_write>())
+	, m_async_queue(nullptr)
 {
 	m_rewind = std::make_unique<rewinder>(*this);
 }
 
 
+//-------------------------------------------------
+//  ~save_manager - destructor
+//-------------------------------------------------
+
+save_manager::~save_manager()
+{
+	// don't leave a worker writing into freed memory; finish and release its item before
+	// the queue goes, but the listeners are being torn down along with us, so don't tell them
+	m_complete_list.clear();
+	wait_async();
+	if (m_async_queue)
+		osd_work_queue_free(m_async_queue);
+}
+
+
 //-------------------------------------------------
 //  allow_registration - allow/disallow
 //  registrations to happen
@@ -171,6 +212,17 @@ void save_manager::register_postload(save_prepost_delegate func)
 }
 
 
+//-------------------------------------------------
+//  register_save_complete - register a function
+//  to be called when an asynchronous save is done
+//-------------------------------------------------
+
+void save_manager::register_save_complete(save_complete_delegate func)
+{
+	m_complete_list.push_back(std::move(func));
+}
+
+
 //-------------------------------------------------
 //  save_memory - register an array of data in
 //  memory
@@ -395,6 +447,139 @@ save_error save_manager::read_buffer(const void *buf, size_t size)
 }
 
 
+//-------------------------------------------------
+//  write_file_async - snapshot the current
+//  machine state and compress and write it to a
+//  file on a worker thread
+//-------------------------------------------------
+
+save_error save_manager::write_file_async(std::unique_ptr<emu_file> &&file)
+{
+	// only one write in flight; the staging buffer is reused
+	wait_async();
+
+	// snapshot the state into the staging buffer
+	async_write &async = *m_async;
+	async.m_data.resize(ram_state::get_size(*this));
+	const save_error err = write_buffer(async.m_data.data(), async.m_data.size());
+	if (err != STATERR_NONE)
+		return err;
+
+	// hand the rest off to a worker
+	if (!m_async_queue)
+		m_async_queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_IO);
+	async.m_file = std::move(file);
+	async.m_result = STATERR_NONE;
+	async.m_item = osd_work_item_queue(m_async_queue, async_write_static, &async, 0);
+	if (!async.m_item)
+	{
+		// couldn't queue it, so write it here
+		async_write_static(&async, 0);
+		complete_async();
+	}
+	return STATERR_NONE;
+}
+
+
+//-------------------------------------------------
+//  async_pending - is an asynchronous write
+//  still in progress?
+//-------------------------------------------------
+
+bool save_manager::async_pending() const
+{
+	return m_async->m_item != nullptr;
+}
+
+
+//-------------------------------------------------
+//  update_async - report a finished asynchronous
+//  write; call from the emulation thread
+//-------------------------------------------------
+
+void save_manager::update_async()
+{
+	if (m_async->m_item && osd_work_item_wait(m_async->m_item, 0))
+		complete_async();
+}
+
+
+//-------------------------------------------------
+//  wait_async - block until any asynchronous
+//  write has finished and been reported
+//-------------------------------------------------
+
+void save_manager::wait_async()
+{
+	if (m_async->m_item)
+	{
+		while (!osd_work_item_wait(m_async->m_item, osd_ticks_per_second() * 10)) { }
+		complete_async();
+	}
+}
+
+
+//-------------------------------------------------
+//  async_write_static - compress and write the
+//  staged state on a worker thread
+//-------------------------------------------------
+
+void *save_manager::async_write_static(void *param, int threadid)
+{
+	async_write &async = *reinterpret_cast<async_write *>(param);
+	util::core_file &file = *async.m_file;
+	async.m_result = STATERR_WRITE_ERROR;
+
+	// the header is written uncompressed
+	if (file.seek(0, SEEK_SET))
+		return nullptr;
+	{
+		util::core_file::ptr proxy;
+		if (util::core_file::open_proxy(file, proxy) || !proxy)
+			return nullptr;
+		auto const [filerr, written] = write(*proxy, async.m_data.data(), HEADER_SIZE);
+		if (filerr)
+			return nullptr;
+	}
+
+	// and everything else is compressed
+	util::write_stream::ptr writer = util::zlib_write(file, 6, 16384);
+	if (!writer)
+		return nullptr;
+	auto const [filerr, written] = write(*writer, async.m_data.data() + HEADER_SIZE, async.m_data.size() - HEADER_SIZE);
+	if (filerr || writer->finalize())
+		return nullptr;
+
+	async.m_result = STATERR_NONE;
+	return nullptr;
+}
+
+
+//-------------------------------------------------
+//  complete_async - close the file and notify
+//  listeners of the result
+//-------------------------------------------------
+
+void save_manager::complete_async()
+{
+	async_write &async = *m_async;
+	if (async.m_item)
+	{
+		osd_work_item_release(async.m_item);
+		async.m_item = nullptr;
+	}
+
+	// close and perhaps delete the file
+	const std::string filename = async.m_file->filename();
+	if (async.m_result != STATERR_NONE)
+		async.m_file->remove_on_close();
+	async.m_file.reset();
+
+	for (auto &func : m_complete_list)
+		func(filename, async.m_result);
+}
+
+
 //-------------------------------------------------
 //  do_write - serialisation logic
 //-------------------------------------------------
@@ -661,11 +846,28 @@ save_error ram_state::load()
 rewinder::rewinder(save_manager &save)
 	: m_save(save)
 	, m_enabled(save.machine().options().rewind())
+	, m_delta(save.machine().options().rewind_delta())
 	, m_capacity(save.machine().options().rewind_capacity())
+	, m_keyframe_interval(std::max(save.machine().options().rewind_keyframe(), 1))
 	, m_current_index(REWIND_INDEX_NONE)
 	, m_first_invalid_index(REWIND_INDEX_NONE)
 	, m_first_time_warning(true)
 	, m_first_time_note(true)
+	, m_keyframe_age(0)
+	, m_delta_used(0)
+{
+}
+
+
+//-------------------------------------------------
+//  delta_state - constructor
+//-------------------------------------------------
+
+rewinder::delta_state::delta_state(std::shared_ptr<const std::vector<u8> > &&keyframe, std::vector<u8> &&delta, const attotime &time)
+	: m_keyframe(std::move(keyframe))
+	, m_delta(std::move(delta))
+	, m_valid(true)
+	, m_time(time)
 {
 }
 
@@ -716,8 +918,16 @@ void rewinder::invalidate()
 		m_first_invalid_index = m_current_index;
 
 		// actually invalidate
-		for (auto it = m_state_list.begin() + m_first_invalid_index; it < m_state_list.end(); ++it)
-			it->get()->m_valid = false;
+		if (m_delta)
+		{
+			for (auto it = m_delta_list.begin() + m_first_invalid_index; it < m_delta_list.end(); ++it)
+				it->get()->m_valid = false;
+		}
+		else
+		{
+			for (auto it = m_state_list.begin() + m_first_invalid_index; it < m_state_list.end(); ++it)
+				it->get()->m_valid = false;
+		}
 	}
 }
 
@@ -735,6 +945,9 @@ bool rewinder::capture()
 		return false;
 	}
 
+	if (m_delta)
+		return capture_delta();
+
 	if (current_index_is_last())
 	{
 		// we need to create a new state
@@ -812,11 +1025,11 @@ bool rewinder::step()
 	if (m_first_invalid_index > REWIND_INDEX_NONE && m_current_index > m_first_invalid_index)
 		m_current_index = m_first_invalid_index;
 
-	// step back and obtain the state pointer
-	ram_state *state = m_state_list.at(--m_current_index).get();
-
-	// try to load and report the result
-	const save_error error = state->load();
+	// step back and try to load the state
+	--m_current_index;
+	const save_error error = m_delta
+			? load_delta(*m_delta_list.at(m_current_index))
+			: m_state_list.at(m_current_index)->load();
 	report_error(error, rewind_operation::LOAD);
 
 	if (error == save_error::STATERR_NONE)
@@ -888,6 +1101,254 @@ bool rewinder::check_size()
 }
 
 
+//-------------------------------------------------
+//  capture_delta - record a single state as a
+//  keyframe or as changes relative to the last
+//  keyframe, returns true on success
+//-------------------------------------------------
+
+bool rewinder::capture_delta()
+{
+	// states ahead of us can't be reached any more, and they may own the keyframe
+	if (!current_index_is_last())
+	{
+		for (auto it = m_delta_list.begin() + m_current_index; it < m_delta_list.end(); ++it)
+			m_delta_used -= it->get()->size();
+		m_delta_list.erase(m_delta_list.begin() + m_current_index, m_delta_list.end());
+		m_keyframe.reset();
+	}
+
+	// let devices flush their state before we look at it
+	m_save.dispatch_presave();
+
+	// try a delta first, falling back to a keyframe when it stops paying off
+	std::vector<u8> delta;
+	if (!m_keyframe || (m_keyframe_age >= m_keyframe_interval) || !encode_delta(*m_keyframe, delta))
+	{
+		m_keyframe = std::make_shared<const std::vector<u8> >(make_keyframe());
+		m_keyframe_age = 0;
+		delta.clear();
+	}
+	else
+	{
+		m_keyframe_age++;
+	}
+
+	// make room, re-basing on a new keyframe if ours had to go
+	auto state = std::make_unique<delta_state>(std::shared_ptr<const std::vector<u8> >(m_keyframe), std::move(delta), m_save.machine().time());
+	trim_delta(state->size());
+	if (m_delta_list.empty() && !state->is_keyframe())
+	{
+		m_keyframe = std::make_shared<const std::vector<u8> >(make_keyframe());
+		m_keyframe_age = 0;
+		state = std::make_unique<delta_state>(std::shared_ptr<const std::vector<u8> >(m_keyframe), std::vector<u8>(), m_save.machine().time());
+	}
+
+	// append
+	m_delta_used += state->size();
+	m_delta_list.push_back(std::move(state));
+
+	m_current_index = m_delta_list.size() - 1;
+	m_first_invalid_index = REWIND_INDEX_NONE;
+
+	// success
+	report_error(STATERR_NONE, rewind_operation::SAVE);
+	return true;
+}
+
+
+//-------------------------------------------------
+//  load_delta - restore the machine state from a
+//  keyframe and the changes recorded against it
+//-------------------------------------------------
+
+save_error rewinder::load_delta(const delta_state &state)
+{
+	// start from the keyframe image
+	std::vector<u8> image(*state.m_keyframe);
+
+	// apply changed pages: offset, length, then (unchanged, literal) runs of XORed bytes
+	const u8 *src = state.m_delta.data();
+	const u8 *const end = src + state.m_delta.size();
+	while (src < end)
+	{
+		u32 offset;
+		u16 length;
+		memcpy(&offset, src, sizeof(offset));
+		memcpy(&length, src + sizeof(offset), sizeof(length));
+		src += sizeof(offset) + sizeof(length);
+		if ((offset + length) > image.size())
+			return STATERR_READ_ERROR;
+
+		u8 *dst = image.data() + offset;
+		u8 *const dstend = dst + length;
+		while (dst < dstend)
+		{
+			u16 skip, literal;
+			memcpy(&skip, src, sizeof(skip));
+			memcpy(&literal, src + sizeof(skip), sizeof(literal));
+			src += sizeof(skip) + sizeof(literal);
+			dst += skip;
+			if ((dst + literal) > dstend || (src + literal) > end)
+				return STATERR_READ_ERROR;
+			for (u16 i = 0; i < literal; i++)
+				*dst++ ^= *src++;
+		}
+	}
+
+	// scatter the image back into the registered entries
+	const u8 *data = image.data();
+	for (auto &entry : m_save.m_entry_list)
+	{
+		const u32 blocksize = entry->m_typesize * entry->m_typecount;
+		u8 *dest = reinterpret_cast<u8 *>(entry->m_data);
+		for (u32 b = 0; entry->m_blockcount > b; ++b, dest += entry->m_stride, data += blocksize)
+			memcpy(dest, data, blocksize);
+	}
+
+	// call the post-load functions
+	m_save.dispatch_postload();
+
+	return STATERR_NONE;
+}
+
+
+//-------------------------------------------------
+//  trim_delta - drop the oldest keyframe groups
+//  until a state of the given size fits
+//-------------------------------------------------
+
+void rewinder::trim_delta(size_t incoming)
+{
+	const size_t capsize = m_capacity * 1024 * 1024;
+	while (!m_delta_list.empty() && (m_delta_used + incoming > capsize))
+	{
+		// a keyframe can only go together with the deltas that depend on it
+		auto it = m_delta_list.begin();
+		do
+		{
+			m_delta_used -= it->get()->size();
+			++it;
+		}
+		while (it != m_delta_list.end() && !it->get()->is_keyframe());
+		m_delta_list.erase(m_delta_list.begin(), it);
+
+		if (m_first_time_note)
+		{
+			m_save.machine().logerror("Rewind note: Capacity has been reached. Old savestates will be erased.\n");
+			m_save.machine().logerror("Capacity: %d bytes. Keyframe size: %d bytes. Savestate count: %d.\n",
+				capsize, ram_state::get_size(m_save) - HEADER_SIZE, m_delta_list.size());
+			m_first_time_note = false;
+		}
+	}
+}
+
+
+//-------------------------------------------------
+//  make_keyframe - gather all registered entries
+//  into a flat image
+//-------------------------------------------------
+
+std::vector<u8> rewinder::make_keyframe() const
+{
+	std::vector<u8> image;
+	image.reserve(ram_state::get_size(m_save) - HEADER_SIZE);
+	for (auto &entry : m_save.m_entry_list)
+	{
+		const u32 blocksize = entry->m_typesize * entry->m_typecount;
+		const u8 *data = reinterpret_cast<const u8 *>(entry->m_data);
+		for (u32 b = 0; entry->m_blockcount > b; ++b, data += entry->m_stride)
+			image.insert(image.end(), data, data + blocksize);
+	}
+	return image;
+}
+
+
+//-------------------------------------------------
+//  encode_delta - record the pages of registered
+//  entries that differ from the keyframe, returns
+//  false if a keyframe would be cheaper
+//-------------------------------------------------
+
+bool rewinder::encode_delta(const std::vector<u8> &keyframe, std::vector<u8> &delta) const
+{
+	const size_t limit = keyframe.size() / 2;
+	const u8 *key = keyframe.data();
+	for (auto &entry : m_save.m_entry_list)
+	{
+		const u32 blocksize = entry->m_typesize * entry->m_typecount;
+		const u8 *data = reinterpret_cast<const u8 *>(entry->m_data);
+		for (u32 b = 0; entry->m_blockcount > b; ++b, data += entry->m_stride, key += blocksize)
+		{
+			// most entries don't change from one capture to the next
+			if (!memcmp(data, key, blocksize))
+				continue;
+
+			for (u32 page = 0; page < blocksize; page += DELTA_PAGE_SIZE)
+			{
+				const u16 length = std::min(blocksize - page, DELTA_PAGE_SIZE);
+				const u8 *const cur = data + page;
+				const u8 *const old = key + page;
+				if (!memcmp(cur, old, length))
+					continue;
+
+				// page header
+				const u32 offset = (key - keyframe.data()) + page;
+				const size_t header = delta.size();
+				delta.resize(header + sizeof(offset) + sizeof(length));
+				memcpy(&delta[header], &offset, sizeof(offset));
+				memcpy(&delta[header + sizeof(offset)], &length, sizeof(length));
+
+				// alternate runs of unchanged and XORed bytes
+				u32 pos = 0;
+				while (pos < length)
+				{
+					u16 skip = 0;
+					while ((pos + skip) < length && cur[pos + skip] == old[pos + skip])
+						skip++;
+
+					// extend the literal until we find an unchanged run worth skipping
+					const u32 start = pos + skip;
+					u32 stop = start;
+					while (stop < length)
+					{
+						u32 same = 0;
+						while ((stop + same) < length && same < DELTA_MIN_RUN && cur[stop + same] == old[stop + same])
+							same++;
+						if (same == DELTA_MIN_RUN || (stop + same) == length)
+							break;
+						stop += same + 1;
+					}
+					const u16 literal = stop - start;
+
+					const size_t run = delta.size();
+					delta.resize(run + sizeof(skip) + sizeof(literal) + literal);
+					memcpy(&delta[run], &skip, sizeof(skip));
+					memcpy(&delta[run + sizeof(skip)], &literal, sizeof(literal));
+					for (u32 i = 0; i < literal; i++)
+						delta[run + sizeof(skip) + sizeof(literal) + i] = cur[start + i] ^ old[start + i];
+					pos = stop;
+				}
+
+				if (delta.size() > limit)
+					return false;
+			}
+		}
+	}
+
+	// an unchanged machine still needs a state to step back to
+	if (delta.empty())
+	{
+		const u32 offset = 0;
+		const u16 length = 0;
+		delta.resize(sizeof(offset) + sizeof(length));
+		memcpy(&delta[0], &offset, sizeof(offset));
+		memcpy(&delta[sizeof(offset)], &length, sizeof(length));
+	}
+	return true;
+}
+
+
 //-------------------------------------------------
 //  report_error - report rewind results
 //-------------------------------------------------
@@ -49,6 +49,9 @@ enum save_error
 // callback delegate for presave/postload
 typedef named_delegate<void ()> save_prepost_delegate;
 
+// callback delegate for asynchronous save completion
+typedef delegate<void (std::string const &, save_error)> save_complete_delegate;
+
 
 /// \brief Declare a type as safe to automatically save/restore
 ///
@@ -153,6 +156,7 @@ public:
 
 	// construction/destruction
 	save_manager(running_machine &machine);
+	~save_manager();
 
 	// getters
 	running_machine &machine() const { return m_machine; }
@@ -167,6 +171,7 @@ public:
 	// function registration
 	void register_presave(save_prepost_delegate func);
 	void register_postload(save_prepost_delegate func);
+	void register_save_complete(save_complete_delegate func);
 
 	// callback dispatching
 	void dispatch_presave();
@@ -309,6 +314,12 @@ public:
 	save_error write_buffer(void *buf, size_t size);
 	save_error read_buffer(const void *buf, size_t size);
 
+	// asynchronous file processing
+	save_error write_file_async(std::unique_ptr<emu_file> &&file);
+	bool async_pending() const;
+	void update_async();
+	void wait_async();
+
 private:
 	// state callback item
 	class state_callback
@@ -320,7 +331,12 @@ private:
 		save_prepost_delegate m_func;                 // delegate
 	};
 
+	// asynchronous write in flight
+	class async_write;
+
 	// internal helpers
+	static void *async_write_static(void *param, int threadid);
+	void complete_async();
 	template <typename T, typename U, typename V, typename W>
 	save_error do_write(T check_space, U write_block, V start_header, W start_data);
 	template <typename T, typename U, typename V, typename W>
@@ -338,6 +354,9 @@ private:
 	std::vector<std::unique_ptr<ram_state>>      m_ramstate_list;    // list of ram states
 	std::vector<std::unique_ptr<state_callback>> m_presave_list;     // list of pre-save functions
 	std::vector<std::unique_ptr<state_callback>> m_postload_list;    // list of post-load functions
+	std::vector<save_complete_delegate>          m_complete_list;    // list of save completion functions
+	std::unique_ptr<async_write>                 m_async;            // staged state for asynchronous writes
+	osd_work_queue *                             m_async_queue;      // queue for compressing and writing
 };
 
 class ram_state
@@ -357,14 +376,35 @@ public:
 
 class rewinder
 {
+	// state stored relative to a shared keyframe (delta mode)
+	class delta_state
+	{
+	public:
+		delta_state(std::shared_ptr<const std::vector<u8> > &&keyframe, std::vector<u8> &&delta, const attotime &time);
+
+		bool is_keyframe() const { return m_delta.empty(); }
+		size_t size() const { return is_keyframe() ? m_keyframe->size() : m_delta.size(); }
+
+		std::shared_ptr<const std::vector<u8> > m_keyframe; // full image this state is relative to
+		std::vector<u8>    m_delta;                   // encoded changed pages, empty for keyframes
+		bool               m_valid;                   // can we load this state?
+		attotime           m_time;                    // machine timestamp
+	};
+
 	save_manager & m_save;                            // reference to save_manager
 	bool           m_enabled;                         // enable rewind savestates
+	bool           m_delta;                           // store states as deltas against periodic keyframes
 	size_t         m_capacity;                        // total memory rewind states can occupy (MB, limited to 1-2048 in options)
+	u32            m_keyframe_interval;               // maximum number of deltas between keyframes
 	s32            m_current_index;                   // where we are in time
 	s32            m_first_invalid_index;             // all states before this one are guarateed to be valid
 	bool           m_first_time_warning;              // keep track of warnings we report
 	bool           m_first_time_note;                 // keep track of notes
 	std::vector<std::unique_ptr<ram_state>> m_state_list; // rewinder's own ram states
+	std::vector<std::unique_ptr<delta_state>> m_delta_list; // rewinder's own delta states
+	std::shared_ptr<const std::vector<u8> > m_keyframe; // keyframe new deltas are encoded against
+	u32            m_keyframe_age;                    // number of deltas encoded against current keyframe
+	size_t         m_delta_used;                      // memory occupied by delta states
 
 	// load/save management
 	enum class rewind_operation
@@ -379,10 +419,18 @@ class rewinder
 		REWIND_INDEX_FIRST
 	};
 
+	s32 state_count() const { return m_delta ? m_delta_list.size() : m_state_list.size(); }
 	bool check_size();
-	bool current_index_is_last() { return m_current_index == m_state_list.size() - 1; }
+	bool current_index_is_last() { return m_current_index == state_count() - 1; }
 	void report_error(save_error type, rewind_operation operation);
 
+	// delta mode helpers
+	bool capture_delta();
+	save_error load_delta(const delta_state &state);
+	void trim_delta(size_t incoming);
+	std::vector<u8> make_keyframe() const;
+	bool encode_delta(const std::vector<u8> &keyframe, std::vector<u8> &delta) const;
+
 public:
 	rewinder(save_manager &save);
 	bool enabled() { return m_enabled; }
@@ -10,6 +10,7 @@
 
 #include "emu.h"
 #include "debugger.h"
+#include "emuopts.h"
 
 //**************************************************************************
 //  DEBUGGING
@@ -48,6 +49,11 @@ inline emu_timer::emu_timer() noexcept :
 	m_scheduler(nullptr),
 	m_next(nullptr),
 	m_prev(nullptr),
+#if MAME_TIMER_HEAP
+	m_heap_index(decltype(device_scheduler::m_timer_heap)::npos),
+	m_heap_seq(0),
+	m_heap_expire(attotime::never),
+#endif
 	m_param(0),
 	m_enabled(false),
 	m_temporary(false),
@@ -204,7 +210,11 @@ void emu_timer::register_save(save_manager &manager)
 	// determine our instance number - timers are indexed based on the callback function name
 	int index = 0;
 	std::string name = m_callback.name() ? m_callback.name() : "unnamed";
+#if MAME_TIMER_HEAP
+	for (const emu_timer *curtimer : m_scheduler->m_timer_heap)
+#else
 	for (const emu_timer *curtimer = m_scheduler->first_timer(); curtimer; curtimer = curtimer->m_next)
+#endif
 	{
 		if (!curtimer->m_temporary)
 		{
@@ -274,6 +284,9 @@ void emu_timer::dump() const
 //  DEVICE SCHEDULER
 //**************************************************************************
 
+thread_local device_execute_interface *device_scheduler::s_group_executing = nullptr;
+
+
 //-------------------------------------------------
 //  device_scheduler - constructor
 //-------------------------------------------------
@@ -283,21 +296,36 @@ device_scheduler::device_scheduler(running_machine &machine) :
 	m_executing_device(nullptr),
 	m_execute_list(nullptr),
 	m_basetime(attotime::zero),
+	m_group_queue(nullptr),
+	m_groups_running(false),
+#if MAME_TIMER_HEAP
+	m_timer_seq(0),
+#else
 	m_timer_list(nullptr),
+#endif
 	m_inactive_timers(nullptr),
 	m_callback_timer(nullptr),
 	m_callback_timer_modified(false),
 	m_callback_timer_expire_time(attotime::zero),
 	m_suspend_changes_pending(true),
+	m_stats_enabled(machine.options().verbose()),
 	m_quantum_minimum(ATTOSECONDS_IN_NSEC(1) / 1000)
 {
 	// append a single never-expiring timer so there is always one in the list
 	// need to subvert it because it would naturally be inserted in the inactive list
+#if MAME_TIMER_HEAP
+	m_timer_heap.reserve(64);
+	emu_timer &never = timer_list_remove(m_timer_allocator.alloc()->init(machine, timer_expired_delegate(), attotime::never, 0, true));
+	never.m_heap_seq = m_timer_seq++;
+	never.m_heap_expire = never.m_expire;
+	m_timer_heap.push(never);
+#else
 	m_timer_list = &timer_list_remove(m_timer_allocator.alloc()->init(machine, timer_expired_delegate(), attotime::never, 0, true));
+#endif
 
-	assert(m_timer_list);
-	assert(!m_timer_list->m_prev);
-	assert(!m_timer_list->m_next);
+	assert(first_timer());
+	assert(!first_timer()->m_prev);
+	assert(!first_timer()->m_next);
 	assert(!m_inactive_timers);
 
 	// register global states
@@ -313,11 +341,14 @@ device_scheduler::device_scheduler(running_machine &machine) :
 
 device_scheduler::~device_scheduler()
 {
+	if (m_group_queue)
+		osd_work_queue_free(m_group_queue);
+
 	// remove all timers
 	while (m_inactive_timers)
 		m_timer_allocator.reclaim(timer_list_remove(*m_inactive_timers));
-	while (m_timer_list)
-		m_timer_allocator.reclaim(timer_list_remove(*m_timer_list));
+	while (first_timer())
+		m_timer_allocator.reclaim(timer_list_remove(*first_timer()));
 }
 
 
@@ -333,7 +364,8 @@ attotime device_scheduler::time() const noexcept
 
 	// if we're executing as a particular CPU, use its local time as a base
 	// otherwise, return the global base time
-	return (m_executing_device != nullptr) ? m_executing_device->local_time() : m_basetime;
+	device_execute_interface *const exec = currently_executing();
+	return (exec != nullptr) ? exec->local_time() : m_basetime;
 }
 
 
@@ -345,7 +377,11 @@ attotime device_scheduler::time() const noexcept
 bool device_scheduler::can_save() const
 {
 	// if any live temporary timers exit, fail
+#if MAME_TIMER_HEAP
+	for (emu_timer *timer : m_timer_heap)
+#else
 	for (emu_timer *timer = m_timer_list; timer; timer = timer->m_next)
+#endif
 	{
 		if (timer->m_temporary && !timer->expire().is_never())
 		{
@@ -402,14 +438,14 @@ void device_scheduler::timeslice()
 		m_quantum_allocator.reclaim(m_quantum_list.detach_head());
 
 	// loop until we hit the next timer
-	while (m_basetime < m_timer_list->m_expire)
+	while (m_basetime < first_timer()->m_expire)
 	{
 		// by default, assume our target is the end of the next quantum
 		attotime target(m_basetime + attotime(0, m_quantum_list.first()->m_actual));
 
 		// however, if the next timer is going to fire before then, override
-		if (m_timer_list->m_expire < target)
-			target = m_timer_list->m_expire;
+		if (first_timer()->m_expire < target)
+			target = first_timer()->m_expire;
 
 		LOG("------------------\n");
 		LOG("cpu_timeslice: target = %s\n", target.as_string(PRECISION));
@@ -418,90 +454,187 @@ void device_scheduler::timeslice()
 		if (m_suspend_changes_pending)
 			apply_suspend_changes();
 
-		// loop over all CPUs
+		if (UNEXPECTED(m_stats_enabled))
+			m_stats.m_timeslices++;
+
+		// loop over all CPUs, leaving grouped devices until last
 		for (device_execute_interface *exec = m_execute_list; exec != nullptr; exec = exec->m_nextexec)
 		{
-			// only process if this CPU is executing or truly halted (not yielding)
-			// and if our target is later than the CPU's current time (coarse check)
-			if (EXPECTED((exec->m_suspend == 0 || exec->m_eatcycles) && target.seconds() >= exec->m_localtime.seconds()))
+			if (EXPECTED(exec->m_execute_group == 0))
+				execute_device<false>(*exec, target, call_debugger);
+		}
+		if (!m_execute_groups.empty())
+			execute_groups(target, call_debugger);
+		m_executing_device = nullptr;
+
+		// update the base time
+		m_basetime = target;
+	}
+
+	// execute timers
+	execute_timers();
+}
+
+
+//-------------------------------------------------
+//  execute_device - run a single device up to
+//  the target time, moving the target up if it
+//  stops short
+//-------------------------------------------------
+
+template <bool Threaded>
+inline void device_scheduler::execute_device(device_execute_interface &exec, attotime &target, bool call_debugger)
+{
+	// only process if this CPU is executing or truly halted (not yielding)
+	// and if our target is later than the CPU's current time (coarse check)
+	if (EXPECTED((exec.m_suspend == 0 || exec.m_eatcycles) && target.seconds() >= exec.m_localtime.seconds()))
+	{
+		// compute how many attoseconds to execute this CPU
+		attoseconds_t delta = target.attoseconds() - exec.m_localtime.attoseconds();
+		if (delta < 0 && target.seconds() > exec.m_localtime.seconds())
+			delta += ATTOSECONDS_PER_SECOND;
+		assert(delta == (target - exec.m_localtime).as_attoseconds());
+
+		if (exec.m_attoseconds_per_cycle == 0)
+		{
+			exec.m_localtime = target;
+		}
+		// if we have enough for at least 1 cycle, do the math
+		else if (delta >= exec.m_attoseconds_per_cycle)
+		{
+			// compute how many cycles we want to execute
+			int ran = exec.m_cycles_running = divu_64x32(u64(delta) >> exec.m_divshift, exec.m_divisor);
+			LOG("  cpu '%s': %d (%d cycles)\n", exec.device().tag(), delta, exec.m_cycles_running);
+
+			// if we're not suspended, actually execute
+			if (exec.m_suspend == 0)
 			{
-				// compute how many attoseconds to execute this CPU
-				attoseconds_t delta = target.attoseconds() - exec->m_localtime.attoseconds();
-				if (delta < 0 && target.seconds() > exec->m_localtime.seconds())
-					delta += ATTOSECONDS_PER_SECOND;
-				assert(delta == (target - exec->m_localtime).as_attoseconds());
+				auto profile = g_profiler.start(exec.m_profiler);
 
-				if (exec->m_attoseconds_per_cycle == 0)
+				// note that this global variable cycles_stolen can be modified
+				// via the call to cpu_execute
+				exec.m_cycles_stolen = 0;
+				if (Threaded)
+					s_group_executing = &exec;
+				else
+					m_executing_device = &exec;
+				*exec.m_icountptr = exec.m_cycles_running;
+				if (!call_debugger)
+					exec.run();
+				else
 				{
-					exec->m_localtime = target;
+					exec.debugger_start_cpu_hook(target);
+					exec.run();
+					exec.debugger_stop_cpu_hook();
 				}
-				// if we have enough for at least 1 cycle, do the math
-				else if (delta >= exec->m_attoseconds_per_cycle)
-				{
-					// compute how many cycles we want to execute
-					int ran = exec->m_cycles_running = divu_64x32(u64(delta) >> exec->m_divshift, exec->m_divisor);
-					LOG("  cpu '%s': %d (%d cycles)\n", exec->device().tag(), delta, exec->m_cycles_running);
 
-					// if we're not suspended, actually execute
-					if (exec->m_suspend == 0)
+				// adjust for any cycles we took back
+				assert(ran >= *exec.m_icountptr);
+				ran -= *exec.m_icountptr;
+				assert(ran >= exec.m_cycles_stolen);
+				ran -= exec.m_cycles_stolen;
+
+				// tally up what the device did with its timeslice
+				if (UNEXPECTED(m_stats_enabled))
+				{
+					device_execute_interface::scheduler_stats &stats = exec.m_stats;
+					stats.m_executions++;
+					stats.m_cycles_requested += ran + *exec.m_icountptr + exec.m_cycles_stolen;
+					stats.m_cycles_run += ran;
+					if (exec.m_cycles_stolen != 0)
 					{
-						auto profile = g_profiler.start(exec->m_profiler);
-
-						// note that this global variable cycles_stolen can be modified
-						// via the call to cpu_execute
-						exec->m_cycles_stolen = 0;
-						m_executing_device = exec;
-						*exec->m_icountptr = exec->m_cycles_running;
-						if (!call_debugger)
-							exec->run();
-						else
-						{
-							exec->debugger_start_cpu_hook(target);
-							exec->run();
-							exec->debugger_stop_cpu_hook();
-						}
-
-						// adjust for any cycles we took back
-						assert(ran >= *exec->m_icountptr);
-						ran -= *exec->m_icountptr;
-						assert(ran >= exec->m_cycles_stolen);
-						ran -= exec->m_cycles_stolen;
+						stats.m_cycles_aborted += exec.m_cycles_stolen;
+						stats.m_aborts++;
 					}
+				}
+			}
 
-					// account for these cycles
-					exec->m_totalcycles += ran;
+			// account for these cycles
+			exec.m_totalcycles += ran;
 
-					// update the local time for this CPU
-					attotime deltatime;
-					if (ran < exec->m_cycles_per_second)
-						deltatime = attotime(0, exec->m_attoseconds_per_cycle * ran);
-					else
-					{
-						u32 remainder;
-						s32 secs = divu_64x32_rem(ran, exec->m_cycles_per_second, remainder);
-						deltatime = attotime(secs, u64(remainder) * exec->m_attoseconds_per_cycle);
-					}
-					assert(deltatime >= attotime::zero);
-					exec->m_localtime += deltatime;
-					LOG("         %d ran, %d total, time = %s\n", ran, s32(exec->m_totalcycles), exec->m_localtime.as_string(PRECISION));
+			// update the local time for this CPU
+			attotime deltatime;
+			if (ran < exec.m_cycles_per_second)
+				deltatime = attotime(0, exec.m_attoseconds_per_cycle * ran);
+			else
+			{
+				u32 remainder;
+				s32 secs = divu_64x32_rem(ran, exec.m_cycles_per_second, remainder);
+				deltatime = attotime(secs, u64(remainder) * exec.m_attoseconds_per_cycle);
+			}
+			assert(deltatime >= attotime::zero);
+			exec.m_localtime += deltatime;
+			LOG("         %d ran, %d total, time = %s\n", ran, s32(exec.m_totalcycles), exec.m_localtime.as_string(PRECISION));
 
-					// if the new local CPU time is less than our target, move the target up, but not before the base
-					if (exec->m_localtime < target)
-					{
-						target = std::max(exec->m_localtime, m_basetime);
-						LOG("         (new target)\n");
-					}
-				}
+			// if the new local CPU time is less than our target, move the target up, but not before the base
+			if (exec.m_localtime < target)
+			{
+				target = std::max(exec.m_localtime, m_basetime);
+				LOG("         (new target)\n");
 			}
 		}
-		m_executing_device = nullptr;
+	}
+}
 
-		// update the base time
-		m_basetime = target;
+
+//-------------------------------------------------
+//  execute_groups - run each execute group up to
+//  the target time, on worker threads if enabled
+//-------------------------------------------------
+
+void device_scheduler::execute_groups(attotime &target, bool call_debugger)
+{
+	for (execute_group &group : m_execute_groups)
+		group.m_target = target;
+
+	if (m_group_queue && !call_debugger)
+	{
+		// every group starts from the same target, so the results don't depend on which finishes first
+		m_groups_running = true;
+		osd_work_item_queue_multiple(m_group_queue, &device_scheduler::execute_group_static, m_execute_groups.size(), &m_execute_groups[0], sizeof(execute_group), WORK_ITEM_FLAG_AUTO_RELEASE);
+		while (!osd_work_queue_wait(m_group_queue, osd_ticks_per_second())) { }
+		m_groups_running = false;
+
+		for (execute_group &group : m_execute_groups)
+		{
+			if (group.m_exception)
+				std::rethrow_exception(std::exchange(group.m_exception, nullptr));
+		}
+	}
+	else
+	{
+		for (execute_group &group : m_execute_groups)
+		{
+			for (device_execute_interface *exec : group.m_devices)
+				execute_device<false>(*exec, group.m_target, call_debugger);
+		}
 	}
 
-	// execute timers
-	execute_timers();
+	// the earliest group decides where everyone ends up
+	for (execute_group &group : m_execute_groups)
+		target = std::min(target, group.m_target);
+}
+
+
+//-------------------------------------------------
+//  execute_group_static - run one execute group
+//  on a worker thread
+//-------------------------------------------------
+
+void *device_scheduler::execute_group_static(void *param, int threadid)
+{
+	execute_group &group = *reinterpret_cast<execute_group *>(param);
+	try
+	{
+		for (device_execute_interface *exec : group.m_devices)
+			group.m_scheduler->execute_device<true>(*exec, group.m_target, false);
+	}
+	catch (...)
+	{
+		group.m_exception = std::current_exception();
+	}
+	s_group_executing = nullptr;
+	return nullptr;
 }
 
 
@@ -512,8 +645,9 @@ void device_scheduler::timeslice()
 
 void device_scheduler::abort_timeslice() noexcept
 {
-	if (m_executing_device != nullptr)
-		m_executing_device->abort_timeslice();
+	device_execute_interface *const exec = currently_executing();
+	if (exec != nullptr)
+		exec->abort_timeslice();
 }
 
 
@@ -554,6 +688,15 @@ void device_scheduler::add_quantum(const attotime &quantum, const attotime &dura
 	attotime expire = curtime + duration;
 	const attoseconds_t quantum_attos = quantum.attoseconds();
 
+	if (UNEXPECTED(m_stats_enabled))
+	{
+		m_stats.m_quantum_adds++;
+		if (m_quantum_list.first() != nullptr && quantum_attos < m_quantum_list.first()->m_requested)
+			m_stats.m_quantum_shrinks++;
+		if (m_executing_device != nullptr)
+			m_executing_device->m_stats.m_quantum_changes++;
+	}
+
 	// figure out where to insert ourselves, expiring any quanta that are out-of-date
 	quantum_slot *insert_after = nullptr;
 	quantum_slot *next;
@@ -592,6 +735,8 @@ void device_scheduler::add_quantum(const attotime &quantum, const attotime &dura
 
 void device_scheduler::perfect_quantum(const attotime &duration)
 {
+	if (UNEXPECTED(m_stats_enabled))
+		m_stats.m_perfect_quanta++;
 	add_quantum(attotime::zero, duration);
 }
 
@@ -648,6 +793,13 @@ void device_scheduler::synchronize(timer_expired_delegate callback, s32 param)
 
 void device_scheduler::eat_all_cycles()
 {
+	if (UNEXPECTED(m_stats_enabled))
+	{
+		m_stats.m_eat_all++;
+		if (m_executing_device != nullptr && m_executing_device->m_icountptr != nullptr)
+			m_executing_device->m_stats.m_cycles_eaten += std::max(*m_executing_device->m_icountptr, 0);
+	}
+
 	for (device_execute_interface *exec = m_execute_list; exec != nullptr; exec = exec->m_nextexec)
 		exec->eat_cycles(1000000000);
 }
@@ -694,9 +846,20 @@ void device_scheduler::postload()
 		timer_list_remove(timer).m_next = private_list;
 		private_list = &timer;
 	}
+#if MAME_TIMER_HEAP
+	// take active timers in the order the list would have held them
+	std::vector<emu_timer *> active(m_timer_heap.begin(), m_timer_heap.end());
+	std::sort(active.begin(), active.end(), [] (const emu_timer *a, const emu_timer *b) { return timer_compare()(*a, *b); });
+	for (emu_timer *const curtimer : active)
+	{
+		emu_timer &timer = *curtimer;
+		if (&timer == active.back())
+			break;
+#else
 	while (m_timer_list->m_next)
 	{
 		emu_timer &timer = *m_timer_list;
+#endif
 
 		if (timer.m_temporary)
 		{
@@ -715,9 +878,9 @@ void device_scheduler::postload()
 	}
 
 	// special dummy timer
-	assert(!m_timer_list->m_enabled);
-	assert(m_timer_list->m_temporary);
-	assert(m_timer_list->m_expire.is_never());
+	assert(!first_timer()->m_enabled);
+	assert(first_timer()->m_temporary);
+	assert(first_timer()->m_expire.is_never());
 
 	// now re-insert them; this effectively re-sorts them by time
 	while (private_list)
@@ -831,6 +994,27 @@ void device_scheduler::rebuild_execute_list()
 
 	// append the suspend list to the end of the active list
 	*active_tailptr = suspend_list;
+
+	// gather grouped devices, keeping the execution order within each group
+	for (execute_group &group : m_execute_groups)
+		group.m_devices.clear();
+	for (device_execute_interface *exec = m_execute_list; exec != nullptr; exec = exec->m_nextexec)
+	{
+		if (exec->m_execute_group != 0)
+		{
+			auto group = std::find_if(m_execute_groups.begin(), m_execute_groups.end(), [exec] (execute_group const &g) { return g.m_group == exec->m_execute_group; });
+			if (group == m_execute_groups.end())
+				group = m_execute_groups.insert(m_execute_groups.end(), execute_group{ this, exec->m_execute_group });
+			group->m_devices.push_back(exec);
+		}
+	}
+
+	// only bother with worker threads if there's more than one group to run
+	// (the profiler isn't thread safe, so profiling builds always run them in turn)
+#ifndef MAME_PROFILER
+	if (!m_group_queue && (m_execute_groups.size() > 1) && machine().options().parallel_exec())
+		m_group_queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_MULTI | WORK_QUEUE_FLAG_HIGH_FREQ);
+#endif
 }
 
 
@@ -841,9 +1025,21 @@ void device_scheduler::rebuild_execute_list()
 
 inline emu_timer &device_scheduler::timer_list_insert(emu_timer &timer)
 {
+	// execute groups must leave the timers alone
+	assert(!m_groups_running);
+
 	// disabled timers never expire
 	if (!timer.m_expire.is_never() && timer.m_enabled)
 	{
+#if MAME_TIMER_HEAP
+		// later insertions go after earlier ones with the same expiry time
+		timer.m_prev = nullptr;
+		timer.m_next = nullptr;
+		timer.m_heap_seq = m_timer_seq++;
+		timer.m_heap_expire = timer.m_expire;
+		m_timer_heap.push(timer);
+		return timer;
+#else
 		// loop over the timer list
 		emu_timer *prevtimer = nullptr;
 		for (emu_timer *curtimer = m_timer_list; curtimer; prevtimer = curtimer, curtimer = curtimer->m_next)
@@ -873,6 +1069,7 @@ inline emu_timer &device_scheduler::timer_list_insert(emu_timer &timer)
 
 		timer.m_prev = prevtimer;
 		timer.m_next = nullptr;
+#endif
 	}
 	else
 	{
@@ -896,15 +1093,28 @@ inline emu_timer &device_scheduler::timer_list_insert(emu_timer &timer)
 
 inline emu_timer &device_scheduler::timer_list_remove(emu_timer &timer)
 {
+	assert(!m_groups_running);
+
+#if MAME_TIMER_HEAP
+	// active timers live in the heap
+	if (m_timer_heap.contains(timer))
+	{
+		m_timer_heap.remove(timer);
+		return timer;
+	}
+#endif
+
 	// remove it from the list
 	if (timer.m_prev)
 	{
 		timer.m_prev->m_next = timer.m_next;
 	}
+#if !MAME_TIMER_HEAP
 	else if (&timer == m_timer_list)
 	{
 		m_timer_list = timer.m_next;
 	}
+#endif
 	else
 	{
 		assert(&timer == m_inactive_timers);
@@ -924,13 +1134,13 @@ inline emu_timer &device_scheduler::timer_list_remove(emu_timer &timer)
 
 inline void device_scheduler::execute_timers()
 {
-	LOG("execute_timers: new=%s head->expire=%s\n", m_basetime.as_string(PRECISION), m_timer_list->m_expire.as_string(PRECISION));
+	LOG("execute_timers: new=%s head->expire=%s\n", m_basetime.as_string(PRECISION), first_timer()->m_expire.as_string(PRECISION));
 
 	// now process any timers that are overdue
-	while (m_timer_list->m_expire <= m_basetime)
+	while (first_timer()->m_expire <= m_basetime)
 	{
 		// if this is a one-shot timer, disable it now
-		emu_timer &timer = *m_timer_list;
+		emu_timer &timer = *first_timer();
 		bool was_enabled = timer.m_enabled;
 		if (timer.m_period.is_zero() || timer.m_period.is_never())
 			timer.m_enabled = false;
@@ -982,9 +1192,59 @@ void device_scheduler::dump_timers() const
 {
 	machine().logerror("=============================================\n");
 	machine().logerror("Timer Dump: Time = %15s\n", time().as_string(PRECISION));
+#if MAME_TIMER_HEAP
+	for (emu_timer *timer : m_timer_heap)
+#else
 	for (emu_timer *timer = m_timer_list; timer; timer = timer->m_next)
+#endif
 		timer->dump();
 	for (emu_timer *timer = m_inactive_timers; timer; timer = timer->m_next)
 		timer->dump();
 	machine().logerror("=============================================\n");
 }
+
+
+//-------------------------------------------------
+//  reset_stats - clear the global and
+//  per-device scheduler statistics
+//-------------------------------------------------
+
+void device_scheduler::reset_stats()
+{
+	m_stats = scheduler_stats();
+	for (device_execute_interface &exec : execute_interface_enumerator(machine().root_device()))
+		exec.m_stats = device_execute_interface::scheduler_stats();
+}
+
+
+//-------------------------------------------------
+//  dump_stats - report the scheduler statistics
+//  collected so far
+//-------------------------------------------------
+
+void device_scheduler::dump_stats() const
+{
+	osd_printf_info("Scheduler statistics:\n");
+	osd_printf_info("  %u timeslices, %u quantum changes (%u shrinking, %u perfect), %u eat_all_cycles\n",
+			m_stats.m_timeslices,
+			m_stats.m_quantum_adds,
+			m_stats.m_quantum_shrinks,
+			m_stats.m_perfect_quanta,
+			m_stats.m_eat_all);
+	for (device_execute_interface &exec : execute_interface_enumerator(machine().root_device()))
+	{
+		device_execute_interface::scheduler_stats const &stats = exec.m_stats;
+		if (stats.m_executions == 0)
+			continue;
+		osd_printf_info("  '%s': %u executions, %u/%u cycles run (%.1f%%), %u aborts (%u cycles), %u cycles eaten, %u quantum changes\n",
+				exec.device().tag(),
+				stats.m_executions,
+				stats.m_cycles_run,
+				stats.m_cycles_requested,
+				stats.m_cycles_requested ? 100.0 * double(stats.m_cycles_run) / double(stats.m_cycles_requested) : 0.0,
+				stats.m_aborts,
+				stats.m_cycles_aborted,
+				stats.m_cycles_eaten,
+				stats.m_quantum_changes);
+	}
+}
@@ -24,6 +24,12 @@
 
 #define TIMER_CALLBACK_MEMBER(name)     void name(s32 param)
 
+// build with MAME_TIMER_HEAP=1 to keep active timers in a binary heap rather
+// than a sorted list; firing order and save states are the same either way
+#ifndef MAME_TIMER_HEAP
+#define MAME_TIMER_HEAP 0
+#endif
+
 
 //**************************************************************************
 //  TYPE DEFINITIONS
@@ -78,6 +84,11 @@ private:
 	device_scheduler *  m_scheduler;    // reference to the owning machine
 	emu_timer *         m_next;         // next timer in order in the list
 	emu_timer *         m_prev;         // previous timer in order in the list
+#if MAME_TIMER_HEAP
+	std::size_t         m_heap_index;   // position in the active timer heap
+	u64                 m_heap_seq;     // insertion order, to break ties
+	attotime            m_heap_expire;  // expiry time the heap is ordered by
+#endif
 	timer_expired_delegate m_callback;  // callback function
 	s32                 m_param;        // integer parameter
 	bool                m_enabled;      // is the timer enabled?
@@ -107,8 +118,12 @@ public:
 	// getters
 	running_machine &machine() const noexcept { return m_machine; }
 	attotime time() const noexcept;
+#if MAME_TIMER_HEAP
+	emu_timer *first_timer() const noexcept { return m_timer_heap.empty() ? nullptr : m_timer_heap.top(); }
+#else
 	emu_timer *first_timer() const noexcept { return m_timer_list; }
-	device_execute_interface *currently_executing() const noexcept { return m_executing_device; }
+#endif
+	device_execute_interface *currently_executing() const noexcept { return EXPECTED(!m_groups_running) ? m_executing_device : s_group_executing; }
 	bool can_save() const;
 
 	// execution
@@ -125,8 +140,23 @@ public:
 	void timer_set(const attotime &duration, timer_expired_delegate callback, s32 param = 0);
 	void synchronize(timer_expired_delegate callback = timer_expired_delegate(), s32 param = 0);
 
+	// statistics
+	struct scheduler_stats
+	{
+		u64 m_timeslices = 0;       // passes through the execute loop
+		u64 m_quantum_adds = 0;     // calls to add_quantum(), including perfect_quantum()
+		u64 m_quantum_shrinks = 0;  // quanta that became shorter than the active one
+		u64 m_perfect_quanta = 0;   // calls to perfect_quantum()
+		u64 m_eat_all = 0;          // calls to eat_all_cycles()
+	};
+	bool stats_enabled() const noexcept { return m_stats_enabled; }
+	void set_stats_enabled(bool enabled) noexcept { m_stats_enabled = enabled; }
+	const scheduler_stats &stats() const noexcept { return m_stats; }
+	void reset_stats();
+
 	// debugging
 	void dump_timers() const;
+	void dump_stats() const;
 
 	// for emergencies only!
 	void eat_all_cycles();
@@ -141,6 +171,9 @@ private:
 	void compute_perfect_interleave();
 	void rebuild_execute_list();
 	void apply_suspend_changes();
+	template <bool Threaded> void execute_device(device_execute_interface &exec, attotime &target, bool call_debugger);
+	void execute_groups(attotime &target, bool call_debugger);
+	static void *execute_group_static(void *param, int threadid);
 
 	// timer helpers
 	emu_timer &timer_list_insert(emu_timer &timer);
@@ -153,8 +186,34 @@ private:
 	device_execute_interface *  m_execute_list;             // list of devices to be executed
 	attotime                    m_basetime;                 // global basetime; everything moves forward from here
 
+	// execute groups
+	struct execute_group
+	{
+		device_scheduler *                      m_scheduler;    // owning scheduler
+		int                                     m_group;        // group number from the device configuration
+		std::vector<device_execute_interface *> m_devices;      // devices in execution order
+		attotime                                m_target;       // target time, moved up if a device stops short
+		std::exception_ptr                      m_exception;    // exception thrown on a worker thread
+	};
+	std::vector<execute_group>  m_execute_groups;           // groups, in order of their first device
+	osd_work_queue *            m_group_queue;              // work queue for running groups in parallel
+	bool                        m_groups_running;           // groups are running on worker threads
+	static thread_local device_execute_interface *s_group_executing; // device executing on this worker thread
+
 	// list of active timers
+#if MAME_TIMER_HEAP
+	struct timer_compare
+	{
+		bool operator()(const emu_timer &a, const emu_timer &b) const noexcept
+		{
+			return (a.m_heap_expire < b.m_heap_expire) || ((a.m_heap_expire == b.m_heap_expire) && (a.m_heap_seq < b.m_heap_seq));
+		}
+	};
+	util::intrusive_heap<emu_timer, timer_compare, &emu_timer::m_heap_index> m_timer_heap; // active timers
+	u64                         m_timer_seq;                // next insertion sequence number
+#else
 	emu_timer *                 m_timer_list;               // head of the active list
+#endif
 	emu_timer *                 m_inactive_timers;          // head of the inactive timer list
 	fixed_allocator<emu_timer>  m_timer_allocator;          // allocator for timers
 
@@ -164,6 +223,10 @@ private:
 	attotime                    m_callback_timer_expire_time; // the original expiration time
 	bool                        m_suspend_changes_pending;  // suspend/resume changes are pending
 
+	// statistics
+	bool                        m_stats_enabled;            // collect statistics?
+	scheduler_stats             m_stats;                    // global statistics
+
 	// scheduling quanta
 	class quantum_slot
 	{
@@ -42,6 +42,8 @@ DEFINE_DEVICE_TYPE(SCREEN, screen_device, "screen", "Video Screen")
 const attotime screen_device::DEFAULT_FRAME_PERIOD(attotime::from_hz(DEFAULT_FRAME_RATE));
 
 u32 screen_device::m_id_counter = 0;
+screen_device *screen_device::m_tracking_screen = nullptr;
+const bitmap_t *screen_device::m_tracking_bitmap = nullptr;
 
 class screen_device::svg_renderer {
 public:
@@ -557,6 +559,7 @@ screen_device::screen_device(const machine_config &mconfig, const char *tag, dev
 	, m_changed(true)
 	, m_last_partial_scan(0)
 	, m_partial_scan_hpos(0)
+	, m_dirty_tracking(false)
 	, m_color(rgb_t(0xff, 0xff, 0xff, 0xff))
 	, m_brightness(0xff)
 	, m_frame_period(DEFAULT_FRAME_PERIOD.as_attoseconds())
@@ -819,6 +822,11 @@ void screen_device::device_start()
 	}
 	register_screen_bitmap(m_priority);
 
+	// dirty tracking needs the update callback to draw straight into the screen bitmap
+	m_dirty_tracking = (m_video_attributes & VIDEO_DIRTY_TRACKING) && m_type == SCREEN_TYPE_RASTER && !(m_video_attributes & (VIDEO_VARIABLE_WIDTH | VIDEO_SELF_RENDER));
+	if (m_dirty_tracking && !screen16 && m_palette)
+		m_dirty_palclient = std::make_unique<palette_client>(*m_palette->palette());
+
 	// allocate raw textures
 	m_texture[0] = machine().render().texture_alloc();
 	m_texture[0]->set_id(u64(m_unique_id) << 57);
@@ -1209,12 +1217,14 @@ bool screen_device::update_partial(int scanline)
 			if (m_type != SCREEN_TYPE_SVG)
 			{
 				screen_bitmap &curbitmap = m_bitmap[m_curbitmap];
+				begin_tracking(curbitmap);
 				switch (curbitmap.format())
 				{
 					default:
 					case BITMAP_FORMAT_IND16:   flags = m_screen_update_ind16(*this, curbitmap.as_ind16(), clip);   break;
 					case BITMAP_FORMAT_RGB32:   flags = m_screen_update_rgb32(*this, curbitmap.as_rgb32(), clip);   break;
 				}
+				end_tracking();
 			}
 			else
 			{
@@ -1311,12 +1321,14 @@ void screen_device::update_now()
 				}
 				else
 				{
+					begin_tracking(curbitmap);
 					switch (curbitmap.format())
 					{
 						default:
 						case BITMAP_FORMAT_IND16:   flags = m_screen_update_ind16(*this, curbitmap.as_ind16(), clip);   break;
 						case BITMAP_FORMAT_RGB32:   flags = m_screen_update_rgb32(*this, curbitmap.as_rgb32(), clip);   break;
 					}
+					end_tracking();
 				}
 
 				m_partial_updates_this_frame++;
@@ -1365,12 +1377,14 @@ void screen_device::update_now()
 			}
 			else
 			{
+				begin_tracking(curbitmap);
 				switch (curbitmap.format())
 				{
 					default:
 					case BITMAP_FORMAT_IND16:   flags = m_screen_update_ind16(*this, curbitmap.as_ind16(), clip);   break;
 					case BITMAP_FORMAT_RGB32:   flags = m_screen_update_rgb32(*this, curbitmap.as_rgb32(), clip);   break;
 				}
+				end_tracking();
 			}
 
 			m_partial_updates_this_frame++;
@@ -1752,7 +1766,10 @@ bool screen_device::update_quads()
 				{
 					create_composited_bitmap();
 				}
-				m_texture[m_curbitmap]->set_bitmap(m_bitmap[m_curbitmap], m_visarea, m_bitmap[m_curbitmap].texformat());
+				if (m_dirty_tracking)
+					m_texture[m_curbitmap]->set_bitmap(m_bitmap[m_curbitmap], m_visarea, m_bitmap[m_curbitmap].texformat(), commit_dirty_area());
+				else
+					m_texture[m_curbitmap]->set_bitmap(m_bitmap[m_curbitmap], m_visarea, m_bitmap[m_curbitmap].texformat());
 				m_curtexture = m_curbitmap;
 				m_curbitmap = 1 - m_curbitmap;
 			}
@@ -1773,6 +1790,40 @@ bool screen_device::update_quads()
 }
 
 
+//-------------------------------------------------
+//  mark_dirty - note that an area of the screen
+//  bitmap changed outside of the tracked tilemap
+//  and gfx draws
+//-------------------------------------------------
+
+void screen_device::mark_dirty(const rectangle &rect)
+{
+	if (m_dirty_tracking)
+		m_dirty.mark(rect);
+}
+
+
+//-------------------------------------------------
+//  commit_dirty_area - return the area of the
+//  current bitmap that may differ from what its
+//  texture held at its previous commit, and start
+//  marking afresh
+//-------------------------------------------------
+
+rectangle screen_device::commit_dirty_area()
+{
+	// palette changes alter every pixel drawn through the palette
+	if (m_dirty_palclient)
+	{
+		u32 mindirty, maxdirty;
+		if (m_dirty_palclient->dirty_list(mindirty, maxdirty) != nullptr)
+			mark_dirty(m_visarea);
+	}
+
+	return m_dirty.commit(m_visarea);
+}
+
+
 //-------------------------------------------------
 //  update_burnin - update the burnin bitmap
 //-------------------------------------------------
@@ -60,6 +60,10 @@ constexpr u32 UPDATE_HAS_NOT_CHANGED = 0x0001;   // the video has not changed
  @def VIDEO_VARIABLE_WIDTH
  causes the screen to construct its final bitmap from a composite upscale of individual scanline bitmaps
 
+ @def VIDEO_DIRTY_TRACKING
+ only hand the changed part of each frame to the renderer; tilemap, gfx and copybitmap draws to the screen
+ bitmap are tracked, anything else that can change (fills, direct pixel writes) must be reported with mark_dirty
+
  @}
  */
 
@@ -70,6 +74,7 @@ constexpr u32 VIDEO_SELF_RENDER             = 0x0008;
 constexpr u32 VIDEO_ALWAYS_UPDATE           = 0x0080;
 constexpr u32 VIDEO_UPDATE_SCANLINE         = 0x0100;
 constexpr u32 VIDEO_VARIABLE_WIDTH          = 0x0200;
+constexpr u32 VIDEO_DIRTY_TRACKING          = 0x0400;
 
 
 //**************************************************************************
@@ -159,6 +164,63 @@ typedef device_delegate<u32 (screen_device &, bitmap_ind16 &, const rectangle &)
 typedef device_delegate<u32 (screen_device &, bitmap_rgb32 &, const rectangle &)> screen_update_rgb32_delegate;
 
 
+// ======================> screen_dirty_history
+
+// screen_dirty_history - the areas marked changed in each frame of a double-buffered screen,
+// folded into the area that differs from what the committed bitmap held two frames ago
+class screen_dirty_history
+{
+public:
+	// construction/destruction
+	screen_dirty_history() { reset(); }
+
+	// forget everything marked so far
+	void reset()
+	{
+		m_area.set(0, -1, 0, -1);
+		for (rectangle &area : m_history)
+			area.set(0, -1, 0, -1);
+	}
+
+	// note that an area changed in the frame being drawn
+	void mark(const rectangle &rect)
+	{
+		if (rect.empty())
+			return;
+		if (m_area.empty())
+			m_area = rect;
+		else
+			m_area |= rect;
+	}
+
+	// return the area of the bitmap about to be committed that may differ from its
+	// previous commit, clipped to the visible area, and start marking afresh
+	rectangle commit(const rectangle &visarea)
+	{
+		// each bitmap only sees every other frame, and a change marked while its rows
+		// were already drawn only reaches the bitmap in the frame after
+		rectangle result = m_area;
+		for (const rectangle &area : m_history)
+		{
+			if (result.empty())
+				result = area;
+			else if (!area.empty())
+				result |= area;
+		}
+		result &= visarea;
+
+		m_history[1] = m_history[0];
+		m_history[0] = m_area;
+		m_area.set(0, -1, 0, -1);
+		return result;
+	}
+
+private:
+	rectangle           m_area;                     // area marked since the last commit
+	rectangle           m_history[2];               // areas marked for each of the last two commits
+};
+
+
 // ======================> screen_device
 
 class screen_device : public device_t
@@ -413,6 +475,12 @@ public:
 	void register_vblank_callback(vblank_state_delegate vblank_callback);
 	void register_screen_bitmap(bitmap_t &bitmap);
 
+	// dirty tracking
+	void mark_dirty(const rectangle &rect);
+	bool dirty_tracking() const { return m_dirty_tracking; }
+	static bool tracks_bitmap(const bitmap_t &bitmap) { return &bitmap == m_tracking_bitmap; }
+	static void mark_bitmap_dirty(const bitmap_t &bitmap, const rectangle &rect) { if (&bitmap == m_tracking_bitmap) m_tracking_screen->mark_dirty(rect); }
+
 	// internal to the video system
 	bool update_quads();
 	void update_burnin();
@@ -447,6 +515,9 @@ private:
 	void create_composited_bitmap();
 	void destroy_scan_bitmaps();
 	void allocate_scan_bitmaps();
+	void begin_tracking(bitmap_t &bitmap) { if (m_dirty_tracking) { m_tracking_screen = this; m_tracking_bitmap = &bitmap; } }
+	void end_tracking() { m_tracking_screen = nullptr; m_tracking_bitmap = nullptr; }
+	rectangle commit_dirty_area();
 
 	// inline configuration data
 	screen_type_enum    m_type;                     // type of screen
@@ -488,6 +559,11 @@ private:
 	s32                 m_last_partial_scan;        // scanline of last partial update
 	s32                 m_partial_scan_hpos;        // horizontal pixel last rendered on this partial scanline
 	bitmap_argb32       m_screen_overlay_bitmap;    // screen overlay bitmap
+
+	// dirty tracking
+	bool                m_dirty_tracking;           // only commit the changed part of each frame
+	screen_dirty_history m_dirty;                   // areas marked in recent frames
+	std::unique_ptr<palette_client> m_dirty_palclient; // client to the palette for RGB32 screens
 	u32                 m_unique_id;                // unique id for this screen_device
 	rgb_t               m_color;                    // render color
 	u8                  m_brightness;               // global brightness
@@ -532,6 +608,8 @@ private:
 	// static data
 	static u32          m_id_counter;   // incremented for each constructed screen_device,
 										// used as a unique identifier during runtime
+	static screen_device *m_tracking_screen;    // screen whose update callback is running, if tracked
+	static const bitmap_t *m_tracking_bitmap;   // the bitmap it is updating
 };
 
 // device type definition
@@ -13,6 +13,7 @@
 #include "config.h"
 #include "emuopts.h"
 #include "main.h"
+#include "resampler.h"
 #include "speaker.h"
 
 #include "wavwrite.h"
@@ -377,7 +378,7 @@ void sound_stream_output::init(sound_stream &stream, u32 index, char const *tag)
 	for (int index = 0; index < filename.size(); index++)
 		if (filename[index] == ':')
 			filename[index] = '_';
-	if (dynamic_cast<default_resampler_stream *>(&stream) != nullptr)
+	if (dynamic_cast<default_resampler_stream *>(&stream) != nullptr || dynamic_cast<polyphase_resampler_stream *>(&stream) != nullptr)
 		filename += "_resampler";
 	filename += "_OUT_";
 	char buf[10];
@@ -505,7 +506,7 @@ read_stream_view sound_stream_input::update(attotime start, attotime end)
 	sound_assert(valid());
 
 	// pick an optimized resampler
-	sound_stream_output &source = m_native_source->optimize_resampler(m_resampler_source);
+	sound_stream_output &source = resolved_source();
 
 	// if not using our own resampler, keep it up to date in case we need to invoke it later
 	if (m_resampler_source != nullptr && &source != m_resampler_source)
@@ -556,6 +557,7 @@ sound_stream::sound_stream(device_t &device, u32 inputs, u32 outputs, u32 output
 	m_output_adaptive(sample_rate == SAMPLE_RATE_OUTPUT_ADAPTIVE),
 	m_synchronous((flags & STREAM_SYNCHRONOUS) != 0),
 	m_resampling_disabled((flags & STREAM_DISABLE_INPUT_RESAMPLING) != 0),
+	m_thread_safe((flags & STREAM_THREAD_SAFE) != 0),
 	m_sync_timer(nullptr),
 	m_last_update_end_time(attotime::zero),
 	m_input(inputs),
@@ -588,7 +590,11 @@ sound_stream::sound_stream(device_t &device, u32 inputs, u32 outputs, u32 output
 		sound_stream_output *resampler = nullptr;
 		if (!m_resampling_disabled)
 		{
-			m_resampler_list.push_back(std::make_unique<default_resampler_stream>(m_device));
+			int const quality = m_device.machine().options().resampler_quality();
+			if (quality > 0)
+				m_resampler_list.push_back(std::make_unique<polyphase_resampler_stream>(m_device, quality));
+			else
+				m_resampler_list.push_back(std::make_unique<default_resampler_stream>(m_device));
 			resampler = &m_resampler_list.back()->m_output[0];
 		}
 
@@ -739,7 +745,16 @@ read_stream_view sound_stream::update_view(attotime start, attotime end, u32 out
 #endif
 
 			// if we have an extended callback, that's all we need
-			m_callback_ex(*this, m_input_view, m_output_view);
+			if (UNEXPECTED(m_device.machine().sound().stats_enabled()))
+			{
+				osd_ticks_t const start_ticks = osd_ticks();
+				m_callback_ex(*this, m_input_view, m_output_view);
+				m_stats.m_ticks += osd_ticks() - start_ticks;
+				m_stats.m_updates++;
+				m_stats.m_samples += samples;
+			}
+			else
+				m_callback_ex(*this, m_input_view, m_output_view);
 
 #if (SOUND_DEBUG)
 			// make sure everything was overwritten
@@ -836,6 +851,9 @@ void sound_stream::print_graph_recursive(int indent, int index)
 
 void sound_stream::sample_rate_changed()
 {
+	// rates and connections decide which resamplers are used, so the update order is stale
+	m_device.machine().sound().invalidate_update_order();
+
 	// if invalid, just punt
 	if (m_sample_rate == SAMPLE_RATE_INVALID)
 		return;
@@ -930,7 +948,7 @@ read_stream_view sound_stream::empty_view(attotime start, attotime end)
 //-------------------------------------------------
 
 default_resampler_stream::default_resampler_stream(device_t &device) :
-	sound_stream(device, 1, 1, 0, SAMPLE_RATE_OUTPUT_ADAPTIVE, stream_update_delegate(&default_resampler_stream::resampler_sound_update, this), STREAM_DISABLE_INPUT_RESAMPLING),
+	sound_stream(device, 1, 1, 0, SAMPLE_RATE_OUTPUT_ADAPTIVE, stream_update_delegate(&default_resampler_stream::resampler_sound_update, this), sound_stream_flags(STREAM_DISABLE_INPUT_RESAMPLING | STREAM_THREAD_SAFE)),
 	m_max_latency(0)
 {
 	// create a name
@@ -1057,6 +1075,110 @@ void default_resampler_stream::resampler_sound_update(sound_stream &stream, std:
 
 
 
+
+//**************************************************************************
+//  POLYPHASE RESAMPLER STREAM
+//**************************************************************************
+
+//-------------------------------------------------
+//  polyphase_resampler_stream - derived
+//  sound_stream class that filters with a
+//  windowed-sinc polyphase resampler
+//-------------------------------------------------
+
+polyphase_resampler_stream::polyphase_resampler_stream(device_t &device, int quality) :
+	sound_stream(device, 1, 1, 0, SAMPLE_RATE_OUTPUT_ADAPTIVE, stream_update_delegate(&polyphase_resampler_stream::resampler_sound_update, this), sound_stream_flags(STREAM_DISABLE_INPUT_RESAMPLING | STREAM_THREAD_SAFE)),
+	m_quality(quality),
+	m_max_latency(0)
+{
+	// create a name
+	m_name = "Polyphase Resampler '";
+	m_name += device.tag();
+	m_name += "'";
+}
+
+
+//-------------------------------------------------
+//  resampler_sound_update - stream callback
+//  handler for resampling an input stream to the
+//  target sample rate of the output
+//-------------------------------------------------
+
+void polyphase_resampler_stream::resampler_sound_update(sound_stream &stream, std::vector<read_stream_view> const &inputs, std::vector<write_stream_view> &outputs)
+{
+	sound_assert(inputs.size() == 1);
+	sound_assert(outputs.size() == 1);
+
+	auto &input = inputs[0];
+	auto &output = outputs[0];
+
+	// if the input has an invalid rate, just fill with zeros
+	if (input.sample_rate() <= 1)
+	{
+		output.fill(0);
+		return;
+	}
+
+	// optimize_resampler ensures we should not have equal sample rates
+	sound_assert(input.sample_rate() != output.sample_rate());
+
+	// fetch the tables for the current rates; these are shared and only built once
+	if (!m_filter || m_filter->input_rate() != input.sample_rate() || m_filter->output_rate() != output.sample_rate())
+		m_filter = device().machine().sound().resampler_filter(input.sample_rate(), output.sample_rate(), m_quality);
+	polyphase_resampler const &filter = *m_filter;
+
+	// the filter needs a full window of input behind each output sample; never
+	// shrink the latency once established, so that rate changes don't skip
+	s64 latency_samples = filter.latency();
+	if (latency_samples <= m_max_latency)
+		latency_samples = m_max_latency;
+	else
+		m_max_latency = latency_samples;
+	attotime latency = latency_samples * input.sample_period();
+
+	// clamp the latency to the start (only relevant at the beginning)
+	s32 dstindex = 0;
+	attotime output_start = output.start_time();
+	auto numsamples = output.samples();
+	while (latency > output_start && dstindex < numsamples)
+	{
+		output.put(dstindex++, 0);
+		output_start += output.sample_period();
+	}
+	if (dstindex >= numsamples)
+		return;
+
+	// create a rebased input buffer around the adjusted start time
+	read_stream_view rebased(input, output_start - latency);
+	sound_assert(rebased.start_time() + latency <= output_start);
+
+	// compute the fractional input start position
+	attotime delta = output_start - (rebased.start_time() + latency);
+	sound_assert(delta.seconds() == 0);
+	double srcpos = double(delta.attoseconds()) / double(rebased.sample_period_attoseconds());
+	sound_assert(srcpos <= 1.0);
+
+	// copy the input into a contiguous window, padded so the final taps can't overrun
+	u32 const available = rebased.samples();
+	m_history.resize(available + filter.taps());
+	for (u32 index = 0; index < available; index++)
+		m_history[index] = rebased.get(index);
+	std::fill(m_history.begin() + available, m_history.end(), 0);
+
+	// line up the first window so that its centre lands where the default resampler's
+	// first sample would; any extra latency from an earlier filter just shifts it later
+	u64 const start = u64((srcpos + double(latency_samples - filter.latency()) + 1.0) * 4294967296.0);
+	sound_assert(((start + u64(numsamples - dstindex - 1) * filter.step()) >> 32) + filter.taps() <= m_history.size());
+
+	// filter, then write out
+	m_scratch.resize(numsamples - dstindex);
+	filter.process(&m_scratch[0], numsamples - dstindex, &m_history[0], start);
+	for (s32 index = 0; dstindex < numsamples; index++, dstindex++)
+		output.put(dstindex, m_scratch[index]);
+}
+
+
+
 //**************************************************************************
 //  SOUND MANAGER
 //**************************************************************************
@@ -1083,7 +1205,12 @@ sound_manager::sound_manager(running_machine &machine) :
 	m_attenuation(0),
 	m_unique_id(0),
 	m_wavfile(),
-	m_first_reset(true)
+	m_first_reset(true),
+	m_batch_samples(std::max(machine.options().sound_batch(), 0)),
+	m_update_order_valid(false),
+	m_update_queue(nullptr),
+	m_stats_enabled(machine.options().verbose()),
+	m_graph_batches(0)
 {
 	// count the mixers
 #if VERBOSE
@@ -1110,6 +1237,13 @@ sound_manager::sound_manager(running_machine &machine) :
 	// start the periodic update flushing timer
 	m_update_timer = machine.scheduler().timer_alloc(timer_expired_delegate(FUNC(sound_manager::update), this));
 	m_update_timer->adjust(STREAMS_UPDATE_ATTOTIME, 0, STREAMS_UPDATE_ATTOTIME);
+
+	// independent subgraphs can be updated on other threads; the profiler only
+	// tracks one thread, so not when it's compiled in
+#ifndef MAME_PROFILER
+	if (machine.options().sound_parallel())
+		m_update_queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_MULTI);
+#endif
 }
 
 
@@ -1119,6 +1253,8 @@ sound_manager::sound_manager(running_machine &machine) :
 
 sound_manager::~sound_manager()
 {
+	if (m_update_queue)
+		osd_work_queue_free(m_update_queue);
 }
 
 
@@ -1140,6 +1276,22 @@ sound_stream *sound_manager::stream_alloc(device_t &device, u32 inputs, u32 outp
 }
 
 
+//-------------------------------------------------
+//  resampler_filter - return the polyphase
+//  resampler tables for the given rates, building
+//  them on first use
+//-------------------------------------------------
+
+std::shared_ptr<polyphase_resampler const> sound_manager::resampler_filter(u32 input_rate, u32 output_rate, int quality)
+{
+	std::lock_guard<std::mutex> lock(m_resampler_filter_lock);
+	auto &filter = m_resampler_filters[std::make_tuple(input_rate, output_rate, quality)];
+	if (!filter)
+		filter = std::make_shared<polyphase_resampler const>(input_rate, output_rate, quality);
+	return filter;
+}
+
+
 //-------------------------------------------------
 //  start_recording - begin audio recording
 //-------------------------------------------------
@@ -1281,6 +1433,242 @@ void sound_manager::apply_sample_rate_changes()
 }
 
 
+//-------------------------------------------------
+//  compute_update_order - list every stream that
+//  feeds a speaker, each after all of its inputs
+//-------------------------------------------------
+
+void sound_manager::compute_update_order()
+{
+	std::set<sound_stream *> visited;
+	m_update_order.clear();
+	for (speaker_device &speaker : m_speakers)
+	{
+		int dummy;
+		sound_stream *const output = speaker.output_to_stream_output(0, dummy);
+		if (output)
+			add_to_update_order(*output, visited);
+	}
+	m_update_order_valid = true;
+
+	// split the graph into subgraphs that share no streams; the speakers' own
+	// streams join everything together, so leave them out and let them pull
+	m_update_groups.clear();
+	m_serial_order.clear();
+	if (!m_update_queue)
+		return;
+
+	std::set<sound_stream *> sinks;
+	for (speaker_device &speaker : m_speakers)
+	{
+		int dummy;
+		sound_stream *const output = speaker.output_to_stream_output(0, dummy);
+		if (output)
+			sinks.insert(output);
+	}
+
+	// union each stream with the sources it reads from
+	std::map<sound_stream *, sound_stream *> parent;
+	for (sound_stream *stream : m_update_order)
+		parent[stream] = stream;
+	auto const find = [&parent] (sound_stream *stream)
+	{
+		while (parent[stream] != stream)
+			stream = parent[stream] = parent[parent[stream]];
+		return stream;
+	};
+	std::set<sound_stream *> unsafe;
+	for (sound_stream *stream : m_update_order)
+	{
+		if (sinks.count(stream))
+			continue;
+		if (!stream->thread_safe())
+			unsafe.insert(stream);
+		for (auto &input : stream->m_input)
+			if (input.valid())
+			{
+				// a source outside the order is synchronous and updates on its own timer,
+				// so a pull from it can land in its callback; keep that on this thread
+				sound_stream *const source = &input.resolved_source().stream();
+				if (!parent.count(source))
+					unsafe.insert(stream);
+				else if (!sinks.count(source))
+					parent[find(stream)] = find(source);
+			}
+	}
+
+	// a subgraph only goes to the queue if every stream in it is thread-safe
+	std::set<sound_stream *> unsafe_roots;
+	for (sound_stream *stream : unsafe)
+		unsafe_roots.insert(find(stream));
+	std::map<sound_stream *, size_t> group_index;
+	for (sound_stream *stream : m_update_order)
+	{
+		if (sinks.count(stream))
+			continue;
+		sound_stream *const root = find(stream);
+		if (unsafe_roots.count(root))
+			m_serial_order.push_back(stream);
+		else
+		{
+			auto const found = group_index.emplace(root, m_update_groups.size());
+			if (found.second)
+				m_update_groups.push_back(update_group{ this, { }, attotime::zero });
+			m_update_groups[found.first->second].streams.push_back(stream);
+		}
+	}
+
+	// with nothing to overlap, the queue would only add overhead
+	if (m_update_groups.size() + (m_serial_order.empty() ? 0 : 1) < 2)
+	{
+		m_update_groups.clear();
+		m_serial_order.clear();
+	}
+}
+
+
+//-------------------------------------------------
+//  add_to_update_order - depth-first helper for
+//  compute_update_order
+//-------------------------------------------------
+
+void sound_manager::add_to_update_order(sound_stream &stream, std::set<sound_stream *> &visited)
+{
+	if (!visited.insert(&stream).second)
+		return;
+
+	// synchronous streams are kept current one sample at a time by their own timers,
+	// which pull their inputs as they go; leave that whole branch alone
+	if (stream.synchronous())
+		return;
+
+	// follow the resampler each input will actually read from
+	for (auto &input : stream.m_input)
+		if (input.valid())
+			add_to_update_order(input.resolved_source().stream(), visited);
+	m_update_order.push_back(&stream);
+}
+
+
+//-------------------------------------------------
+//  update_graph - bring every stream feeding the
+//  speakers up to the given time, sources first,
+//  in batches of a fixed number of output samples
+//-------------------------------------------------
+
+void sound_manager::update_graph(attotime endtime)
+{
+	if (!m_update_order_valid)
+		compute_update_order();
+
+	// independent subgraphs run on the queue while the rest runs here; the speakers'
+	// streams then mix the results when they pull
+	if (m_update_groups.empty())
+		m_graph_batches += update_streams(m_update_order, endtime);
+	else
+	{
+		for (update_group &group : m_update_groups)
+			group.end = endtime;
+		osd_work_item_queue_multiple(m_update_queue, &sound_manager::update_group_work, m_update_groups.size(), &m_update_groups[0], sizeof(m_update_groups[0]), WORK_ITEM_FLAG_AUTO_RELEASE);
+		m_graph_batches += update_streams(m_serial_order, endtime);
+		while (!osd_work_queue_wait(m_update_queue, osd_ticks_per_second())) { }
+	}
+}
+
+
+//-------------------------------------------------
+//  update_streams - update the given streams, in
+//  order, to the given time, a batch at a time;
+//  returns the number of batches
+//-------------------------------------------------
+
+u32 sound_manager::update_streams(std::vector<sound_stream *> const &streams, attotime endtime) const
+{
+	// each stream only generates its own samples here; its pulls from its inputs find
+	// them already up to date and just return views
+	attotime const batch = (m_batch_samples != 0) ? attotime(0, m_batch_samples * HZ_TO_ATTOSECONDS(machine().sample_rate())) : (endtime - m_last_update);
+	u32 batches = 0;
+	for (attotime batch_end = m_last_update; batch_end < endtime; batches++)
+	{
+		batch_end = std::min(batch_end + batch, endtime);
+		for (sound_stream *stream : streams)
+		{
+			attotime const start = stream->m_output[0].end_time();
+			if (start < batch_end)
+				stream->update_view(start, batch_end);
+		}
+	}
+	return batches;
+}
+
+
+//-------------------------------------------------
+//  update_group_work - work queue callback to
+//  update one independent subgraph
+//-------------------------------------------------
+
+void *sound_manager::update_group_work(void *param, int threadid)
+{
+	update_group const &group = *reinterpret_cast<update_group const *>(param);
+	group.manager->update_streams(group.streams, group.end);
+	return nullptr;
+}
+
+
+//-------------------------------------------------
+//  reset_stats - clear the per-stream update
+//  statistics
+//-------------------------------------------------
+
+void sound_manager::reset_stats()
+{
+	for (auto &stream : m_stream_list)
+	{
+		stream->m_stats = sound_stream::update_stats();
+		for (auto &resampler : stream->m_resampler_list)
+			resampler->m_stats = sound_stream::update_stats();
+	}
+	m_graph_batches = 0;
+}
+
+
+//-------------------------------------------------
+//  dump_stats - report the per-stream update
+//  statistics collected so far, most expensive
+//  first
+//-------------------------------------------------
+
+void sound_manager::dump_stats() const
+{
+	std::vector<sound_stream const *> streams;
+	osd_ticks_t total = 0;
+	stats_for_each(
+			[&streams, &total] (sound_stream const &stream)
+			{
+				if (stream.stats().m_updates != 0)
+				{
+					streams.push_back(&stream);
+					total += stream.stats().m_ticks;
+				}
+			});
+	std::sort(streams.begin(), streams.end(), [] (sound_stream const *a, sound_stream const *b) { return a->stats().m_ticks > b->stats().m_ticks; });
+
+	osd_printf_info("Sound stream statistics:\n");
+	osd_printf_info("  %u graph batches, %.3f ms in stream callbacks\n", m_graph_batches, double(total) * 1000.0 / double(osd_ticks_per_second()));
+	for (sound_stream const *stream : streams)
+	{
+		sound_stream::update_stats const &stats = stream->stats();
+		osd_printf_info("  %s: %u updates, %u samples (%.1f per update), %.3f ms (%.1f%%)\n",
+				stream->name(),
+				stats.m_updates,
+				stats.m_samples,
+				double(stats.m_samples) / double(stats.m_updates),
+				double(stats.m_ticks) * 1000.0 / double(osd_ticks_per_second()),
+				total ? 100.0 * double(stats.m_ticks) / double(total) : 0.0);
+	}
+}
+
+
 //-------------------------------------------------
 //  reset - reset all sound chips
 //-------------------------------------------------
@@ -1313,6 +1701,7 @@ void sound_manager::reset()
 
 			m_speakers.emplace_back(speaker);
 		}
+		invalidate_update_order();
 
 #if (SOUND_DEBUG)
 		// dump the sound graph when we start up
@@ -1529,6 +1918,11 @@ void sound_manager::update(s32 param)
 	std::fill_n(&m_leftmix[0], m_samples_this_update, 0);
 	std::fill_n(&m_rightmix[0], m_samples_this_update, 0);
 
+	// generate everything feeding the speakers in dependency order, so that their
+	// pulls below find each input already up to date
+	if (m_batch_samples != 0 || m_update_queue)
+		update_graph(endtime);
+
 	// force all the speaker streams to generate the proper number of samples
 	for (speaker_device &speaker : m_speakers)
 		speaker.mix(&m_leftmix[0], &m_rightmix[0], m_last_update, endtime, m_samples_this_update, (m_muted & MUTE_REASON_SYSTEM));
@@ -63,6 +63,12 @@
 
 #include "wavwrite.h"
 
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <tuple>
+
 
 //**************************************************************************
 //  CONSTANTS
@@ -102,6 +108,10 @@ constexpr u32 SAMPLE_RATE_MINIMUM = 50;
 //  TYPE DEFINITIONS
 //**************************************************************************
 
+// forward declarations
+class polyphase_resampler;
+
+
 // ======================> stream_buffer
 
 class stream_buffer
@@ -559,6 +569,9 @@ public:
 	// connect the source
 	void set_source(sound_stream_output *source);
 
+	// return the output we actually read from, which may be a resampler shared with another input
+	sound_stream_output &resolved_source() { sound_assert(valid()); return m_native_source->optimize_resampler(m_resampler_source); }
+
 	// update and return an reading view
 	read_stream_view update(attotime start, attotime end);
 
@@ -596,7 +609,11 @@ enum sound_stream_flags : u32
 
 	// specify that input streams should not be resampled; stream update handler
 	// must be able to accommodate multiple strams of differing input rates
-	STREAM_DISABLE_INPUT_RESAMPLING = 0x02
+	STREAM_DISABLE_INPUT_RESAMPLING = 0x02,
+
+	// specify that the update callback only touches state belonging to its own
+	// device, so it may run on another thread alongside unrelated streams
+	STREAM_THREAD_SAFE = 0x04
 };
 
 
@@ -622,6 +639,7 @@ public:
 	bool output_adaptive() const { return m_output_adaptive; }
 	bool synchronous() const { return m_synchronous; }
 	bool resampling_disabled() const { return m_resampling_disabled; }
+	bool thread_safe() const { return m_thread_safe; }
 
 	// input and output getters
 	u32 input_count() const { return m_input.size(); }
@@ -630,6 +648,15 @@ public:
 	sound_stream_input &input(int index) { sound_assert(index >= 0 && index < m_input.size()); return m_input[index]; }
 	sound_stream_output &output(int index) { sound_assert(index >= 0 && index < m_output.size()); return m_output[index]; }
 
+	// update statistics, only collected while enabled in the sound manager
+	struct update_stats
+	{
+		u64 m_updates = 0;          // number of times the callback ran
+		u64 m_samples = 0;          // samples generated by those calls
+		osd_ticks_t m_ticks = 0;    // host time spent in the callback
+	};
+	const update_stats &stats() const { return m_stats; }
+
 	// sample rate and timing getters
 	u32 sample_rate() const { return (m_pending_sample_rate != SAMPLE_RATE_INVALID) ? m_pending_sample_rate : m_sample_rate; }
 	attotime sample_time() const { return m_output[0].end_time(); }
@@ -694,6 +721,7 @@ private:
 	bool m_output_adaptive;                        // adaptive stream that runs at the sample rate of its output
 	bool m_synchronous;                            // synchronous stream that runs at the rate of its input
 	bool m_resampling_disabled;                    // is resampling of input streams disabled?
+	bool m_thread_safe;                            // can the callback run on another thread?
 	emu_timer *m_sync_timer;                       // update timer for synchronous streams
 
 	attotime m_last_update_end_time;               // last end_time() in update
@@ -711,6 +739,9 @@ private:
 
 	// callback information
 	stream_update_delegate m_callback_ex;          // extended callback function
+
+	// statistics
+	update_stats m_stats;                          // update statistics
 };
 
 
@@ -731,6 +762,27 @@ private:
 };
 
 
+// ======================> polyphase_resampler_stream
+
+class polyphase_resampler_stream : public sound_stream
+{
+public:
+	// construction/destruction
+	polyphase_resampler_stream(device_t &device, int quality);
+
+	// update handler
+	void resampler_sound_update(sound_stream &stream, std::vector<read_stream_view> const &inputs, std::vector<write_stream_view> &outputs);
+
+private:
+	// internal state
+	int m_quality;                                 // quality level of the filter
+	u32 m_max_latency;                             // largest latency used so far, in input samples
+	std::shared_ptr<polyphase_resampler const> m_filter; // coefficient tables for the current rates
+	std::vector<stream_buffer::sample_t> m_history; // contiguous copy of the input window
+	std::vector<stream_buffer::sample_t> m_scratch; // filtered output before it is written
+};
+
+
 // ======================> sound_manager
 
 // structure describing an indexed mixer
@@ -773,6 +825,9 @@ public:
 	// allocate a new stream with a new-style callback
 	sound_stream *stream_alloc(device_t &device, u32 inputs, u32 outputs, u32 sample_rate, stream_update_delegate callback, sound_stream_flags flags);
 
+	// return shared polyphase resampler tables for the given rates
+	std::shared_ptr<polyphase_resampler const> resampler_filter(u32 input_rate, u32 output_rate, int quality);
+
 	// WAV recording
 	bool is_recording() const { return bool(m_wavfile); }
 	bool start_recording();
@@ -797,6 +852,14 @@ public:
 	// fill the given buffer with 16-bit stereo audio samples
 	void samples(s16 *buffer);
 
+	// statistics
+	bool stats_enabled() const { return m_stats_enabled; }
+	void set_stats_enabled(bool enabled) { m_stats_enabled = enabled; }
+	u64 graph_batches() const { return m_graph_batches; }
+	template <typename T> void stats_for_each(T &&callback) const;
+	void reset_stats();
+	void dump_stats() const;
+
 private:
 	// set/reset the mute state for the given reason
 	void mute(bool mute, u8 reason);
@@ -807,6 +870,16 @@ private:
 	// apply pending sample rate changes
 	void apply_sample_rate_changes();
 
+	// compute the order in which update_graph visits streams
+	void invalidate_update_order() { m_update_order_valid = false; }
+	void compute_update_order();
+	void add_to_update_order(sound_stream &stream, std::set<sound_stream *> &visited);
+
+	// bring the speakers' inputs up to date in dependency order, a batch at a time
+	void update_graph(attotime endtime);
+	u32 update_streams(std::vector<sound_stream *> const &streams, attotime endtime) const;
+	static void *update_group_work(void *param, int threadid);
+
 	// reset all sound chips
 	void reset();
 
@@ -851,7 +924,53 @@ private:
 	std::vector<std::unique_ptr<sound_stream>> m_stream_list; // list of streams
 	std::map<sound_stream *, u8> m_orphan_stream_list; // list of orphaned streams
 	bool m_first_reset;                   // is this our first reset?
+
+	// dependency-ordered updates
+	u32 m_batch_samples;                  // samples per batch at the output rate, or 0 to pull from the speakers
+	bool m_update_order_valid;            // is m_update_order current?
+	std::vector<sound_stream *> m_update_order; // streams feeding the speakers, sources first
+
+	// independent subgraphs, updated concurrently
+	struct update_group
+	{
+		sound_manager *             manager;    // owning manager
+		std::vector<sound_stream *> streams;    // streams in the subgraph, sources first
+		attotime                    end;        // time to update them to
+	};
+	osd_work_queue *m_update_queue;       // work queue for thread-safe subgraphs, or nullptr
+	std::vector<update_group> m_update_groups; // thread-safe subgraphs to run on the queue
+	std::vector<sound_stream *> m_serial_order; // everything else, updated on the calling thread
+
+	// statistics
+	bool m_stats_enabled;                 // collect per-stream statistics?
+	u64 m_graph_batches;                  // batches run by update_graph
+
+	// shared resampler tables
+	std::map<std::tuple<u32, u32, int>, std::shared_ptr<polyphase_resampler const>> m_resampler_filters;
+	std::mutex m_resampler_filter_lock;   // guards the table map
 };
 
 
+
+//**************************************************************************
+//  INLINE FUNCTIONS
+//**************************************************************************
+
+//-------------------------------------------------
+//  stats_for_each - call the given function for
+//  every stream, including internal resamplers
+//-------------------------------------------------
+
+template <typename T>
+void sound_manager::stats_for_each(T &&callback) const
+{
+	for (auto &stream : m_stream_list)
+	{
+		callback(std::as_const(*stream));
+		for (auto &resampler : stream->m_resampler_list)
+			callback(std::as_const(*resampler));
+	}
+}
+
+
 #endif // MAME_EMU_SOUND_H
@@ -11,7 +11,9 @@
 #include "emu.h"
 #include "tilemap.h"
 
+#include "emuopts.h"
 #include "screen.h"
+#include "video/tilespan.h"
 
 
 //**************************************************************************
@@ -114,8 +116,7 @@ inline void tilemap_t::scanline_draw_opaque_null(int count, u8 *pri, u32 pcode)
 		return;
 
 	// update priority across the scanline
-	for (int i = 0; i < count; i++)
-		pri[i] = (pri[i] & (pcode >> 8)) | pcode;
+	tile_span::priority(pri, count, pcode);
 }
 
 
@@ -131,9 +132,7 @@ inline void tilemap_t::scanline_draw_masked_null(const u8 *maskptr, int mask, in
 		return;
 
 	// update priority across the scanline, checking the mask
-	for (int i = 0; i < count; i++)
-		if ((maskptr[i] & mask) == value)
-			pri[i] = (pri[i] & (pcode >> 8)) | pcode;
+	tile_span::priority_masked(pri, maskptr, mask, value, count, pcode);
 }
 
 
@@ -151,32 +150,13 @@ inline void tilemap_t::scanline_draw_opaque_ind16(u16 *dest, const u16 *source,
 	{
 		// use memcpy which should be well-optimized for the platform
 		memcpy(dest, source, count * 2);
-
-		// skip the rest if not changing priority
-		if (pcode == 0xff00)
-			return;
-
-		// update priority across the scanline
-		for (int i = 0; i < count; i++)
-			pri[i] = (pri[i] & (pcode >> 8)) | pcode;
-	}
-
-	// priority case
-	else if ((pcode & 0xffff) != 0xff00)
-	{
-		for (int i = 0; i < count; i++)
-		{
-			dest[i] = source[i] + pal;
-			pri[i] = (pri[i] & (pcode >> 8)) | pcode;
-		}
 	}
-
-	// no priority case
 	else
-	{
-		for (int i = 0; i < count; i++)
-			dest[i] = source[i] + pal;
-	}
+		tile_span::offset_ind16(dest, source, count, pal);
+
+	// update priority across the scanline
+	if ((pcode & 0xffff) != 0xff00)
+		tile_span::priority(pri, count, pcode);
 }
 
 
@@ -187,26 +167,11 @@ inline void tilemap_t::scanline_draw_opaque_ind16(u16 *dest, const u16 *source,
 
 inline void tilemap_t::scanline_draw_masked_ind16(u16 *dest, const u16 *source, const u8 *maskptr, int mask, int value, int count, u8 *pri, u32 pcode)
 {
-	int pal = pcode >> 16;
+	tile_span::offset_masked_ind16(dest, source, maskptr, mask, value, count, pcode >> 16);
 
-	// priority case
+	// update priority across the scanline, checking the mask
 	if ((pcode & 0xffff) != 0xff00)
-	{
-		for (int i = 0; i < count; i++)
-			if ((maskptr[i] & mask) == value)
-			{
-				dest[i] = source[i] + pal;
-				pri[i] = (pri[i] & (pcode >> 8)) | pcode;
-			}
-	}
-
-	// no priority case
-	else
-	{
-		for (int i = 0; i < count; i++)
-			if ((maskptr[i] & mask) == value)
-				dest[i] = source[i] + pal;
-	}
+		tile_span::priority_masked(pri, maskptr, mask, value, count, pcode);
 }
 
 
@@ -218,24 +183,11 @@ inline void tilemap_t::scanline_draw_masked_ind16(u16 *dest, const u16 *source,
 
 inline void tilemap_t::scanline_draw_opaque_rgb32(u32 *dest, const u16 *source, int count, const rgb_t *pens, u8 *pri, u32 pcode)
 {
-	const rgb_t *clut = &pens[pcode >> 16];
+	tile_span::lookup_rgb32(dest, source, count, &pens[pcode >> 16]);
 
-	// priority case
+	// update priority across the scanline
 	if ((pcode & 0xffff) != 0xff00)
-	{
-		for (int i = 0; i < count; i++)
-		{
-			dest[i] = clut[source[i]];
-			pri[i] = (pri[i] & (pcode >> 8)) | pcode;
-		}
-	}
-
-	// no priority case
-	else
-	{
-		for (int i = 0; i < count; i++)
-			dest[i] = clut[source[i]];
-	}
+		tile_span::priority(pri, count, pcode);
 }
 
 
@@ -246,26 +198,11 @@ inline void tilemap_t::scanline_draw_opaque_rgb32(u32 *dest, const u16 *source,
 
 inline void tilemap_t::scanline_draw_masked_rgb32(u32 *dest, const u16 *source, const u8 *maskptr, int mask, int value, int count, const rgb_t *pens, u8 *pri, u32 pcode)
 {
-	const rgb_t *clut = &pens[pcode >> 16];
+	tile_span::lookup_masked_rgb32(dest, source, maskptr, mask, value, count, &pens[pcode >> 16]);
 
-	// priority case
+	// update priority across the scanline, checking the mask
 	if ((pcode & 0xffff) != 0xff00)
-	{
-		for (int i = 0; i < count; i++)
-			if ((maskptr[i] & mask) == value)
-			{
-				dest[i] = clut[source[i]];
-				pri[i] = (pri[i] & (pcode >> 8)) | pcode;
-			}
-	}
-
-	// no priority case
-	else
-	{
-		for (int i = 0; i < count; i++)
-			if ((maskptr[i] & mask) == value)
-				dest[i] = clut[source[i]];
-	}
+		tile_span::priority_masked(pri, maskptr, mask, value, count, pcode);
 }
 
 
@@ -383,6 +320,10 @@ void tilemap_t::init_common(
 	m_palette_offset = 0;
 	m_gfx_used = 0;
 	memset(m_gfx_dirtyseq, 0, sizeof(m_gfx_dirtyseq));
+	m_changed_area.set(0, -1, 0, -1);
+	m_tracked_enable = false;
+	m_tracked_scrollx = m_tracked_scrolly = TILE_LINE_DISABLED;
+	m_tracked_palette_offset = 0;
 
 	// reset scroll information
 	m_scrollrows = 1;
@@ -506,6 +447,7 @@ void tilemap_t::mark_tile_dirty(tilemap_memory_index memindex)
 		if (logindex != INVALID_LOGICAL_INDEX)
 		{
 			m_tileflags[logindex] = TILE_FLAG_DIRTY;
+			m_dirty.set(logindex);
 			m_all_tiles_clean = false;
 		}
 	}
@@ -701,6 +643,7 @@ void tilemap_t::mappings_create()
 	m_memory_to_logical.resize(max_memory_index);
 	m_logical_to_memory.resize(max_logical_index);
 	m_tileflags.resize(max_logical_index);
+	m_dirty.resize(max_logical_index);
 
 	// update the mappings
 	mappings_update();
@@ -753,6 +696,7 @@ inline void tilemap_t::realize_all_dirty_tiles()
 	if (m_all_tiles_dirty || gfx_elements_changed())
 	{
 		memset(&m_tileflags[0], TILE_FLAG_DIRTY, m_tileflags.size());
+		m_dirty.set_all();
 		m_all_tiles_dirty = false;
 		m_gfx_used = 0;
 	}
@@ -777,18 +721,39 @@ void tilemap_t::pixmap_update()
 	// flush the dirty state to all tiles as appropriate
 	realize_all_dirty_tiles();
 
-	// iterate over rows and columns
-	logical_index logindex = 0;
-	for (u32 row = 0; row < m_rows; row++)
-		for (u32 col = 0; col < m_cols; col++, logindex++)
-			if (m_tileflags[logindex] == TILE_FLAG_DIRTY)
-				tile_update(logindex, col, row);
+	// update just the dirty tiles
+	m_dirty.for_each(0, m_tileflags.size(), [this] (logical_index logindex) { tile_update(logindex, logindex % m_cols, logindex / m_cols); });
 
 	// mark it all clean
 	m_all_tiles_clean = true;
 }
 
 
+//-------------------------------------------------
+//  realize_instance - update the dirty tiles an
+//  instance of the tilemap at xpos,ypos shows
+//  inside the cliprect, leaving the rest for
+//  later
+//-------------------------------------------------
+
+void tilemap_t::realize_instance(const rectangle &cliprect, int xpos, int ypos)
+{
+	// clip to the tilemap exactly as draw_instance does
+	int const x1 = (std::max)(xpos, cliprect.left()) - xpos;
+	int const x2 = (std::min)(xpos + int(m_width), cliprect.right() + 1) - xpos;
+	int const y1 = (std::max)(ypos, cliprect.top()) - ypos;
+	int const y2 = (std::min)(ypos + int(m_height), cliprect.bottom() + 1) - ypos;
+	if (x1 >= x2 || y1 >= y2 || m_dirty.empty())
+		return;
+
+	// update the dirty tiles on each row this touches
+	u32 const mincol = x1 / m_tilewidth;
+	u32 const maxcol = (x2 + m_tilewidth - 1) / m_tilewidth;
+	for (u32 row = y1 / m_tileheight; row < (y2 + m_tileheight - 1) / m_tileheight; row++)
+		m_dirty.for_each(row * m_cols + mincol, row * m_cols + maxcol, [this, row] (logical_index logindex) { tile_update(logindex, logindex % m_cols, row); });
+}
+
+
 //-------------------------------------------------
 //  tile_update - update a single dirty tile
 //-------------------------------------------------
@@ -796,6 +761,8 @@ void tilemap_t::pixmap_update()
 void tilemap_t::tile_update(logical_index logindex, u32 col, u32 row)
 {
 	auto profile = g_profiler.start(PROFILER_TILEMAP_UPDATE);
+	m_dirty.clear(logindex);
+	m_manager->stats_realized();
 
 	// call the get info callback for the associated memory index
 	tilemap_memory_index memindex = m_logical_to_memory[logindex];
@@ -820,6 +787,13 @@ void tilemap_t::tile_update(logical_index logindex, u32 col, u32 row)
 		m_gfx_used |= 1 << m_tileinfo.gfxnum;
 		m_gfx_dirtyseq[m_tileinfo.gfxnum] = m_tileinfo.decoder->gfx(m_tileinfo.gfxnum)->dirtyseq();
 	}
+
+	// grow the area a tracked screen needs to hear about
+	rectangle const tile(x0, x0 + m_tilewidth - 1, y0, y0 + m_tileheight - 1);
+	if (m_changed_area.empty())
+		m_changed_area = tile;
+	else
+		m_changed_area |= tile;
 }
 
 
@@ -991,7 +965,10 @@ void tilemap_t::draw_common(screen_device &screen, _BitmapClass &dest, const rec
 {
 	// skip if disabled
 	if (!m_enable)
+	{
+		track_draw(dest, TILE_LINE_DISABLED, TILE_LINE_DISABLED);
 		return;
+	}
 
 	auto profile = g_profiler.start(PROFILER_TILEMAP_DRAW);
 
@@ -1009,6 +986,44 @@ void tilemap_t::draw_common(screen_device &screen, _BitmapClass &dest, const rec
 	u32 const xextent = visarea.right() + visarea.left() + 1; // x0 + x1 + 1 for calculating horizontal centre as (x0 + x1 + 1) >> 1
 	u32 const yextent = visarea.bottom() + visarea.top() + 1; // y0 + y1 + 1 for calculating vertical centre as (y0 + y1 + 1) >> 1
 
+	// large draws are split into bands of scanlines, each scrolled independently
+	m_manager->stats_frame(screen.frame_number());
+	auto const draw = [&] (const rectangle &band)
+	{
+		blit_parameters bandblit = blit;
+		bandblit.cliprect = band;
+		for_each_instance(bandblit, xextent, yextent, [&] (const blit_parameters &instance, int xpos, int ypos) { draw_instance(screen, dest, instance, xpos, ypos); });
+	};
+	auto const realize = [&] ()
+	{
+		for_each_instance(blit, xextent, yextent, [this] (const blit_parameters &instance, int xpos, int ypos) { realize_instance(instance.cliprect, xpos, ypos); });
+	};
+	draw_banded(blit.cliprect, draw, realize);
+
+	// with rows or columns scrolling independently, any of it may have moved
+	if (m_scrollrows == 1 && m_scrollcols == 1)
+		track_draw(dest, effective_rowscroll(0, xextent), effective_colscroll(0, yextent));
+	else
+		track_draw(dest, TILE_LINE_DISABLED, TILE_LINE_DISABLED);
+}
+
+void tilemap_t::draw(screen_device &screen, bitmap_ind16 &dest, const rectangle &cliprect, u32 flags, u8 priority, u8 priority_mask)
+{ draw_common(screen, dest, cliprect, flags, priority, priority_mask); }
+
+void tilemap_t::draw(screen_device &screen, bitmap_rgb32 &dest, const rectangle &cliprect, u32 flags, u8 priority, u8 priority_mask)
+{ draw_common(screen, dest, cliprect, flags, priority, priority_mask); }
+
+
+//-------------------------------------------------
+//  for_each_instance - call func(blit, xpos, ypos)
+//  for every scrolled instance of the tilemap
+//  that falls in the cliprect, with the cliprect
+//  narrowed to its rows or columns
+//-------------------------------------------------
+
+template<typename T>
+void tilemap_t::for_each_instance(blit_parameters blit, u32 xextent, u32 yextent, const T &func)
+{
 	// XY scrolling playfield
 	if (m_scrollrows == 1 && m_scrollcols == 1)
 	{
@@ -1017,7 +1032,7 @@ void tilemap_t::draw_common(screen_device &screen, _BitmapClass &dest, const rec
 		int scrolly = effective_colscroll(0, yextent);
 		for (int ypos = scrolly - m_height; ypos <= blit.cliprect.bottom(); ypos += m_height)
 			for (int xpos = scrollx - m_width; xpos <= blit.cliprect.right(); xpos += m_width)
-				draw_instance(screen, dest, blit, xpos, ypos);
+				func(blit, xpos, ypos);
 	}
 
 	// scrolling rows + vertical scroll
@@ -1053,7 +1068,7 @@ void tilemap_t::draw_common(screen_device &screen, _BitmapClass &dest, const rec
 
 				// iterate over X to handle wraparound
 				for (int xpos = scrollx - m_width; xpos <= original_cliprect.right(); xpos += m_width)
-					draw_instance(screen, dest, blit, xpos, ypos);
+					func(blit, xpos, ypos);
 			}
 		}
 	}
@@ -1088,17 +1103,94 @@ void tilemap_t::draw_common(screen_device &screen, _BitmapClass &dest, const rec
 
 				// iterate over Y to handle wraparound
 				for (int ypos = scrolly - m_height; ypos <= original_cliprect.bottom(); ypos += m_height)
-					draw_instance(screen, dest, blit, xpos, ypos);
+					func(blit, xpos, ypos);
 			}
 		}
 	}
 }
 
-void tilemap_t::draw(screen_device &screen, bitmap_ind16 &dest, const rectangle &cliprect, u32 flags, u8 priority, u8 priority_mask)
-{ draw_common(screen, dest, cliprect, flags, priority, priority_mask); }
 
-void tilemap_t::draw(screen_device &screen, bitmap_rgb32 &dest, const rectangle &cliprect, u32 flags, u8 priority, u8 priority_mask)
-{ draw_common(screen, dest, cliprect, flags, priority, priority_mask); }
+//-------------------------------------------------
+//  draw_banded - call a draw for horizontal
+//  bands of the cliprect on the manager's work
+//  queue, or once for the whole cliprect if it
+//  is too small to be worth splitting
+//-------------------------------------------------
+
+template<typename T, typename U>
+void tilemap_t::draw_banded(const rectangle &cliprect, const T &draw, const U &realize)
+{
+	int const bands = m_manager->band_count(cliprect.height());
+	if (bands < 2)
+	{
+		draw(cliprect);
+		return;
+	}
+
+	// the bands only read the pixmap, so every tile they might touch has to be realized first
+	realize();
+
+	struct band_params
+	{
+		const T *   draw;
+		rectangle   cliprect;
+	};
+	band_params params[tilemap_manager::MAX_BANDS];
+	for (int band = 0; band < bands; band++)
+	{
+		params[band].draw = &draw;
+		params[band].cliprect = cliprect;
+		params[band].cliprect.sety(cliprect.top() + cliprect.height() * band / bands, cliprect.top() + cliprect.height() * (band + 1) / bands - 1);
+	}
+
+	auto const work = [] (void *param, int) -> void *
+	{
+		band_params const &band = *reinterpret_cast<band_params const *>(param);
+		(*band.draw)(band.cliprect);
+		return nullptr;
+	};
+	osd_work_item_queue_multiple(m_manager->m_band_queue, work, bands, params, sizeof(params[0]), WORK_ITEM_FLAG_AUTO_RELEASE);
+	while (!osd_work_queue_wait(m_manager->m_band_queue, osd_ticks_per_second())) { }
+}
+
+
+//-------------------------------------------------
+//  track_draw - tell a dirty-tracked screen what
+//  a draw may have changed since the last one:
+//  just the redrawn tiles if the tilemap sits
+//  where it did, everything otherwise
+//-------------------------------------------------
+
+void tilemap_t::track_draw(const bitmap_t &dest, s32 scrollx, s32 scrolly)
+{
+	if (!screen_device::tracks_bitmap(dest))
+		return;
+
+	const rectangle &destclip = dest.cliprect();
+	if (m_enable != m_tracked_enable || (m_enable && (scrollx == TILE_LINE_DISABLED || scrollx != m_tracked_scrollx || scrolly != m_tracked_scrolly || m_palette_offset != m_tracked_palette_offset)))
+	{
+		// the whole bitmap, not just this cliprect, since later partial updates will draw the same way
+		screen_device::mark_bitmap_dirty(dest, destclip);
+	}
+	else if (m_enable && !m_changed_area.empty())
+	{
+		// each wraparound instance of the redrawn tiles
+		for (int ypos = scrolly - m_height; ypos <= destclip.bottom(); ypos += m_height)
+			for (int xpos = scrollx - m_width; xpos <= destclip.right(); xpos += m_width)
+			{
+				rectangle changed = m_changed_area;
+				changed.offset(xpos, ypos);
+				changed &= destclip;
+				screen_device::mark_bitmap_dirty(dest, changed);
+			}
+	}
+
+	m_changed_area.set(0, -1, 0, -1);
+	m_tracked_enable = m_enable;
+	m_tracked_scrollx = scrollx;
+	m_tracked_scrolly = scrolly;
+	m_tracked_palette_offset = m_palette_offset;
+}
 
 
 //-------------------------------------------------
@@ -1119,7 +1211,10 @@ void tilemap_t::draw_roz_common(screen_device &screen, _BitmapClass &dest, const
 
 	// skip if disabled
 	if (!m_enable)
+	{
+		track_draw(dest, TILE_LINE_DISABLED, TILE_LINE_DISABLED);
 		return;
+	}
 
 	// see if this is just a regular render and if so, do a regular render
 	if (incxx == (1 << 16) && incxy == 0 && incyx == 0 && incyy == (1 << 16) && wraparound)
@@ -1141,8 +1236,16 @@ void tilemap_t::draw_roz_common(screen_device &screen, _BitmapClass &dest, const
 	// get the full pixmap for the tilemap
 	pixmap();
 
-	// then do the roz copy
-	draw_roz_core(screen, dest, blit, startx, starty, incxx, incxy, incyx, incyy, wraparound);
+	// then do the roz copy, in bands if it is large enough
+	m_manager->stats_frame(screen.frame_number());
+	auto const draw = [&] (const rectangle &band)
+	{
+		blit_parameters bandblit = blit;
+		bandblit.cliprect = band;
+		draw_roz_core(screen, dest, bandblit, startx, starty, incxx, incxy, incyx, incyy, wraparound);
+	};
+	draw_banded(blit.cliprect, draw, [] () { });
+	track_draw(dest, TILE_LINE_DISABLED, TILE_LINE_DISABLED);
 }
 
 void tilemap_t::draw_roz(screen_device &screen, bitmap_ind16 &dest, const rectangle &cliprect,
@@ -1585,8 +1688,18 @@ void tilemap_t::get_info_debug(u32 col, u32 row, u8 &gfxnum, u32 &code, u32 &col
 
 tilemap_manager::tilemap_manager(running_machine &machine)
 	: m_machine(machine),
-		m_instance(0)
+		m_instance(0),
+		m_bands(std::min(machine.options().tilemap_bands(), MAX_BANDS)),
+		m_band_queue(nullptr),
+		m_tiles_realized(0),
+		m_stats_frame(0),
+		m_stats_frames(0),
+		m_frame_realized(0),
+		m_peak_realized(0)
 {
+	// large draws can be split into bands on other threads
+	if (m_bands > 1)
+		m_band_queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_MULTI);
 }
 
 
@@ -1609,6 +1722,34 @@ tilemap_manager::~tilemap_manager()
 				break;
 			}
 	}
+
+	if (m_band_queue)
+		osd_work_queue_free(m_band_queue);
+
+	// report how much tile realization the run needed
+	if (m_tiles_realized != 0)
+	{
+		stats_frame(m_stats_frame + 1);
+		osd_printf_verbose("Tilemaps: %u tiles realized over %u frames (%.1f per frame, peak %u)\n",
+				m_tiles_realized, m_stats_frames, double(m_tiles_realized) / double(m_stats_frames), m_peak_realized);
+	}
+}
+
+
+//-------------------------------------------------
+//  stats_frame - start counting realized tiles
+//  for a new screen frame
+//-------------------------------------------------
+
+void tilemap_manager::stats_frame(u64 frame)
+{
+	if (frame == m_stats_frame)
+		return;
+
+	m_peak_realized = std::max(m_peak_realized, m_frame_realized);
+	m_stats_frames++;
+	m_stats_frame = frame;
+	m_frame_realized = 0;
 }
 
 
@@ -304,6 +304,7 @@
 #pragma once
 
 #include "memarray.h"
+#include <algorithm>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -400,6 +401,87 @@ typedef device_delegate<void (tilemap_t &, tile_data &, tilemap_memory_index)> t
 typedef device_delegate<tilemap_memory_index (u32, u32, u32, u32)> tilemap_mapper_delegate;
 
 
+// ======================> tilemap_dirty_bits
+
+// word-packed set of dirty tiles, by logical index
+class tilemap_dirty_bits
+{
+public:
+	// sizing
+	void resize(u32 count) { m_size = count; m_words.assign((count + 63) / 64, 0); m_count = 0; }
+
+	// getters
+	u32 count() const { return m_count; }
+	bool empty() const { return m_count == 0; }
+	bool test(u32 index) const { return BIT(m_words[index / 64], index % 64); }
+
+	// setters
+	void set(u32 index)
+	{
+		u64 &word = m_words[index / 64];
+		u64 const bit = u64(1) << (index % 64);
+		if (!(word & bit))
+		{
+			word |= bit;
+			m_count++;
+		}
+	}
+
+	void clear(u32 index)
+	{
+		u64 &word = m_words[index / 64];
+		u64 const bit = u64(1) << (index % 64);
+		if (word & bit)
+		{
+			word &= ~bit;
+			m_count--;
+		}
+	}
+
+	void set_all()
+	{
+		std::fill(m_words.begin(), m_words.end(), ~u64(0));
+		if (m_size % 64)
+			m_words.back() = ~u64(0) >> (64 - m_size % 64);
+		m_count = m_size;
+	}
+
+	// call func(index) for each dirty index in [first, last); clean words are skipped, and the
+	// scan stops once the popcounts of the words visited account for every dirty index
+	template <typename T>
+	void for_each(u32 first, u32 last, T &&func) const
+	{
+		u32 remaining = m_count;
+		for (u32 wordnum = first / 64; remaining != 0 && wordnum * 64 < last; wordnum++)
+		{
+			u64 word = m_words[wordnum];
+			if (!word)
+				continue;
+			remaining -= population_count_64(word);
+
+			// trim the first and last words to the range
+			if (wordnum == first / 64)
+				word &= ~u64(0) << (first % 64);
+			if ((wordnum + 1) * 64 > last)
+				word &= ~u64(0) >> (64 - (last - wordnum * 64));
+
+			// func may clear bits, so work from the copy
+			while (word)
+			{
+				u32 const bit = 63 - count_leading_zeros_64(word & (~word + 1));
+				word &= word - 1;
+				func(wordnum * 64 + bit);
+			}
+		}
+	}
+
+private:
+	std::vector<u64>    m_words;            // one bit per tile
+	u32                 m_size = 0;         // number of tiles
+	u32                 m_count = 0;        // number of bits set
+};
+
+
 // ======================> tilemap_t
 
 // core tilemap structure
@@ -546,6 +628,7 @@ private:
 	void mappings_create();
 	void mappings_update();
 	void realize_all_dirty_tiles();
+	void realize_instance(const rectangle &cliprect, int xpos, int ypos);
 
 	// internal drawing
 	void pixmap_update();
@@ -554,9 +637,12 @@ private:
 	u8 tile_apply_bitmask(const u8 *maskdata, u32 x0, u32 y0, u8 category, u8 flags);
 	void configure_blit_parameters(blit_parameters &blit, bitmap_ind8 &priority_bitmap, const rectangle &cliprect, u32 flags, u8 priority, u8 priority_mask);
 	template<class _BitmapClass> void draw_common(screen_device &screen, _BitmapClass &dest, const rectangle &cliprect, u32 flags, u8 priority, u8 priority_mask);
+	template<typename T> void for_each_instance(blit_parameters blit, u32 xextent, u32 yextent, const T &func);
+	template<typename T, typename U> void draw_banded(const rectangle &cliprect, const T &draw, const U &realize);
 	template<class _BitmapClass> void draw_roz_common(screen_device &screen, _BitmapClass &dest, const rectangle &cliprect, u32 startx, u32 starty, int incxx, int incxy, int incyx, int incyy, bool wraparound, u32 flags, u8 priority, u8 priority_mask);
 	template<class _BitmapClass> void draw_instance(screen_device &screen, _BitmapClass &dest, const blit_parameters &blit, int xpos, int ypos);
 	template<class _BitmapClass> void draw_roz_core(screen_device &screen, _BitmapClass &destbitmap, const blit_parameters &blit, u32 startx, u32 starty, int incxx, int incxy, int incyx, int incyy, bool wraparound);
+	void track_draw(const bitmap_t &dest, s32 scrollx, s32 scrolly);
 
 	// managers and devices
 	tilemap_manager *           m_manager;              // reference to the owning manager
@@ -607,7 +693,15 @@ private:
 	// transparency mapping
 	bitmap_ind8                 m_flagsmap;             // per-pixel flags
 	std::vector<u8>             m_tileflags;            // per-tile flags
+	tilemap_dirty_bits          m_dirty;                // tiles still to be realized
 	u8                          m_pen_to_flags[MAX_PEN_TO_FLAGS * TILEMAP_NUM_GROUPS]; // mapping of pens to flags
+
+	// dirty tracking for screens that want it
+	rectangle                   m_changed_area;         // pixmap area redrawn since the last tracked draw
+	bool                        m_tracked_enable;       // enable state at the last tracked draw
+	s32                         m_tracked_scrollx;      // XY scroll at the last tracked draw, or TILE_LINE_DISABLED
+	s32                         m_tracked_scrolly;
+	u32                         m_tracked_palette_offset; // palette offset at the last tracked draw
 };
 
 
@@ -642,6 +736,9 @@ public:
 	void mark_all_dirty();
 	void set_flip_all(u32 attributes);
 
+	// statistics
+	u64 tiles_realized() const { return m_tiles_realized; }
+
 private:
 	// tilemap creation
 	tilemap_t &create(device_gfx_interface &decoder, tilemap_get_info_delegate tile_get_info, tilemap_mapper_delegate mapper, u16 tilewidth, u16 tileheight, u32 cols, u32 rows, tilemap_t *allocated);
@@ -650,10 +747,30 @@ private:
 	// allocate an instance index
 	int alloc_instance() { return ++m_instance; }
 
+	// statistics helpers
+	void stats_frame(u64 frame);
+	void stats_realized() { m_tiles_realized++; m_frame_realized++; }
+
+	// number of bands to split a draw of the given height into
+	int band_count(int rows) const { return m_band_queue ? std::min(m_bands, rows / MIN_BAND_ROWS) : 1; }
+
+	// banded drawing limits
+	static constexpr int MAX_BANDS = 32;        // most bands a draw is split into
+	static constexpr int MIN_BAND_ROWS = 16;    // fewest rows worth handing to another thread
+
 	// internal state
 	running_machine &       m_machine;
 	simple_list<tilemap_t>  m_tilemap_list;
 	int                     m_instance;
+	int                     m_bands;            // bands to split large draws into (0 or 1 = draw on this thread)
+	osd_work_queue *        m_band_queue;       // work queue for banded draws
+
+	// statistics
+	u64                     m_tiles_realized;   // tiles realized in total
+	u64                     m_stats_frame;      // screen frame the current count belongs to
+	u32                     m_stats_frames;     // frames with tilemap draws
+	u32                     m_frame_realized;   // tiles realized in the current frame
+	u32                     m_peak_realized;    // most tiles realized in one frame
 };
 
 
@@ -88,6 +88,8 @@ video_manager::video_manager(running_machine &machine)
 	, m_speed_last_realtime(0)
 	, m_speed_last_emutime(attotime::zero)
 	, m_speed_percent(1.0)
+	, m_speed_last_uploaded(0)
+	, m_speed_last_upload_total(0)
 	, m_overall_real_seconds(0)
 	, m_overall_real_ticks(0)
 	, m_overall_emutime(attotime::zero)
@@ -110,6 +112,8 @@ video_manager::video_manager(running_machine &machine)
 	, m_snap_native(true)
 	, m_snap_width(0)
 	, m_snap_height(0)
+	, m_snap_queue(nullptr)
+	, m_snap_bands(std::max(machine.options().snap_bands(), 0))
 {
 	// request a callback upon exiting
 	machine.add_notifier(MACHINE_NOTIFY_EXIT, machine_notify_delegate(&video_manager::exit, this));
@@ -171,6 +175,10 @@ video_manager::video_manager(running_machine &machine)
 	if (sscanf(machine.options().snap_size(), "%dx%d", &m_snap_width, &m_snap_height) != 2)
 		m_snap_width = m_snap_height = 0;
 
+	// snapshots and movie frames can be rendered in bands on other threads
+	if (m_snap_bands > 1)
+		m_snap_queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_MULTI);
+
 	// if no screens, create a periodic timer to drive updates
 	if (no_screens)
 	{
@@ -315,6 +323,14 @@ std::string video_manager::speed_text()
 	if (partials > 1)
 		util::stream_format(str, "\n%d partial updates", partials);
 
+	// and how much of the refreshed texture data the OSD actually uploaded since last time
+	u64 const uploaded = machine().render().uploaded_pixels() - m_speed_last_uploaded;
+	u64 const total = machine().render().upload_total_pixels() - m_speed_last_upload_total;
+	m_speed_last_uploaded += uploaded;
+	m_speed_last_upload_total += total;
+	if (total != 0 && uploaded != total)
+		util::stream_format(str, "\n%d%% of texture pixels uploaded", int(100 * uploaded / total));
+
 	return str.str();
 }
 
@@ -501,6 +517,11 @@ void video_manager::exit()
 	// free the snapshot target
 	machine().render().target_free(m_snap_target);
 	m_snap_bitmap.reset();
+	if (m_snap_queue)
+	{
+		osd_work_queue_free(m_snap_queue);
+		m_snap_queue = nullptr;
+	}
 
 	// print a final result if we have at least 2 seconds' worth of data
 	if (!emulator_info::standalone() && m_overall_emutime.seconds() >= 1)
@@ -1046,9 +1067,9 @@ void video_manager::create_snapshot_bitmap(screen_device *screen)
 	render_primitive_list &primlist = m_snap_target->get_primitives();
 	primlist.acquire_lock();
 	if (machine().options().snap_bilinear())
-		snap_renderer_bilinear::draw_primitives(primlist, &m_snap_bitmap.pix(0), width, height, m_snap_bitmap.rowpixels());
+		snap_renderer_bilinear::draw_primitives(primlist, &m_snap_bitmap.pix(0), width, height, m_snap_bitmap.rowpixels(), m_snap_queue, m_snap_bands);
 	else
-		snap_renderer::draw_primitives(primlist, &m_snap_bitmap.pix(0), width, height, m_snap_bitmap.rowpixels());
+		snap_renderer::draw_primitives(primlist, &m_snap_bitmap.pix(0), width, height, m_snap_bitmap.rowpixels(), m_snap_queue, m_snap_bands);
 	primlist.release_lock();
 }
 
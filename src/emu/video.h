@@ -130,6 +130,8 @@ private:
 	osd_ticks_t         m_speed_last_realtime;      // real time at the last speed calculation
 	attotime            m_speed_last_emutime;       // emulated time at the last speed calculation
 	double              m_speed_percent;            // most recent speed percentage
+	u64                 m_speed_last_uploaded;      // texture pixels uploaded at the last speed text
+	u64                 m_speed_last_upload_total;  // refreshed texture pixels at the last speed text
 
 	// overall speed computation
 	u32                 m_overall_real_seconds;     // accumulated real seconds at normal speed
@@ -161,6 +163,8 @@ private:
 	bool                m_snap_native;              // are we using native per-screen layouts?
 	s32                 m_snap_width;               // width of snapshots (0 == auto)
 	s32                 m_snap_height;              // height of snapshots (0 == auto)
+	osd_work_queue *    m_snap_queue;               // work queue for banded snapshot rendering
+	u32                 m_snap_bands;               // number of bands to render snapshots in
 
 	// movie recordings
 	std::vector<movie_recording::ptr> m_movie_recordings;
@@ -0,0 +1,529 @@
+// license:BSD-3-Clause
+// copyright-holders:agent
+/***************************************************************************
+
+    gfxspan.h
+
+    SIMD kernels for the common drawgfx pixel operations: rebasing
+    8-bit pens into indexed bitmaps, remapping them through a palette
+    into RGB bitmaps, and alpha blending remapped pens, each with an
+    optional priority bitmap. Which pens draw is described by one of
+    the pen classes below. The instruction set is picked at compile
+    time the same way rgbspan.h picks one; without one, each kernel
+    is just its scalar loop.
+
+    Every kernel writes exactly the pixels the PIXEL_OP macros in
+    drawgfxt.ipp write, and reads the palette only for pens that are
+    drawn.
+
+***************************************************************************/
+
+#ifndef MAME_EMU_VIDEO_GFXSPAN_H
+#define MAME_EMU_VIDEO_GFXSPAN_H
+
+#pragma once
+
+#if (!defined(MAME_DEBUG) || defined(__OPTIMIZE__)) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)))
+#define MAME_GFX_SPAN_SSE
+#include <emmintrin.h>
+#if defined(__SSSE3__) || defined(__AVX2__)
+#include <tmmintrin.h>
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define MAME_GFX_SPAN_NEON
+#include <arm_neon.h>
+#endif
+
+
+class gfx_span
+{
+#if defined(MAME_GFX_SPAN_SSE)
+	using vector = __m128i;
+#elif defined(MAME_GFX_SPAN_NEON)
+	using vector = uint8x16_t;
+#endif
+
+public:
+#if defined(MAME_GFX_SPAN_SSE) || defined(MAME_GFX_SPAN_NEON)
+	static constexpr bool enabled = true;
+#else
+	static constexpr bool enabled = false;
+#endif
+
+	//-------------------------------------------------
+	//  all_pens - every pen draws
+	//-------------------------------------------------
+
+	class all_pens
+	{
+	public:
+		bool draws(u8 pen) const { return true; }
+#if defined(MAME_GFX_SPAN_SSE)
+		vector select(u8 const *src) const { return _mm_set1_epi8(-1); }
+#elif defined(MAME_GFX_SPAN_NEON)
+		vector select(u8 const *src) const { return vdupq_n_u8(0xff); }
+#endif
+	};
+
+
+	//-------------------------------------------------
+	//  trans_pen - every pen but one draws
+	//-------------------------------------------------
+
+	class trans_pen
+	{
+	public:
+		trans_pen(u32 pen) : m_pen(pen) { }
+
+		bool draws(u8 pen) const { return pen != m_pen; }
+#if defined(MAME_GFX_SPAN_SSE)
+		vector select(u8 const *src) const
+		{
+			// a pen above 0xff never matches a source byte
+			if (m_pen > 0xff)
+				return _mm_set1_epi8(-1);
+			__m128i const s = _mm_loadu_si128(reinterpret_cast<__m128i const *>(src));
+			return _mm_xor_si128(_mm_cmpeq_epi8(s, _mm_set1_epi8(char(m_pen))), _mm_set1_epi8(-1));
+		}
+#elif defined(MAME_GFX_SPAN_NEON)
+		vector select(u8 const *src) const
+		{
+			if (m_pen > 0xff)
+				return vdupq_n_u8(0xff);
+			return vmvnq_u8(vceqq_u8(vld1q_u8(src), vdupq_n_u8(u8(m_pen))));
+		}
+#endif
+
+	private:
+		u32 m_pen;
+	};
+
+
+	//-------------------------------------------------
+	//  trans_mask - pens whose bit is clear in a
+	//  32-bit mask draw; larger pens wrap the way
+	//  the shift in the scalar op does on x86 and
+	//  ARM hosts
+	//-------------------------------------------------
+
+	class trans_mask
+	{
+	public:
+		trans_mask(u32 mask) : m_mask(mask)
+		{
+			for (int pen = 0; pen < 32; pen++)
+				m_table[pen] = BIT(mask, pen) ? 0x00 : 0xff;
+		}
+
+		bool draws(u8 pen) const { return ((m_mask >> pen) & 1) == 0; }
+#if defined(MAME_GFX_SPAN_SSE) || defined(MAME_GFX_SPAN_NEON)
+		vector select(u8 const *src) const { return lookup32(src, m_table); }
+#endif
+
+	private:
+		u32 m_mask;
+		u8 m_table[32];
+	};
+
+
+	//-------------------------------------------------
+	//  pri_mask - priority values whose bit is clear
+	//  in 'pmask' let a drawn pen through
+	//-------------------------------------------------
+
+	class pri_mask
+	{
+	public:
+		pri_mask(u32 pmask) : m_pmask(pmask)
+		{
+			for (int pri = 0; pri < 32; pri++)
+				m_table[pri] = BIT(pmask, pri) ? 0x00 : 0xff;
+		}
+
+		bool allows(u8 pri) const { return ((1 << (pri & 0x1f)) & m_pmask) == 0; }
+#if defined(MAME_GFX_SPAN_SSE) || defined(MAME_GFX_SPAN_NEON)
+		vector select(u8 const *pri) const { return lookup32(pri, m_table); }
+#endif
+
+	private:
+		u32 m_pmask;
+		u8 m_table[32];
+	};
+
+
+	//-------------------------------------------------
+	//  rebase_ind16 - dest = color + src for pens
+	//  that draw
+	//-------------------------------------------------
+
+	template <typename Pens>
+	static void rebase_ind16(u16 *dest, u8 const *src, s32 count, u32 color, Pens const &pens)
+	{
+		s32 x = 0;
+#if defined(MAME_GFX_SPAN_SSE) || defined(MAME_GFX_SPAN_NEON)
+		for ( ; x + 16 <= count; x += 16)
+		{
+			vector const draw = pens.select(src + x);
+			u32 const bits = select_bits(draw);
+			if (bits != 0)
+				rebase16_store(dest + x, src + x, color, draw, bits == 0xffff);
+		}
+#endif
+		for ( ; x < count; x++)
+			if (pens.draws(src[x]))
+				dest[x] = color + src[x];
+	}
+
+	template <typename Pens>
+	static void rebase_ind16(u16 *dest, u8 *pri, u8 const *src, s32 count, u32 color, Pens const &pens, pri_mask const &pmask)
+	{
+		s32 x = 0;
+#if defined(MAME_GFX_SPAN_SSE) || defined(MAME_GFX_SPAN_NEON)
+		for ( ; x + 16 <= count; x += 16)
+		{
+			vector const draw = pens.select(src + x);
+			if (select_bits(draw) == 0)
+				continue;
+			vector const write = update_priority(pri + x, draw, pmask);
+			u32 const bits = select_bits(write);
+			if (bits != 0)
+				rebase16_store(dest + x, src + x, color, write, bits == 0xffff);
+		}
+#endif
+		for ( ; x < count; x++)
+			if (pens.draws(src[x]))
+			{
+				if (pmask.allows(pri[x]))
+					dest[x] = color + src[x];
+				pri[x] = 31;
+			}
+	}
+
+
+	//-------------------------------------------------
+	//  remap_rgb32 - dest = paldata[src] for pens
+	//  that draw
+	//-------------------------------------------------
+
+	template <typename Pens>
+	static void remap_rgb32(u32 *dest, u8 const *src, s32 count, pen_t const *paldata, Pens const &pens)
+	{
+		s32 x = 0;
+#if defined(MAME_GFX_SPAN_SSE) || defined(MAME_GFX_SPAN_NEON)
+		for ( ; x + 16 <= count; x += 16)
+		{
+			vector const draw = pens.select(src + x);
+			u32 const bits = select_bits(draw);
+			if (bits != 0)
+				remap32_store(dest + x, src + x, paldata, draw, bits);
+		}
+#endif
+		for ( ; x < count; x++)
+			if (pens.draws(src[x]))
+				dest[x] = paldata[src[x]];
+	}
+
+	template <typename Pens>
+	static void remap_rgb32(u32 *dest, u8 *pri, u8 const *src, s32 count, pen_t const *paldata, Pens const &pens, pri_mask const &pmask)
+	{
+		s32 x = 0;
+#if defined(MAME_GFX_SPAN_SSE) || defined(MAME_GFX_SPAN_NEON)
+		for ( ; x + 16 <= count; x += 16)
+		{
+			vector const draw = pens.select(src + x);
+			if (select_bits(draw) == 0)
+				continue;
+			vector const write = update_priority(pri + x, draw, pmask);
+			u32 const bits = select_bits(write);
+			if (bits != 0)
+				remap32_store(dest + x, src + x, paldata, write, bits);
+		}
+#endif
+		for ( ; x < count; x++)
+			if (pens.draws(src[x]))
+			{
+				if (pmask.allows(pri[x]))
+					dest[x] = paldata[src[x]];
+				pri[x] = 31;
+			}
+	}
+
+
+	//-------------------------------------------------
+	//  alpha_rgb32 - blend paldata[src] over dest
+	//  by 'alpha' for pens that draw, as
+	//  alpha_blend_r32 does
+	//-------------------------------------------------
+
+	template <typename Pens>
+	static void alpha_rgb32(u32 *dest, u8 const *src, s32 count, pen_t const *paldata, Pens const &pens, u8 alpha)
+	{
+		s32 x = 0;
+#if defined(MAME_GFX_SPAN_SSE) || defined(MAME_GFX_SPAN_NEON)
+		for ( ; x + 16 <= count; x += 16)
+		{
+			vector const draw = pens.select(src + x);
+			u32 const bits = select_bits(draw);
+			if (bits != 0)
+				alpha32_store(dest + x, src + x, paldata, draw, bits, alpha);
+		}
+#endif
+		for ( ; x < count; x++)
+			if (pens.draws(src[x]))
+				dest[x] = alpha_blend_r32(dest[x], paldata[src[x]], alpha);
+	}
+
+	template <typename Pens>
+	static void alpha_rgb32(u32 *dest, u8 *pri, u8 const *src, s32 count, pen_t const *paldata, Pens const &pens, pri_mask const &pmask, u8 alpha)
+	{
+		s32 x = 0;
+#if defined(MAME_GFX_SPAN_SSE) || defined(MAME_GFX_SPAN_NEON)
+		for ( ; x + 16 <= count; x += 16)
+		{
+			vector const draw = pens.select(src + x);
+			if (select_bits(draw) == 0)
+				continue;
+			vector const write = update_priority(pri + x, draw, pmask);
+			u32 const bits = select_bits(write);
+			if (bits != 0)
+				alpha32_store(dest + x, src + x, paldata, write, bits, alpha);
+		}
+#endif
+		for ( ; x < count; x++)
+			if (pens.draws(src[x]))
+			{
+				if (pmask.allows(pri[x]))
+					dest[x] = alpha_blend_r32(dest[x], paldata[src[x]], alpha);
+				pri[x] = 31;
+			}
+	}
+
+private:
+#if defined(MAME_GFX_SPAN_SSE)
+	// one bit per selected byte
+	static u32 select_bits(__m128i sel)
+	{
+		return u32(_mm_movemask_epi8(sel));
+	}
+
+	// table[index & 0x1f] for sixteen bytes
+	static __m128i lookup32(u8 const *index, u8 const (&table)[32])
+	{
+#if defined(__SSSE3__) || defined(__AVX2__)
+		__m128i const i = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<__m128i const *>(index)), _mm_set1_epi8(0x1f));
+		__m128i const lo = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const *>(&table[0])), i);
+		__m128i const hi = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const *>(&table[16])), i);
+		__m128i const upper = _mm_cmpeq_epi8(_mm_and_si128(i, _mm_set1_epi8(0x10)), _mm_set1_epi8(0x10));
+		return _mm_or_si128(_mm_and_si128(upper, hi), _mm_andnot_si128(upper, lo));
+#else
+		// no byte shuffle in plain SSE2
+		alignas(16) u8 result[16];
+		for (int i = 0; i < 16; i++)
+			result[i] = table[index[i] & 0x1f];
+		return _mm_load_si128(reinterpret_cast<__m128i const *>(result));
+#endif
+	}
+
+	// set the priority of drawn pixels to 31, returning the ones the priority mask lets through
+	static __m128i update_priority(u8 *pri, __m128i draw, pri_mask const &pmask)
+	{
+		__m128i const p = _mm_loadu_si128(reinterpret_cast<__m128i const *>(pri));
+		__m128i const write = _mm_and_si128(draw, pmask.select(pri));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(pri), _mm_or_si128(_mm_and_si128(draw, _mm_set1_epi8(31)), _mm_andnot_si128(draw, p)));
+		return write;
+	}
+
+	static void rebase16_store(u16 *dest, u8 const *src, u32 color, __m128i sel, bool all)
+	{
+		__m128i const zero = _mm_setzero_si128(), vcolor = _mm_set1_epi16(s16(color));
+		__m128i const s = _mm_loadu_si128(reinterpret_cast<__m128i const *>(src));
+		__m128i const s0 = _mm_add_epi16(_mm_unpacklo_epi8(s, zero), vcolor);
+		__m128i const s1 = _mm_add_epi16(_mm_unpackhi_epi8(s, zero), vcolor);
+		__m128i *const d = reinterpret_cast<__m128i *>(dest);
+		if (all)
+		{
+			_mm_storeu_si128(d + 0, s0);
+			_mm_storeu_si128(d + 1, s1);
+			return;
+		}
+		__m128i const sel0 = _mm_unpacklo_epi8(sel, sel), sel1 = _mm_unpackhi_epi8(sel, sel);
+		_mm_storeu_si128(d + 0, _mm_or_si128(_mm_and_si128(sel0, s0), _mm_andnot_si128(sel0, _mm_loadu_si128(d + 0))));
+		_mm_storeu_si128(d + 1, _mm_or_si128(_mm_and_si128(sel1, s1), _mm_andnot_si128(sel1, _mm_loadu_si128(d + 1))));
+	}
+
+	// alpha_blend_r32 on four pixels; every intermediate fits in 16 bits
+	static __m128i blend_r32(__m128i d, __m128i s, u8 alpha)
+	{
+		__m128i const zero = _mm_setzero_si128();
+		__m128i const level = _mm_set1_epi16(alpha), inverse = _mm_set1_epi16(s16(256 - alpha));
+		__m128i const lo = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(s, zero), level), _mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), inverse)), 8);
+		__m128i const hi = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(s, zero), level), _mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), inverse)), 8);
+		return _mm_and_si128(_mm_packus_epi16(lo, hi), _mm_set1_epi32(0x00ffffff));
+	}
+
+	// byte selects for pixels 4*quarter to 4*quarter+3, widened to 32 bits
+	static __m128i widen32(__m128i sel, int quarter)
+	{
+		__m128i const half = (quarter < 2) ? _mm_unpacklo_epi8(sel, sel) : _mm_unpackhi_epi8(sel, sel);
+		return (quarter & 1) ? _mm_unpackhi_epi16(half, half) : _mm_unpacklo_epi16(half, half);
+	}
+
+	static void alpha32_store(u32 *dest, u8 const *src, pen_t const *paldata, __m128i sel, u32 bits, u8 alpha)
+	{
+		alignas(16) u32 pens[16];
+		fetch_pens(pens, src, paldata, sel, bits);
+		for (int quarter = 0; quarter < 4; quarter++)
+		{
+			__m128i *const d = reinterpret_cast<__m128i *>(dest + quarter * 4);
+			__m128i const dv = _mm_loadu_si128(d);
+			__m128i const blended = blend_r32(dv, _mm_load_si128(reinterpret_cast<__m128i const *>(pens + quarter * 4)), alpha);
+			__m128i const sel32 = widen32(sel, quarter);
+			_mm_storeu_si128(d, _mm_or_si128(_mm_and_si128(sel32, blended), _mm_andnot_si128(sel32, dv)));
+		}
+	}
+
+#if defined(__AVX2__)
+	static void remap32_store(u32 *dest, u8 const *src, pen_t const *paldata, __m128i sel, u32 bits)
+	{
+		int const *const table = reinterpret_cast<int const *>(paldata);
+		for (int half = 0; half < 2; half++)
+		{
+			__m128i const s = _mm_loadl_epi64(reinterpret_cast<__m128i const *>(src + half * 8));
+			__m256i const index = _mm256_cvtepu8_epi32(s);
+			__m256i *const d = reinterpret_cast<__m256i *>(dest + half * 8);
+			if ((bits >> (half * 8) & 0xff) == 0xff)
+			{
+				_mm256_storeu_si256(d, _mm256_i32gather_epi32(table, index, 4));
+			}
+			else if ((bits >> (half * 8) & 0xff) != 0)
+			{
+				// masked lanes neither read the palette nor touch the destination
+				__m256i const mask = _mm256_cvtepi8_epi32(half ? _mm_srli_si128(sel, 8) : sel);
+				__m256i const pens = _mm256_mask_i32gather_epi32(_mm256_setzero_si256(), table, index, mask, 4);
+				_mm256_maskstore_epi32(reinterpret_cast<int *>(d), mask, pens);
+			}
+		}
+	}
+
+	static void fetch_pens(u32 *pens, u8 const *src, pen_t const *paldata, __m128i sel, u32 bits)
+	{
+		int const *const table = reinterpret_cast<int const *>(paldata);
+		for (int half = 0; half < 2; half++)
+		{
+			__m256i const index = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<__m128i const *>(src + half * 8)));
+			__m256i const mask = _mm256_cvtepi8_epi32(half ? _mm_srli_si128(sel, 8) : sel);
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(pens + half * 8), _mm256_mask_i32gather_epi32(_mm256_setzero_si256(), table, index, mask, 4));
+		}
+	}
+#endif
+
+#elif defined(MAME_GFX_SPAN_NEON)
+	// one bit per selected byte
+	static u32 select_bits(uint8x16_t sel)
+	{
+		static u8 const weights[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+		uint8x16_t const w = vandq_u8(sel, vld1q_u8(weights));
+		uint8x8_t sum = vpadd_u8(vget_low_u8(w), vget_high_u8(w));
+		sum = vpadd_u8(sum, sum);
+		sum = vpadd_u8(sum, sum);
+		return vget_lane_u16(vreinterpret_u16_u8(sum), 0);
+	}
+
+	// table[index & 0x1f] for sixteen bytes
+	static uint8x16_t lookup32(u8 const *index, u8 const (&table)[32])
+	{
+		uint8x8x4_t t;
+		t.val[0] = vld1_u8(&table[0]);
+		t.val[1] = vld1_u8(&table[8]);
+		t.val[2] = vld1_u8(&table[16]);
+		t.val[3] = vld1_u8(&table[24]);
+		uint8x16_t const i = vandq_u8(vld1q_u8(index), vdupq_n_u8(0x1f));
+		return vcombine_u8(vtbl4_u8(t, vget_low_u8(i)), vtbl4_u8(t, vget_high_u8(i)));
+	}
+
+	// set the priority of drawn pixels to 31, returning the ones the priority mask lets through
+	static uint8x16_t update_priority(u8 *pri, uint8x16_t draw, pri_mask const &pmask)
+	{
+		uint8x16_t const write = vandq_u8(draw, pmask.select(pri));
+		vst1q_u8(pri, vbslq_u8(draw, vdupq_n_u8(31), vld1q_u8(pri)));
+		return write;
+	}
+
+	static void rebase16_store(u16 *dest, u8 const *src, u32 color, uint8x16_t sel, bool all)
+	{
+		uint16x8_t const vcolor = vdupq_n_u16(u16(color));
+		uint8x16_t const s = vld1q_u8(src);
+		uint16x8_t const s0 = vaddw_u8(vcolor, vget_low_u8(s)), s1 = vaddw_u8(vcolor, vget_high_u8(s));
+		if (all)
+		{
+			vst1q_u16(dest + 0, s0);
+			vst1q_u16(dest + 8, s1);
+			return;
+		}
+		uint8x16x2_t const wide = vzipq_u8(sel, sel);
+		vst1q_u16(dest + 0, vbslq_u16(vreinterpretq_u16_u8(wide.val[0]), s0, vld1q_u16(dest + 0)));
+		vst1q_u16(dest + 8, vbslq_u16(vreinterpretq_u16_u8(wide.val[1]), s1, vld1q_u16(dest + 8)));
+	}
+
+	// alpha_blend_r32 on four pixels; every intermediate fits in 16 bits
+	static uint32x4_t blend_r32(uint32x4_t d, uint32x4_t s, u8 alpha)
+	{
+		uint8x16_t const sb = vreinterpretq_u8_u32(s), db = vreinterpretq_u8_u32(d);
+		uint16x8_t const lo = vmlaq_n_u16(vmulq_n_u16(vmovl_u8(vget_low_u8(sb)), alpha), vmovl_u8(vget_low_u8(db)), u16(256 - alpha));
+		uint16x8_t const hi = vmlaq_n_u16(vmulq_n_u16(vmovl_u8(vget_high_u8(sb)), alpha), vmovl_u8(vget_high_u8(db)), u16(256 - alpha));
+		uint8x16_t const result = vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8));
+		return vandq_u32(vreinterpretq_u32_u8(result), vdupq_n_u32(0x00ffffff));
+	}
+
+	static void alpha32_store(u32 *dest, u8 const *src, pen_t const *paldata, uint8x16_t sel, u32 bits, u8 alpha)
+	{
+		u32 pens[16];
+		fetch_pens(pens, src, paldata, sel, bits);
+		uint8x16x2_t const wide16 = vzipq_u8(sel, sel);
+		for (int quarter = 0; quarter < 4; quarter++)
+		{
+			uint16x8_t const half = vreinterpretq_u16_u8(wide16.val[quarter >> 1]);
+			uint16x4_t const part = (quarter & 1) ? vget_high_u16(half) : vget_low_u16(half);
+			uint32x4_t const sel32 = vreinterpretq_u32_u16(vcombine_u16(vzip_u16(part, part).val[0], vzip_u16(part, part).val[1]));
+			uint32x4_t const dv = vld1q_u32(dest + quarter * 4);
+			vst1q_u32(dest + quarter * 4, vbslq_u32(sel32, blend_r32(dv, vld1q_u32(pens + quarter * 4), alpha), dv));
+		}
+	}
+#endif
+
+#if defined(MAME_GFX_SPAN_NEON) || (defined(MAME_GFX_SPAN_SSE) && !defined(__AVX2__))
+	// no gather: fully drawn runs use four independent loads per step, the rest go pixel by pixel
+	static void remap32_store(u32 *dest, u8 const *src, pen_t const *paldata, vector sel, u32 bits)
+	{
+		if (bits == 0xffff)
+		{
+			for (int i = 0; i < 16; i += 4)
+			{
+				u32 const p0 = paldata[src[i + 0]], p1 = paldata[src[i + 1]];
+				u32 const p2 = paldata[src[i + 2]], p3 = paldata[src[i + 3]];
+				dest[i + 0] = p0;
+				dest[i + 1] = p1;
+				dest[i + 2] = p2;
+				dest[i + 3] = p3;
+			}
+		}
+		else
+		{
+			for (int i = 0; i < 16; i++)
+				if (BIT(bits, i))
+					dest[i] = paldata[src[i]];
+		}
+	}
+
+	static void fetch_pens(u32 *pens, u8 const *src, pen_t const *paldata, vector sel, u32 bits)
+	{
+		for (int i = 0; i < 16; i++)
+			pens[i] = BIT(bits, i) ? paldata[src[i]] : 0;
+	}
+#endif
+};
+
+#endif // MAME_EMU_VIDEO_GFXSPAN_H
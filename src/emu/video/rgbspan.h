@@ -0,0 +1,403 @@
+// license:BSD-3-Clause
+// copyright-holders:agent
+/***************************************************************************
+
+    rgbspan.h
+
+    SIMD kernels that combine rows of 32-bit xRGB pixels for the
+    software renderer. The instruction set is picked at compile time
+    the same way rgbutil.h picks an rgbaint_t implementation. Without
+    one, rgb_span::enabled is false and callers keep their scalar loops.
+
+    Every kernel produces exactly what the scalar blitters in
+    rendersw.hxx produce for a destination in the standard xRGB
+    layout, including a zero alpha byte in blended pixels.
+
+***************************************************************************/
+
+#ifndef MAME_EMU_VIDEO_RGBSPAN_H
+#define MAME_EMU_VIDEO_RGBSPAN_H
+
+#pragma once
+
+#include <algorithm>
+
+#if (!defined(MAME_DEBUG) || defined(__OPTIMIZE__)) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)))
+#define MAME_RGB_SPAN_SSE
+#include <emmintrin.h>
+#if defined(__SSE4_1__) || defined(__AVX2__)
+#include <smmintrin.h>
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define MAME_RGB_SPAN_NEON
+#include <arm_neon.h>
+#endif
+
+
+class rgb_span
+{
+public:
+#if defined(MAME_RGB_SPAN_SSE) || defined(MAME_RGB_SPAN_NEON)
+	static constexpr bool enabled = true;
+#else
+	static constexpr bool enabled = false;
+#endif
+
+	//-------------------------------------------------
+	//  modulate - dest = src * (sr,sg,sb) / 256;
+	//  factors must be at most 256
+	//-------------------------------------------------
+
+	static void modulate(u32 *dest, u32 const *src, s32 count, u32 sr, u32 sg, u32 sb)
+	{
+		s32 x = 0;
+#if defined(MAME_RGB_SPAN_SSE)
+		__m128i const zero = _mm_setzero_si128();
+		__m128i const factor = _mm_set_epi16(0, sr, sg, sb, 0, sr, sg, sb);
+		for ( ; x + 4 <= count; x += 4)
+		{
+			__m128i const s = _mm_loadu_si128(reinterpret_cast<__m128i const *>(src + x));
+			__m128i const lo = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(s, zero), factor), 8);
+			__m128i const hi = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(s, zero), factor), 8);
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(dest + x), _mm_packus_epi16(lo, hi));
+		}
+#elif defined(MAME_RGB_SPAN_NEON)
+		u16 const f[8] = { u16(sb), u16(sg), u16(sr), 0, u16(sb), u16(sg), u16(sr), 0 };
+		uint16x8_t const factor = vld1q_u16(f);
+		for ( ; x + 4 <= count; x += 4)
+		{
+			uint8x16_t const s = vreinterpretq_u8_u32(vld1q_u32(src + x));
+			uint8x8_t const lo = vshrn_n_u16(vmulq_u16(vmovl_u8(vget_low_u8(s)), factor), 8);
+			uint8x8_t const hi = vshrn_n_u16(vmulq_u16(vmovl_u8(vget_high_u8(s)), factor), 8);
+			vst1q_u32(dest + x, vreinterpretq_u32_u8(vcombine_u8(lo, hi)));
+		}
+#endif
+		for ( ; x < count; x++)
+		{
+			u32 const pix = src[x];
+			dest[x] = ((((pix >> 16) & 0xff) * sr) >> 8) << 16 | ((((pix >> 8) & 0xff) * sg) >> 8) << 8 | (((pix & 0xff) * sb) >> 8);
+		}
+	}
+
+
+	//-------------------------------------------------
+	//  blend_const - dest = (src * (sr,sg,sb) +
+	//  dest * invsa) / 256; each factor plus invsa
+	//  must be at most 256
+	//-------------------------------------------------
+
+	static void blend_const(u32 *dest, u32 const *src, s32 count, u32 sr, u32 sg, u32 sb, u32 invsa)
+	{
+		s32 x = 0;
+#if defined(MAME_RGB_SPAN_SSE)
+		__m128i const zero = _mm_setzero_si128();
+		__m128i const factor = _mm_set_epi16(0, 0, invsa, sr, invsa, sg, invsa, sb);
+		for ( ; x + 4 <= count; x += 4)
+		{
+			__m128i const s = _mm_loadu_si128(reinterpret_cast<__m128i const *>(src + x));
+			__m128i const d = _mm_loadu_si128(reinterpret_cast<__m128i const *>(dest + x));
+			__m128i const slo = _mm_unpacklo_epi8(s, zero), shi = _mm_unpackhi_epi8(s, zero);
+			__m128i const dlo = _mm_unpacklo_epi8(d, zero), dhi = _mm_unpackhi_epi8(d, zero);
+
+			// pair each source channel with its destination channel and multiply-add
+			__m128i const p0 = _mm_srli_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(slo, dlo), factor), 8);
+			__m128i const p1 = _mm_srli_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(slo, dlo), factor), 8);
+			__m128i const p2 = _mm_srli_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(shi, dhi), factor), 8);
+			__m128i const p3 = _mm_srli_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(shi, dhi), factor), 8);
+			__m128i const lo = _mm_packs_epi32(p0, p1), hi = _mm_packs_epi32(p2, p3);
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(dest + x), _mm_packus_epi16(lo, hi));
+		}
+#elif defined(MAME_RGB_SPAN_NEON)
+		u16 const f[4] = { u16(sb), u16(sg), u16(sr), 0 };
+		uint16x4_t const factor = vld1_u16(f);
+		u16 const i[4] = { u16(invsa), u16(invsa), u16(invsa), 0 };
+		uint16x4_t const invf = vld1_u16(i);
+		for ( ; x + 4 <= count; x += 4)
+		{
+			uint8x16_t const s = vreinterpretq_u8_u32(vld1q_u32(src + x));
+			uint8x16_t const d = vreinterpretq_u8_u32(vld1q_u32(dest + x));
+			uint16x8_t const slo = vmovl_u8(vget_low_u8(s)), shi = vmovl_u8(vget_high_u8(s));
+			uint16x8_t const dlo = vmovl_u8(vget_low_u8(d)), dhi = vmovl_u8(vget_high_u8(d));
+			uint16x4_t const p0 = vshrn_n_u32(vmlal_u16(vmull_u16(vget_low_u16(slo), factor), vget_low_u16(dlo), invf), 8);
+			uint16x4_t const p1 = vshrn_n_u32(vmlal_u16(vmull_u16(vget_high_u16(slo), factor), vget_high_u16(dlo), invf), 8);
+			uint16x4_t const p2 = vshrn_n_u32(vmlal_u16(vmull_u16(vget_low_u16(shi), factor), vget_low_u16(dhi), invf), 8);
+			uint16x4_t const p3 = vshrn_n_u32(vmlal_u16(vmull_u16(vget_high_u16(shi), factor), vget_high_u16(dhi), invf), 8);
+			uint8x16_t const result = vcombine_u8(vqmovn_u16(vcombine_u16(p0, p1)), vqmovn_u16(vcombine_u16(p2, p3)));
+			vst1q_u32(dest + x, vreinterpretq_u32_u8(result));
+		}
+#endif
+		for ( ; x < count; x++)
+		{
+			u32 const pix = src[x], dpix = dest[x];
+			u32 const r = (((pix >> 16) & 0xff) * sr + ((dpix >> 16) & 0xff) * invsa) >> 8;
+			u32 const g = (((pix >> 8) & 0xff) * sg + ((dpix >> 8) & 0xff) * invsa) >> 8;
+			u32 const b = ((pix & 0xff) * sb + (dpix & 0xff) * invsa) >> 8;
+			dest[x] = (r << 16) | (g << 8) | b;
+		}
+	}
+
+
+	//-------------------------------------------------
+	//  blend_alpha - dest = (src * a + dest *
+	//  (256 - a)) / 256 using each source pixel's
+	//  alpha, leaving dest alone where alpha is 0
+	//-------------------------------------------------
+
+	static void blend_alpha(u32 *dest, u32 const *src, s32 count)
+	{
+		s32 x = 0;
+#if defined(MAME_RGB_SPAN_SSE)
+		__m128i const zero = _mm_setzero_si128();
+		__m128i const c256 = _mm_set1_epi16(0x100);
+		__m128i const rgbmask = _mm_set1_epi32(0x00ffffff);
+		for ( ; x + 4 <= count; x += 4)
+		{
+			__m128i const s = _mm_loadu_si128(reinterpret_cast<__m128i const *>(src + x));
+			__m128i const d = _mm_loadu_si128(reinterpret_cast<__m128i const *>(dest + x));
+			__m128i const slo = _mm_unpacklo_epi8(s, zero), shi = _mm_unpackhi_epi8(s, zero);
+			__m128i const dlo = _mm_unpacklo_epi8(d, zero), dhi = _mm_unpackhi_epi8(d, zero);
+
+			// broadcast each pixel's alpha across its four channels
+			__m128i const alo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(slo, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+			__m128i const ahi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(shi, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+
+			// src * a + dest * (256 - a) is at most 255 * 256, so 16 bits are enough
+			__m128i const lo = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(slo, alo), _mm_mullo_epi16(dlo, _mm_sub_epi16(c256, alo))), 8);
+			__m128i const hi = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(shi, ahi), _mm_mullo_epi16(dhi, _mm_sub_epi16(c256, ahi))), 8);
+			__m128i const blended = _mm_and_si128(_mm_packus_epi16(lo, hi), rgbmask);
+
+			// keep the destination where the source is fully transparent
+			__m128i const keep = _mm_cmpeq_epi32(_mm_srli_epi32(s, 24), zero);
+#if defined(__SSE4_1__) || defined(__AVX2__)
+			__m128i const result = _mm_blendv_epi8(blended, d, keep);
+#else
+			__m128i const result = _mm_or_si128(_mm_and_si128(keep, d), _mm_andnot_si128(keep, blended));
+#endif
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(dest + x), result);
+		}
+#elif defined(MAME_RGB_SPAN_NEON)
+		uint16x8_t const c256 = vdupq_n_u16(0x100);
+		uint32x4_t const rgbmask = vdupq_n_u32(0x00ffffff);
+		uint8x8_t const alphaidx = vcreate_u8(0x0707070703030303ULL);
+		for ( ; x + 4 <= count; x += 4)
+		{
+			uint32x4_t const s32v = vld1q_u32(src + x);
+			uint32x4_t const d32v = vld1q_u32(dest + x);
+			uint8x16_t const s = vreinterpretq_u8_u32(s32v), d = vreinterpretq_u8_u32(d32v);
+			uint16x8_t const alo = vmovl_u8(vtbl1_u8(vget_low_u8(s), alphaidx));
+			uint16x8_t const ahi = vmovl_u8(vtbl1_u8(vget_high_u8(s), alphaidx));
+			uint16x8_t const lo = vshrq_n_u16(vmlaq_u16(vmulq_u16(vmovl_u8(vget_low_u8(s)), alo), vmovl_u8(vget_low_u8(d)), vsubq_u16(c256, alo)), 8);
+			uint16x8_t const hi = vshrq_n_u16(vmlaq_u16(vmulq_u16(vmovl_u8(vget_high_u8(s)), ahi), vmovl_u8(vget_high_u8(d)), vsubq_u16(c256, ahi)), 8);
+			uint32x4_t const blended = vandq_u32(vreinterpretq_u32_u8(vcombine_u8(vmovn_u16(lo), vmovn_u16(hi))), rgbmask);
+			uint32x4_t const keep = vceqq_u32(vshrq_n_u32(s32v, 24), vdupq_n_u32(0));
+			vst1q_u32(dest + x, vbslq_u32(keep, d32v, blended));
+		}
+#endif
+		for ( ; x < count; x++)
+		{
+			u32 const pix = src[x];
+			u32 const ta = pix >> 24;
+			if (ta != 0)
+			{
+				u32 const dpix = dest[x];
+				u32 const invta = 0x100 - ta;
+				u32 const r = (((pix >> 16) & 0xff) * ta + ((dpix >> 16) & 0xff) * invta) >> 8;
+				u32 const g = (((pix >> 8) & 0xff) * ta + ((dpix >> 8) & 0xff) * invta) >> 8;
+				u32 const b = ((pix & 0xff) * ta + (dpix & 0xff) * invta) >> 8;
+				dest[x] = (r << 16) | (g << 8) | b;
+			}
+		}
+	}
+
+
+	//-------------------------------------------------
+	//  add_saturate - dest = min(dest + src, 255)
+	//-------------------------------------------------
+
+	static void add_saturate(u32 *dest, u32 const *src, s32 count)
+	{
+		s32 x = 0;
+#if defined(MAME_RGB_SPAN_SSE)
+		__m128i const rgbmask = _mm_set1_epi32(0x00ffffff);
+		for ( ; x + 4 <= count; x += 4)
+		{
+			__m128i const s = _mm_loadu_si128(reinterpret_cast<__m128i const *>(src + x));
+			__m128i const d = _mm_loadu_si128(reinterpret_cast<__m128i const *>(dest + x));
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(dest + x), _mm_and_si128(_mm_adds_epu8(s, d), rgbmask));
+		}
+#elif defined(MAME_RGB_SPAN_NEON)
+		uint32x4_t const rgbmask = vdupq_n_u32(0x00ffffff);
+		for ( ; x + 4 <= count; x += 4)
+		{
+			uint8x16_t const sum = vqaddq_u8(vreinterpretq_u8_u32(vld1q_u32(src + x)), vreinterpretq_u8_u32(vld1q_u32(dest + x)));
+			vst1q_u32(dest + x, vandq_u32(vreinterpretq_u32_u8(sum), rgbmask));
+		}
+#endif
+		for ( ; x < count; x++)
+		{
+			u32 const pix = src[x], dpix = dest[x];
+			u32 const r = std::min<u32>(((pix >> 16) & 0xff) + ((dpix >> 16) & 0xff), 0xff);
+			u32 const g = std::min<u32>(((pix >> 8) & 0xff) + ((dpix >> 8) & 0xff), 0xff);
+			u32 const b = std::min<u32>((pix & 0xff) + (dpix & 0xff), 0xff);
+			dest[x] = (r << 16) | (g << 8) | b;
+		}
+	}
+
+
+	//-------------------------------------------------
+	//  add_alpha - dest = min(dest + src * a / 256,
+	//  255) using each source pixel's alpha, leaving
+	//  dest alone where alpha is 0
+	//-------------------------------------------------
+
+	static void add_alpha(u32 *dest, u32 const *src, s32 count)
+	{
+		s32 x = 0;
+#if defined(MAME_RGB_SPAN_SSE)
+		__m128i const zero = _mm_setzero_si128();
+		__m128i const rgbmask = _mm_set1_epi32(0x00ffffff);
+		for ( ; x + 4 <= count; x += 4)
+		{
+			__m128i const s = _mm_loadu_si128(reinterpret_cast<__m128i const *>(src + x));
+			__m128i const d = _mm_loadu_si128(reinterpret_cast<__m128i const *>(dest + x));
+			__m128i const slo = _mm_unpacklo_epi8(s, zero), shi = _mm_unpackhi_epi8(s, zero);
+			__m128i const alo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(slo, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+			__m128i const ahi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(shi, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+			__m128i const lo = _mm_srli_epi16(_mm_mullo_epi16(slo, alo), 8);
+			__m128i const hi = _mm_srli_epi16(_mm_mullo_epi16(shi, ahi), 8);
+			__m128i const added = _mm_and_si128(_mm_adds_epu8(_mm_packus_epi16(lo, hi), d), rgbmask);
+
+			// keep the destination where the source is fully transparent
+			__m128i const keep = _mm_cmpeq_epi32(_mm_srli_epi32(s, 24), zero);
+#if defined(__SSE4_1__) || defined(__AVX2__)
+			__m128i const result = _mm_blendv_epi8(added, d, keep);
+#else
+			__m128i const result = _mm_or_si128(_mm_and_si128(keep, d), _mm_andnot_si128(keep, added));
+#endif
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(dest + x), result);
+		}
+#elif defined(MAME_RGB_SPAN_NEON)
+		uint32x4_t const rgbmask = vdupq_n_u32(0x00ffffff);
+		uint8x8_t const alphaidx = vcreate_u8(0x0707070703030303ULL);
+		for ( ; x + 4 <= count; x += 4)
+		{
+			uint32x4_t const s32v = vld1q_u32(src + x);
+			uint32x4_t const d32v = vld1q_u32(dest + x);
+			uint8x16_t const s = vreinterpretq_u8_u32(s32v);
+			uint8x8_t const lo = vshrn_n_u16(vmull_u8(vget_low_u8(s), vtbl1_u8(vget_low_u8(s), alphaidx)), 8);
+			uint8x8_t const hi = vshrn_n_u16(vmull_u8(vget_high_u8(s), vtbl1_u8(vget_high_u8(s), alphaidx)), 8);
+			uint32x4_t const added = vandq_u32(vreinterpretq_u32_u8(vqaddq_u8(vcombine_u8(lo, hi), vreinterpretq_u8_u32(d32v))), rgbmask);
+			uint32x4_t const keep = vceqq_u32(vshrq_n_u32(s32v, 24), vdupq_n_u32(0));
+			vst1q_u32(dest + x, vbslq_u32(keep, d32v, added));
+		}
+#endif
+		for ( ; x < count; x++)
+		{
+			u32 const pix = src[x];
+			u32 const ta = pix >> 24;
+			if (ta != 0)
+			{
+				u32 const dpix = dest[x];
+				u32 const r = std::min<u32>(((((pix >> 16) & 0xff) * ta) >> 8) + ((dpix >> 16) & 0xff), 0xff);
+				u32 const g = std::min<u32>(((((pix >> 8) & 0xff) * ta) >> 8) + ((dpix >> 8) & 0xff), 0xff);
+				u32 const b = std::min<u32>((((pix & 0xff) * ta) >> 8) + (dpix & 0xff), 0xff);
+				dest[x] = (r << 16) | (g << 8) | b;
+			}
+		}
+	}
+
+
+	//-------------------------------------------------
+	//  add_scaled - dest = min(dest + src *
+	//  (sr,sg,sb) * sa / 65536, 255); factors must
+	//  be at most 256
+	//-------------------------------------------------
+
+	static void add_scaled(u32 *dest, u32 const *src, s32 count, u32 sr, u32 sg, u32 sb, u32 sa)
+	{
+		s32 x = 0;
+#if defined(MAME_RGB_SPAN_SSE)
+		__m128i const zero = _mm_setzero_si128();
+		__m128i const factor = _mm_set_epi16(0, sr, sg, sb, 0, sr, sg, sb);
+		__m128i const alpha = _mm_set1_epi16(sa);
+		__m128i const rgbmask = _mm_set1_epi32(0x00ffffff);
+		for ( ; x + 4 <= count; x += 4)
+		{
+			__m128i const s = _mm_loadu_si128(reinterpret_cast<__m128i const *>(src + x));
+			__m128i const d = _mm_loadu_si128(reinterpret_cast<__m128i const *>(dest + x));
+
+			// src * factor fits in 16 bits, and the high half of multiplying that by sa is the shift by 16
+			__m128i const lo = _mm_mulhi_epu16(_mm_mullo_epi16(_mm_unpacklo_epi8(s, zero), factor), alpha);
+			__m128i const hi = _mm_mulhi_epu16(_mm_mullo_epi16(_mm_unpackhi_epi8(s, zero), factor), alpha);
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(dest + x), _mm_and_si128(_mm_adds_epu8(_mm_packus_epi16(lo, hi), d), rgbmask));
+		}
+#elif defined(MAME_RGB_SPAN_NEON)
+		u16 const f[4] = { u16(sb), u16(sg), u16(sr), 0 };
+		uint16x8_t const factor = vcombine_u16(vld1_u16(f), vld1_u16(f));
+		uint16x4_t const alpha = vdup_n_u16(u16(sa));
+		uint32x4_t const rgbmask = vdupq_n_u32(0x00ffffff);
+		for ( ; x + 4 <= count; x += 4)
+		{
+			uint8x16_t const s = vreinterpretq_u8_u32(vld1q_u32(src + x));
+			uint16x8_t const lo = vmulq_u16(vmovl_u8(vget_low_u8(s)), factor);
+			uint16x8_t const hi = vmulq_u16(vmovl_u8(vget_high_u8(s)), factor);
+			uint16x8_t const slo = vcombine_u16(vshrn_n_u32(vmull_u16(vget_low_u16(lo), alpha), 16), vshrn_n_u32(vmull_u16(vget_high_u16(lo), alpha), 16));
+			uint16x8_t const shi = vcombine_u16(vshrn_n_u32(vmull_u16(vget_low_u16(hi), alpha), 16), vshrn_n_u32(vmull_u16(vget_high_u16(hi), alpha), 16));
+			uint8x16_t const sum = vqaddq_u8(vcombine_u8(vmovn_u16(slo), vmovn_u16(shi)), vreinterpretq_u8_u32(vld1q_u32(dest + x)));
+			vst1q_u32(dest + x, vandq_u32(vreinterpretq_u32_u8(sum), rgbmask));
+		}
+#endif
+		for ( ; x < count; x++)
+		{
+			u32 const pix = src[x], dpix = dest[x];
+			u32 const r = std::min<u32>(((((pix >> 16) & 0xff) * sr * sa) >> 16) + ((dpix >> 16) & 0xff), 0xff);
+			u32 const g = std::min<u32>(((((pix >> 8) & 0xff) * sg * sa) >> 16) + ((dpix >> 8) & 0xff), 0xff);
+			u32 const b = std::min<u32>((((pix & 0xff) * sb * sa) >> 16) + (dpix & 0xff), 0xff);
+			dest[x] = (r << 16) | (g << 8) | b;
+		}
+	}
+
+
+	//-------------------------------------------------
+	//  fetch_clamped - point sample a row of texels
+	//  from a 32bpp texture, clamping coordinates
+	//  to its edges
+	//-------------------------------------------------
+
+	static void fetch_clamped(u32 *dest, u32 const *texbase, u32 rowpixels, s32 width, s32 height, s32 curu, s32 curv, s32 dudx, s32 dvdx, s32 count)
+	{
+		s32 x = 0;
+#if defined(MAME_RGB_SPAN_SSE) && defined(__AVX2__)
+		__m256i const steps = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+		__m256i const maxu = _mm256_set1_epi32(width - 1), maxv = _mm256_set1_epi32(height - 1);
+		__m256i const pitch = _mm256_set1_epi32(rowpixels);
+		__m256i u = _mm256_add_epi32(_mm256_set1_epi32(curu), _mm256_mullo_epi32(_mm256_set1_epi32(dudx), steps));
+		__m256i v = _mm256_add_epi32(_mm256_set1_epi32(curv), _mm256_mullo_epi32(_mm256_set1_epi32(dvdx), steps));
+		__m256i const du = _mm256_set1_epi32(dudx * 8), dv = _mm256_set1_epi32(dvdx * 8);
+		for ( ; x + 8 <= count; x += 8)
+		{
+			__m256i const iu = _mm256_min_epi32(_mm256_max_epi32(_mm256_srai_epi32(u, 16), _mm256_setzero_si256()), maxu);
+			__m256i const iv = _mm256_min_epi32(_mm256_max_epi32(_mm256_srai_epi32(v, 16), _mm256_setzero_si256()), maxv);
+			__m256i const index = _mm256_add_epi32(_mm256_mullo_epi32(iv, pitch), iu);
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(dest + x), _mm256_i32gather_epi32(reinterpret_cast<int const *>(texbase), index, 4));
+			u = _mm256_add_epi32(u, du);
+			v = _mm256_add_epi32(v, dv);
+		}
+		curu += dudx * x;
+		curv += dvdx * x;
+#endif
+		for ( ; x < count; x++)
+		{
+			s32 const u = std::clamp<s32>(curu >> 16, 0, width - 1);
+			s32 const v = std::clamp<s32>(curv >> 16, 0, height - 1);
+			dest[x] = texbase[v * rowpixels + u];
+			curu += dudx;
+			curv += dvdx;
+		}
+	}
+};
+
+#endif // MAME_EMU_VIDEO_RGBSPAN_H
@@ -0,0 +1,260 @@
+// license:BSD-3-Clause
+// copyright-holders:agent
+/***************************************************************************
+
+    tilespan.h
+
+    SIMD kernels for the tilemap scanline rasterizers: copying rows
+    of the 16-bit pixmap into indexed or RGB bitmaps, optionally
+    through the per-pixel flags mask, and updating the priority
+    bitmap alongside them. The instruction set is picked at compile
+    time the same way rgbspan.h picks one; without one, each kernel
+    is just its scalar loop.
+
+    Every kernel writes exactly the pixels the scalar rasterizers in
+    tilemap.cpp write, and leaves every other pixel alone.
+
+***************************************************************************/
+
+#ifndef MAME_EMU_VIDEO_TILESPAN_H
+#define MAME_EMU_VIDEO_TILESPAN_H
+
+#pragma once
+
+#if (!defined(MAME_DEBUG) || defined(__OPTIMIZE__)) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)))
+#define MAME_TILE_SPAN_SSE
+#include <emmintrin.h>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define MAME_TILE_SPAN_NEON
+#include <arm_neon.h>
+#endif
+
+
+class tile_span
+{
+public:
+#if defined(MAME_TILE_SPAN_SSE) || defined(MAME_TILE_SPAN_NEON)
+	static constexpr bool enabled = true;
+#else
+	static constexpr bool enabled = false;
+#endif
+
+	//-------------------------------------------------
+	//  priority - apply a priority code to every
+	//  pixel of the span
+	//-------------------------------------------------
+
+	static void priority(u8 *pri, s32 count, u32 pcode)
+	{
+		u8 const keep = u8(pcode >> 8), set = u8(pcode);
+		s32 x = 0;
+#if defined(MAME_TILE_SPAN_SSE)
+		__m128i const vkeep = _mm_set1_epi8(char(keep)), vset = _mm_set1_epi8(char(set));
+		for ( ; x + 16 <= count; x += 16)
+		{
+			__m128i const p = _mm_loadu_si128(reinterpret_cast<__m128i const *>(pri + x));
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(pri + x), _mm_or_si128(_mm_and_si128(p, vkeep), vset));
+		}
+#elif defined(MAME_TILE_SPAN_NEON)
+		uint8x16_t const vkeep = vdupq_n_u8(keep), vset = vdupq_n_u8(set);
+		for ( ; x + 16 <= count; x += 16)
+			vst1q_u8(pri + x, vorrq_u8(vandq_u8(vld1q_u8(pri + x), vkeep), vset));
+#endif
+		for ( ; x < count; x++)
+			pri[x] = (pri[x] & keep) | set;
+	}
+
+
+	//-------------------------------------------------
+	//  priority_masked - apply a priority code to
+	//  the pixels whose flags match
+	//-------------------------------------------------
+
+	static void priority_masked(u8 *pri, u8 const *maskptr, u8 mask, u8 value, s32 count, u32 pcode)
+	{
+		u8 const keep = u8(pcode >> 8), set = u8(pcode);
+		s32 x = 0;
+#if defined(MAME_TILE_SPAN_SSE)
+		__m128i const vkeep = _mm_set1_epi8(char(keep)), vset = _mm_set1_epi8(char(set));
+		__m128i const vmask = _mm_set1_epi8(char(mask)), vvalue = _mm_set1_epi8(char(value));
+		for ( ; x + 16 <= count; x += 16)
+		{
+			__m128i const m = _mm_loadu_si128(reinterpret_cast<__m128i const *>(maskptr + x));
+			__m128i const sel = _mm_cmpeq_epi8(_mm_and_si128(m, vmask), vvalue);
+			__m128i const p = _mm_loadu_si128(reinterpret_cast<__m128i const *>(pri + x));
+			__m128i const np = _mm_or_si128(_mm_and_si128(p, vkeep), vset);
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(pri + x), _mm_or_si128(_mm_and_si128(sel, np), _mm_andnot_si128(sel, p)));
+		}
+#elif defined(MAME_TILE_SPAN_NEON)
+		uint8x16_t const vkeep = vdupq_n_u8(keep), vset = vdupq_n_u8(set);
+		uint8x16_t const vmask = vdupq_n_u8(mask), vvalue = vdupq_n_u8(value);
+		for ( ; x + 16 <= count; x += 16)
+		{
+			uint8x16_t const sel = vceqq_u8(vandq_u8(vld1q_u8(maskptr + x), vmask), vvalue);
+			uint8x16_t const p = vld1q_u8(pri + x);
+			vst1q_u8(pri + x, vbslq_u8(sel, vorrq_u8(vandq_u8(p, vkeep), vset), p));
+		}
+#endif
+		for ( ; x < count; x++)
+			if ((maskptr[x] & mask) == value)
+				pri[x] = (pri[x] & keep) | set;
+	}
+
+
+	//-------------------------------------------------
+	//  offset_ind16 - dest = source + pal
+	//-------------------------------------------------
+
+	static void offset_ind16(u16 *dest, u16 const *source, s32 count, u16 pal)
+	{
+		s32 x = 0;
+#if defined(MAME_TILE_SPAN_SSE)
+		__m128i const vpal = _mm_set1_epi16(s16(pal));
+		for ( ; x + 8 <= count; x += 8)
+		{
+			__m128i const s = _mm_loadu_si128(reinterpret_cast<__m128i const *>(source + x));
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(dest + x), _mm_add_epi16(s, vpal));
+		}
+#elif defined(MAME_TILE_SPAN_NEON)
+		uint16x8_t const vpal = vdupq_n_u16(pal);
+		for ( ; x + 8 <= count; x += 8)
+			vst1q_u16(dest + x, vaddq_u16(vld1q_u16(source + x), vpal));
+#endif
+		for ( ; x < count; x++)
+			dest[x] = source[x] + pal;
+	}
+
+
+	//-------------------------------------------------
+	//  offset_masked_ind16 - dest = source + pal
+	//  where the flags match
+	//-------------------------------------------------
+
+	static void offset_masked_ind16(u16 *dest, u16 const *source, u8 const *maskptr, u8 mask, u8 value, s32 count, u16 pal)
+	{
+		s32 x = 0;
+#if defined(MAME_TILE_SPAN_SSE)
+		__m128i const vpal = _mm_set1_epi16(s16(pal));
+		__m128i const vmask = _mm_set1_epi8(char(mask)), vvalue = _mm_set1_epi8(char(value));
+		for ( ; x + 16 <= count; x += 16)
+		{
+			__m128i const m = _mm_loadu_si128(reinterpret_cast<__m128i const *>(maskptr + x));
+			__m128i const sel = _mm_cmpeq_epi8(_mm_and_si128(m, vmask), vvalue);
+			int const bits = _mm_movemask_epi8(sel);
+			if (bits == 0)
+				continue;
+
+			// widen the byte selects to cover 16-bit pixels
+			__m128i const sel0 = _mm_unpacklo_epi8(sel, sel), sel1 = _mm_unpackhi_epi8(sel, sel);
+			__m128i const s0 = _mm_add_epi16(_mm_loadu_si128(reinterpret_cast<__m128i const *>(source + x)), vpal);
+			__m128i const s1 = _mm_add_epi16(_mm_loadu_si128(reinterpret_cast<__m128i const *>(source + x + 8)), vpal);
+			if (bits == 0xffff)
+			{
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(dest + x), s0);
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(dest + x + 8), s1);
+				continue;
+			}
+			__m128i const d0 = _mm_loadu_si128(reinterpret_cast<__m128i const *>(dest + x));
+			__m128i const d1 = _mm_loadu_si128(reinterpret_cast<__m128i const *>(dest + x + 8));
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(dest + x), _mm_or_si128(_mm_and_si128(sel0, s0), _mm_andnot_si128(sel0, d0)));
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(dest + x + 8), _mm_or_si128(_mm_and_si128(sel1, s1), _mm_andnot_si128(sel1, d1)));
+		}
+#elif defined(MAME_TILE_SPAN_NEON)
+		uint16x8_t const vpal = vdupq_n_u16(pal);
+		uint8x8_t const vmask = vdup_n_u8(mask), vvalue = vdup_n_u8(value);
+		for ( ; x + 8 <= count; x += 8)
+		{
+			uint8x8_t const sel8 = vceq_u8(vand_u8(vld1_u8(maskptr + x), vmask), vvalue);
+			uint16x8_t const sel = vreinterpretq_u16_u8(vcombine_u8(vzip_u8(sel8, sel8).val[0], vzip_u8(sel8, sel8).val[1]));
+			vst1q_u16(dest + x, vbslq_u16(sel, vaddq_u16(vld1q_u16(source + x), vpal), vld1q_u16(dest + x)));
+		}
+#endif
+		for ( ; x < count; x++)
+			if ((maskptr[x] & mask) == value)
+				dest[x] = source[x] + pal;
+	}
+
+
+	//-------------------------------------------------
+	//  lookup_rgb32 - dest = clut[source]
+	//-------------------------------------------------
+
+	static void lookup_rgb32(u32 *dest, u16 const *source, s32 count, rgb_t const *clut)
+	{
+		s32 x = 0;
+#if defined(MAME_TILE_SPAN_SSE) && defined(__AVX2__)
+		int const *const table = reinterpret_cast<int const *>(clut);
+		for ( ; x + 8 <= count; x += 8)
+		{
+			__m256i const index = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const *>(source + x)));
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(dest + x), _mm256_i32gather_epi32(table, index, 4));
+		}
+#else
+		// no gather without AVX2, but four independent loads per step still pipeline well
+		for ( ; x + 4 <= count; x += 4)
+		{
+			u32 const p0 = clut[source[x + 0]], p1 = clut[source[x + 1]];
+			u32 const p2 = clut[source[x + 2]], p3 = clut[source[x + 3]];
+			dest[x + 0] = p0;
+			dest[x + 1] = p1;
+			dest[x + 2] = p2;
+			dest[x + 3] = p3;
+		}
+#endif
+		for ( ; x < count; x++)
+			dest[x] = clut[source[x]];
+	}
+
+
+	//-------------------------------------------------
+	//  lookup_masked_rgb32 - dest = clut[source]
+	//  where the flags match; runs of sixteen
+	//  pixels that all match or all miss skip the
+	//  per-pixel test
+	//-------------------------------------------------
+
+	static void lookup_masked_rgb32(u32 *dest, u16 const *source, u8 const *maskptr, u8 mask, u8 value, s32 count, rgb_t const *clut)
+	{
+		s32 x = 0;
+#if defined(MAME_TILE_SPAN_SSE) || defined(MAME_TILE_SPAN_NEON)
+		for ( ; x + 16 <= count; x += 16)
+		{
+			u32 const bits = select_bits(maskptr + x, mask, value);
+			if (bits == 0xffff)
+				lookup_rgb32(dest + x, source + x, 16, clut);
+			else if (bits != 0)
+				for (s32 i = 0; i < 16; i++)
+					if (BIT(bits, i))
+						dest[x + i] = clut[source[x + i]];
+		}
+#endif
+		for ( ; x < count; x++)
+			if ((maskptr[x] & mask) == value)
+				dest[x] = clut[source[x]];
+	}
+
+private:
+#if defined(MAME_TILE_SPAN_SSE) || defined(MAME_TILE_SPAN_NEON)
+	// one bit per flags byte that matches, for sixteen bytes
+	static u32 select_bits(u8 const *maskptr, u8 mask, u8 value)
+	{
+#if defined(MAME_TILE_SPAN_SSE)
+		__m128i const m = _mm_loadu_si128(reinterpret_cast<__m128i const *>(maskptr));
+		return u32(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(m, _mm_set1_epi8(char(mask))), _mm_set1_epi8(char(value)))));
+#else
+		static u8 const weights[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+		uint8x16_t const sel = vceqq_u8(vandq_u8(vld1q_u8(maskptr), vdupq_n_u8(mask)), vdupq_n_u8(value));
+		uint8x16_t const w = vandq_u8(sel, vld1q_u8(weights));
+		uint8x8_t sum = vpadd_u8(vget_low_u8(w), vget_high_u8(w));
+		sum = vpadd_u8(sum, sum);
+		sum = vpadd_u8(sum, sum);
+		return vget_lane_u16(vreinterpret_u16_u8(sum), 0);
+#endif
+	}
+#endif
+};
+
+#endif // MAME_EMU_VIDEO_TILESPAN_H
@@ -1433,6 +1433,7 @@ void lua_engine::initialize()
 	machine_type["time"] = sol::property(&running_machine::time);
 	machine_type["system"] = sol::property(&running_machine::system);
 	machine_type["parameters"] = sol::property(&running_machine::parameters);
+	machine_type["scheduler"] = sol::property(&running_machine::scheduler);
 	machine_type["video"] = sol::property(&running_machine::video);
 	machine_type["sound"] = sol::property(&running_machine::sound);
 	machine_type["output"] = sol::property(&running_machine::output);
@@ -1999,6 +2000,39 @@ void lua_engine::initialize()
 	parameters_type["lookup"] = &parameters_manager::lookup;
 
 
+	auto scheduler_type = sol().registry().new_usertype<device_scheduler>("scheduler", sol::no_constructor);
+	scheduler_type["reset_stats"] = &device_scheduler::reset_stats;
+	scheduler_type["dump_stats"] = &device_scheduler::dump_stats;
+	scheduler_type["stats_enabled"] = sol::property(&device_scheduler::stats_enabled, &device_scheduler::set_stats_enabled);
+	scheduler_type["stats"] = sol::property(
+			[this] (device_scheduler &sched)
+			{
+				auto const &stats = sched.stats();
+				sol::table table = sol().create_table();
+				table["timeslices"] = stats.m_timeslices;
+				table["quantum_changes"] = stats.m_quantum_adds;
+				table["quantum_shrinks"] = stats.m_quantum_shrinks;
+				table["perfect_quanta"] = stats.m_perfect_quanta;
+				table["eat_all"] = stats.m_eat_all;
+				sol::table devices = sol().create_table();
+				for (device_execute_interface &exec : execute_interface_enumerator(sched.machine().root_device()))
+				{
+					auto const &devstats = exec.stats();
+					sol::table entry = sol().create_table();
+					entry["executions"] = devstats.m_executions;
+					entry["cycles_requested"] = devstats.m_cycles_requested;
+					entry["cycles_run"] = devstats.m_cycles_run;
+					entry["cycles_aborted"] = devstats.m_cycles_aborted;
+					entry["cycles_eaten"] = devstats.m_cycles_eaten;
+					entry["aborts"] = devstats.m_aborts;
+					entry["quantum_changes"] = devstats.m_quantum_changes;
+					devices[exec.device().tag()] = entry;
+				}
+				table["devices"] = devices;
+				return table;
+			});
+
+
 	auto video_type = sol().registry().new_usertype<video_manager>("video", sol::no_constructor);
 	video_type["frame_update"] = [] (video_manager &vm) { vm.frame_update(true); };
 	video_type["snapshot"] = &video_manager::save_active_screen_snapshots;
@@ -2078,6 +2112,28 @@ void lua_engine::initialize()
 			&sound_manager::attenuation,
 			&sound_manager::set_attenuation);
 	sound_type["recording"] = sol::property(&sound_manager::is_recording);
+	sound_type["reset_stats"] = &sound_manager::reset_stats;
+	sound_type["dump_stats"] = &sound_manager::dump_stats;
+	sound_type["stats_enabled"] = sol::property(&sound_manager::stats_enabled, &sound_manager::set_stats_enabled);
+	sound_type["stats"] = sol::property(
+			[this] (sound_manager &sm)
+			{
+				sol::table table = sol().create_table();
+				table["graph_batches"] = sm.graph_batches();
+				sol::table streams = sol().create_table();
+				sm.stats_for_each(
+						[this, &streams] (sound_stream const &stream)
+						{
+							auto const &stats = stream.stats();
+							sol::table entry = sol().create_table();
+							entry["updates"] = stats.m_updates;
+							entry["samples"] = stats.m_samples;
+							entry["seconds"] = double(stats.m_ticks) / double(osd_ticks_per_second());
+							streams[stream.name()] = entry;
+						});
+				table["streams"] = streams;
+				return table;
+			});
 
 
 	auto ui_type = sol().registry().new_usertype<mame_ui_manager>("ui", sol::no_constructor);
@@ -76,6 +76,7 @@ std::vector<submenu::option> submenu::advanced_options()
 			{ option_type::EMU,  N_("Automatic save/restore"),                  OPTION_AUTOSAVE },
 			{ option_type::EMU,  N_("Allow rewind"),                            OPTION_REWIND },
 			{ option_type::EMU,  N_("Rewind capacity"),                         OPTION_REWIND_CAPACITY },
+			{ option_type::EMU,  N_("Rewind delta states"),                     OPTION_REWIND_DELTA },
 			{ option_type::EMU,  N_("Bilinear filtering for snapshots"),        OPTION_SNAPBILINEAR },
 			{ option_type::EMU,  N_("Burn-in"),                                 OPTION_BURNIN },
 
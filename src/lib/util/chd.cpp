@@ -22,6 +22,7 @@
 
 #include <zlib.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <cstdlib>
@@ -284,6 +285,9 @@ inline uint8_t chd_file::bits_for_value(uint64_t value)
  */
 
 chd_file::chd_file()
+	: m_read_cache_hunks(0)
+	, m_prefetch_count(0)
+	, m_prefetch_queue(nullptr)
 {
 	// reset state
 	close();
@@ -872,6 +876,7 @@ void chd_file::close()
 	// reset caching
 	m_cache.clear();
 	m_cachehunk = ~0;
+	read_cache_reset();
 }
 
 /**
@@ -898,6 +903,68 @@ void chd_file::close()
  */
 
 std::error_condition chd_file::read_hunk(uint32_t hunknum, void *buffer)
+{
+	// without a read cache, go straight to the file
+	if (!m_read_cache_hunks || !buffer)
+		return read_hunk_direct(hunknum, buffer);
+
+	// watch for sequential access so we can decompress ahead
+	if (hunknum == m_sequential_next)
+		m_sequential_run++;
+	else
+		m_sequential_run = 0;
+	m_sequential_next = hunknum + 1;
+
+	auto found = m_read_cache_map.find(hunknum);
+	if (found != m_read_cache_map.end())
+	{
+		// move hits to the front
+		m_read_cache.splice(m_read_cache.begin(), m_read_cache, found->second);
+	}
+	else
+	{
+		// recycle the least recently used buffer if the cache is full
+		std::vector<uint8_t> data;
+		if (m_read_cache.size() >= m_read_cache_hunks)
+		{
+			m_read_cache_map.erase(m_read_cache.back().m_hunknum);
+			data = std::move(m_read_cache.back().m_data);
+			m_read_cache.pop_back();
+		}
+		data.resize(m_hunkbytes);
+
+		// use the prefetched copy if there is one, otherwise decompress it now
+		if (!take_prefetched(hunknum, data))
+		{
+			std::error_condition err = read_hunk_direct(hunknum, &data[0]);
+			if (err)
+				return err;
+		}
+		m_read_cache.push_front(cached_hunk{ hunknum, std::move(data) });
+		found = m_read_cache_map.emplace(hunknum, m_read_cache.begin()).first;
+	}
+	memcpy(buffer, &found->second->m_data[0], m_hunkbytes);
+
+	// keep the pipeline full while reading sequentially
+	if (m_prefetch_count && m_sequential_run)
+		prefetch_hunks(hunknum + 1);
+	return std::error_condition();
+}
+
+/**
+ * @fn  std::error_condition chd_file::read_hunk_direct(uint32_t hunknum, void *buffer)
+ *
+ * @brief   -------------------------------------------------
+ *            read_hunk_direct - read a single hunk from the CHD file, bypassing the read cache
+ *          -------------------------------------------------.
+ *
+ * @param   hunknum         The hunknum.
+ * @param [in,out]  buffer  If non-null, the buffer.
+ *
+ * @return  The hunk.
+ */
+
+std::error_condition chd_file::read_hunk_direct(uint32_t hunknum, void *buffer)
 {
 	// wrap this for clean reporting
 	try
@@ -1253,6 +1320,258 @@ std::error_condition chd_file::write_bytes(uint64_t offset, const void *buffer,
 	return std::error_condition();
 }
 
+/**
+ * @fn  void chd_file::set_read_cache(uint32_t hunks, uint32_t prefetch)
+ *
+ * @brief   -------------------------------------------------
+ *            set_read_cache - keep up to the given number of decompressed hunks, and
+ *            decompress up to the given number of hunks ahead on other threads when reads
+ *            are sequential
+ *          -------------------------------------------------.
+ *
+ * @param   hunks       Number of hunks to cache, or 0 to disable caching.
+ * @param   prefetch    Number of hunks to decompress ahead.
+ */
+
+void chd_file::set_read_cache(uint32_t hunks, uint32_t prefetch)
+{
+	read_cache_reset();
+
+	// uncompressed data gains nothing over the OS file cache
+	if (!m_file || !compressed() || !hunks)
+		return;
+
+	// prefetched hunks land in the cache, so make sure it can hold them
+	m_read_cache_hunks = std::max(hunks, prefetch + 2);
+
+	// laserdisc codecs need configuration from the owner, so only prefetch the others
+	for (chd_codec_type type : m_compression)
+		if (type == CHD_CODEC_AVHUFF)
+			prefetch = 0;
+
+	if (prefetch)
+	{
+		m_prefetch_queue = osd_work_queue_alloc(WORK_QUEUE_FLAG_MULTI);
+		if (m_prefetch_queue)
+		{
+			m_prefetch.reset(new prefetch_item[prefetch]);
+			m_prefetch_count = prefetch;
+			for (uint32_t itemnum = 0; itemnum < prefetch; itemnum++)
+			{
+				m_prefetch[itemnum].m_compressed.resize(m_hunkbytes);
+				m_prefetch[itemnum].m_data.resize(m_hunkbytes);
+			}
+		}
+	}
+}
+
+/**
+ * @fn  void chd_file::read_cache_reset()
+ *
+ * @brief   -------------------------------------------------
+ *            read_cache_reset - wait for outstanding prefetches and drop all cached hunks
+ *          -------------------------------------------------.
+ */
+
+void chd_file::read_cache_reset()
+{
+	if (m_prefetch_queue)
+	{
+		osd_work_queue_wait(m_prefetch_queue, 30 * osd_ticks_per_second());
+		for (uint32_t itemnum = 0; itemnum < m_prefetch_count; itemnum++)
+			prefetch_release(m_prefetch[itemnum]);
+		osd_work_queue_free(m_prefetch_queue);
+		m_prefetch_queue = nullptr;
+	}
+	m_prefetch.reset();
+	m_prefetch_count = 0;
+
+	m_read_cache.clear();
+	m_read_cache_map.clear();
+	m_read_cache_hunks = 0;
+	m_sequential_next = ~0;
+	m_sequential_run = 0;
+}
+
+/**
+ * @fn  bool chd_file::take_prefetched(uint32_t hunknum, std::vector<uint8_t> &data)
+ *
+ * @brief   -------------------------------------------------
+ *            take_prefetched - claim a hunk decompressed ahead of time, waiting for it if
+ *            it is still in progress
+ *          -------------------------------------------------.
+ *
+ * @param   hunknum         The hunknum.
+ * @param [in,out]  data    Receives the data; its old buffer is handed to the prefetcher.
+ *
+ * @return  true if the hunk was prefetched successfully.
+ */
+
+bool chd_file::take_prefetched(uint32_t hunknum, std::vector<uint8_t> &data)
+{
+	for (uint32_t itemnum = 0; itemnum < m_prefetch_count; itemnum++)
+	{
+		prefetch_item &item = m_prefetch[itemnum];
+		if (item.m_status != PS_IDLE && item.m_hunknum == hunknum)
+		{
+			prefetch_release(item);
+			bool const success = item.m_status == PS_COMPLETE;
+			if (success)
+				data.swap(item.m_data);
+			item.m_status = PS_IDLE;
+			return success;
+		}
+	}
+	return false;
+}
+
+/**
+ * @fn  void chd_file::prefetch_hunks(uint32_t first)
+ *
+ * @brief   -------------------------------------------------
+ *            prefetch_hunks - start decompressing the hunks following a sequential read
+ *          -------------------------------------------------.
+ *
+ * @param   first   The first hunk to prefetch.
+ */
+
+void chd_file::prefetch_hunks(uint32_t first)
+{
+	uint32_t const last = std::min<uint64_t>(uint64_t(first) + m_prefetch_count, m_hunkcount);
+	for (uint32_t hunknum = first; hunknum < last; hunknum++)
+	{
+		// skip hunks we already have or are working on
+		if (m_read_cache_map.find(hunknum) != m_read_cache_map.end())
+			continue;
+		prefetch_item *free = nullptr;
+		bool pending = false;
+		for (uint32_t itemnum = 0; itemnum < m_prefetch_count && !pending; itemnum++)
+		{
+			prefetch_item &item = m_prefetch[itemnum];
+			if (item.m_status != PS_IDLE && item.m_hunknum == hunknum)
+				pending = true;
+			else if (!free && (item.m_status != PS_QUEUED) && ((item.m_status == PS_IDLE) || (item.m_hunknum < first) || (item.m_hunknum >= last)))
+				free = &item;
+		}
+		if (pending)
+			continue;
+
+		// stop once every item is busy with something we still want
+		if (!free)
+			break;
+		prefetch_release(*free);
+		free->m_status = PS_IDLE;
+		prefetch_hunk(*free, hunknum);
+	}
+}
+
+/**
+ * @fn  bool chd_file::prefetch_hunk(prefetch_item &item, uint32_t hunknum)
+ *
+ * @brief   -------------------------------------------------
+ *            prefetch_hunk - read a compressed hunk and queue it for decompression; the
+ *            file is only touched from this thread
+ *          -------------------------------------------------.
+ *
+ * @param [in,out]  item    The idle item to use.
+ * @param   hunknum         The hunknum.
+ *
+ * @return  true if the hunk was queued.
+ */
+
+bool chd_file::prefetch_hunk(prefetch_item &item, uint32_t hunknum)
+{
+	// only v5 codec-compressed hunks are worth the trip; everything else is a copy
+	if (m_version < 5)
+		return false;
+	uint8_t const *const rawmap = &m_rawmap[m_mapentrybytes * hunknum];
+	if (rawmap[0] > COMPRESSION_TYPE_3)
+		return false;
+
+	try
+	{
+		item.m_hunknum = hunknum;
+		item.m_compression = rawmap[0];
+		item.m_complen = get_u24be(&rawmap[1]);
+		item.m_crc16 = get_u16be(&rawmap[10]);
+		if (item.m_complen > item.m_compressed.size())
+			return false;
+		file_read(get_u48be(&rawmap[4]), &item.m_compressed[0], item.m_complen);
+		if (!item.m_decompressor[item.m_compression])
+			item.m_decompressor[item.m_compression] = chd_codec_list::new_decompressor(m_compression[item.m_compression], *this);
+		if (!item.m_decompressor[item.m_compression])
+			return false;
+	}
+	catch (std::error_condition const &)
+	{
+		// leave it for the synchronous path to report
+		return false;
+	}
+
+	item.m_status = PS_QUEUED;
+	item.m_osd = osd_work_item_queue(m_prefetch_queue, async_decompress_static, &item, 0);
+	if (!item.m_osd)
+	{
+		item.m_status = PS_IDLE;
+		return false;
+	}
+	return true;
+}
+
+/**
+ * @fn  void chd_file::prefetch_release(prefetch_item &item)
+ *
+ * @brief   -------------------------------------------------
+ *            prefetch_release - wait for an item's work to finish and free the OSD work
+ *            item
+ *          -------------------------------------------------.
+ *
+ * @param [in,out]  item    The item.
+ */
+
+void chd_file::prefetch_release(prefetch_item &item)
+{
+	if (item.m_osd)
+	{
+		osd_work_item_wait(item.m_osd, 30 * osd_ticks_per_second());
+		osd_work_item_release(item.m_osd);
+		item.m_osd = nullptr;
+	}
+}
+
+/**
+ * @fn  void *chd_file::async_decompress_static(void *param, int threadid)
+ *
+ * @brief   -------------------------------------------------
+ *            async_decompress_static - decompress and check a prefetched hunk on a worker
+ *            thread
+ *          -------------------------------------------------.
+ *
+ * @param [in,out]  param   The prefetch item.
+ * @param   threadid        The threadid.
+ *
+ * @return  null.
+ */
+
+void *chd_file::async_decompress_static(void *param, int threadid)
+{
+	auto &item = *reinterpret_cast<prefetch_item *>(param);
+	try
+	{
+		chd_decompressor &decompressor = *item.m_decompressor[item.m_compression];
+		decompressor.decompress(&item.m_compressed[0], item.m_complen, &item.m_data[0], item.m_data.size());
+		bool const valid = decompressor.lossy()
+				? (util::crc16_creator::simple(&item.m_compressed[0], item.m_complen) == item.m_crc16)
+				: (util::crc16_creator::simple(&item.m_data[0], item.m_data.size()) == item.m_crc16);
+		item.m_status = valid ? PS_COMPLETE : PS_FAILED;
+	}
+	catch (...)
+	{
+		item.m_status = PS_FAILED;
+	}
+	return nullptr;
+}
+
 /**
  * @fn  std::error_condition chd_file::read_metadata(chd_metadata_tag searchtag, uint32_t searchindex, std::string &output)
  *
@@ -20,10 +20,13 @@
 
 #include <atomic>
 #include <functional>
+#include <list>
 #include <memory>
 #include <string>
 #include <string_view>
 #include <system_error>
+#include <unordered_map>
+#include <vector>
 
 
 /***************************************************************************
@@ -343,6 +346,9 @@ public:
 	std::error_condition read_bytes(uint64_t offset, void *buffer, uint32_t bytes);
 	std::error_condition write_bytes(uint64_t offset, const void *buffer, uint32_t bytes);
 
+	// read caching
+	void set_read_cache(uint32_t hunks, uint32_t prefetch);
+
 	// metadata management
 	std::error_condition read_metadata(chd_metadata_tag searchtag, uint32_t searchindex, std::string &output);
 	std::error_condition read_metadata(chd_metadata_tag searchtag, uint32_t searchindex, std::vector<uint8_t> &output);
@@ -371,6 +377,36 @@ private:
 	struct metadata_entry;
 	struct metadata_hash;
 
+	// a decompressed hunk in the read cache
+	struct cached_hunk
+	{
+		uint32_t            m_hunknum;          // number of the hunk
+		std::vector<uint8_t> m_data;            // decompressed data
+	};
+
+	// status of a prefetch item
+	enum prefetch_status
+	{
+		PS_IDLE = 0,
+		PS_QUEUED,
+		PS_COMPLETE,
+		PS_FAILED
+	};
+
+	// a hunk being decompressed ahead of use on another thread
+	struct prefetch_item
+	{
+		osd_work_item *     m_osd = nullptr;    // OSD work item decompressing this hunk
+		std::atomic<int32_t> m_status { PS_IDLE }; // current status of this item
+		uint32_t            m_hunknum = 0;      // number of the hunk we're working on
+		uint8_t             m_compression = 0;  // index of the codec used
+		uint32_t            m_complen = 0;      // compressed data length
+		util::crc16_t       m_crc16;            // expected CRC-16
+		chd_decompressor::ptr m_decompressor[4]; // private codec instances
+		std::vector<uint8_t> m_compressed;      // compressed data
+		std::vector<uint8_t> m_data;            // decompressed data
+	};
+
 	// inline helpers
 	util::sha1_t be_read_sha1(const uint8_t *base) const;
 	void be_write_sha1(uint8_t *base, util::sha1_t value);
@@ -397,6 +433,13 @@ private:
 	void metadata_set_previous_next(uint64_t prevoffset, uint64_t nextoffset);
 	void metadata_update_hash();
 	static int CLIB_DECL metadata_hash_compare(const void *elem1, const void *elem2);
+	std::error_condition read_hunk_direct(uint32_t hunknum, void *buffer);
+	bool take_prefetched(uint32_t hunknum, std::vector<uint8_t> &data);
+	void prefetch_hunks(uint32_t first);
+	bool prefetch_hunk(prefetch_item &item, uint32_t hunknum);
+	void prefetch_release(prefetch_item &item);
+	void read_cache_reset();
+	static void *async_decompress_static(void *param, int threadid);
 
 	// file characteristics
 	util::random_read_write::ptr m_file;        // handle to the open core file
@@ -434,6 +477,16 @@ private:
 	// caching
 	std::vector<uint8_t>    m_cache;            // single-hunk cache for partial reads/writes
 	uint32_t                m_cachehunk;        // which hunk is in the cache?
+
+	// read cache and prefetching
+	std::list<cached_hunk>  m_read_cache;       // decompressed hunks, most recently used first
+	std::unordered_map<uint32_t, std::list<cached_hunk>::iterator> m_read_cache_map; // cached hunks by number
+	uint32_t                m_read_cache_hunks; // maximum number of cached hunks
+	std::unique_ptr<prefetch_item []> m_prefetch; // hunks being decompressed ahead
+	uint32_t                m_prefetch_count;   // number of prefetch items
+	osd_work_queue *        m_prefetch_queue;   // queue for decompressing on other threads
+	uint32_t                m_sequential_next;  // hunk that continues a sequential read
+	uint32_t                m_sequential_run;   // number of sequential hunks read so far
 };
 
 
@@ -23,6 +23,7 @@
 #include <string_view>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 // ======================> simple_list
 
@@ -526,6 +527,107 @@ private:
 };
 
 
+// a binary min-heap of pointers to elements that record their own position,
+// so arbitrary elements can be removed or re-keyed in O(log n)
+template <typename T, typename Compare, std::size_t T::*Index>
+class intrusive_heap
+{
+public:
+	static constexpr std::size_t npos = ~std::size_t(0);
+
+	typedef typename std::vector<T *>::const_iterator const_iterator;
+
+	intrusive_heap(Compare const &compare = Compare()) : m_compare(compare) { }
+	intrusive_heap(intrusive_heap const &) = delete;
+	intrusive_heap &operator=(intrusive_heap const &) = delete;
+
+	bool empty() const noexcept { return m_heap.empty(); }
+	std::size_t size() const noexcept { return m_heap.size(); }
+	T *top() const noexcept { return m_heap.front(); }
+	bool contains(T const &element) const noexcept { return element.*Index != npos; }
+
+	// iteration is in heap order, not sorted order
+	const_iterator begin() const noexcept { return m_heap.begin(); }
+	const_iterator end() const noexcept { return m_heap.end(); }
+
+	void reserve(std::size_t count) { m_heap.reserve(count); }
+
+	void push(T &element)
+	{
+		element.*Index = m_heap.size();
+		m_heap.push_back(&element);
+		sift_up(m_heap.size() - 1);
+	}
+
+	void remove(T &element) noexcept
+	{
+		std::size_t const index = element.*Index;
+		element.*Index = npos;
+
+		// move the last element into the hole and restore the heap property
+		T *const last = m_heap.back();
+		m_heap.pop_back();
+		if (last != &element)
+		{
+			m_heap[index] = last;
+			last->*Index = index;
+			if (!sift_up(index))
+				sift_down(index);
+		}
+	}
+
+	void clear() noexcept
+	{
+		for (T *element : m_heap)
+			element->*Index = npos;
+		m_heap.clear();
+	}
+
+private:
+	bool sift_up(std::size_t index) noexcept
+	{
+		T *const element = m_heap[index];
+		std::size_t const start = index;
+		while (index > 0)
+		{
+			std::size_t const parent = (index - 1) / 2;
+			if (!m_compare(*element, *m_heap[parent]))
+				break;
+			m_heap[index] = m_heap[parent];
+			m_heap[index]->*Index = index;
+			index = parent;
+		}
+		m_heap[index] = element;
+		element->*Index = index;
+		return index != start;
+	}
+
+	void sift_down(std::size_t index) noexcept
+	{
+		T *const element = m_heap[index];
+		std::size_t const count = m_heap.size();
+		while (true)
+		{
+			std::size_t child = (index * 2) + 1;
+			if (child >= count)
+				break;
+			if (((child + 1) < count) && m_compare(*m_heap[child + 1], *m_heap[child]))
+				++child;
+			if (!m_compare(*m_heap[child], *element))
+				break;
+			m_heap[index] = m_heap[child];
+			m_heap[index]->*Index = index;
+			index = child;
+		}
+		m_heap[index] = element;
+		element->*Index = index;
+	}
+
+	std::vector<T *>    m_heap;
+	Compare             m_compare;
+};
+
+
 // extract a string_view from an ovectorstream buffer
 template <typename CharT, typename Traits, typename Allocator>
 std::basic_string_view<CharT, Traits> buf_to_string_view(basic_ovectorstream<CharT, Traits, Allocator> &stream)
@@ -602,6 +602,7 @@ void gng_state::gng(machine_config &config)
 	screen.set_screen_update(FUNC(gng_state::screen_update));
 	screen.screen_vblank().set(m_spriteram, FUNC(buffered_spriteram8_device::vblank_copy_rising));
 	screen.set_palette(m_palette);
+	screen.set_video_attributes(VIDEO_DIRTY_TRACKING);  // everything is drawn with tilemaps and gfx
 
 	GFXDECODE(config, m_gfxdecode, m_palette, gfx_gng);
 
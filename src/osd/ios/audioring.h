@@ -0,0 +1,187 @@
+//============================================================
+//
+//  audioring.h - lock-free audio buffering for the IOS OSD
+//
+//  The emulation thread pushes stereo frames through an
+//  ios_audio_resampler into an ios_audio_ring, and the host
+//  audio callback pulls them out. The resampler stretches or
+//  squeezes its input by a fraction of a percent according to
+//  how full the ring is, so the emulated and host audio clocks
+//  can never drift apart.
+//
+//============================================================
+
+#ifndef MAME_OSD_IOS_AUDIORING_H
+#define MAME_OSD_IOS_AUDIORING_H
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+
+//============================================================
+//  ios_audio_ring - single-producer/single-consumer
+//  ring of interleaved 16-bit stereo frames
+//============================================================
+
+class ios_audio_ring
+{
+public:
+	// the capacity is rounded up to a power of two frames
+	ios_audio_ring(uint32_t frames)
+	{
+		uint32_t capacity = 1;
+		while (capacity < frames)
+			capacity <<= 1;
+		m_buffer.resize(capacity * 2);
+		m_mask = capacity - 1;
+	}
+
+	// getters, callable from either side
+	uint32_t capacity() const { return m_mask + 1; }
+	uint32_t fill() const { return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire); }
+	uint32_t underruns() const { return m_underruns.load(std::memory_order_relaxed); }
+	uint32_t overruns() const { return m_overruns.load(std::memory_order_relaxed); }
+
+	// producer side: store as many frames as fit, returning the number stored
+	uint32_t write(const int16_t *data, uint32_t frames)
+	{
+		uint32_t const head = m_head.load(std::memory_order_relaxed);
+		uint32_t const room = capacity() - (head - m_tail.load(std::memory_order_acquire));
+		if (frames > room)
+		{
+			m_overruns.fetch_add(1, std::memory_order_relaxed);
+			frames = room;
+		}
+
+		uint32_t const start = head & m_mask;
+		uint32_t const first = std::min(frames, capacity() - start);
+		memcpy(&m_buffer[start * 2], data, first * 4);
+		memcpy(&m_buffer[0], data + first * 2, (frames - first) * 4);
+		m_head.store(head + frames, std::memory_order_release);
+		return frames;
+	}
+
+	// consumer side: fill the whole request, fading out from the last frame on underrun
+	uint32_t read(int16_t *data, uint32_t frames)
+	{
+		uint32_t const tail = m_tail.load(std::memory_order_relaxed);
+		uint32_t const avail = std::min(frames, m_head.load(std::memory_order_acquire) - tail);
+
+		uint32_t const start = tail & m_mask;
+		uint32_t const first = std::min(avail, capacity() - start);
+		memcpy(data, &m_buffer[start * 2], first * 4);
+		memcpy(data + first * 2, &m_buffer[0], (avail - first) * 4);
+		m_tail.store(tail + avail, std::memory_order_release);
+
+		if (avail)
+		{
+			m_last[0] = data[avail * 2 - 2];
+			m_last[1] = data[avail * 2 - 1];
+		}
+		if (avail < frames)
+		{
+			// a short ramp to silence instead of a step avoids an audible click
+			m_underruns.fetch_add(1, std::memory_order_relaxed);
+			for (uint32_t frame = avail; frame < frames; frame++)
+			{
+				m_last[0] = m_last[0] * 15 / 16;
+				m_last[1] = m_last[1] * 15 / 16;
+				data[frame * 2 + 0] = m_last[0];
+				data[frame * 2 + 1] = m_last[1];
+			}
+		}
+		return avail;
+	}
+
+private:
+	std::vector<int16_t>                m_buffer;               // interleaved frames
+	uint32_t                            m_mask;                 // capacity - 1
+	alignas(64) std::atomic<uint32_t>   m_head { 0 };           // frames written, owned by the producer
+	alignas(64) std::atomic<uint32_t>   m_tail { 0 };           // frames read, owned by the consumer
+	std::atomic<uint32_t>               m_underruns { 0 };      // reads that ran out of data
+	std::atomic<uint32_t>               m_overruns { 0 };       // writes that ran out of room
+	int16_t                             m_last[2] = { 0, 0 };   // last frame played, for fading out
+};
+
+
+//============================================================
+//  ios_audio_resampler - producer-side linear
+//  resampler whose ratio follows the ring fill level
+//============================================================
+
+class ios_audio_resampler
+{
+public:
+	// largest change to the ratio, small enough to be inaudible as pitch
+	static constexpr double MAX_ADJUST = 0.005;
+
+	// how quickly the fill estimate follows the ring, per push
+	static constexpr double FILL_SMOOTHING = 0.1;
+
+	// how quickly a persistent clock mismatch is trimmed out, per push
+	static constexpr double DRIFT_GAIN = 0.02;
+
+	// aim to keep the given number of frames in the ring
+	void reset(uint32_t target)
+	{
+		m_target = target;
+		m_fill = target;
+		m_ratio = 1.0;
+		m_drift = 0.0;
+		m_position = 0.0;
+		m_prev[0] = m_prev[1] = 0;
+	}
+
+	// current ratio of input to output frames
+	double ratio() const { return m_ratio; }
+
+	// resample a block of frames and store it in the ring
+	void push(ios_audio_ring &ring, const int16_t *data, uint32_t frames)
+	{
+		if (!frames)
+			return;
+
+		// consume input faster when the ring is filling up and slower when it is draining;
+		// the drift term accumulates so the fill settles on the target rather than beside it
+		m_fill += (double(ring.fill()) - m_fill) * FILL_SMOOTHING;
+		double const error = std::clamp((m_fill - double(m_target)) / double(m_target), -1.0, 1.0) * MAX_ADJUST;
+		m_drift = std::clamp(m_drift + error * DRIFT_GAIN, -MAX_ADJUST, MAX_ADJUST);
+		m_ratio = 1.0 + std::clamp(error + m_drift, -MAX_ADJUST, MAX_ADJUST);
+
+		// interpolate between the previous frame (position 0) and the new ones (1 to frames)
+		m_output.clear();
+		double position = m_position;
+		while (position < double(frames))
+		{
+			uint32_t const index = uint32_t(position);
+			double const frac = position - double(index);
+			int16_t const *const a = index ? &data[(index - 1) * 2] : m_prev;
+			int16_t const *const b = &data[index * 2];
+			m_output.push_back(int16_t(a[0] + (b[0] - a[0]) * frac));
+			m_output.push_back(int16_t(a[1] + (b[1] - a[1]) * frac));
+			position += m_ratio;
+		}
+		m_position = position - double(frames);
+		m_prev[0] = data[frames * 2 - 2];
+		m_prev[1] = data[frames * 2 - 1];
+
+		if (!m_output.empty())
+			ring.write(&m_output[0], m_output.size() / 2);
+	}
+
+private:
+	uint32_t                m_target = 1;               // frames we want buffered
+	double                  m_fill = 0.0;               // smoothed fill level
+	double                  m_ratio = 1.0;              // input frames per output frame
+	double                  m_drift = 0.0;              // accumulated correction for clock mismatch
+	double                  m_position = 0.0;           // fractional input position carried between pushes
+	int16_t                 m_prev[2] = { 0, 0 };       // last input frame of the previous push
+	std::vector<int16_t>    m_output;                   // resampled frames
+};
+
+#endif // MAME_OSD_IOS_AUDIORING_H
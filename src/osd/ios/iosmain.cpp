@@ -56,6 +56,7 @@ static const options_entry s_option_entries[] =
     { OPTION_BEAM,          "1.0",      core_options::option_type::FLOAT,       "set vector beam width maximum" },
     { OPTION_BENCH,         "0",        core_options::option_type::INTEGER,     "benchmark for the given number of emulated seconds" },
     { OPTION_NUMPROCESSORS, "auto",     core_options::option_type::STRING,      "number of processors; this overrides the number the system reports" },
+    { OPTION_AUDIO_LATENCY, "0.05",     core_options::option_type::FLOAT,       "audio latency in seconds; the host buffer holds twice this" },
 
     { nullptr }
 };
@@ -68,7 +69,7 @@ extern "C" int myosd_main(int argc, char** argv, myosd_callbacks* callbacks, siz
 {
     myosd_callbacks host_callbacks;
     memset(&host_callbacks, 0, sizeof(host_callbacks));
-    memcpy(&host_callbacks, callbacks, MIN(sizeof(host_callbacks), sizeof(myosd_callbacks)));
+    memcpy(&host_callbacks, callbacks, MIN(sizeof(host_callbacks), callbacks_size));
     
     if (argc == 0 || argv == NULL) {
         static const char* args[] = {"myosd"};
@@ -105,6 +106,18 @@ extern "C" intptr_t myosd_get(int var)
             
         case MYOSD_SPEED:
             return 0;
+
+        case MYOSD_AUDIO_FILL:
+        case MYOSD_AUDIO_CAPACITY:
+        case MYOSD_AUDIO_UNDERRUNS:
+        case MYOSD_AUDIO_OVERRUNS:
+        case MYOSD_AUDIO_RATIO:
+            return myosd_sound_get(var);
+
+        case MYOSD_VIDEO_CHANGED:
+        case MYOSD_VIDEO_PRIMITIVES:
+        case MYOSD_VIDEO_DIRTY:
+            return myosd_video_get(var);
     }
     return 0;
 }
@@ -489,6 +502,10 @@ void ios_osd_interface::init(running_machine &machine)
     
     // ensure we get called on the way out
     machine.add_notifier(MACHINE_NOTIFY_EXIT, machine_notify_delegate(&ios_osd_interface::machine_exit, this));
+
+    // let the host know when background save states land on disk
+    if (m_callbacks.state_saved != NULL)
+        machine.save().register_save_complete(save_complete_delegate(&ios_osd_interface::state_saved, this));
     
     auto &options = machine.options();
     
@@ -570,6 +587,15 @@ void ios_osd_interface::machine_exit()
     sound_exit();
 }
 
+//============================================================
+//  state_saved
+//============================================================
+
+void ios_osd_interface::state_saved(std::string const &filename, save_error error)
+{
+    m_callbacks.state_saved(filename.c_str(), error);
+}
+
 //============================================================
 //  osd_setup_osd_specific_emu_options
 //============================================================
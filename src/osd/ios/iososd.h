@@ -24,6 +24,13 @@
 //============================================================
 extern int myosd_display_width;
 extern int myosd_display_height;
+extern float myosd_sound_latency;
+
+// audio buffer statistics for myosd_get
+intptr_t myosd_sound_get(int var);
+
+// primitive list statistics for myosd_get
+intptr_t myosd_video_get(int var);
 
 //============================================================
 //  OPTIONS
@@ -35,6 +42,7 @@ extern int myosd_display_height;
 #define OPTION_SOUND    "sound"
 #define OPTION_VIDEO    "video"
 #define OPTION_NUMPROCESSORS "numprocessors"
+#define OPTION_AUDIO_LATENCY "audio_latency"
 
 //============================================================
 //  TYPE DEFINITIONS
@@ -107,6 +115,7 @@ private:
     void sound_exit();
 
     void machine_exit();
+    void state_saved(std::string const &filename, save_error error);
 
     // internal state
     running_machine *m_machine;
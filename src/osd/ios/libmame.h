@@ -142,6 +142,7 @@ enum MYOSD_GAME_INFO
 };
 
 // this is copy/clone of the render_primitive in render.h passed up to UI/OSD layer in myosd_video_draw
+// the list itself stays allocated until the second video_draw after it, so the host may compare against the previous frame
 typedef struct _myosd_render_primitive myosd_render_primitive;
 struct _myosd_render_primitive
 {
@@ -166,7 +167,8 @@ struct _myosd_render_primitive
             uint32_t      antialias:1;          /* antialias flag */
             uint32_t      screentex:1;          /* SCREEN flag */
             uint32_t      texwrap:1;            /* texture wrap */
-            uint32_t      unused:17;
+            uint32_t      texture_dirty:1;      /* texture may have changed since the previous video_draw */
+            uint32_t      unused:16;
         };
     };
     float                 width;                /* width (for line primitives) */
@@ -180,6 +182,13 @@ struct _myosd_render_primitive
     uint32_t              texture_junk;         /* padding */
 //  render_quad_texuv     texcoords;            /* texture coordinates (for quad primitives) */
     struct {float u,v;}   texcoords[4];
+    // fields below were added later; everything above keeps its original layout, so append only
+    uint64_t              texture_unique_id;    /* unique id of the texture; seqids restart when a texture is reallocated */
+    uint32_t              texture_dirty_seqid;  /* seqid the dirty area below is relative to */
+    int32_t               texture_dirty_min_x;  /* texels changed since texture_dirty_seqid, inclusive; */
+    int32_t               texture_dirty_max_x;  /* a host still holding that seqid need only update this area, */
+    int32_t               texture_dirty_min_y;  /* which is empty if max < min */
+    int32_t               texture_dirty_max_y;
 };
 
 /* render primitive types */
@@ -361,6 +370,14 @@ enum {
     MYOSD_DISPLAY_HEIGHT,
     MYOSD_FPS,                  // GET, SET: show framerate
     MYOSD_SPEED,                // GET, SET: emulation speed (100 = 100%)
+    MYOSD_AUDIO_FILL,           // GET: audio frames buffered for the host (default sound only)
+    MYOSD_AUDIO_CAPACITY,       // GET: size of the audio buffer in frames
+    MYOSD_AUDIO_UNDERRUNS,      // GET: times the host found the audio buffer empty
+    MYOSD_AUDIO_OVERRUNS,       // GET: times emulation found the audio buffer full
+    MYOSD_AUDIO_RATIO,          // GET: current resample ratio in millionths (1000000 = unchanged)
+    MYOSD_VIDEO_CHANGED,        // GET: 0 if the last primitive list passed to video_draw was identical to the one before
+    MYOSD_VIDEO_PRIMITIVES,     // GET: number of primitives in the last list passed to video_draw
+    MYOSD_VIDEO_DIRTY,          // GET: number of primitives in that list with texture_dirty set
 };
 extern intptr_t myosd_get(int var);
 extern void myosd_set(int var, intptr_t value);
@@ -388,6 +405,9 @@ typedef struct {
     void (*sound_play)(void *buff, int len);
     void (*sound_exit)(void);
 
+    // called on the MAME thread when a background save state write finishes (error is 0 on success)
+    void (*state_saved)(const char* name, int error);
+
 }   myosd_callbacks;
 
 // main entry point
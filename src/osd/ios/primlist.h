@@ -0,0 +1,245 @@
+//============================================================
+//
+//  primlist.h - render primitive handoff for the IOS OSD
+//
+//  Converts the render target's primitive list into the
+//  myosd_render_primitive list passed to the host's video_draw
+//  callback. Two lists are kept and used alternately, so the
+//  previous frame stays intact for comparison, and each
+//  textured primitive is flagged dirty when its texture (by
+//  unique id and base) has a new seqid or palette, or was not
+//  in the previous frame at all. Dirty textures also carry the
+//  area changed since their dirty seqid, and the texels a host
+//  has to upload are counted for the render manager.
+//
+//  Include emu.h and render.h before this header.
+//
+//============================================================
+
+#ifndef MAME_OSD_IOS_PRIMLIST_H
+#define MAME_OSD_IOS_PRIMLIST_H
+
+#pragma once
+
+#include "libmame.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+
+//============================================================
+//  ios_render_primlist
+//============================================================
+
+class ios_render_primlist
+{
+public:
+	// convert a frame's primitives, returning the head of the new list (or nullptr if empty)
+	template <typename T>
+	myosd_render_primitive *convert(T const &prims)
+	{
+		m_current ^= 1;
+		std::vector<myosd_render_primitive> &list = m_list[m_current];
+		std::vector<myosd_render_primitive> const &prev = m_list[m_current ^ 1];
+		texture_map &textures = m_textures[m_current];
+		texture_map const &prevtextures = m_textures[m_current ^ 1];
+
+		// the list only ever grows, so steady state conversion does not allocate
+		size_t count = 0;
+		for (render_primitive const &prim : prims)
+		{
+			if (count == list.size())
+				list.resize(count + 64);
+			convert_prim(list[count], prim);
+			count++;
+		}
+		m_count = count;
+
+		// flag textures whose contents may differ from the previous frame
+		textures.clear();
+		m_dirty = 0;
+		m_uploaded = m_upload_total = 0;
+		for (size_t i = 0; i < count; i++)
+		{
+			myosd_render_primitive &prim = list[i];
+			if (prim.texture_base == nullptr)
+				continue;
+
+			// a texture freed and reallocated at the same address restarts its seqids, but gets a new
+			// unique id; the base still tells apart the scaled copies of one texture
+			texture_key const key = { prim.texture_unique_id, prim.texture_base };
+			texture_state const state = { prim.texture_seqid, prim.texture_palette };
+			auto const found = prevtextures.find(key);
+			prim.texture_dirty = (found == prevtextures.end()) || (found->second.seqid != state.seqid) || (found->second.palette != state.palette);
+			m_dirty += prim.texture_dirty;
+			textures[key] = state;
+
+			// count what a host keeping its textures from the previous frame has to upload: just the
+			// dirty rows if it holds the seqid they are relative to, otherwise the whole texture
+			if (prim.texture_dirty)
+			{
+				uint64_t const total = uint64_t(prim.texture_width) * prim.texture_height;
+				if ((found != prevtextures.end()) && (found->second.seqid == prim.texture_dirty_seqid) && (found->second.palette == state.palette))
+				{
+					int32_t const miny = std::max<int32_t>(prim.texture_dirty_min_y, 0);
+					int32_t const maxy = std::min<int32_t>(prim.texture_dirty_max_y, int32_t(prim.texture_height) - 1);
+					if ((prim.texture_dirty_max_x >= prim.texture_dirty_min_x) && (maxy >= miny))
+						m_uploaded += uint64_t(maxy - miny + 1) * prim.texture_width;
+				}
+				else
+				{
+					m_uploaded += total;
+				}
+				m_upload_total += total;
+			}
+		}
+
+		// the frame is unchanged if the list matches the previous one and no texture is dirty
+		m_changed = (m_dirty != 0) || (count != m_prev_count);
+		for (size_t i = 0; !m_changed && i < count; i++)
+			m_changed = !same_prim(list[i], prev[i]);
+		m_prev_count = count;
+
+		// link the list for the host
+		if (count == 0)
+			return nullptr;
+		for (size_t i = 0; i < count - 1; i++)
+			list[i].next = &list[i + 1];
+		list[count - 1].next = nullptr;
+		return &list[0];
+	}
+
+	// forget the previous frame, so the next one is reported fully changed
+	void reset()
+	{
+		m_textures[0].clear();
+		m_textures[1].clear();
+		m_prev_count = ~size_t(0);
+		m_changed = true;
+	}
+
+	// getters for the most recent frame
+	size_t count() const { return m_count; }
+	size_t dirty() const { return m_dirty; }
+	bool changed() const { return m_changed; }
+	uint64_t uploaded_pixels() const { return m_uploaded; }
+	uint64_t upload_total_pixels() const { return m_upload_total; }
+
+private:
+	struct texture_key
+	{
+		uint64_t    unique_id;
+		void const *base;
+
+		bool operator==(texture_key const &that) const { return (unique_id == that.unique_id) && (base == that.base); }
+	};
+	struct texture_key_hash
+	{
+		size_t operator()(texture_key const &key) const { return std::hash<uint64_t>()(key.unique_id) ^ std::hash<void const *>()(key.base); }
+	};
+	struct texture_state
+	{
+		uint32_t    seqid;
+		void const *palette;
+	};
+	using texture_map = std::unordered_map<texture_key, texture_state, texture_key_hash>;
+
+	static bool same_prim(myosd_render_primitive const &a, myosd_render_primitive const &b)
+	{
+		// primitives are cleared before conversion, so padding compares equal; the dirty flag is ours, not the frame's
+		myosd_render_primitive ca = a, cb = b;
+		ca.texture_dirty = cb.texture_dirty = 0;
+		return !memcmp(&ca.type, &cb.type, sizeof(ca) - offsetof(myosd_render_primitive, type));
+	}
+
+	static void convert_prim(myosd_render_primitive &myosd_prim, const render_primitive &prim);
+
+	std::vector<myosd_render_primitive> m_list[2];          // alternating primitive lists
+	texture_map                         m_textures[2];      // texture state seen in each list
+	int                                 m_current = 0;      // index of the most recent list
+	size_t                              m_count = 0;        // primitives in the most recent list
+	size_t                              m_prev_count = ~size_t(0); // primitives in the list before it
+	size_t                              m_dirty = 0;        // dirty textured primitives in the most recent list
+	bool                                m_changed = true;   // whether the most recent list differs from the one before
+	uint64_t                            m_uploaded = 0;     // texels of dirty textures a host has to update
+	uint64_t                            m_upload_total = 0; // texels of dirty textures in full
+};
+
+
+//============================================================
+//  convert render_primitive to myosd_render_primitive
+//============================================================
+
+inline void ios_render_primlist::convert_prim(myosd_render_primitive &myosd_prim, const render_primitive &prim)
+{
+	memset(&myosd_prim, 0, sizeof(myosd_prim));
+
+	myosd_prim.type = (prim.type-1);
+	static_assert(MYOSD_RENDER_PRIMITIVE_LINE == render_primitive::primitive_type::LINE-1, "");
+	static_assert(MYOSD_RENDER_PRIMITIVE_QUAD == render_primitive::primitive_type::QUAD-1, "");
+
+	myosd_prim.bounds_x0 = prim.bounds.x0;
+	myosd_prim.bounds_y0 = prim.bounds.y0;
+	myosd_prim.bounds_x1 = prim.bounds.x1;
+	myosd_prim.bounds_y1 = prim.bounds.y1;
+	myosd_prim.color_a = prim.color.a;
+	myosd_prim.color_r = prim.color.r;
+	myosd_prim.color_g = prim.color.g;
+	myosd_prim.color_b = prim.color.b;
+
+	static int const map_fmt[] = {MYOSD_TEXFORMAT_UNDEFINED, MYOSD_TEXFORMAT_PALETTE16, MYOSD_TEXFORMAT_RGB32, MYOSD_TEXFORMAT_ARGB32, MYOSD_TEXFORMAT_YUY16};
+	static_assert(TEXFORMAT_UNDEFINED == 0, "");
+	static_assert(TEXFORMAT_PALETTE16 == 1, "");
+	static_assert(TEXFORMAT_RGB32     == 2, "");
+	static_assert(TEXFORMAT_ARGB32    == 3, "");
+	static_assert(TEXFORMAT_YUY16     == 4, "");
+	myosd_prim.texformat = map_fmt[PRIMFLAG_GET_TEXFORMAT(prim.flags)];
+
+	myosd_prim.texorient = PRIMFLAG_GET_TEXORIENT(prim.flags);
+	static_assert(MYOSD_ORIENTATION_FLIP_X == ORIENTATION_FLIP_X, "");
+	static_assert(MYOSD_ORIENTATION_FLIP_Y == ORIENTATION_FLIP_Y, "");
+	static_assert(MYOSD_ORIENTATION_SWAP_XY == ORIENTATION_SWAP_XY, "");
+
+	myosd_prim.blendmode = PRIMFLAG_GET_BLENDMODE(prim.flags);
+	static_assert(MYOSD_BLENDMODE_NONE == BLENDMODE_NONE, "");
+	static_assert(MYOSD_BLENDMODE_ALPHA == BLENDMODE_ALPHA, "");
+	static_assert(MYOSD_BLENDMODE_RGB_MULTIPLY == BLENDMODE_RGB_MULTIPLY, "");
+	static_assert(MYOSD_BLENDMODE_ADD == BLENDMODE_ADD, "");
+
+	myosd_prim.antialias = PRIMFLAG_GET_ANTIALIAS(prim.flags);
+	myosd_prim.screentex = PRIMFLAG_GET_SCREENTEX(prim.flags);
+	myosd_prim.texwrap   = PRIMFLAG_GET_TEXWRAP(prim.flags);
+
+	myosd_prim.width = prim.width;
+	myosd_prim.texture_base = prim.texture.base;
+	myosd_prim.texture_rowpixels = prim.texture.rowpixels;
+	myosd_prim.texture_width = prim.texture.width;
+	myosd_prim.texture_height = prim.texture.height;
+	myosd_prim.texture_palette = prim.texture.palette;
+	myosd_prim.texture_seqid = prim.texture.seqid;
+
+	myosd_prim.texcoords[0].u = prim.texcoords.tl.u;
+	myosd_prim.texcoords[0].v = prim.texcoords.tl.v;
+	myosd_prim.texcoords[1].u = prim.texcoords.tr.u;
+	myosd_prim.texcoords[1].v = prim.texcoords.tr.v;
+	myosd_prim.texcoords[2].u = prim.texcoords.bl.u;
+	myosd_prim.texcoords[2].v = prim.texcoords.bl.v;
+	myosd_prim.texcoords[3].u = prim.texcoords.br.u;
+	myosd_prim.texcoords[3].v = prim.texcoords.br.v;
+
+	// hosts built against an older libmame.h read the fields up to here directly
+	static_assert(offsetof(myosd_render_primitive, texcoords) == offsetof(myosd_render_primitive, texture_junk) + sizeof(uint32_t), "");
+	static_assert(offsetof(myosd_render_primitive, texture_unique_id) >= offsetof(myosd_render_primitive, texcoords) + sizeof(myosd_prim.texcoords), "");
+	myosd_prim.texture_unique_id = prim.texture.unique_id;
+	myosd_prim.texture_dirty_seqid = prim.texture.dirty_seqid;
+	myosd_prim.texture_dirty_min_x = prim.texture.dirty.left();
+	myosd_prim.texture_dirty_max_x = prim.texture.dirty.right();
+	myosd_prim.texture_dirty_min_y = prim.texture.dirty.top();
+	myosd_prim.texture_dirty_max_y = prim.texture.dirty.bottom();
+}
+
+#endif // MAME_OSD_IOS_PRIMLIST_H
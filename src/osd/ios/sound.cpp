@@ -10,6 +10,9 @@
 
 // IOS headers
 #include "iososd.h"
+#include "audioring.h"
+
+#include <memory>
 
 static void myosd_sound_init(int rate, int stereo);
 static void myosd_sound_play(void *buff, int len);
@@ -32,6 +35,7 @@ void ios_osd_interface::sound_init()
     }
 
     m_sample_rate = options().sample_rate();
+    myosd_sound_latency = options().float_value(OPTION_AUDIO_LATENCY);
 
     if (strcmp(options().value(OPTION_SOUND), "none") == 0)
         m_sample_rate = 0;
@@ -137,22 +141,34 @@ typedef struct AQCallbackStruct {
 
 AQCallbackStruct in;
 
-static pthread_mutex_t sound_mutex = PTHREAD_MUTEX_INITIALIZER;
-
 static int global_low_latency_sound  = 1;
 
+//SQ buffers for sound between MAME and iOS AudioQueue. AudioQueue
+//SQ callback reads from these. The ring holds twice the requested
+//latency and the resampler keeps it half full.
+float myosd_sound_latency = 0.05f;
+static std::unique_ptr<ios_audio_ring> sound_ring;
+static ios_audio_resampler sound_resampler;
+
 int sound_close_AudioQueue(void);
 int sound_open_AudioQueue(int rate, int bits, int stereo);
 int sound_close_AudioUnit(void);
 int sound_open_AudioUnit(int rate, int bits, int stereo);
 void queue(unsigned char *p,unsigned size);
 unsigned short dequeue(unsigned char *p,unsigned size);
-inline int emptyQueue(void);
 
 static void myosd_sound_init(int rate, int stereo)
 {
     if (soundInit == 0)
     {
+        uint32_t const latency = std::max<uint32_t>(rate * myosd_sound_latency, 256);
+        sound_ring = std::make_unique<ios_audio_ring>(latency * 2);
+        sound_resampler.reset(latency);
+
+        // start out with the target latency worth of silence
+        std::vector<int16_t> silence(latency * 2, 0);
+        sound_ring->write(&silence[0], latency);
+
         if(global_low_latency_sound)
         {
             osd_printf_debug("myosd_openSound LOW LATENCY rate:%d stereo:%d \n",rate,stereo);
@@ -188,99 +204,45 @@ static void myosd_sound_play(void *buff, int len)
     queue((unsigned char *)buff,len);
 }
 
-//SQ buffers for sound between MAME and iOS AudioQueue. AudioQueue
-//SQ callback reads from these.
-//SQ Size: (48000/30fps) * bytesize * stereo * (3 buffers)
-#define TAM (1600 * 2 * 2 * 3)
-unsigned char ptr_buf[TAM];
-unsigned head = 0;
-unsigned tail = 0;
-
-inline int fullQueue(unsigned short size){
+void queue(unsigned char *p,unsigned size)
+{
+    if (sound_ring)
+        sound_resampler.push(*sound_ring, (const int16_t *)p, size / 4);
+}
 
-    if(head < tail)
-    {
-        return head + size >= tail;
-    }
-    else if(head > tail)
+unsigned short dequeue(unsigned char *p,unsigned size)
+{
+    if (!sound_ring)
     {
-        return (head + size) >= TAM ? (head + size)- TAM >= tail : false;
+        memset(p, 0, size);
+        return 0;
     }
-    else return false;
+    return sound_ring->read((int16_t *)p, size / 4) * 4;
 }
 
-inline int emptyQueue(){
-    return head == tail;
-}
-
-void queue(unsigned char *p,unsigned size) {
-    
-        if (fullQueue(size))
-        {
-            osd_printf_verbose("queue: FULL\n");
-        }
-    
-        unsigned newhead;
-        if(head + size < TAM)
-        {
-            memcpy(ptr_buf+head,p,size);
-            newhead = head + size;
-        }
-        else
-        {
-            memcpy(ptr_buf+head,p, TAM -head);
-            memcpy(ptr_buf,p + (TAM-head), size - (TAM-head));
-            newhead = (head + size) - TAM;
-        }
-        pthread_mutex_lock(&sound_mutex);
-
-        head = newhead;
-
-        pthread_mutex_unlock(&sound_mutex);
-}
-
-unsigned short dequeue(unsigned char *p,unsigned size){
-
-        unsigned real;
-        unsigned datasize;
-
-        if(emptyQueue())
-        {
-            osd_printf_verbose("dequeue: EMPTY(%d)\n", size);
-            memset(p,0,size);//TODO ver si quito para que no petardee
-            return 0;
-        }
-
-        pthread_mutex_lock(&sound_mutex);
-
-        datasize = head > tail ? head - tail : (TAM - tail) + head ;
-        real = datasize > size ? size : datasize;
-
-        if(tail + real < TAM)
-        {
-            memcpy(p,ptr_buf+tail,real);
-            tail+=real;
-        }
-        else
-        {
-            memcpy(p,ptr_buf + tail, TAM - tail);
-            memcpy(p+ (TAM-tail),ptr_buf , real - (TAM-tail));
-            tail = (tail + real) - TAM;
-        }
-    
-        pthread_mutex_unlock(&sound_mutex);
+//============================================================
+//  myosd_sound_get - buffer statistics for myosd_get
+//============================================================
 
-        if (real < size)
-        {
-            osd_printf_verbose("dequeue: LOW(%d)\n", size-real);
-            memset(p+real, 0, size-real);
-        }
-        else
-        {
-            osd_printf_verbose("dequeue: OK(%d)\n", size);
-        }
+intptr_t myosd_sound_get(int var)
+{
+    if (!sound_ring)
+        return 0;
 
-        return real;
+    switch (var)
+    {
+        case MYOSD_AUDIO_FILL:
+            return sound_ring->fill();
+        case MYOSD_AUDIO_CAPACITY:
+            return sound_ring->capacity();
+        case MYOSD_AUDIO_UNDERRUNS:
+            return sound_ring->underruns();
+        case MYOSD_AUDIO_OVERRUNS:
+            return sound_ring->overruns();
+        case MYOSD_AUDIO_RATIO:
+            return (intptr_t)(sound_resampler.ratio() * 1000000.0);
+    }
+    return 0;
 }
 
 void checkStatus(OSStatus status){}
@@ -306,8 +268,7 @@ int sound_close_AudioQueue(){
     {
         AudioQueueDispose(in.queue, true);
         soundInit = 0;
-        head = 0;
-        tail = 0;
+        sound_ring.reset();
     }
     return 1;
 }
@@ -412,8 +373,7 @@ int sound_close_AudioUnit(){
         
         AudioUnitUninitialize(audioUnit);
         soundInit = 0;
-        head = 0;
-        tail = 0;
+        sound_ring.reset();
     }
     
     return 1;
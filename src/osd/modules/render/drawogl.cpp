@@ -343,7 +343,8 @@ private:
 
 	int gl_checkFramebufferStatus() const;
 	int texture_fbo_create(uint32_t text_unit, uint32_t text_name, uint32_t fbo_name, int width, int height) const;
-	void texture_set_data(ogl_texture_info *texture, const render_texinfo *texsource, uint32_t flags) const;
+	void texture_set_data(ogl_texture_info *texture, const render_texinfo *texsource, uint32_t flags, bool partial = false) const;
+	void texture_upload_rows(ogl_texture_info *texture, bool partial, int firstrow, int lastrow) const;
 
 	int gl_check_error(bool log, const char *file, int line) const
 	{
@@ -2447,8 +2448,25 @@ static inline void copyline_yuy16_to_argb(uint32_t *dst, const uint16_t *src, in
 //  texture_set_data
 //============================================================
 
-void renderer_ogl::texture_set_data(ogl_texture_info *texture, const render_texinfo *texsource, uint32_t flags) const
+void renderer_ogl::texture_set_data(ogl_texture_info *texture, const render_texinfo *texsource, uint32_t flags, bool partial) const
 {
+	// a partial update only converts and uploads the rows in the dirty area; the PBO path always does the lot
+	int firstrow = 0, lastrow = texsource->height - 1;
+	if (partial && texture->type != TEXTURE_TYPE_DYNAMIC)
+	{
+		firstrow = std::max(texsource->dirty.top(), 0);
+		lastrow = std::min(texsource->dirty.bottom(), int(texsource->height) - 1);
+		if (texsource->dirty.empty())
+			lastrow = firstrow - 1;
+	}
+	else
+		partial = false;
+
+	// let the core know how much of the refreshed texture actually gets sent
+	window().machine().render().add_texture_upload(u64(lastrow - firstrow + 1) * texsource->width, u64(texsource->height) * texsource->width);
+	if (lastrow < firstrow)
+		return;
+
 	if ( texture->type == TEXTURE_TYPE_DYNAMIC )
 	{
 		assert(texture->pbo);
@@ -2466,7 +2484,7 @@ void renderer_ogl::texture_set_data(ogl_texture_info *texture, const render_texi
 	}
 
 	// always fill non-wrapping textures with an extra pixel on the top
-	if (texture->borderpix)
+	if (texture->borderpix && !partial)
 	{
 		memset(texture->data, 0,
 				(texsource->width * texture->xprescale + 2) * sizeof(uint32_t));
@@ -2478,7 +2496,7 @@ void renderer_ogl::texture_set_data(ogl_texture_info *texture, const render_texi
 		int y, y2;
 		uint8_t *dst;
 
-		for (y = 0; y < texsource->height; y++)
+		for (y = firstrow; y <= lastrow; y++)
 		{
 			for (y2 = 0; y2 < texture->yprescale; y2++)
 			{
@@ -2511,7 +2529,7 @@ void renderer_ogl::texture_set_data(ogl_texture_info *texture, const render_texi
 	}
 
 	// always fill non-wrapping textures with an extra pixel on the bottom
-	if (texture->borderpix)
+	if (texture->borderpix && !partial)
 	{
 		memset((uint8_t *)texture->data +
 				(texsource->height + 1) * texture->rawwidth * sizeof(uint32_t),
@@ -2530,8 +2548,7 @@ void renderer_ogl::texture_set_data(ogl_texture_info *texture, const render_texi
 			glPixelStorei(GL_UNPACK_ROW_LENGTH, texture->rawwidth);
 
 		// and upload the image
-		glTexSubImage2D(texture->texTarget, 0, 0, 0, texture->rawwidth, texture->rawheight,
-				GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV, texture->data);
+		texture_upload_rows(texture, partial, firstrow, lastrow);
 	}
 	else if ( texture->type == TEXTURE_TYPE_DYNAMIC )
 	{
@@ -2557,8 +2574,32 @@ void renderer_ogl::texture_set_data(ogl_texture_info *texture, const render_texi
 			glPixelStorei(GL_UNPACK_ROW_LENGTH, texture->rawwidth);
 
 		// and upload the image
+		texture_upload_rows(texture, partial, firstrow, lastrow);
+	}
+}
+
+//============================================================
+//  texture_upload_rows
+//============================================================
+
+void renderer_ogl::texture_upload_rows(ogl_texture_info *texture, bool partial, int firstrow, int lastrow) const
+{
+	if (!partial)
+	{
 		glTexSubImage2D(texture->texTarget, 0, 0, 0, texture->rawwidth, texture->rawheight,
-						GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV, texture->data);
+				GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV, texture->data);
+	}
+	else if (texture->nocopy)
+	{
+		// straight from the source bitmap, which has no border or prescale
+		glTexSubImage2D(texture->texTarget, 0, 0, firstrow, texture->rawwidth, lastrow - firstrow + 1,
+				GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV, texture->data + firstrow * texture->texinfo.rowpixels);
+	}
+	else
+	{
+		int const top = firstrow * texture->yprescale + texture->borderpix;
+		glTexSubImage2D(texture->texTarget, 0, 0, top, texture->rawwidth, (lastrow - firstrow + 1) * texture->yprescale,
+				GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV, texture->data + top * texture->rawwidth);
 	}
 }
 
@@ -2820,10 +2861,12 @@ ogl_texture_info * renderer_ogl::texture_update(const render_primitive *prim, in
 		{
 			if (prim->texture.base != nullptr && texture->texinfo.seqid != prim->texture.seqid)
 			{
+				// if we have the sequence the dirty area is relative to, only that area needs copying
+				bool const partial = (texture->texinfo.seqid == prim->texture.dirty_seqid);
 				texture->texinfo.seqid = prim->texture.seqid;
 
 				// if we found it, but with a different seqid, copy the data
-				texture_set_data(texture, &prim->texture, prim->flags);
+				texture_set_data(texture, &prim->texture, prim->flags, partial);
 				texBound=1;
 			}
 		}
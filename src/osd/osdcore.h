@@ -156,6 +156,21 @@ struct osd_work_item;
 typedef void *(*osd_work_callback)(void *param, int threadid);
 
 
+/*-----------------------------------------------------------------------------
+    osd_get_num_processors: return the number of processors
+
+    Parameters:
+
+        heavy_mt - true if the caller intends to use all processors for
+            heavy multithreaded work; otherwise the count is capped
+
+    Return value:
+
+        The number of processors available for work.
+-----------------------------------------------------------------------------*/
+int osd_get_num_processors(bool heavy_mt);
+
+
 /*-----------------------------------------------------------------------------
     osd_work_queue_alloc: create a new work queue
 
@@ -0,0 +1,201 @@
+#include "catch.hpp"
+#include "emu.h"
+#include "resampler.h"
+
+#include <cmath>
+#include <vector>
+
+
+//-------------------------------------------------
+//  sine - a tone at the given frequency
+//-------------------------------------------------
+
+static std::vector<float> sine(u32 rate, double frequency, u32 count)
+{
+	std::vector<float> result(count);
+	for (u32 index = 0; index < count; index++)
+		result[index] = float(0.5 * std::sin(2.0 * M_PI * frequency * index / rate));
+	return result;
+}
+
+
+//-------------------------------------------------
+//  default_resample - the algorithm used by
+//  default_resampler_stream, over a plain array
+//-------------------------------------------------
+
+static std::vector<float> default_resample(std::vector<float> const &input, u32 input_rate, u32 output_rate, u32 count)
+{
+	std::vector<float> result(count);
+	float const step = float(input_rate) / float(output_rate);
+	float const stepinv = 1.0f / step;
+	float srcpos = 0;
+	u32 srcindex = 0;
+	if (step < 1.0f)
+	{
+		// point sample except where our sample period covers a boundary
+		float cursample = input[srcindex++];
+		for (u32 dstindex = 0; dstindex < count; dstindex++)
+		{
+			srcpos += step;
+			if (srcpos <= 1.0f)
+				result[dstindex] = cursample;
+			else
+			{
+				srcpos -= 1.0f;
+				float const prevsample = cursample;
+				cursample = input[srcindex++];
+				result[dstindex] = stepinv * (prevsample * (step - srcpos) + srcpos * cursample);
+			}
+		}
+	}
+	else
+	{
+		// sum the energy
+		float cursample = input[srcindex++];
+		for (u32 dstindex = 0; dstindex < count; dstindex++)
+		{
+			float const scale = 1.0f - srcpos;
+			float sample = cursample * scale;
+			float remaining = step - scale;
+			while (remaining >= 1.0f)
+			{
+				sample += input[srcindex++];
+				remaining -= 1.0f;
+			}
+			cursample = input[srcindex++];
+			sample += cursample * remaining;
+			result[dstindex] = sample * stepinv;
+			srcpos = remaining;
+		}
+	}
+	return result;
+}
+
+
+//-------------------------------------------------
+//  polyphase_resample - run a polyphase filter
+//  over a plain array
+//-------------------------------------------------
+
+static std::vector<float> polyphase_resample(std::vector<float> const &input, u32 input_rate, u32 output_rate, int quality, u32 count)
+{
+	polyphase_resampler const filter(input_rate, output_rate, quality);
+	std::vector<float> result(count);
+	filter.process(&result[0], count, &input[0], 0);
+	return result;
+}
+
+
+//-------------------------------------------------
+//  residual_db - level of whatever isn't the
+//  given tone, relative to the tone, after
+//  skipping the filters' startup
+//-------------------------------------------------
+
+static double residual_db(std::vector<float> const &output, u32 rate, double frequency)
+{
+	// least-squares fit of a sine, a cosine and DC
+	u32 const first = output.size() / 4;
+	double ss = 0, sc = 0, cc = 0, s1 = 0, c1 = 0, n = 0, sy = 0, cy = 0, y1 = 0;
+	for (u32 index = first; index < output.size(); index++)
+	{
+		double const s = std::sin(2.0 * M_PI * frequency * index / rate), c = std::cos(2.0 * M_PI * frequency * index / rate), y = output[index];
+		ss += s * s; sc += s * c; cc += c * c; s1 += s; c1 += c; n += 1;
+		sy += s * y; cy += c * y; y1 += y;
+	}
+	double m[3][4] = { { ss, sc, s1, sy }, { sc, cc, c1, cy }, { s1, c1, n, y1 } };
+	for (int col = 0; col < 3; col++)
+		for (int row = 0; row < 3; row++)
+			if (row != col)
+			{
+				double const ratio = m[row][col] / m[col][col];
+				for (int k = 0; k < 4; k++)
+					m[row][k] -= ratio * m[col][k];
+			}
+	double const a = m[0][3] / m[0][0], b = m[1][3] / m[1][1], dc = m[2][3] / m[2][2];
+
+	double signal = 0, noise = 0;
+	for (u32 index = first; index < output.size(); index++)
+	{
+		double const fit = a * std::sin(2.0 * M_PI * frequency * index / rate) + b * std::cos(2.0 * M_PI * frequency * index / rate);
+		signal += fit * fit;
+		noise += (output[index] - fit - dc) * (output[index] - fit - dc);
+	}
+	return 10.0 * std::log10(noise / signal);
+}
+
+
+//-------------------------------------------------
+//  level_db - level of the output after skipping
+//  the filters' startup, relative to a 0.5 sine
+//-------------------------------------------------
+
+static double level_db(std::vector<float> const &output)
+{
+	double sum = 0;
+	u32 const first = output.size() / 4;
+	for (u32 index = first; index < output.size(); index++)
+		sum += double(output[index]) * output[index];
+	return 10.0 * std::log10(sum / (output.size() - first) / 0.125);
+}
+
+
+TEST_CASE("Polyphase resampler keeps in-band tones clean", "[emu]")
+{
+	static const u32 rates[][2] = { { 44100, 48000 }, { 55500, 48000 }, { 1000000, 48000 }, { 48000, 44100 } };
+	for (auto const &rate : rates)
+	{
+		u32 const count = 4096;
+		std::vector<float> const input = sine(rate[0], 5000.0, u64(count) * rate[0] / rate[1] + 2048);
+		double const baseline = residual_db(default_resample(input, rate[0], rate[1], count), rate[1], 5000.0);
+		for (int quality = polyphase_resampler::QUALITY_LOW; quality <= polyphase_resampler::QUALITY_HIGH; quality++)
+		{
+			double const residual = residual_db(polyphase_resample(input, rate[0], rate[1], quality, count), rate[1], 5000.0);
+			INFO(rate[0] << " -> " << rate[1] << " quality " << quality << ": " << residual << " dB vs " << baseline << " dB");
+			REQUIRE(residual < -60.0 - 10.0 * quality);
+			REQUIRE(residual < baseline - 20.0);
+		}
+	}
+}
+
+
+TEST_CASE("Polyphase resampler rejects tones above the output Nyquist frequency", "[emu]")
+{
+	static const u32 rates[][3] = { { 55500, 48000, 27000 }, { 96000, 48000, 30000 }, { 1000000, 48000, 30000 }, { 1000000, 48000, 100000 } };
+	for (auto const &rate : rates)
+	{
+		u32 const count = 4096;
+		std::vector<float> const input = sine(rate[0], rate[2], u64(count) * rate[0] / rate[1] + 2048);
+		double const baseline = level_db(default_resample(input, rate[0], rate[1], count));
+		for (int quality = polyphase_resampler::QUALITY_LOW; quality <= polyphase_resampler::QUALITY_HIGH; quality++)
+		{
+			double const level = level_db(polyphase_resample(input, rate[0], rate[1], quality, count));
+			INFO(rate[0] << " -> " << rate[1] << " at " << rate[2] << " Hz, quality " << quality << ": " << level << " dB vs " << baseline << " dB");
+			REQUIRE(level < -40.0 - 10.0 * quality);
+			REQUIRE(level < baseline - 10.0);
+		}
+	}
+}
+
+
+TEST_CASE("Polyphase resampler tables have unity gain and a centred window", "[emu]")
+{
+	// a step up to 1.0 should come out at 1.0, half way through the window
+	polyphase_resampler const filter(44100, 48000, polyphase_resampler::QUALITY_MEDIUM);
+	std::vector<float> input(4096, 0.0f);
+	std::fill(input.begin() + 1024, input.end(), 1.0f);
+	std::vector<float> output(2048);
+	filter.process(&output[0], output.size(), &input[0], 0);
+	REQUIRE(std::fabs(output.back() - 1.0f) < 1e-4f);
+
+	// the reconstruction point for output N is N * step + taps / 2 - 1
+	for (u32 index = 0; index < output.size(); index++)
+	{
+		double const position = double(index) * 44100.0 / 48000.0 + filter.taps() / 2 - 1;
+		if (position < 1024 - filter.taps() / 2)
+			REQUIRE(std::fabs(output[index]) < 1e-3f);
+		else if (position > 1024 + filter.taps() / 2)
+			REQUIRE(std::fabs(output[index] - 1.0f) < 2e-3f);
+	}
+}
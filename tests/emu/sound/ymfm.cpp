@@ -0,0 +1,153 @@
+#include "catch.hpp"
+#include "emu.h"
+#include "ymfm_opl.h"
+#include "ymfm_opn.h"
+
+#include <random>
+#include <vector>
+
+
+//-------------------------------------------------
+//  fm_block_check - run one engine a sample at a
+//  time through clock() and output(), and another
+//  through generate_block(), feeding both the same
+//  register writes, and compare every channel's
+//  output and envelope counter
+//-------------------------------------------------
+
+template<class RegisterType>
+class fm_block_check
+{
+public:
+	using engine = ymfm::fm_engine_base<RegisterType>;
+	using output_data = typename engine::output_data;
+
+	fm_block_check(uint32_t rshift, int32_t clipmax, uint32_t chanmask, uint32_t outmask) :
+		m_reference(m_refintf),
+		m_block(m_blockintf),
+		m_rshift(rshift),
+		m_clipmax(clipmax),
+		m_chanmask(chanmask),
+		m_outmask(outmask)
+	{
+		m_reference.reset();
+		m_block.reset();
+	}
+
+	void write(uint16_t regnum, uint8_t data)
+	{
+		m_reference.write(regnum, data);
+		m_block.write(regnum, data);
+	}
+
+	// generate 'count' samples in blocks of 'blocksize' and return whether they matched
+	bool run(uint32_t count, uint32_t blocksize)
+	{
+		std::vector<output_data> reference(engine::CHANNELS * count), block(engine::CHANNELS * count);
+		std::vector<uint32_t> refenv(count), blockenv(count);
+		for (auto &out : reference)
+			out.clear();
+		for (auto &out : block)
+			out.clear();
+
+		for (uint32_t samp = 0; samp < count; samp++)
+		{
+			refenv[samp] = m_reference.clock(m_chanmask);
+			for (uint32_t chnum = 0; chnum < engine::CHANNELS; chnum++)
+				if (ymfm::bitfield(m_outmask, chnum))
+					m_reference.output(reference[chnum * count + samp], m_rshift, m_clipmax, m_chanmask & (1 << chnum));
+		}
+
+		for (uint32_t samp = 0; samp < count; )
+		{
+			output_data *chanout[engine::CHANNELS];
+			for (uint32_t chnum = 0; chnum < engine::CHANNELS; chnum++)
+				chanout[chnum] = ymfm::bitfield(m_outmask, chnum) ? &block[chnum * count + samp] : nullptr;
+			uint32_t const generated = m_block.generate_block(chanout, std::min(blocksize, count - samp), m_rshift, m_clipmax, m_chanmask);
+			if (generated == 0)
+				return false;
+			for (uint32_t index = 0; index < generated; index++)
+				blockenv[samp + index] = m_block.block_env_counter(index);
+			samp += generated;
+		}
+
+		for (uint32_t index = 0; index < reference.size(); index++)
+			for (uint32_t output = 0; output < engine::OUTPUTS; output++)
+				if (reference[index].data[output] != block[index].data[output])
+					return false;
+		return refenv == blockenv;
+	}
+
+private:
+	ymfm::ymfm_interface m_refintf, m_blockintf;
+	engine m_reference, m_block;
+	uint32_t m_rshift;
+	int32_t m_clipmax;
+	uint32_t m_chanmask, m_outmask;
+};
+
+
+TEST_CASE("ymfm OPN block generation matches per-sample generation", "[emu][sound]")
+{
+	std::mt19937 rng(2612);
+
+	// YM2612 mixing with the DAC replacing channel 6, and YM2610 with its 4 FM channels
+	fm_block_check<ymfm::opna_registers> opn2(5, 256, 0x3f, 0x1f);
+	fm_block_check<ymfm::opna_registers> opnb(1, 32767, 0x36, 0x36);
+	for (auto *check : { &opn2, &opnb })
+	{
+		for (int pass = 0; pass < 40; pass++)
+		{
+			// rewrite random operator and channel registers in both banks, including
+			// SSG-EG, the LFO and random key on/off states
+			for (int count = 0; count < 64; count++)
+			{
+				uint16_t const regnum = 0x30 + rng() % (0xb8 - 0x30) + ((rng() & 1) ? 0x100 : 0);
+				check->write(regnum, rng());
+			}
+			check->write(0x22, rng() & 0x0f);
+			for (int chnum = 0; chnum < 6; chnum++)
+				check->write(0x28, (rng() & 0xf0) | (chnum + (chnum >= 3)));
+
+			// odd block sizes, some larger than a block, and a long run every so often
+			// to cross the periodic prepare
+			uint32_t const blocksize = 1 + rng() % 100;
+			uint32_t const count = (pass % 8 == 7) ? 9000 : 1 + rng() % 500;
+			INFO("pass " << pass << ", " << count << " samples in blocks of " << blocksize);
+			REQUIRE(check->run(count, blocksize));
+		}
+	}
+}
+
+
+TEST_CASE("ymfm OPL3 block generation matches per-sample generation", "[emu][sound]")
+{
+	std::mt19937 rng(262);
+
+	fm_block_check<ymfm::opl3_registers> opl3(0, 32767, 0x3ffff, 0x3ffff);
+	opl3.write(0x105, 0x01);
+	for (int pass = 0; pass < 60; pass++)
+	{
+		// random operator, channel and waveform registers in both banks, then random
+		// 4-operator pairings; rhythm mode is left on some of the time, which
+		// takes the sample at a time path
+		for (int count = 0; count < 64; count++)
+		{
+			uint16_t const regnum = 0x20 + rng() % (0xf6 - 0x20) + ((rng() & 1) ? 0x100 : 0);
+			if ((regnum & 0xff) != 0xbd)
+				opl3.write(regnum, rng());
+		}
+		opl3.write(0x104, rng() & 0x3f);
+		opl3.write(0xbd, (rng() & 0xc0) | (((pass % 4) == 3) ? (0x20 | (rng() & 0x1f)) : 0));
+		for (int chnum = 0; chnum < 9; chnum++)
+		{
+			opl3.write(0xb0 + chnum, rng());
+			opl3.write(0x1b0 + chnum, rng());
+		}
+
+		uint32_t const blocksize = 1 + rng() % 100;
+		uint32_t const count = (pass % 8 == 7) ? 9000 : 1 + rng() % 500;
+		INFO("pass " << pass << ", " << count << " samples in blocks of " << blocksize);
+		REQUIRE(opl3.run(count, blocksize));
+	}
+}
@@ -0,0 +1,217 @@
+#include "catch.hpp"
+#include "emu.h"
+#include "render.h"
+#include "screen.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+
+//-------------------------------------------------
+//  dirty_track_screen - a double-buffered screen
+//  the way screen_device drives it: each frame
+//  redraws one bitmap, marks what changed, and
+//  hands the texture the committed dirty area;
+//  an OSD-style copy of each texture is kept up
+//  to date from the texinfo alone
+//-------------------------------------------------
+
+class dirty_track_screen
+{
+public:
+	dirty_track_screen(int width, int height) :
+		m_visarea(0, width - 1, 0, height - 1),
+		m_curbitmap(0)
+	{
+		for (int i = 0; i < 2; i++)
+		{
+			m_bitmap[i].allocate(width, height);
+			m_texture[i] = m_allocator.alloc();
+			m_copy[i].resize(width * height, 0);
+			m_copy_seqid[i] = ~0U;
+		}
+	}
+
+	~dirty_track_screen()
+	{
+		for (render_texture *texture : m_texture)
+			m_allocator.reclaim(texture);
+	}
+
+	const rectangle &visarea() const { return m_visarea; }
+	bitmap_rgb32 &bitmap() { return m_bitmap[m_curbitmap]; }
+
+	// note a change to the frame being drawn
+	void mark(const rectangle &rect) { m_dirty.mark(rect); }
+
+	// commit the frame to its texture, fetch it back as the renderer would, and
+	// update the OSD copy; returns the texinfo it was fetched with
+	render_texinfo commit()
+	{
+		rectangle const dirty = m_dirty.commit(m_visarea);
+		m_texture[m_curbitmap]->set_bitmap(m_bitmap[m_curbitmap], m_visarea, TEXFORMAT_RGB32, dirty);
+
+		render_primitive_list primlist;
+		render_texinfo texinfo;
+		m_texture[m_curbitmap]->get_scaled(m_visarea.width(), m_visarea.height(), texinfo, primlist);
+		upload(m_curbitmap, texinfo);
+
+		m_curbitmap ^= 1;
+		return texinfo;
+	}
+
+	// whether the OSD copy of the texture last committed matches its bitmap
+	bool copy_matches() const
+	{
+		int const which = m_curbitmap ^ 1;
+		for (int y = 0; y < m_visarea.height(); y++)
+			for (int x = 0; x < m_visarea.width(); x++)
+				if (m_copy[which][y * m_visarea.width() + x] != m_bitmap[which].pix(y, x))
+					return false;
+		return true;
+	}
+
+	// rows the OSD copied, in total and out of all it refreshed
+	u64 uploaded_pixels() const { return m_uploaded; }
+	u64 refreshed_pixels() const { return m_refreshed; }
+
+private:
+	// copy the changed rows, or the whole lot if we don't have the sequence the dirty
+	// area is relative to, the way drawogl does
+	void upload(int which, const render_texinfo &texinfo)
+	{
+		if (texinfo.seqid == m_copy_seqid[which])
+			return;
+
+		int firstrow = 0, lastrow = texinfo.height - 1;
+		if (m_copy_seqid[which] == texinfo.dirty_seqid)
+		{
+			firstrow = std::max(texinfo.dirty.top(), 0);
+			lastrow = texinfo.dirty.empty() ? -1 : std::min(texinfo.dirty.bottom(), int(texinfo.height) - 1);
+		}
+		m_copy_seqid[which] = texinfo.seqid;
+
+		u32 const *const base = reinterpret_cast<u32 const *>(texinfo.base);
+		for (int y = firstrow; y <= lastrow; y++)
+			std::copy_n(&base[y * texinfo.rowpixels], texinfo.width, &m_copy[which][y * texinfo.width]);
+		if (lastrow >= firstrow)
+			m_uploaded += u64(lastrow - firstrow + 1) * texinfo.width;
+		m_refreshed += u64(texinfo.height) * texinfo.width;
+	}
+
+	fixed_allocator<render_texture> m_allocator;
+	rectangle               m_visarea;
+	bitmap_rgb32            m_bitmap[2];
+	render_texture *        m_texture[2];
+	screen_dirty_history    m_dirty;
+	int                     m_curbitmap;
+	std::vector<u32>        m_copy[2];
+	u32                     m_copy_seqid[2];
+	u64                     m_uploaded = 0;
+	u64                     m_refreshed = 0;
+};
+
+
+TEST_CASE("Dirty area covers each mark for the next two commits", "[emu]")
+{
+	dirty_track_screen screen(64, 48);
+
+	// the first commit of each bitmap has nothing to be relative to
+	screen.mark(rectangle(0, 63, 0, 47));
+	u32 seqid[2];
+	seqid[0] = screen.commit().seqid;
+	seqid[1] = screen.commit().seqid;
+	int which = 0;
+
+	// commit a frame and check what changed since the last commit of the same bitmap
+	auto const check = [&screen, &seqid, &which] (const rectangle &expected)
+	{
+		render_texinfo const texinfo = screen.commit();
+		if (expected.empty())
+		{
+			REQUIRE(texinfo.seqid == seqid[which]);
+		}
+		else
+		{
+			REQUIRE(texinfo.seqid != seqid[which]);
+			REQUIRE(texinfo.dirty_seqid == seqid[which]);
+			REQUIRE(texinfo.dirty == expected);
+		}
+		seqid[which] = texinfo.seqid;
+		which ^= 1;
+	};
+	rectangle const nothing(0, -1, 0, -1);
+
+	// the full mark still has one commit to go, then nothing marked means nothing dirty
+	check(rectangle(0, 63, 0, 47));
+	check(nothing);
+	check(nothing);
+
+	// a mark shows up in this commit and the next two, then drops out
+	screen.mark(rectangle(10, 19, 5, 9));
+	screen.mark(rectangle(60, 70, 40, 50));
+	for (int i = 0; i < 3; i++)
+		check(rectangle(10, 63, 5, 47));
+	check(nothing);
+	check(nothing);
+
+	// and overlapping histories take the union
+	screen.mark(rectangle(0, 3, 0, 3));
+	check(rectangle(0, 3, 0, 3));
+	screen.mark(rectangle(30, 33, 20, 23));
+	check(rectangle(0, 33, 0, 23));
+	check(rectangle(0, 33, 0, 23));
+	check(rectangle(30, 33, 20, 23));
+	check(nothing);
+}
+
+
+TEST_CASE("Dirty-tracked uploads keep both buffers up to date", "[emu]")
+{
+	int const width = 96, height = 80, tile = 8;
+	std::mt19937 rng(0x5c7ee7);
+	dirty_track_screen screen(width, height);
+
+	// a tile background that changes now and again, and a few sprites moving along a band
+	std::vector<u32> tiles((width / tile) * (height / tile));
+	for (auto &color : tiles)
+		color = rng() & 0xffffff;
+	struct sprite { int x, y, dx, dy; u32 color; };
+	std::vector<sprite> sprites(4);
+	for (auto &spr : sprites)
+		spr = sprite{ int(rng() % width), 16 + int(rng() % 8), int(rng() % 5) - 2, int(rng() % 3) - 1, rng() & 0xffffff };
+
+	for (int frame = 0; frame < 200; frame++)
+	{
+		// change a tile now and again, marking it the way a tilemap would
+		if ((frame % 16) == 0)
+		{
+			int const index = rng() % tiles.size();
+			tiles[index] = rng() & 0xffffff;
+			int const tx = (index % (width / tile)) * tile, ty = (index / (width / tile)) * tile;
+			screen.mark(rectangle(tx, tx + tile - 1, ty, ty + tile - 1));
+		}
+
+		// redraw the whole frame; only the sprites mark their destination, like gfx draws
+		bitmap_rgb32 &bitmap = screen.bitmap();
+		for (int y = 0; y < height; y++)
+			for (int x = 0; x < width; x++)
+				bitmap.pix(y, x) = tiles[(y / tile) * (width / tile) + x / tile];
+		for (auto &spr : sprites)
+		{
+			rectangle dest(spr.x, spr.x + 11, spr.y, spr.y + 11);
+			dest &= screen.visarea();
+			bitmap.fill(spr.color, dest);
+			screen.mark(dest);
+			spr.x = (spr.x + spr.dx + width) % width;
+			spr.y = std::clamp(spr.y + spr.dy, 8, 32);
+		}
+
+		screen.commit();
+		REQUIRE(screen.copy_matches());
+	}
+
+	// and the whole point: only part of each refresh gets copied
+	REQUIRE(screen.uploaded_pixels() < screen.refreshed_pixels() / 2);
+}
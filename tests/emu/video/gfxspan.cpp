@@ -0,0 +1,185 @@
+#include "catch.hpp"
+#include "emu.h"
+#include "drawgfxt.ipp"
+
+#include <random>
+#include <vector>
+
+
+//-------------------------------------------------
+//  gfx_span_row - one random row of source pens
+//  with destination and priority pixels under it
+//-------------------------------------------------
+
+struct gfx_span_row
+{
+	gfx_span_row(std::mt19937 &rng, s32 count, int pass) : src(count + 2), dest16(count + 2), dest32(count + 2), pri(count + 2)
+	{
+		for (s32 i = 0; i < count + 2; i++)
+		{
+			// mostly transparent, fully opaque, fully transparent and random rows
+			switch (pass)
+			{
+			case 0:     src[i] = rng() % 4;                     break;
+			case 1:     src[i] = 1 + rng() % 255;               break;
+			case 2:     src[i] = 0;                             break;
+			default:    src[i] = rng();                         break;
+			}
+			dest16[i] = rng();
+			dest32[i] = rng();
+			pri[i] = rng();
+		}
+	}
+
+	std::vector<u8> src;
+	std::vector<u16> dest16;
+	std::vector<u32> dest32;
+	std::vector<u8> pri;
+};
+
+
+TEST_CASE("Gfx span kernels match the drawgfx pixel ops", "[emu][video]")
+{
+	std::mt19937 rng(4711);
+	std::vector<pen_t> pens(256);
+	for (auto &pen : pens)
+		pen = rng();
+	const pen_t *const paldata = pens.data();
+
+	// every length, starting one byte in so no load is aligned
+	for (s32 count = 0; count <= 67; count++)
+	{
+		for (int pass = 0; pass < 4; pass++)
+		{
+			gfx_span_row const row(rng, count, pass);
+			u32 const trans_pen = (pass == 3 && (count & 1)) ? 0x100 : (rng() % 4);
+			u32 const trans_mask = rng() | 1;
+			u32 const pmask = rng() | (1 << 31);
+			u32 const color = rng();
+			u8 const alpha_val = rng();
+			u8 const *const srcp = &row.src[1];
+
+			// apply a pixel op to each pixel, and the matching kernel to the whole row, and compare
+			auto check16 = [&] (auto &&pixel, auto &&kernel)
+			{
+				std::vector<u16> ref(row.dest16), test(row.dest16);
+				for (s32 x = 1; x <= count; x++)
+					pixel(ref[x], row.src[x]);
+				kernel(&test[1], srcp, count);
+				return ref == test;
+			};
+			auto check16_pri = [&] (auto &&pixel, auto &&kernel)
+			{
+				std::vector<u16> ref(row.dest16), test(row.dest16);
+				std::vector<u8> refpri(row.pri), testpri(row.pri);
+				for (s32 x = 1; x <= count; x++)
+					pixel(ref[x], refpri[x], row.src[x]);
+				kernel(&test[1], &testpri[1], srcp, count);
+				return ref == test && refpri == testpri;
+			};
+			auto check32 = [&] (auto &&pixel, auto &&kernel)
+			{
+				std::vector<u32> ref(row.dest32), test(row.dest32);
+				for (s32 x = 1; x <= count; x++)
+					pixel(ref[x], row.src[x]);
+				kernel(&test[1], srcp, count);
+				return ref == test;
+			};
+			auto check32_pri = [&] (auto &&pixel, auto &&kernel)
+			{
+				std::vector<u32> ref(row.dest32), test(row.dest32);
+				std::vector<u8> refpri(row.pri), testpri(row.pri);
+				for (s32 x = 1; x <= count; x++)
+					pixel(ref[x], refpri[x], row.src[x]);
+				kernel(&test[1], &testpri[1], srcp, count);
+				return ref == test && refpri == testpri;
+			};
+
+			// trans_mask only covers pens 0-31, so it only sees the low-pen rows
+			gfx_span::all_pens const all;
+			gfx_span::trans_pen const pen(trans_pen);
+			gfx_span::trans_mask const mask(trans_mask);
+			gfx_span::pri_mask const primask(pmask);
+
+			REQUIRE(check16([&] (u16 &destp, u8 srcp) { PIXEL_OP_REBASE_OPAQUE(destp, srcp); },
+					[&] (u16 *d, u8 const *s, s32 n) { gfx_span::rebase_ind16(d, s, n, color, all); }));
+			REQUIRE(check16([&] (u16 &destp, u8 srcp) { PIXEL_OP_REBASE_TRANSPEN(destp, srcp); },
+					[&] (u16 *d, u8 const *s, s32 n) { gfx_span::rebase_ind16(d, s, n, color, pen); }));
+			if (pass == 0 || pass == 2)
+				REQUIRE(check16([&] (u16 &destp, u8 srcp) { PIXEL_OP_REBASE_TRANSMASK(destp, srcp); },
+						[&] (u16 *d, u8 const *s, s32 n) { gfx_span::rebase_ind16(d, s, n, color, mask); }));
+
+			REQUIRE(check16_pri([&] (u16 &destp, u8 &pri, u8 srcp) { PIXEL_OP_REBASE_OPAQUE_PRIORITY(destp, pri, srcp); },
+					[&] (u16 *d, u8 *p, u8 const *s, s32 n) { gfx_span::rebase_ind16(d, p, s, n, color, all, primask); }));
+			REQUIRE(check16_pri([&] (u16 &destp, u8 &pri, u8 srcp) { PIXEL_OP_REBASE_TRANSPEN_PRIORITY(destp, pri, srcp); },
+					[&] (u16 *d, u8 *p, u8 const *s, s32 n) { gfx_span::rebase_ind16(d, p, s, n, color, pen, primask); }));
+			if (pass == 0 || pass == 2)
+				REQUIRE(check16_pri([&] (u16 &destp, u8 &pri, u8 srcp) { PIXEL_OP_REBASE_TRANSMASK_PRIORITY(destp, pri, srcp); },
+						[&] (u16 *d, u8 *p, u8 const *s, s32 n) { gfx_span::rebase_ind16(d, p, s, n, color, mask, primask); }));
+
+			REQUIRE(check32([&] (u32 &destp, u8 srcp) { PIXEL_OP_REMAP_OPAQUE(destp, srcp); },
+					[&] (u32 *d, u8 const *s, s32 n) { gfx_span::remap_rgb32(d, s, n, paldata, all); }));
+			REQUIRE(check32([&] (u32 &destp, u8 srcp) { PIXEL_OP_REMAP_TRANSPEN(destp, srcp); },
+					[&] (u32 *d, u8 const *s, s32 n) { gfx_span::remap_rgb32(d, s, n, paldata, pen); }));
+			if (pass == 0 || pass == 2)
+				REQUIRE(check32([&] (u32 &destp, u8 srcp) { PIXEL_OP_REMAP_TRANSMASK(destp, srcp); },
+						[&] (u32 *d, u8 const *s, s32 n) { gfx_span::remap_rgb32(d, s, n, paldata, mask); }));
+			REQUIRE(check32([&] (u32 &destp, u8 srcp) { PIXEL_OP_REMAP_TRANSPEN_ALPHA32(destp, srcp); },
+					[&] (u32 *d, u8 const *s, s32 n) { gfx_span::alpha_rgb32(d, s, n, paldata, pen, alpha_val); }));
+
+			REQUIRE(check32_pri([&] (u32 &destp, u8 &pri, u8 srcp) { PIXEL_OP_REMAP_OPAQUE_PRIORITY(destp, pri, srcp); },
+					[&] (u32 *d, u8 *p, u8 const *s, s32 n) { gfx_span::remap_rgb32(d, p, s, n, paldata, all, primask); }));
+			REQUIRE(check32_pri([&] (u32 &destp, u8 &pri, u8 srcp) { PIXEL_OP_REMAP_TRANSPEN_PRIORITY(destp, pri, srcp); },
+					[&] (u32 *d, u8 *p, u8 const *s, s32 n) { gfx_span::remap_rgb32(d, p, s, n, paldata, pen, primask); }));
+			if (pass == 0 || pass == 2)
+				REQUIRE(check32_pri([&] (u32 &destp, u8 &pri, u8 srcp) { PIXEL_OP_REMAP_TRANSMASK_PRIORITY(destp, pri, srcp); },
+						[&] (u32 *d, u8 *p, u8 const *s, s32 n) { gfx_span::remap_rgb32(d, p, s, n, paldata, mask, primask); }));
+			REQUIRE(check32_pri([&] (u32 &destp, u8 &pri, u8 srcp) { PIXEL_OP_REMAP_TRANSPEN_ALPHA32_PRIORITY(destp, pri, srcp); },
+					[&] (u32 *d, u8 *p, u8 const *s, s32 n) { gfx_span::alpha_rgb32(d, p, s, n, paldata, pen, primask, alpha_val); }));
+		}
+	}
+}
+
+
+TEST_CASE("Staged span ops match flipped and zoomed pixel ops", "[emu][video]")
+{
+	std::mt19937 rng(815);
+	std::vector<pen_t> pens(256);
+	for (auto &pen : pens)
+		pen = rng();
+	const pen_t *const paldata = pens.data();
+
+	// long enough to cross several staging chunks
+	for (s32 count = 1; count <= 200; count += 7)
+	{
+		gfx_span_row const row(rng, 2 * count, 0);
+		u32 const trans_pen = rng() % 4;
+		u32 const pmask = rng() | (1 << 31);
+		s32 const dx = 0x8000 + rng() % 0x10000;
+		span_op_remap_priority const op(paldata, gfx_span::trans_pen(trans_pen), pmask);
+
+		// flipped, reading leftward from the end of the row
+		{
+			std::vector<u32> ref(row.dest32), test(row.dest32);
+			std::vector<u8> refpri(row.pri), testpri(row.pri);
+			for (s32 x = 0; x < count; x++)
+				PIXEL_OP_REMAP_TRANSPEN_PRIORITY(ref[x], refpri[x], row.src[count - 1 - x]);
+			drawgfx_span_staged(count, [srcptr = &row.src[count - 1]] () mutable { return *srcptr--; },
+					[&] (s32 x, const u8 *staged, s32 chunk) { op.span(&test[x], &testpri[x], staged, chunk); });
+			REQUIRE(ref == test);
+			REQUIRE(refpri == testpri);
+		}
+
+		// zoomed, stepping through the source in 16.16
+		{
+			std::vector<u32> ref(row.dest32), test(row.dest32);
+			std::vector<u8> refpri(row.pri), testpri(row.pri);
+			for (s32 x = 0; x < count; x++)
+				PIXEL_OP_REMAP_TRANSPEN_PRIORITY(ref[x], refpri[x], row.src[(x * dx) >> 16]);
+			drawgfx_span_staged(count, [srcptr = row.src.data(), cursrcx = 0, dx] () mutable { u8 const pen = srcptr[cursrcx >> 16]; cursrcx += dx; return pen; },
+					[&] (s32 x, const u8 *staged, s32 chunk) { op.span(&test[x], &testpri[x], staged, chunk); });
+			REQUIRE(ref == test);
+			REQUIRE(refpri == testpri);
+		}
+	}
+}
@@ -0,0 +1,182 @@
+#include "catch.hpp"
+#include "emu.h"
+#include "render.h"
+#include "rendersw.hxx"
+
+#include <random>
+#include <vector>
+
+
+//-------------------------------------------------
+//  span_test_frame - random textures drawn with
+//  every blitter the span kernels take over, and
+//  a few they leave alone
+//-------------------------------------------------
+
+class span_test_frame
+{
+public:
+	span_test_frame(u32 seed, u32 width, u32 height) : m_rng(seed)
+	{
+		m_rgb.resize(37 * 23);
+		for (auto &pixel : m_rgb)
+			pixel = m_rng();
+		m_argb.resize(41 * 29);
+		for (auto &pixel : m_argb)
+			pixel = ((m_rng() % 3) ? m_rng() : (m_rng() & 0x00ffffff));
+		m_pal16.resize(19 * 17);
+		for (auto &pixel : m_pal16)
+			pixel = m_rng() % 256;
+		m_palette.resize(256);
+		for (auto &entry : m_palette)
+			entry = rgb_t(m_rng());
+
+		for (int wrap = 0; wrap < 2; wrap++)
+		{
+			for (int i = 0; i < 6; i++)
+			{
+				render_color const color = random_color(i);
+				add_quad(width, height, m_rgb.data(), 37, 23, TEXFORMAT_RGB32, BLENDMODE_NONE, wrap, color);
+				add_quad(width, height, m_rgb.data(), 37, 23, TEXFORMAT_RGB32, BLENDMODE_ALPHA, wrap, color);
+				add_quad(width, height, m_argb.data(), 41, 29, TEXFORMAT_ARGB32, BLENDMODE_ALPHA, wrap, color);
+				add_quad(width, height, m_argb.data(), 41, 29, TEXFORMAT_ARGB32, BLENDMODE_ADD, wrap, color);
+				add_quad(width, height, m_rgb.data(), 37, 23, TEXFORMAT_RGB32, BLENDMODE_ADD, wrap, color);
+				add_quad(width, height, m_rgb.data(), 37, 23, TEXFORMAT_RGB32, BLENDMODE_RGB_MULTIPLY, wrap, color);
+				add_quad(width, height, m_pal16.data(), 19, 17, TEXFORMAT_PALETTE16, BLENDMODE_NONE, wrap, color).texture.palette = m_palette.data();
+			}
+		}
+	}
+
+	render_primitive const *first() const { return m_list.first(); }
+
+private:
+	// opaque white, tinted and translucent colours, including the odd one brighter than white
+	render_color random_color(int kind)
+	{
+		float const r = (m_rng() % 1000) * 0.001F, g = (m_rng() % 1000) * 0.001F, b = (m_rng() % 1000) * 0.001F;
+		switch (kind)
+		{
+		case 0:     return render_color{ 1.0F, 1.0F, 1.0F, 1.0F };
+		case 1:     return render_color{ 1.0F, r, g, b };
+		case 2:     return render_color{ r, 1.0F, 1.0F, 1.0F };
+		case 3:     return render_color{ r, g, b, 1.0F };
+		case 4:     return render_color{ r, 1.3F, g, b };
+		default:    return render_color{ 0.0F, r, g, b };
+		}
+	}
+
+	render_primitive &add_quad(u32 width, u32 height, void *texture, u32 texwidth, u32 texheight, texture_format format, int blendmode, bool wrap, render_color const &color)
+	{
+		// random bounds that may hang off the edges, with texture coordinates that may run outside the texture
+		float const x0 = float(int(m_rng() % (width + 40)) - 20), y0 = float(int(m_rng() % (height + 40)) - 20);
+		float const x1 = x0 + 1 + m_rng() % width, y1 = y0 + 1 + m_rng() % height;
+		float const u0 = int(m_rng() % 300 - 100) * 0.01F, v0 = int(m_rng() % 300 - 100) * 0.01F;
+		float const u1 = int(m_rng() % 300 - 100) * 0.01F, v1 = int(m_rng() % 300 - 100) * 0.01F;
+
+		render_primitive &prim = m_list.append(*new render_primitive);
+		prim.type = render_primitive::QUAD;
+		prim.bounds = render_bounds{ x0, y0, x1, y1 };
+		prim.color = color;
+		prim.flags = PRIMFLAG_TEXFORMAT(format) | PRIMFLAG_BLENDMODE(blendmode) | PRIMFLAG_TEXWRAP(wrap ? 1 : 0);
+		prim.texture = render_texinfo();
+		prim.texture.base = texture;
+		prim.texture.rowpixels = texwidth;
+		prim.texture.width = texwidth;
+		prim.texture.height = texheight;
+		prim.texcoords = render_quad_texuv{ { u0, v0 }, { u1, v0 }, { u0, v1 }, { u1, v1 } };
+		return prim;
+	}
+
+	std::mt19937 m_rng;
+	simple_list<render_primitive> m_list;
+	std::vector<u32> m_rgb;
+	std::vector<u32> m_argb;
+	std::vector<u16> m_pal16;
+	std::vector<rgb_t> m_palette;
+};
+
+
+//-------------------------------------------------
+//  render_both - draw a frame with and without
+//  the span kernels and compare the results
+//-------------------------------------------------
+
+template <bool NoDestRead, bool BilinearFilter>
+static bool render_both(u32 seed)
+{
+	u32 const width = 203, height = 131;
+	span_test_frame const frame(seed, width, height);
+
+	// start from the same random background
+	std::mt19937 rng(seed);
+	std::vector<u32> simd(width * height), scalar(width * height);
+	for (u32 i = 0; i < width * height; i++)
+		simd[i] = scalar[i] = rng();
+
+	software_renderer<u32, 0,0,0, 16,8,0, NoDestRead, BilinearFilter, true>::draw_primitives(frame.first(), simd.data(), width, height, width);
+	software_renderer<u32, 0,0,0, 16,8,0, NoDestRead, BilinearFilter, false>::draw_primitives(frame.first(), scalar.data(), width, height, width);
+	return simd == scalar;
+}
+
+
+TEST_CASE("Software renderer span kernels match the scalar blitters", "[emu][video]")
+{
+	for (u32 seed = 1; seed <= 8; seed++)
+	{
+		REQUIRE((render_both<false, false>(seed)));
+		REQUIRE((render_both<false, true>(seed)));
+		REQUIRE((render_both<true, false>(seed)));
+		REQUIRE((render_both<true, true>(seed)));
+	}
+}
+
+
+TEST_CASE("Span kernels handle every length and extreme factors", "[emu][video]")
+{
+	// the scalar tail of each kernel is the reference for its vector body
+	std::mt19937 rng(1357);
+	std::vector<u32> src(67), dest(67);
+	u32 const factors[] = { 0, 1, 127, 128, 255, 256 };
+	for (s32 count = 0; count <= 67; count++)
+	{
+		for (u32 const f : factors)
+		{
+			for (auto &pixel : src)
+				pixel = rng();
+			for (auto &pixel : dest)
+				pixel = rng();
+			u32 const g = rng() % 257, invsa = 256 - f;
+
+			// each kernel applied to the whole span versus one pixel at a time
+			auto check = [&] (auto &&kernel)
+			{
+				std::vector<u32> whole(dest), single(dest);
+				kernel(whole.data(), src.data(), count);
+				for (s32 x = 0; x < count; x++)
+					kernel(&single[x], &src[x], 1);
+				return whole == single;
+			};
+			REQUIRE(check([&] (u32 *d, u32 const *s, s32 n) { rgb_span::modulate(d, s, n, f, g, 256 - f); }));
+			REQUIRE(check([&] (u32 *d, u32 const *s, s32 n) { rgb_span::blend_const(d, s, n, f, f, f, invsa); }));
+			REQUIRE(check([&] (u32 *d, u32 const *s, s32 n) { rgb_span::blend_alpha(d, s, n); }));
+			REQUIRE(check([&] (u32 *d, u32 const *s, s32 n) { rgb_span::add_saturate(d, s, n); }));
+			REQUIRE(check([&] (u32 *d, u32 const *s, s32 n) { rgb_span::add_alpha(d, s, n); }));
+			REQUIRE(check([&] (u32 *d, u32 const *s, s32 n) { rgb_span::add_scaled(d, s, n, f, g, 256, 256 - f); }));
+		}
+	}
+
+	// clamped fetches, including coordinates that walk off all four edges
+	u32 texture[13 * 7];
+	for (auto &texel : texture)
+		texel = rng();
+	for (s32 count = 1; count <= 67; count++)
+	{
+		s32 const curu = s32(rng() % (40 << 16)) - (20 << 16), curv = s32(rng() % (30 << 16)) - (15 << 16);
+		s32 const dudx = s32(rng() % (2 << 16)) - (1 << 16), dvdx = s32(rng() % (2 << 16)) - (1 << 16);
+		std::vector<u32> whole(count), single(count);
+		rgb_span::fetch_clamped(whole.data(), texture, 13, 13, 7, curu, curv, dudx, dvdx, count);
+		for (s32 x = 0; x < count; x++)
+			rgb_span::fetch_clamped(&single[x], texture, 13, 13, 7, curu + x * dudx, curv + x * dvdx, dudx, dvdx, 1);
+		REQUIRE(whole == single);
+	}
+}
@@ -0,0 +1,73 @@
+#include "catch.hpp"
+#include "emu.h"
+#include "video/tilespan.h"
+
+#include <random>
+#include <vector>
+
+
+TEST_CASE("Tile span kernels match the scalar rasterizers", "[emu][video]")
+{
+	std::mt19937 rng(8642);
+	std::vector<rgb_t> pens(0x10000 + 0x1000);
+	for (auto &pen : pens)
+		pen = rgb_t(rng());
+
+	// every length, starting at odd offsets so no load is aligned
+	for (s32 count = 0; count <= 67; count++)
+	{
+		for (int pass = 0; pass < 4; pass++)
+		{
+			std::vector<u16> source(count + 3), dest16(count + 3);
+			std::vector<u8> maskbytes(count + 3), pri(count + 3);
+			std::vector<u32> dest32(count + 3);
+			for (s32 i = 0; i < count + 3; i++)
+			{
+				source[i] = rng();
+				dest16[i] = rng();
+				dest32[i] = rng();
+				pri[i] = rng();
+
+				// long opaque and transparent runs as well as mixed ones
+				maskbytes[i] = (pass == 0) ? 0x10 : (pass == 1) ? 0x00 : rng();
+			}
+			u8 const mask = (pass == 3) ? 0x0f : 0x10, value = (pass == 3) ? (rng() & 0x0f) : 0x10;
+			u16 const pal = rng() & 0x0fff;
+			u32 const pcode = rng();
+			u16 const *const src = &source[1];
+			u8 const *const maskptr = &maskbytes[1];
+			rgb_t const *const clut = &pens[pal];
+
+			std::vector<u8> pri_ref(pri), pri_masked_ref(pri), pri_test(pri), pri_masked_test(pri);
+			std::vector<u16> ind16_ref(dest16), ind16_masked_ref(dest16), ind16_test(dest16), ind16_masked_test(dest16);
+			std::vector<u32> rgb32_ref(dest32), rgb32_masked_ref(dest32), rgb32_test(dest32), rgb32_masked_test(dest32);
+			for (s32 i = 1; i <= count; i++)
+			{
+				bool const hit = (maskbytes[i] & mask) == value;
+				pri_ref[i] = (pri_ref[i] & (pcode >> 8)) | pcode;
+				ind16_ref[i] = source[i] + pal;
+				rgb32_ref[i] = pens[pal + source[i]];
+				if (hit)
+				{
+					pri_masked_ref[i] = (pri_masked_ref[i] & (pcode >> 8)) | pcode;
+					ind16_masked_ref[i] = source[i] + pal;
+					rgb32_masked_ref[i] = pens[pal + source[i]];
+				}
+			}
+
+			tile_span::priority(&pri_test[1], count, pcode);
+			tile_span::priority_masked(&pri_masked_test[1], maskptr, mask, value, count, pcode);
+			tile_span::offset_ind16(&ind16_test[1], src, count, pal);
+			tile_span::offset_masked_ind16(&ind16_masked_test[1], src, maskptr, mask, value, count, pal);
+			tile_span::lookup_rgb32(&rgb32_test[1], src, count, clut);
+			tile_span::lookup_masked_rgb32(&rgb32_masked_test[1], src, maskptr, mask, value, count, clut);
+
+			REQUIRE(pri_test == pri_ref);
+			REQUIRE(pri_masked_test == pri_masked_ref);
+			REQUIRE(ind16_test == ind16_ref);
+			REQUIRE(ind16_masked_test == ind16_masked_ref);
+			REQUIRE(rgb32_test == rgb32_ref);
+			REQUIRE(rgb32_masked_test == rgb32_masked_ref);
+		}
+	}
+}
@@ -0,0 +1,137 @@
+#include "catch.hpp"
+
+#include "ios/audioring.h"
+
+#include <random>
+#include <thread>
+#include <vector>
+
+
+TEST_CASE("Audio ring keeps frames in order across threads", "[osd][ios]")
+{
+	ios_audio_ring ring(1000);
+	REQUIRE(ring.capacity() == 1024);
+
+	constexpr uint32_t total = 200000;
+	std::thread producer([&ring] ()
+	{
+		std::vector<int16_t> block;
+		uint32_t next = 0;
+		while (next < total)
+		{
+			uint32_t const count = std::min<uint32_t>(1 + next % 97, total - next);
+			block.clear();
+			for (uint32_t frame = 0; frame < count; frame++)
+			{
+				block.push_back(int16_t(next + frame));
+				block.push_back(int16_t(~(next + frame)));
+			}
+			uint32_t written = 0;
+			while (written < count)
+			{
+				written += ring.write(&block[written * 2], count - written);
+				std::this_thread::yield();
+			}
+			next += count;
+		}
+	});
+
+	std::vector<int16_t> block(2 * 128);
+	uint32_t expected = 0;
+	bool ordered = true;
+	while (expected < total)
+	{
+		uint32_t const count = std::min<uint32_t>(ring.fill(), 128);
+		if (!count)
+		{
+			std::this_thread::yield();
+			continue;
+		}
+		REQUIRE(ring.read(&block[0], count) == count);
+		for (uint32_t frame = 0; frame < count; frame++, expected++)
+			ordered = ordered && (block[frame * 2] == int16_t(expected)) && (block[frame * 2 + 1] == int16_t(~expected));
+	}
+	producer.join();
+
+	REQUIRE(ordered);
+	REQUIRE(ring.underruns() == 0);
+}
+
+
+TEST_CASE("Audio ring fades out on underrun", "[osd][ios]")
+{
+	ios_audio_ring ring(64);
+	int16_t const frame[2] = { 16000, -16000 };
+	ring.write(frame, 1);
+
+	int16_t out[2 * 64];
+	REQUIRE(ring.read(out, 64) == 1);
+	REQUIRE(ring.underruns() == 1);
+	REQUIRE(out[2] < 16000);
+	REQUIRE(out[2] > 0);
+	REQUIRE(out[2 * 63] < out[2]);
+	REQUIRE(out[2 * 63 + 1] > out[3]);
+}
+
+
+TEST_CASE("Audio resampler follows a jittery consumer clock", "[osd][ios]")
+{
+	/*
+	    Emulation produces 800 frames every 1/60 second at 48kHz while
+	    the host consumes at a clock 0.3% fast, in uneven chunks at
+	    uneven times.  Without rate control the ring would drain by
+	    about 144 frames per second; with it, the fill level should
+	    settle around the target with no underruns or overruns.
+	*/
+	constexpr uint32_t rate = 48000;
+	constexpr uint32_t latency = rate / 20;
+	ios_audio_ring ring(latency * 2);
+	ios_audio_resampler resampler;
+	resampler.reset(latency);
+	std::vector<int16_t> silence(latency * 2, 0);
+	ring.write(&silence[0], latency);
+
+	std::mt19937 rng(99);
+	std::vector<int16_t> produced(800 * 2);
+	std::vector<int16_t> consumed(2048 * 2);
+	double const host_rate = rate * 1.003;
+	double produce_time = 0.0;
+	double consume_time = 0.0;
+	double consume_debt = 0.0;
+	uint32_t phase = 0;
+	uint32_t min_fill = ~0U, max_fill = 0;
+	for (int frame = 0; frame < 60 * 120; frame++)
+	{
+		// one video frame of sine wave audio
+		for (uint32_t sample = 0; sample < 800; sample++, phase++)
+		{
+			produced[sample * 2 + 0] = int16_t(8000.0 * std::sin(phase * 0.05));
+			produced[sample * 2 + 1] = produced[sample * 2 + 0];
+		}
+		resampler.push(ring, &produced[0], 800);
+		produce_time += 1.0 / 60.0;
+
+		// the host wakes up every 2-12ms and takes whatever its clock says it played
+		while (consume_time < produce_time)
+		{
+			double const step = (2.0 + (rng() % 1000) * 0.01) / 1000.0;
+			consume_time += step;
+			consume_debt += step * host_rate;
+			uint32_t const count = std::min<uint32_t>(uint32_t(consume_debt), 2048);
+			consume_debt -= count;
+			ring.read(&consumed[0], count);
+		}
+
+		if (frame >= 60 * 30)
+		{
+			min_fill = std::min(min_fill, ring.fill());
+			max_fill = std::max(max_fill, ring.fill());
+		}
+	}
+
+	REQUIRE(ring.underruns() == 0);
+	REQUIRE(ring.overruns() == 0);
+	REQUIRE(resampler.ratio() < 1.0);
+	REQUIRE(min_fill > latency / 2);
+	REQUIRE(max_fill < latency * 3 / 2);
+}
@@ -0,0 +1,187 @@
+#include "catch.hpp"
+#include "emu.h"
+#include "render.h"
+#include "ios/primlist.h"
+
+#include <vector>
+
+
+//-------------------------------------------------
+//  make_quad - build a textured quad primitive
+//-------------------------------------------------
+
+static render_primitive make_quad(void *base, u32 seqid, float x, u64 id = 0)
+{
+	render_primitive prim;
+	prim.type = render_primitive::QUAD;
+	prim.bounds = render_bounds{ x, 0.0F, x + 100.0F, 100.0F };
+	prim.color = render_color{ 1.0F, 1.0F, 1.0F, 1.0F };
+	prim.flags = PRIMFLAG_TEXFORMAT(TEXFORMAT_ARGB32) | PRIMFLAG_BLENDMODE(BLENDMODE_ALPHA);
+	prim.texture.base = base;
+	prim.texture.rowpixels = 16;
+	prim.texture.width = 16;
+	prim.texture.height = 16;
+	prim.texture.seqid = seqid;
+	prim.texture.unique_id = id;
+	return prim;
+}
+
+
+//-------------------------------------------------
+//  fake_video_draw - stand-in for the host's
+//  video_draw callback, recording what it sees
+//-------------------------------------------------
+
+struct fake_frame
+{
+	unsigned count = 0;
+	unsigned dirty = 0;
+	std::vector<float> x0;
+};
+
+static fake_frame fake_video_draw(myosd_render_primitive *prim_list)
+{
+	fake_frame frame;
+	for (myosd_render_primitive *prim = prim_list; prim != nullptr; prim = prim->next)
+	{
+		frame.count++;
+		frame.dirty += prim->texture_dirty;
+		frame.x0.push_back(prim->bounds_x0);
+	}
+	return frame;
+}
+
+
+TEST_CASE("Primitive list handoff is not limited in size", "[osd][ios]")
+{
+	static u32 pixels[16 * 16];
+	std::vector<render_primitive> prims;
+	for (int i = 0; i < 5000; i++)
+		prims.push_back(make_quad(pixels, 1, float(i)));
+
+	ios_render_primlist primlist;
+	fake_frame const frame = fake_video_draw(primlist.convert(prims));
+	REQUIRE(frame.count == 5000);
+	REQUIRE(frame.x0.back() == 4999.0F);
+	REQUIRE(primlist.count() == 5000);
+
+	prims.clear();
+	REQUIRE(primlist.convert(prims) == nullptr);
+	REQUIRE(primlist.count() == 0);
+	REQUIRE(primlist.changed());
+}
+
+
+TEST_CASE("Primitive list flags only changed textures", "[osd][ios]")
+{
+	static u32 screen[16 * 16], artwork[16 * 16];
+	ios_render_primlist primlist;
+
+	// first frame: everything is new
+	std::vector<render_primitive> prims = { make_quad(artwork, 7, 0.0F, 1), make_quad(screen, 1, 100.0F, 2) };
+	fake_frame frame = fake_video_draw(primlist.convert(prims));
+	REQUIRE(frame.count == 2);
+	REQUIRE(frame.dirty == 2);
+	REQUIRE(primlist.changed());
+
+	// same frame again: nothing to upload or redraw
+	frame = fake_video_draw(primlist.convert(prims));
+	REQUIRE(frame.dirty == 0);
+	REQUIRE(!primlist.changed());
+
+	// the screen texture is updated, the artwork is not
+	prims[1].texture.seqid = 2;
+	myosd_render_primitive *list = primlist.convert(prims);
+	REQUIRE(!list->texture_dirty);
+	REQUIRE(list->next->texture_dirty);
+	REQUIRE(primlist.dirty() == 1);
+	REQUIRE(primlist.changed());
+
+	// a primitive moves but no texture changes: redraw without uploading
+	prims[0].bounds.x0 = 10.0F;
+	frame = fake_video_draw(primlist.convert(prims));
+	REQUIRE(frame.dirty == 0);
+	REQUIRE(primlist.changed());
+
+	// the previous list is still intact while the next one is in use
+	myosd_render_primitive *const prev = primlist.convert(prims);
+	REQUIRE(!primlist.changed());
+	myosd_render_primitive *const next = primlist.convert(prims);
+	REQUIRE(prev != next);
+	REQUIRE(prev->bounds_x0 == 10.0F);
+	REQUIRE(prev->next->bounds_x0 == 100.0F);
+
+	// after a reset the next frame is reported in full
+	primlist.reset();
+	frame = fake_video_draw(primlist.convert(prims));
+	REQUIRE(frame.dirty == 2);
+	REQUIRE(primlist.changed());
+}
+
+
+TEST_CASE("Primitive list flags a texture reallocated at the same address", "[osd][ios]")
+{
+	static u32 pixels[16 * 16];
+	ios_render_primlist primlist;
+
+	std::vector<render_primitive> prims = { make_quad(pixels, 1, 0.0F, 10) };
+	REQUIRE(primlist.convert(prims)->texture_dirty);
+	REQUIRE(!primlist.convert(prims)->texture_dirty);
+
+	// the texture is freed and a new one lands on the same memory; its seqid restarts at
+	// the same value and the palette matches, but it has a new unique id
+	prims[0].texture.unique_id = 11;
+	myosd_render_primitive *list = primlist.convert(prims);
+	REQUIRE(list->texture_dirty);
+	REQUIRE(list->texture_unique_id == 11);
+	REQUIRE(primlist.dirty() == 1);
+	REQUIRE(primlist.changed());
+
+	// two scaled copies of one texture in the same frame are tracked separately
+	static u32 small[8 * 8];
+	prims.push_back(make_quad(small, 3, 100.0F, 11));
+	primlist.convert(prims);
+	REQUIRE(primlist.convert(prims)->texture_dirty == 0);
+	REQUIRE(primlist.dirty() == 0);
+}
+
+
+TEST_CASE("Primitive list forwards dirty areas and counts uploads", "[osd][ios]")
+{
+	static u32 pixels[16 * 16];
+	ios_render_primlist primlist;
+
+	// a new texture has to be uploaded in full
+	std::vector<render_primitive> prims = { make_quad(pixels, 1, 0.0F, 20) };
+	prims[0].texture.dirty_seqid = 0;
+	prims[0].texture.dirty = rectangle(0, 15, 0, 15);
+	primlist.convert(prims);
+	REQUIRE(primlist.uploaded_pixels() == 16 * 16);
+	REQUIRE(primlist.upload_total_pixels() == 16 * 16);
+
+	// an unchanged texture uploads nothing
+	primlist.convert(prims);
+	REQUIRE(primlist.uploaded_pixels() == 0);
+	REQUIRE(primlist.upload_total_pixels() == 0);
+
+	// relative to the seqid the host holds, only the dirty rows go up
+	prims[0].texture.seqid = 2;
+	prims[0].texture.dirty_seqid = 1;
+	prims[0].texture.dirty = rectangle(3, 9, 4, 7);
+	myosd_render_primitive *list = primlist.convert(prims);
+	REQUIRE(list->texture_dirty);
+	REQUIRE(list->texture_dirty_seqid == 1);
+	REQUIRE(list->texture_dirty_min_x == 3);
+	REQUIRE(list->texture_dirty_max_x == 9);
+	REQUIRE(list->texture_dirty_min_y == 4);
+	REQUIRE(list->texture_dirty_max_y == 7);
+	REQUIRE(primlist.uploaded_pixels() == 4 * 16);
+	REQUIRE(primlist.upload_total_pixels() == 16 * 16);
+
+	// a host that missed the sequence the area is relative to refreshes it all
+	prims[0].texture.seqid = 4;
+	prims[0].texture.dirty_seqid = 3;
+	primlist.convert(prims);
+	REQUIRE(primlist.uploaded_pixels() == 16 * 16);
+	REQUIRE(primlist.upload_total_pixels() == 16 * 16);
+}